@@ -0,0 +1,103 @@
+/*
+  ==============================================================================
+
+    BenchRunner.cpp
+    Created: 15 Oct 2026 10:12:31am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "BenchRunner.h"
+
+BenchRunner::BenchRunner(const Options& options) : _options(options) {
+}
+
+bool BenchRunner::isSelected(const String& name) const {
+	return _options.filter.isEmpty() || name.contains(_options.filter);
+}
+
+bool BenchRunner::isAnySelected(const String& prefix, const StringArray& cases) const {
+	for (const auto& c : cases)
+		if (isSelected(prefix + "/" + c))
+			return true;
+	return false;
+}
+
+void BenchRunner::run(const String& name, const NamedValueSet& params, double itemsPerIteration, const std::function<void()>& fn) {
+	if (!isSelected(name))
+		return;
+	fn();
+
+	std::vector<double> times;
+	const double start = Time::getMillisecondCounterHiRes();
+	while ((int)times.size() < _options.minIterations || Time::getMillisecondCounterHiRes() - start < _options.minDuration) {
+		const double t0 = Time::getMillisecondCounterHiRes();
+		fn();
+		times.push_back(Time::getMillisecondCounterHiRes() - t0);
+	}
+
+	double sum = 0.0;
+	for (auto t : times)
+		sum += t;
+	const double meanMs = sum / (double)times.size();
+	add(name, params, std::move(times), itemsPerIteration > 0.0 && meanMs > 0.0 ? itemsPerIteration * 1000.0 / meanMs : 0.0);
+}
+
+void BenchRunner::add(const String& name, const NamedValueSet& params, std::vector<double> times, double itemsPerSecond) {
+	if (!isSelected(name) || times.empty())
+		return;
+	Result r;
+	r.name = name;
+	r.params = params;
+	r.iterations = (int)times.size();
+	double sum = 0.0;
+	for (auto t : times)
+		sum += t;
+	r.meanMs = sum / (double)times.size();
+	std::sort(times.begin(), times.end());
+	r.medianMs = times[times.size() / 2];
+	r.minMs = times.front();
+	r.maxMs = times.back();
+	r.itemsPerSecond = itemsPerSecond;
+	_results.push_back(r);
+	if (onResult)
+		onResult(r);
+}
+
+String BenchRunner::toJson() const {
+	auto* build = new DynamicObject();
+#if JUCE_DEBUG
+	build->setProperty("config", "Debug");
+#else
+	build->setProperty("config", "Release");
+#endif
+	build->setProperty("version", ProjectInfo::versionString);
+	build->setProperty("juce", SystemStats::getJUCEVersion());
+	build->setProperty("cpu", SystemStats::getCpuModel());
+	build->setProperty("cores", SystemStats::getNumCpus());
+	build->setProperty("os", SystemStats::getOperatingSystemName());
+	build->setProperty("date", Time::getCurrentTime().toISO8601(true));
+
+	Array<var> results;
+	for (const auto& r : _results) {
+		auto* o = new DynamicObject();
+		o->setProperty("name", r.name);
+		auto* params = new DynamicObject();
+		for (const auto& p : r.params)
+			params->setProperty(p.name, p.value);
+		o->setProperty("params", var(params));
+		o->setProperty("iterations", r.iterations);
+		o->setProperty("meanMs", r.meanMs);
+		o->setProperty("medianMs", r.medianMs);
+		o->setProperty("minMs", r.minMs);
+		o->setProperty("maxMs", r.maxMs);
+		o->setProperty("itemsPerSecond", r.itemsPerSecond);
+		results.add(var(o));
+	}
+
+	auto* root = new DynamicObject();
+	root->setProperty("build", var(build));
+	root->setProperty("results", results);
+	return JSON::toString(var(root));
+}
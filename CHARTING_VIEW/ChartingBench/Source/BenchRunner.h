@@ -0,0 +1,65 @@
+/*
+  ==============================================================================
+
+    BenchRunner.h
+    Created: 15 Oct 2026 10:12:31am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+
+/*
+	Times the cases of ChartingBench and collects the results as JSON, one
+	file per build to compare them :
+
+	{ "build": { "config", "version", "juce", "cpu", "cores", "os", "date" },
+	  "results": [ { "name", "params", "iterations", "meanMs", "medianMs",
+	                 "minMs", "maxMs", "itemsPerSecond" } ] }
+
+	A case runs once to warm up (caches, lazy allocations), then until
+	minDuration ms passed and at least minIterations ran. Names are paths
+	("layout/flex/10000/wrap/resize"), the filter selects them by substring :
+	suites check isAnySelected() before building their data.
+*/
+
+class BenchRunner {
+public:
+	struct Options {
+		double minDuration = 500.0; // ms per case
+		int minIterations = 5;
+		String filter;              // every case when empty
+	};
+
+	struct Result {
+		String name;
+		NamedValueSet params;
+		int iterations = 0;
+		double meanMs = 0.0, medianMs = 0.0, minMs = 0.0, maxMs = 0.0;
+		double itemsPerSecond = 0.0; // items processed by one iteration / mean, 0 when not given
+	};
+
+	explicit BenchRunner(const Options& options);
+
+	bool isSelected(const String& name) const;
+	// any of the cases prefix/<case>, before building the data they share
+	bool isAnySelected(const String& prefix, const StringArray& cases) const;
+	// fn is one iteration, its setup stays outside
+	void run(const String& name, const NamedValueSet& params, double itemsPerIteration, const std::function<void()>& fn);
+	// a case timed by the suite itself (frames of a replay...), times in ms
+	void add(const String& name, const NamedValueSet& params, std::vector<double> times, double itemsPerSecond);
+
+	const Options& getOptions() const { return _options; }
+
+	const std::vector<Result>& getResults() const { return _results; }
+	String toJson() const;
+
+	// progress on stderr, the JSON alone goes to stdout
+	std::function<void(const Result&)> onResult;
+
+private:
+	Options _options;
+	std::vector<Result> _results;
+};
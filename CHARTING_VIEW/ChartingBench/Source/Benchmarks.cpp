@@ -0,0 +1,449 @@
+/*
+  ==============================================================================
+
+    Benchmarks.cpp
+    Created: 15 Oct 2026 10:12:31am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "Benchmarks.h"
+#include <iostream>
+#include "../../ChartingView/Source/core/data/IndicatorEngine.h"
+#include "../../ChartingView/Source/core/data/LodPyramid.h"
+#include "../../ChartingView/Source/core/data/FillClusters.h"
+#include "../../ChartingView/Source/core/data/CorrelationMatrix.h"
+#include "../../ChartingView/Source/core/data/CompressedKlineStore.h"
+#include "../../ChartingView/Source/core/io/BinanceKlineFeed.h"
+#include "../../ChartingView/Source/core/widgets/layout/WFlexLayout.h"
+#include "../../ChartingView/Source/core/widgets/ui/chart/WChart.h"
+
+KlineStore::Ptr Benchmarks::makeSyntheticStore(size_t numRows, uint32 seed) {
+	struct Columns {
+		std::vector<int64> time;
+		std::vector<double> open, high, low, close, volume;
+	};
+	auto c = std::make_shared<Columns>();
+	c->time.resize(numRows);
+	c->open.resize(numRows);
+	c->high.resize(numRows);
+	c->low.resize(numRows);
+	c->close.resize(numRows);
+	c->volume.resize(numRows);
+
+	Random random((int64)seed);
+	const int64 start = 1600000000000; // Sep 2020
+	double price = 10000.0;
+	for (size_t i = 0; i < numRows; i++) {
+		const double open = price;
+		price = jmax(1.0, price * (1.0 + (random.nextDouble() - 0.5) * 0.004));
+		const double wick = price * random.nextDouble() * 0.002;
+		c->time[i] = start + (int64)i * 60000;
+		c->open[i] = open;
+		c->close[i] = price;
+		c->high[i] = jmax(open, price) + wick;
+		c->low[i] = jmin(open, price) - wick;
+		c->volume[i] = 1.0 + random.nextDouble() * 100.0;
+	}
+
+	const void* columns[KlineStore::numColumns] = {};
+	columns[KlineStore::openTime] = c->time.data();
+	columns[KlineStore::open] = c->open.data();
+	columns[KlineStore::high] = c->high.data();
+	columns[KlineStore::low] = c->low.data();
+	columns[KlineStore::close] = c->close.data();
+	columns[KlineStore::volume] = c->volume.data();
+	auto store = KlineStore::wrapExternal(c, columns, numRows);
+	store->setSymbol("SYNTHETIC");
+	store->setInterval("1m");
+	return store;
+}
+
+//==============================================================================
+void Benchmarks::layout(BenchRunner& bench) {
+	// groups of 10 leaves, the groups are laid out by the root
+	for (int numLeaves : { 1000, 10000 }) {
+		for (bool wrap : { false, true }) {
+			const String name = "layout/flex/" + String(numLeaves) + (wrap ? "/wrap" : "/nowrap");
+			if (!bench.isAnySelected(name, { "resize", "unchanged" }))
+				continue;
+			BaseComponent root;
+			auto rootOptions = wrap ? WFlexLayout::Options::horizontal_items() : WFlexLayout::Options::vertical_group();
+			if (wrap) {
+				rootOptions.justify = WFlexLayout::JustifyContent::FlexStart;
+				rootOptions.wrap = WFlexLayout::FlexWrap::Wrap;
+			}
+			root.setParentLayout(new WFlexLayout(rootOptions));
+			std::vector<UPtr<BaseComponent>> nodes;
+			for (int g = 0; g < numLeaves / 10; g++) {
+				auto group = std::make_unique<BaseComponent>();
+				group->setParentLayout(new WFlexLayout(WFlexLayout::Options::horizontal_group()));
+				group->getPreferredSize().setPreferredSize(120, 24, false);
+				for (int i = 0; i < 10; i++) {
+					auto leaf = std::make_unique<BaseComponent>();
+					leaf->getPreferredSize().setPreferredSize(10, 24, false);
+					group->addAndMakeVisible(leaf.get());
+					nodes.push_back(std::move(leaf));
+				}
+				root.addAndMakeVisible(group.get());
+				nodes.push_back(std::move(group));
+			}
+			root.setBounds(0, 0, 1920, 1080);
+
+			const auto params = NamedValueSet({ { "leaves", numLeaves }, { "wrap", wrap } });
+			// the size alternates : without wrap every group is resized and lays its leaves
+			// out again, with wrap the groups move to other lines
+			bool odd = false;
+			bench.run(name + "/resize", params, (double)nodes.size(), [&]() {
+				odd = !odd;
+				root.setBounds(0, 0, odd ? 1600 : 1920, odd ? 900 : 1080);
+			});
+			bench.run(name + "/unchanged", params, (double)nodes.size(), [&]() {
+				root.resized();
+			});
+		}
+	}
+}
+
+//==============================================================================
+void Benchmarks::mapping(BenchRunner& bench) {
+	if (!bench.isAnySelected("mapping", { "x/scalar", "x/slice", "y/scalar/linear", "y/slice/linear", "y/scalar/log", "y/slice/log" }))
+		return;
+	const size_t n = 1000000;
+	auto store = makeSyntheticStore(n);
+	WChartScaleTransform t;
+	t.xWorld.setWorldStart(0).setWorldEnd(1600).setViewportStart(0).setViewportEnd(1600);
+	t.xUnit.setWorldStart(0).setWorldEnd((double)(n * 60000));
+	t.yWorld.setWorldStart(0).setWorldEnd(900).setViewportStart(0).setViewportEnd(900);
+	const auto prices = store->computePriceRange(0, n);
+	t.yUnit.setWorldStart(prices.getStart()).setWorldEnd(prices.getEnd());
+	const int64 origin = store->getFirstOpenTime();
+	std::vector<float> out(n);
+	float sink = 0.0f;
+	const auto params = NamedValueSet({ { "values", (int)n } });
+
+	bench.run("mapping/x/scalar", params, (double)n, [&]() {
+		const auto xMap = t.getXMapping(origin, 1600.0f);
+		const auto* times = store->getOpenTime();
+		for (size_t i = 0; i < n; i++)
+			out[i] = xMap.toPixel(times[i]);
+		sink += out[n - 1];
+	});
+	bench.run("mapping/x/slice", params, (double)n, [&]() {
+		t.getXMapping(origin, 1600.0f).toPixels(store->getOpenTime(), out.data(), n);
+		sink += out[n - 1];
+	});
+	for (auto scale : { AxisScale::linear, AxisScale::logarithmic }) {
+		t.yScale = scale;
+		const String suffix = scale == AxisScale::linear ? "linear" : "log";
+		bench.run("mapping/y/scalar/" + suffix, params, (double)n, [&]() {
+			t.withYMapper(900.0f, [&](const auto& yMap) {
+				const auto* close = store->getClose();
+				for (size_t i = 0; i < n; i++)
+					out[i] = yMap.toPixel(close[i]);
+			});
+			sink += out[n - 1];
+		});
+		bench.run("mapping/y/slice/" + suffix, params, (double)n, [&]() {
+			t.withYMapper(900.0f, [&](const auto& yMap) { yMap.toPixels(store->getClose(), out.data(), n); });
+			sink += out[n - 1];
+		});
+	}
+	// keeps the loops from being optimized out
+	if (sink == 1.2345f)
+		std::cerr << sink;
+}
+
+//==============================================================================
+void Benchmarks::lod(BenchRunner& bench) {
+	for (size_t n : { (size_t)10000, (size_t)1000000, (size_t)10000000 }) {
+		const String name = "lod/" + String((int64)n);
+		if (!bench.isAnySelected(name, { "build", "query", "range", "scan" }))
+			continue;
+		auto store = makeSyntheticStore(n);
+		LodPyramid lod;
+		const auto params = NamedValueSet({ { "rows", (int64)n } });
+		bench.run(name + "/build", params, (double)n, [&]() { lod.build(*store); });
+
+		// price range of random visible ranges over 1600 px, as the viewport fits its y axis
+		const int numQueries = 1000;
+		Random random(7);
+		std::vector<std::pair<size_t, size_t>> ranges;
+		for (int i = 0; i < numQueries; i++) {
+			const size_t span = jmax((size_t)100, (size_t)(random.nextDouble() * (double)n));
+			const size_t first = (size_t)(random.nextDouble() * (double)(n - jmin(n, span)));
+			ranges.push_back({ first, jmin(n, first + span) });
+		}
+		double sink = 0.0;
+		bench.run(name + "/query", params, (double)numQueries, [&]() {
+			for (const auto& r : ranges) {
+				const auto level = lod.getLevel(lod.chooseLevel((double)(r.second - r.first) / 1600.0));
+				const size_t b0 = r.first >> level.shift;
+				const size_t b1 = jmin(level.size, ((r.second - 1) >> level.shift) + 1);
+				double high = level.high[b0], low = level.low[b0];
+				for (size_t b = b0 + 1; b < b1; b++) {
+					high = jmax(high, level.high[b]);
+					low = jmin(low, level.low[b]);
+				}
+				sink += high - low;
+			}
+		});
+		// exact low / high of the same ranges (y autoscale) : the pyramid as a segment tree, then the rows
+		bench.run(name + "/range", params, (double)numQueries, [&]() {
+			for (const auto& r : ranges)
+				sink += lod.computePriceRange(r.first, r.second).getLength();
+		});
+		bench.run(name + "/scan", params, (double)numQueries, [&]() {
+			for (const auto& r : ranges)
+				sink += store->computePriceRange(r.first, r.second).getLength();
+		});
+		if (sink == 1.2345)
+			std::cerr << sink;
+	}
+}
+
+//==============================================================================
+void Benchmarks::fills(BenchRunner& bench) {
+	for (size_t n : { (size_t)10000, (size_t)1000000 }) {
+		const String name = "fills/" + String((int64)n);
+		if (!bench.isAnySelected(name, { "build", "query" }))
+			continue;
+		// a fill every few minutes on average, over the span of as many candles
+		Random random(11);
+		const int64 start = 1600000000000;
+		const int64 span = (int64)n * 60000;
+		std::vector<FillClusters::Fill> fills(n);
+		for (auto& f : fills) {
+			f.time = start + (int64)(random.nextDouble() * (double)span);
+			f.price = 10000.0 + random.nextDouble() * 1000.0;
+			f.qty = (random.nextBool() ? 1.0 : -1.0) * (0.01 + random.nextDouble());
+			f.pnl = (random.nextDouble() - 0.5) * 10.0;
+		}
+		const auto params = NamedValueSet({ { "fills", (int64)n } });
+		UPtr<FillClusters> clusters;
+		bench.run(name + "/build", params, (double)n, [&]() { clusters = std::make_unique<FillClusters>(fills); });
+
+		// clusters of 16 px over 1600 px for random visible ranges
+		const int numQueries = 1000;
+		std::vector<std::pair<int64, int64>> ranges;
+		for (int i = 0; i < numQueries; i++) {
+			const int64 width = jmax((int64)6000000, (int64)(random.nextDouble() * (double)span));
+			const int64 first = start + (int64)(random.nextDouble() * (double)(span - jmin(span, width)));
+			ranges.push_back({ first, first + width });
+		}
+		std::vector<FillClusters::Cluster> visible;
+		double sink = 0.0;
+		bench.run(name + "/query", params, (double)numQueries, [&]() {
+			for (const auto& r : ranges) {
+				clusters->query(r.first, r.second, (double)(r.second - r.first) / 100.0, visible);
+				sink += (double)visible.size();
+			}
+		});
+		if (sink == 1.2345)
+			std::cerr << sink;
+	}
+}
+
+//==============================================================================
+void Benchmarks::correlation(BenchRunner& bench) {
+	for (int n : { 100, 300 }) {
+		const String name = "correlation/" + String(n);
+		if (!bench.isAnySelected(name, { "push", "matrix" }))
+			continue;
+		// log returns of a minute bar, a few bars ahead of the window to loop over
+		const int window = 100, numBars = 1000;
+		Random random(17);
+		std::vector<double> returns((size_t)n * (size_t)numBars);
+		for (auto& r : returns)
+			r = (random.nextDouble() - 0.5) * 0.004;
+		const auto params = NamedValueSet({ { "symbols", n }, { "window", window } });
+		CorrelationMatrix matrix(n, window);
+		bench.run(name + "/push", params, (double)numBars, [&]() {
+			for (int k = 0; k < numBars; k++)
+				matrix.push(returns.data() + (size_t)k * (size_t)n);
+		});
+		std::vector<float> out;
+		double sink = 0.0;
+		bench.run(name + "/matrix", params, (double)n * (double)n, [&]() {
+			matrix.getMatrix(out);
+			sink += out[1];
+		});
+		if (sink == 1.2345)
+			std::cerr << sink;
+	}
+}
+
+//==============================================================================
+int Benchmarks::numFailedChecks = 0;
+
+void Benchmarks::compression(BenchRunner& bench) {
+	const size_t n = 1000000;
+	const String name = "compression/" + String((int64)n);
+	if (!bench.isAnySelected(name, { "compress", "decompress" }))
+		return;
+	// the synthetic candles with a quote volume as the exchanges write it : 8 decimals, now and
+	// then a large whole amount ahead of them in its block (exact at 0 digits, not once scaled)
+	auto synthetic = makeSyntheticStore(n);
+	auto store = KlineStore::allocate(n);
+	for (int c = 0; c < KlineStore::numColumns; c++)
+		memcpy(store->getWritableColumnData((KlineStore::Column)c), synthetic->getColumnData((KlineStore::Column)c), n * KlineStore::elementSize);
+	Random random(23);
+	auto* quote = store->getWritableDoubleColumn(KlineStore::quoteVolume);
+	for (size_t i = 0; i < n; i++)
+		quote[i] = i % 97 == 0
+			? std::floor(1e10 + random.nextDouble() * 1e11)
+			: std::round(store->getVolume()[i] * store->getClose()[i] * 1e8) / 1e8;
+
+	const auto params = NamedValueSet({ { "rows", (int64)n } });
+	CompressedKlineStore::Ptr compressed;
+	bench.run(name + "/compress", params, (double)n, [&]() { compressed = CompressedKlineStore::compress(*store); });
+	KlineStore::Ptr decoded;
+	bench.run(name + "/decompress", params, (double)n, [&]() { decoded = compressed->decompress(); });
+
+	// every value gives the same bits back
+	size_t numDiffering = 0;
+	for (int c = 0; c < KlineStore::numColumns; c++) {
+		const auto* a = static_cast<const uint64*>(store->getColumnData((KlineStore::Column)c));
+		const auto* b = static_cast<const uint64*>(decoded->getColumnData((KlineStore::Column)c));
+		for (size_t i = 0; i < n; i++)
+			numDiffering += a[i] != b[i];
+	}
+	if (numDiffering > 0) {
+		std::cerr << name << " : " << numDiffering << " values differ after a round trip" << std::endl;
+		numFailedChecks++;
+	}
+}
+
+//==============================================================================
+void Benchmarks::chart(BenchRunner& bench) {
+	const int width = 1600, height = 900;
+	for (size_t n : { (size_t)10000, (size_t)1000000, (size_t)10000000 }) {
+		const String name = "chart/software/" + String((int64)n);
+		if (!bench.isAnySelected(name, { "all", "last500" }))
+			continue;
+		WChart chart;
+		WChart::SharedX x;
+		x.stack = &chart;
+		chart.setSharedX(&x);
+		chart.setBackgroundRenderingEnabled(false);
+		chart.setOpenGLEnabled(false);
+		chart.setBounds(0, 0, width, height);
+		chart.setStore(makeSyntheticStore(n));
+		x.transform.snapZoom = false;
+
+		Image image(Image::ARGB, width, height, true, SoftwareImageType());
+		// the zoom moves a little every frame : every layer cache misses, as while zooming
+		bool odd = false;
+		auto frame = [&]() {
+			odd = !odd;
+			const float plotWidth = (float)x.transform.xWorld.getWorldSize();
+			x.transform.zoomX(odd ? 0.999 : 1.0 / 0.999, plotWidth, plotWidth);
+			Graphics g(image);
+			chart.paintEntireComponent(g, true);
+		};
+		const auto params = NamedValueSet({ { "candles", (int64)n }, { "width", width }, { "height", height } });
+		bench.run(name + "/all", params, 1.0, frame);
+
+		// last 500 candles, the right edge stays in place
+		const float plotWidth = (float)x.transform.xWorld.getWorldSize();
+		x.transform.zoomX(500.0 / (double)n, plotWidth, plotWidth);
+		bench.run(name + "/last500", params, 1.0, frame);
+		chart.setSharedX(nullptr);
+	}
+}
+
+//==============================================================================
+void Benchmarks::replay(BenchRunner& bench) {
+	const int width = 1600, height = 900;
+	// one update every 2 s of recorded time, as the kline stream
+	const int ticksPerKline = 30;
+	const double frameMs = 1000.0 / 60.0;
+	// the symbols share one store : the replay cost does not depend on the prices
+	const size_t numRows = 200000;
+	KlineStore::Ptr store;
+	for (int numSymbols : { 1, 10, 100 }) {
+		const String name = "replay/" + String(numSymbols);
+		if (!bench.isAnySelected(name, { "10x", "100x", "1000x", "max" }))
+			continue;
+		if (store == nullptr)
+			store = makeSyntheticStore(numRows);
+		StringArray symbols;
+		for (int i = 0; i < numSymbols; i++)
+			symbols.add("SYM" + String(i));
+		const std::vector<KlineStore::Ptr> stores((size_t)numSymbols, store);
+
+		for (double speed : { 10.0, 100.0, 1000.0, ReplayClock::asFastAsPossible }) {
+			const String caseName = name + "/" + (speed > 0.0 ? String((int)speed) + "x" : String("max"));
+			if (!bench.isSelected(caseName))
+				continue;
+			BinanceKlineFeed feed(1 << 14, 1 << 12);
+
+			// the live path downstream of the feed : an incremental SMA per symbol on the
+			// closes, the first symbol in a chart repainting its live candles
+			std::vector<std::vector<double>> closes((size_t)numSymbols);
+			std::vector<UPtr<Indicator>> smas;
+			for (int i = 0; i < numSymbols; i++)
+				smas.push_back(std::make_unique<SmaIndicator>(20));
+			std::vector<int64> lastOpenTime((size_t)numSymbols, -1);
+			feed.onKline = [&](const BinanceKlineFeed::Event& e) {
+				auto& c = closes[(size_t)e.symbolIndex];
+				auto& last = lastOpenTime[(size_t)e.symbolIndex];
+				if (e.openTime != last || c.empty())
+					c.push_back(e.close);
+				else
+					c.back() = e.close;
+				last = e.openTime;
+				smas[(size_t)e.symbolIndex]->update(c.data(), c.size(), c.size() - 1);
+			};
+
+			WChart chart;
+			WChart::SharedX x;
+			x.stack = &chart;
+			chart.setSharedX(&x);
+			chart.setBackgroundRenderingEnabled(false);
+			chart.setOpenGLEnabled(false);
+			chart.setBounds(0, 0, width, height);
+			Image image(Image::ARGB, width, height, true, SoftwareImageType());
+
+			BinanceKlineFeed::Replay replay;
+			replay.ticksPerKline = ticksPerKline;
+			replay.clock = std::make_shared<ReplayClock>(speed);
+			feed.startReplay(symbols, stores, replay);
+			chart.setLiveSeries(feed.getSeries(0));
+			feed.onUpdated = [&] { chart.updateLiveSeries(); };
+
+			// frames at 60 Hz as the message thread would run them : drain, then paint.
+			// Headless, the whole chart is painted, its layers cached as in the app
+			const double duration = jmax(200.0, bench.getOptions().minDuration * 4.0);
+			std::vector<double> times;
+			const double start = Time::getMillisecondCounterHiRes();
+			double next = start;
+			while (Time::getMillisecondCounterHiRes() - start < duration && !feed.isReplayFinished()) {
+				next += frameMs;
+				const double t0 = Time::getMillisecondCounterHiRes();
+				feed.drain();
+				{
+					Graphics g(image);
+					chart.paintEntireComponent(g, true);
+				}
+				const double t1 = Time::getMillisecondCounterHiRes();
+				times.push_back(t1 - t0);
+				if (next > t1)
+					Time::waitForMillisecondCounter((uint32)next);
+				else
+					next = t1;
+			}
+			const double elapsed = Time::getMillisecondCounterHiRes() - start;
+			feed.stop();
+			chart.setSharedX(nullptr);
+
+			// events per second the speed asks for, above the sustained rate when the
+			// pipeline falls behind
+			const double target = speed > 0.0 ? (double)numSymbols * ticksPerKline * speed / 60.0 : 0.0;
+			const auto params = NamedValueSet({ { "symbols", numSymbols }, { "speed", speed }, { "ticksPerKline", ticksPerKline },
+				{ "targetPerSecond", target }, { "applied", (int64)feed.getNumApplied() }, { "dropped", (int64)feed.getNumDropped() } });
+			bench.add(caseName, params, std::move(times), (double)feed.getNumApplied() * 1000.0 / elapsed);
+		}
+	}
+}
@@ -0,0 +1,55 @@
+/*
+  ==============================================================================
+
+    Benchmarks.h
+    Created: 15 Oct 2026 10:12:31am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+#include "BenchRunner.h"
+#include "../../ChartingView/Source/core/data/KlineStore.h"
+
+/*
+	The suites of ChartingBench, each adds its cases to the runner :
+
+	- layout : WFlexLayout passes over synthetic trees (1k / 10k leaves, wrap
+	  and no wrap), the root resized and memoized (unchanged) passes
+	- mapping : WChartScaleTransform frame mappings over 1M values, per
+	  point and in slices, linear and log
+	- lod : LodPyramid builds and visible range queries, exact price ranges
+	  from the pyramid (computePriceRange) against a scan of the rows
+	- fills : FillClusters builds over 10k / 1M fills and the visible clusters
+	  of the same random ranges as lod, to compare with its query
+	- correlation : CorrelationMatrix bars pushed for 100 / 300 symbols over a
+	  window of 100, and the full matrix read back
+	- compression : CompressedKlineStore compress and decompress of 1M
+	  candles, then a check that every value comes back bit for bit (quote
+	  volumes mixing large whole amounts and 8 decimals)
+	- chart : software rendered WChart frames at 1e4 / 1e6 / 1e7 candles,
+	  whole series and last 500 candles in view
+	- replay : BinanceKlineFeed::startReplay of 1 / 10 / 100 symbols at 10x,
+	  100x, 1000x and as fast as possible, drained and drawn at 60 Hz. The
+	  frame times are the UI frames, itemsPerSecond the sustained updates
+*/
+
+struct Benchmarks {
+	static void layout(BenchRunner& bench);
+	static void mapping(BenchRunner& bench);
+	static void lod(BenchRunner& bench);
+	static void fills(BenchRunner& bench);
+	static void correlation(BenchRunner& bench);
+	static void compression(BenchRunner& bench);
+	static void chart(BenchRunner& bench);
+	static void replay(BenchRunner& bench);
+
+	// random walk of one minute candles, the same for a seed. Only the time and
+	// price columns are stored, the others read as zeros
+	static KlineStore::Ptr makeSyntheticStore(size_t numRows, uint32 seed = 1);
+
+	// round trips that didn't give their input back, ChartingBench then exits with 1
+	static int numFailedChecks;
+};
@@ -0,0 +1,64 @@
+/*
+  ==============================================================================
+
+    Headless benchmarks of the ChartingView core, results as JSON :
+
+        ChartingBench [--filter <substring>] [--out <file.json>] [--quick]
+
+    Without --out the JSON goes to stdout, progress always goes to stderr.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "BenchRunner.h"
+#include "Benchmarks.h"
+#include <iostream>
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    // fonts, images and the message manager of the widgets
+    juce::ScopedJuceInitialiser_GUI juce;
+
+    juce::ArgumentList args (argc, argv);
+    BenchRunner::Options options;
+    options.filter = args.getValueForOption ("--filter");
+    if (args.containsOption ("--quick"))
+    {
+        options.minDuration = 50.0;
+        options.minIterations = 2;
+    }
+
+    BenchRunner bench (options);
+    bench.onResult = [] (const BenchRunner::Result& r)
+    {
+        std::cerr << r.name << " : " << juce::String (r.medianMs, 3) << " ms (" << r.iterations << " runs)" << std::endl;
+    };
+
+    Benchmarks::layout (bench);
+    Benchmarks::mapping (bench);
+    Benchmarks::lod (bench);
+    Benchmarks::fills (bench);
+    Benchmarks::correlation (bench);
+    Benchmarks::compression (bench);
+    Benchmarks::chart (bench);
+    Benchmarks::replay (bench);
+
+    const auto json = bench.toJson();
+    const auto out = args.getValueForOption ("--out");
+    if (out.isNotEmpty())
+    {
+        const auto file = juce::File::getCurrentWorkingDirectory().getChildFile (out);
+        if (! file.replaceWithText (json))
+        {
+            std::cerr << "can't write " << file.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+    else
+    {
+        std::cout << json << std::endl;
+    }
+    return Benchmarks::numFailedChecks > 0 ? 1 : 0;
+}
@@ -21,6 +21,9 @@
 template <typename T>
 using UPtr = std::unique_ptr<T>;
 
+template <typename T>
+using SPtr = std::shared_ptr<T>;
+
 // [END_USER_CODE_SECTION]
 
 /*
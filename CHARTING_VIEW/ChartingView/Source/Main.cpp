@@ -8,6 +8,9 @@
 
 #include <JuceHeader.h>
 #include "MainComponent.h"
+#include "core/ChartBatchRenderer.h"
+#include "core/Workspace.h"
+#include <iostream>
 
 //==============================================================================
 class ChartingViewApplication  : public juce::JUCEApplication
@@ -25,14 +28,51 @@ public:
     {
         // This method is where you should put your application's initialisation code..
 
-        mainWindow.reset (new MainWindow (getApplicationName()));
+        // headless : ChartingView --render spec.json [--out dir], see ChartBatchRenderer
+        juce::ArgumentList args (getApplicationName(), getCommandLineParameterArray());
+        if (args.containsOption ("--render"))
+        {
+            const auto spec = args.getFileForOption ("--render");
+            const auto out = args.containsOption ("--out") ? args.getFileForOption ("--out") : juce::File();
+            const auto result = ChartBatchRenderer::render (spec, out);
+            for (const auto& error : result.errors)
+                std::cerr << error << std::endl;
+            std::cout << result.numRendered << " charts rendered" << std::endl;
+            setApplicationReturnValue (result.errors.isEmpty() ? 0 : 1);
+            quit();
+            return;
+        }
+
+        // ctrl + N in any window opens another one, they all share the Workspace
+        Workspace::getInstance().onOpenWindow = [this] { openWindow(); };
+        openWindow();
     }
 
     void shutdown() override
     {
         // Add your application's shutdown code here..
 
-        mainWindow = nullptr; // (deletes our window)
+        Workspace::getInstance().onOpenWindow = nullptr;
+        windows.clear(); // (deletes our windows)
+    }
+
+    void openWindow()
+    {
+        auto* window = windows.add (new MainWindow (getApplicationName()));
+        // cascaded from the first one
+        if (windows.size() > 1)
+            window->setTopLeftPosition (windows.getFirst()->getPosition() + juce::Point<int> (30, 30) * (windows.size() - 1));
+    }
+
+    void closeWindow (juce::DocumentWindow* window)
+    {
+        // not from inside the window's own callback
+        juce::MessageManager::callAsync ([this, window]
+        {
+            windows.removeObject (dynamic_cast<MainWindow*> (window));
+            if (windows.isEmpty())
+                systemRequestedQuit();
+        });
     }
 
     //==============================================================================
@@ -79,10 +119,10 @@ public:
 
         void closeButtonPressed() override
         {
-            // This is called when the user tries to close this window. Here, we'll just
-            // ask the app to quit when this happens, but you can change this to do
-            // whatever you need.
-            JUCEApplication::getInstance()->systemRequestedQuit();
+            // This is called when the user tries to close this window. The app quits
+            // with its last window.
+            if (auto* app = dynamic_cast<ChartingViewApplication*> (JUCEApplication::getInstance()))
+                app->closeWindow (this);
         }
 
         /* Note: Be careful if you override any DocumentWindow methods - the base
@@ -97,7 +137,7 @@ public:
     };
 
 private:
-    std::unique_ptr<MainWindow> mainWindow;
+    juce::OwnedArray<MainWindow> windows;
 };
 
 //==============================================================================
@@ -0,0 +1,334 @@
+/*
+  ==============================================================================
+
+    ChartBatchRenderer.cpp
+    Created: 15 Oct 2026 11:04:18am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "ChartBatchRenderer.h"
+#include "data/IndicatorEngine.h"
+#include "data/KlineResampler.h"
+#include "io/DerivedCache.h"
+#include "io/KlineCsvLoader.h"
+#include "io/KlineFile.h"
+#include "utils/TaskPool.h"
+#include "widgets/ui/WLookAndFeel.h"
+#include "widgets/ui/chart/WChart.h"
+
+namespace {
+	struct Overlay {
+		String type;
+		int period = 20;
+		double deviations = 2.0;
+		Colour colour;
+	};
+
+	struct Marker {
+		WChartShapes::Type type = WChartShapes::Type::dot;
+		int64 time = 0;
+		double price = 0.0;
+		Colour colour;
+	};
+
+	struct Chart {
+		size_t series = 0;   // in the loaded series
+		File out;
+		int width = 640;
+		int height = 360;
+		bool axes = true;
+		bool log = false;
+		int64 start = 0;     // whole series when start >= end
+		int64 end = 0;
+		std::vector<Overlay> overlays;
+		std::vector<Marker> markers;
+	};
+
+	struct Series {
+		File file;
+		int64 timeframe = 0;
+		KlineStore::Ptr store;
+		String error;
+	};
+
+	struct Curve {
+		SPtr<const std::vector<double>> values;
+		WChartCurve::Options options;
+	};
+
+	// offscreen chart painted by one range of the parallelFor at a time
+	struct Renderer {
+		WLookAndFeel lnf;
+		WChart chart;
+		KlineStore::Ptr shown;
+
+		Renderer() {
+			chart.setLookAndFeel(&lnf);
+			chart.setBackgroundRenderingEnabled(false);
+			chart.setOpenGLEnabled(false);
+		}
+		~Renderer() { chart.setLookAndFeel(nullptr); }
+
+		JUCE_DECLARE_NON_COPYABLE(Renderer)
+	};
+}
+
+// "#2196f3", "ff2196f3" or a colour name
+static Colour parseColour(const var& v, Colour fallback) {
+	auto s = v.toString().trim().trimCharactersAtStart("#");
+	if (s.isEmpty())
+		return fallback;
+	if (s.containsOnly("0123456789abcdefABCDEF"))
+		return Colour::fromString(s.length() <= 6 ? "ff" + s : s);
+	return Colours::findColourForName(s, fallback);
+}
+
+static var getValue(const var& chart, const var& spec, const Identifier& name, const var& fallback) {
+	if (chart.hasProperty(name))
+		return chart[name];
+	return spec.getProperty(name, fallback);
+}
+
+static Colour getDefaultColour(size_t overlay) {
+	static const Colour colours[] = { Colour(0xff2196f3), Colour(0xffffb300), Colour(0xffab47bc), Colour(0xff66bb6a) };
+	return colours[overlay % std::size(colours)];
+}
+
+static bool parseMarker(const var& v, Marker& m) {
+	const auto type = v["type"].toString();
+	if (type == "buy" || type.isEmpty())
+		m = { WChartShapes::Type::triangleUp, (int64)v["time"], (double)v["price"], WLookAndFeel::candleUpColour };
+	else if (type == "sell")
+		m = { WChartShapes::Type::triangleDown, (int64)v["time"], (double)v["price"], WLookAndFeel::candleDownColour };
+	else if (type == "dot" || type == "circle")
+		m = { type == "dot" ? WChartShapes::Type::dot : WChartShapes::Type::circle, (int64)v["time"], (double)v["price"], Colours::white };
+	else
+		return false;
+	m.colour = parseColour(v["colour"], m.colour);
+	return true;
+}
+
+static void computeOverlays(const Chart& chart, const KlineStore& store, const File& file, std::vector<Curve>& curves) {
+	IndicatorEngine engine;
+	std::vector<IndicatorEngine::Id> ids;
+	for (const auto& o : chart.overlays) {
+		if (o.type == "sma")
+			ids.push_back(engine.addSma(o.period));
+		else if (o.type == "ema")
+			ids.push_back(engine.addEma(o.period));
+		else
+			ids.push_back(engine.addBollinger(o.period, o.deviations));
+	}
+	// cached next to the file, a sweep rendered again only reads them
+	DerivedCache::updateIndicators(engine, store, file);
+	// the outputs outlive the engine
+	for (size_t i = 0; i < ids.size(); i++) {
+		WChartCurve::Options options;
+		options.colour = chart.overlays[i].colour;
+		auto* indicator = engine.get(ids[i]);
+		for (int output = 0; output < indicator->getNumOutputs(); output++) {
+			// bollinger : dashed middle, plain bands
+			options.style = indicator->getNumOutputs() > 1 && output == BollingerIndicator::middle ? WChartCurve::Style::dashed : WChartCurve::Style::line;
+			curves.push_back({ indicator->getOutput(output), options });
+		}
+	}
+}
+
+ChartBatchRenderer::Result ChartBatchRenderer::render(const File& spec, const File& outDir) {
+	if (!spec.existsAsFile()) {
+		Result result;
+		result.errors.add(spec.getFullPathName() + ": no such file");
+		return result;
+	}
+	var json;
+	const auto parsed = JSON::parse(spec.loadFileAsString(), json);
+	if (parsed.failed()) {
+		Result result;
+		result.errors.add(spec.getFileName() + ": " + parsed.getErrorMessage());
+		return result;
+	}
+	return render(json, spec.getParentDirectory(), outDir);
+}
+
+ChartBatchRenderer::Result ChartBatchRenderer::render(const var& spec, const File& baseDirectory, const File& outDir) {
+	Result result;
+	auto& pool = TaskPool::getInstance();
+
+	// charts and the series they read
+	const auto* charts = spec.isArray() ? spec.getArray() : spec["charts"].getArray();
+	if (charts == nullptr || charts->isEmpty()) {
+		result.errors.add("no charts in the spec");
+		return result;
+	}
+	const File out = outDir != File() ? outDir : baseDirectory.getChildFile(spec.getProperty("outDir", ".").toString());
+	std::vector<Series> series;
+	std::vector<Chart> jobs;
+	for (int i = 0; i < charts->size(); i++) {
+		const auto& c = charts->getReference(i);
+		Chart chart;
+		const auto file = baseDirectory.getChildFile(getValue(c, spec, "file", "").toString());
+		const auto timeframe = KlineResampler::parseInterval(getValue(c, spec, "timeframe", "").toString());
+		auto it = std::find_if(series.begin(), series.end(), [&](const Series& s) { return s.file == file && s.timeframe == timeframe; });
+		chart.series = (size_t)(it - series.begin());
+		if (it == series.end())
+			series.push_back({ file, timeframe });
+
+		chart.out = out.getChildFile(c.getProperty("out", "chart_" + String(i) + ".png").toString());
+		chart.width = jmax(16, (int)getValue(c, spec, "width", chart.width));
+		chart.height = jmax(16, (int)getValue(c, spec, "height", chart.height));
+		chart.axes = (bool)getValue(c, spec, "axes", chart.axes);
+		chart.log = (bool)getValue(c, spec, "log", chart.log);
+		chart.start = (int64)c.getProperty("start", 0);
+		chart.end = (int64)c.getProperty("end", 0);
+		if (const auto* overlays = getValue(c, spec, "overlays", var()).getArray()) {
+			for (const auto& o : *overlays) {
+				Overlay overlay{ o["type"].toString().toLowerCase(), jmax(1, (int)o.getProperty("period", 20)), (double)o.getProperty("deviations", 2.0) };
+				if (overlay.type != "sma" && overlay.type != "ema" && overlay.type != "bollinger") {
+					result.errors.add(chart.out.getFileName() + ": unknown overlay " + overlay.type);
+					continue;
+				}
+				overlay.colour = parseColour(o["colour"], getDefaultColour(chart.overlays.size()));
+				chart.overlays.push_back(overlay);
+			}
+		}
+		if (const auto* markers = c["markers"].getArray()) {
+			for (const auto& m : *markers) {
+				Marker marker;
+				if (parseMarker(m, marker))
+					chart.markers.push_back(marker);
+			}
+		}
+		jobs.push_back(std::move(chart));
+	}
+
+	// each series on its own core, a single one uses them all
+	pool.parallelFor(series.size(), 1, [&](size_t first, size_t last) {
+		for (size_t i = first; i < last; i++) {
+			auto& s = series[i];
+			if (s.file.hasFileExtension(KlineFile::fileExtension)) {
+				s.store = KlineFile::open(s.file, &s.error);
+			}
+			else {
+				KlineCsvLoader::Options options;
+				options.numThreads = series.size() > 1 ? 1 : 0;
+				s.store = KlineCsvLoader::parseFile(s.file, options, &s.error);
+			}
+			if (s.store && s.timeframe > 0) {
+				KlineResampler resampler;
+				resampler.setSource(s.store);
+				s.store = DerivedCache::getTimeframe(resampler, s.timeframe, s.file);
+			}
+			if (s.store == nullptr || s.store->isEmpty()) {
+				s.store = nullptr;
+				s.error = s.file.getFileName() + ": " + (s.error.isEmpty() ? String("no rows") : s.error);
+			}
+		}
+	});
+	for (const auto& s : series)
+		if (s.store == nullptr)
+			result.errors.add(s.error);
+
+	// charts of the same series one after the other : each range of a batch goes to one
+	// chart, which keeps its pyramid
+	std::vector<size_t> order;
+	for (size_t i = 0; i < jobs.size(); i++)
+		if (series[jobs[i].series].store != nullptr)
+			order.push_back(i);
+	std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return jobs[a].series < jobs[b].series; });
+
+	// one chart per range of the parallelFor (at most a range per worker and the calling
+	// thread), created here : Components are built on the message thread, then only painted
+	// offscreen into their own software image, which JUCE allows from any thread
+	const size_t numRenderers = jmin((size_t)pool.getNumThreads() + 1, jmax((size_t)1, order.size()));
+	std::vector<UPtr<Renderer>> renderers;
+	for (size_t i = 0; i < numRenderers; i++)
+		renderers.push_back(std::make_unique<Renderer>());
+	CriticalSection rendererLock;
+	auto acquire = [&]() {
+		const ScopedLock sl(rendererLock);
+		auto r = std::move(renderers.back());
+		renderers.pop_back();
+		return r;
+	};
+	auto release = [&](UPtr<Renderer> r) {
+		const ScopedLock sl(rendererLock);
+		renderers.push_back(std::move(r));
+	};
+
+	CriticalSection errorLock;
+	std::atomic<int> numWritten{ 0 };
+	TaskPool::Group encodes;
+	const size_t batchSize = (size_t)pool.getNumThreads() * 2 + 2;
+	for (size_t batch = 0; batch < order.size(); batch += batchSize) {
+		const size_t n = jmin(batchSize, order.size() - batch);
+		pool.parallelFor(n, 1, [&](size_t first, size_t last) {
+			auto renderer = acquire();
+			auto& chart = renderer->chart;
+			std::vector<Curve> curves;
+			for (size_t i = first; i < last; i++) {
+				const auto& job = jobs[order[batch + i]];
+				const auto& store = series[job.series].store;
+				curves.clear();
+				computeOverlays(job, *store, series[job.series].file, curves);
+				if (store != renderer->shown) {
+					chart.setStore(store);
+					renderer->shown = store;
+				}
+				chart.setXAxisVisible(job.axes);
+				chart.setYAxisVisible(job.axes);
+				chart.setLogScale(job.log);
+				chart.setBounds(0, 0, job.width, job.height);
+				if (job.start < job.end) {
+					chart.showTimeRange(job.start, job.end);
+				}
+				else {
+					const auto* t = store->getOpenTime();
+					const auto rows = store->size();
+					chart.showTimeRange(t[0], t[rows - 1] + (rows > 1 ? t[rows - 1] - t[rows - 2] : 1));
+				}
+				chart.clearCurves();
+				for (const auto& c : curves)
+					chart.addCurve(store, c.values, c.options);
+				auto& shapes = chart.getShapes();
+				shapes.clear();
+				shapes.reserveMarkers(job.markers.size());
+				for (const auto& m : job.markers) {
+					WChartShapes::Options options;
+					options.colour = m.colour;
+					shapes.addMarker(m.type, m.time, m.price, options);
+				}
+
+				Image image(Image::ARGB, job.width, job.height, true, SoftwareImageType());
+				{
+					Graphics g(image);
+					g.fillAll(WLookAndFeel::bgColour);
+					chart.paintEntireComponent(g, true);
+				}
+
+				pool.submit([image, file = job.out, &errorLock, &result, &numWritten]() {
+					file.getParentDirectory().createDirectory();
+					file.deleteFile();
+					FileOutputStream stream(file);
+					PNGImageFormat png;
+					if (stream.openedOk() && png.writeImageToStream(image, stream)) {
+						numWritten++;
+						return;
+					}
+					const ScopedLock sl(errorLock);
+					result.errors.add(file.getFullPathName() + ": can't write");
+				}, TaskPool::Priority::normal, &encodes);
+			}
+			release(std::move(renderer));
+		});
+
+		// the encodes waiting stay under a few frames
+		while (encodes.getNumPending() > (int)batchSize)
+			if (!pool.runPending())
+				Thread::sleep(1);
+	}
+	encodes.wait();
+	result.numRendered = numWritten.load();
+	return result;
+}
@@ -0,0 +1,50 @@
+/*
+  ==============================================================================
+
+    ChartBatchRenderer.h
+    Created: 15 Oct 2026 11:04:18am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+
+/*
+	Headless rendering of chart specs to PNG (ChartingView --render spec.json),
+	e.g. one thumbnail per run of a Strategy/ parameter sweep.
+
+	Spec (JSON, paths relative to the spec file, the top level values are the
+	defaults of every chart) :
+
+	{ "width": 640, "height": 360, "outDir": "thumbs", "axes": true,
+	  "charts": [ {
+		"file": "../Data/klines_INJUSDC_1m_from_2025_09_01.csv",  // csv or .klines
+		"out": "run_042.png",                                      // in outDir
+		"timeframe": "15m", "start": 1756684800000, "end": 1757289600000, "log": false,
+		"overlays": [ { "type": "bollinger", "period": 20, "deviations": 2, "colour": "#2196f3" } ],
+		"markers": [ { "time": 1756690000000, "price": 23.1, "type": "buy" } ] } ] }
+
+	overlays : sma, ema, bollinger. markers : buy, sell, dot, circle, the whole
+	series is in view without start / end.
+
+	Every file x timeframe is loaded once, whatever the number of charts reading
+	it, the loads run in parallel. Then the charts go by batches, each split in
+	ranges over the TaskPool : a range computes the overlays of its charts and
+	paints them with its own offscreen WChart (one per worker, built on the
+	message thread, reused for the next charts) into their own software
+	image, encoded to PNG on the pool while the next batch runs.
+*/
+
+class ChartBatchRenderer {
+public:
+	struct Result {
+		int numRendered = 0;
+		StringArray errors; // one per chart or file that failed
+	};
+
+	// message thread, returns once every PNG is written. outDir replaces the one of the spec
+	static Result render(const File& spec, const File& outDir = {});
+	static Result render(const var& spec, const File& baseDirectory, const File& outDir = {});
+};
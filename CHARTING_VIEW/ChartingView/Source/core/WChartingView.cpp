@@ -11,9 +11,13 @@
 #include "WChartingView.h"
 #include "widgets/ui/WLookAndFeel.h"
 #include "widgets/ui/WColorSurface.h"
+#include "utils/FrameProfiler.h"
+#include "utils/MemoryBudget.h"
+#include "Workspace.h"
 
 WChartingView::WChartingView()
-: _lnf(_initLnf()), _label("Toto") {
+: _lnf(Workspace::getInstance().getLookAndFeel()), _label("Toto") {
+	setLookAndFeel(_lnf.get());
 	// auto* c1 = new WColorSurface(Colours::red.withSaturation(0.8f));
 	// auto* c2 = new WColorSurface(Colours::green.withSaturation(0.8f));
 	// auto* c3 = new WColorSurface(Colours::blue.withSaturation(0.8f));
@@ -21,9 +25,11 @@ WChartingView::WChartingView()
 	// ownAndMakeVisible(c1);
 	// ownAndMakeVisible(c2);
 	// ownAndMakeVisible(c3);
-	addAndMakeVisible(_chart);
+	addAndMakeVisible(_charts);
 	setBorders(20);
-	_chart.getPreferredSize().setFlexibleSize(10000, 10000);
+	_charts.getPreferredSize().setFlexibleSize(10000, 10000);
+	addChildComponent(_profiler);
+	setWantsKeyboardFocus(true);
 }
 
 WChartingView::~WChartingView() {
@@ -31,16 +37,40 @@ WChartingView::~WChartingView() {
 }
 
 void WChartingView::paint(Graphics& g) {
+	// every paint pass of the window starts here and ends in paintOverChildren
+	FrameProfiler::getInstance().beginFrame();
 	g.fillAll(getLookAndFeel().findColour(juce::ResizableWindow::backgroundColourId));
 }
 
+void WChartingView::paintOverChildren(Graphics&) {
+	FrameProfiler::getInstance().endFrame();
+	// between frames : nothing drawn is read anymore, an off screen chart is not drawn
+	MemoryBudget::getInstance().trim();
+}
+
 void WChartingView::resized() {
 	// BaseComponent::resized();
-	_chart.setBounds(getBorders().subtractedFrom(getLocalBounds()));
+	_charts.setBounds(getBorders().subtractedFrom(getLocalBounds()));
+	_profiler.setBounds(getWidth() - WProfilerOverlay::preferredWidth - 8, 8, WProfilerOverlay::preferredWidth, _profiler.getPreferredHeight());
 }
 
-WLookAndFeel* WChartingView::_initLnf() {
-	auto* lnf = new WLookAndFeel();
-	setLookAndFeel(lnf);
-	return lnf;
+bool WChartingView::keyPressed(const KeyPress& key) {
+	if (key == KeyPress('n', ModifierKeys::commandModifier, 0)) {
+		Workspace::getInstance().openWindow();
+		return true;
+	}
+	if (key.getKeyCode() != KeyPress::F12Key)
+		return false;
+	auto& profiler = FrameProfiler::getInstance();
+	if (key.getModifiers().isShiftDown()) {
+		const auto file = File::getSpecialLocation(File::userDesktopDirectory)
+			.getNonexistentChildFile("ChartingView_trace_" + Time::getCurrentTime().formatted("%Y-%m-%d_%H-%M-%S"), ".json");
+		profiler.writeChromeTrace(file);
+		return true;
+	}
+	const bool show = !_profiler.isVisible();
+	profiler.setEnabled(show);
+	_profiler.setVisible(show);
+	_profiler.toFront(false);
+	return true;
 }
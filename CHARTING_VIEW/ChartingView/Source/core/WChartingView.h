@@ -11,7 +11,8 @@
 #pragma once
 #include "widgets/ui/BaseComponent.h"
 #include "widgets/ui/WLabel.h"
-#include "widgets/ui/chart/WChart.h"
+#include "widgets/ui/WProfilerOverlay.h"
+#include "widgets/ui/chart/WChartManager.h"
 
 class WLookAndFeel;
 
@@ -24,14 +25,19 @@ public:
 
 	void paint(Graphics& g) override;
 
+	void paintOverChildren(Graphics& g) override;
+
 	void resized() override;
 
-private:
+	// F12 : profiler overlay, shift + F12 : trace of the last frames on the desktop,
+	// ctrl + N : another window (Workspace)
+	bool keyPressed(const KeyPress& key) override;
 
-	WLookAndFeel* _initLnf();
+private:
 
-	UPtr<WLookAndFeel> _lnf;
+	SPtr<WLookAndFeel> _lnf; // the one of every window
 	WLabel _label;
-	WChart _chart;
+	WChartManager _charts;
+	WProfilerOverlay _profiler;
 };
 
@@ -0,0 +1,93 @@
+/*
+  ==============================================================================
+
+	Workspace.cpp
+	Created: 16 Oct 2026 9:02:37pm
+	Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "Workspace.h"
+#include "io/DerivedCache.h"
+#include "widgets/ui/WLookAndFeel.h"
+
+Workspace& Workspace::getInstance() {
+	static Workspace workspace;
+	return workspace;
+}
+
+SPtr<WLookAndFeel> Workspace::getLookAndFeel() {
+	auto lnf = _lnf.lock();
+	if (!lnf) {
+		lnf = std::make_shared<WLookAndFeel>();
+		_lnf = lnf;
+	}
+	return lnf;
+}
+
+SPtr<KlineResampler> Workspace::findSeries(const File& file) const {
+	const auto it = _series.find(file.getFullPathName());
+	if (it == _series.end())
+		return nullptr;
+	const auto& s = it->second;
+	if (s.fileSize != file.getSize() || s.modTime != file.getLastModificationTime().toMilliseconds())
+		return nullptr;
+	return s.resampler.lock();
+}
+
+void Workspace::addSeries(const File& file, SPtr<KlineResampler> resampler) {
+	_prune();
+	if (!resampler || !file.existsAsFile())
+		return;
+	Series s;
+	s.fileSize = file.getSize();
+	s.modTime = file.getLastModificationTime().toMilliseconds();
+	s.resampler = resampler;
+	_series[file.getFullPathName()] = std::move(s);
+}
+
+SPtr<LodPyramid> Workspace::getPyramid(const KlineStore::Ptr& store, const File& cacheSource) {
+	if (!store)
+		return std::make_shared<LodPyramid>();
+	auto& entry = _pyramids[store.get()];
+	auto lod = entry.lock();
+	if (lod && lod->getNumRows() == store->size())
+		return lod;
+	_prune();
+	lod = std::make_shared<LodPyramid>();
+	DerivedCache::buildLod(*lod, *store, cacheSource);
+	_pyramids[store.get()] = lod;
+	return lod;
+}
+
+void* Workspace::getNativeSharedContext() const {
+	const ScopedLock l(_glLock);
+	for (auto* context : _glContexts)
+		if (auto* native = context->getRawContext())
+			return native;
+	return nullptr;
+}
+
+void Workspace::addGLContext(OpenGLContext* context) {
+	const ScopedLock l(_glLock);
+	_glContexts.addIfNotAlreadyThere(context);
+}
+
+void Workspace::removeGLContext(OpenGLContext* context) {
+	const ScopedLock l(_glLock);
+	_glContexts.removeAllInstancesOf(context);
+}
+
+void Workspace::openWindow() {
+	if (onOpenWindow)
+		onOpenWindow();
+}
+
+void Workspace::_prune() {
+	// entries of the series no window uses anymore
+	for (auto it = _series.begin(); it != _series.end();)
+		it = it->second.resampler.expired() ? _series.erase(it) : std::next(it);
+	for (auto it = _pyramids.begin(); it != _pyramids.end();)
+		it = it->second.expired() ? _pyramids.erase(it) : std::next(it);
+}
@@ -0,0 +1,87 @@
+/*
+  ==============================================================================
+
+	Workspace.h
+	Created: 16 Oct 2026 9:02:37pm
+	Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+#include "data/KlineResampler.h"
+#include "data/LodPyramid.h"
+
+class WLookAndFeel;
+
+/*
+	What the windows of the app share, so a second window on the same series
+	costs almost nothing : no parsing, no aggregation, no pyramid built again.
+
+		look and feel  one for every window
+		series         the resampler of a loaded file (its store and the
+		               timeframes aggregated from it), WChart adopts it instead
+		               of loading the file again
+		pyramids       the LodPyramid of a file series, built by the first
+		               viewport drawing it
+		GL contexts    every WChartGLRenderer context is created in the share
+		               group of the first live one (shaders, buffers and
+		               textures can be used by all)
+
+	Everything is held weakly : an entry lives as long as a window uses it, the
+	last window closing a series frees it. The TaskPool, MemoryBudget and
+	TextCache singletons are process wide already, so are the tile caches'
+	budget.
+
+	A file series is shared once completely loaded and keyed by its size and
+	mtime : a file that changed since is loaded again (and replaces the entry).
+
+		WChart::loadFile(file)  // a file already open in another window is adopted
+
+	Message thread, but the GL contexts (added and removed on their GL thread).
+*/
+
+class Workspace {
+public:
+	static Workspace& getInstance();
+
+	SPtr<WLookAndFeel> getLookAndFeel();
+
+	// the series of an unchanged file loaded by a window, null when none
+	SPtr<KlineResampler> findSeries(const File& file) const;
+	// resampler's source is the whole content of file
+	void addSeries(const File& file, SPtr<KlineResampler> resampler);
+
+	// the pyramid of store shared by the viewports drawing it, built (from the
+	// DerivedCache of cacheSource) by the first one. store must not change anymore
+	SPtr<LodPyramid> getPyramid(const KlineStore::Ptr& store, const File& cacheSource);
+
+	// native handle of a live GL context to share with, null when none
+	void* getNativeSharedContext() const;
+	void addGLContext(OpenGLContext* context);
+	void removeGLContext(OpenGLContext* context);
+
+	// another window, see openWindow()
+	std::function<void()> onOpenWindow;
+	void openWindow();
+
+private:
+	Workspace() = default;
+
+	struct Series {
+		int64 fileSize = 0;
+		int64 modTime = 0;
+		std::weak_ptr<KlineResampler> resampler;
+	};
+
+	void _prune();
+
+	std::weak_ptr<WLookAndFeel> _lnf;
+	std::map<String, Series> _series;
+	std::map<const KlineStore*, std::weak_ptr<LodPyramid>> _pyramids;
+	CriticalSection _glLock;
+	Array<OpenGLContext*> _glContexts;
+
+	JUCE_DECLARE_NON_COPYABLE(Workspace)
+};
@@ -0,0 +1,453 @@
+/*
+  ==============================================================================
+
+    CompressedKlineStore.cpp
+    Created: 15 Oct 2026 10:12:47pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "CompressedKlineStore.h"
+#include "../utils/TaskPool.h"
+#include <bit>
+
+enum class Codec { deltaOfDelta, varint, floating };
+
+static Codec getCodec(KlineStore::Column c) {
+	if (c == KlineStore::openTime || c == KlineStore::closeTime)
+		return Codec::deltaOfDelta;
+	if (c == KlineStore::trades)
+		return Codec::varint;
+	return Codec::floating;
+}
+
+// msb first
+struct BitWriter {
+	std::vector<uint8>& out;
+	uint64 acc = 0;
+	int numBits = 0;
+
+	void write(uint64 value, int bits) {
+		if (bits > 32) {
+			write(value >> 32, bits - 32);
+			write(value & 0xffffffff, 32);
+			return;
+		}
+		acc = (acc << bits) | (value & ((1ull << bits) - 1));
+		numBits += bits;
+		while (numBits >= 8) {
+			numBits -= 8;
+			out.push_back((uint8)(acc >> numBits));
+		}
+		acc &= (1ull << numBits) - 1;
+	}
+	void flush() {
+		if (numBits > 0)
+			out.push_back((uint8)(acc << (8 - numBits)));
+		acc = 0;
+		numBits = 0;
+	}
+};
+
+struct BitReader {
+	const uint8* p;
+	const uint8* end;
+	uint64 acc = 0;
+	int numBits = 0;
+
+	uint64 read(int bits) {
+		if (bits > 32) {
+			const uint64 hi = read(bits - 32);
+			return (hi << 32) | read(32);
+		}
+		while (numBits < bits) {
+			acc = (acc << 8) | (p < end ? *p++ : 0);
+			numBits += 8;
+		}
+		numBits -= bits;
+		const uint64 v = (acc >> numBits) & ((1ull << bits) - 1);
+		acc &= (1ull << numBits) - 1;
+		return v;
+	}
+	bool readBit() { return read(1) != 0; }
+};
+
+static uint64 zigzag(int64 v) { return ((uint64)v << 1) ^ (uint64)(v >> 63); }
+static int64 unzigzag(uint64 v) { return (int64)(v >> 1) ^ -(int64)(v & 1); }
+
+// first value raw, then the change of the delta : 0 -> '0', else a prefix picks the width
+static void encodeDeltaOfDelta(const int64* values, size_t n, std::vector<uint8>& out) {
+	BitWriter w{ out };
+	w.write((uint64)values[0], 64);
+	int64 delta = 0;
+	for (size_t i = 1; i < n; i++) {
+		const int64 d = values[i] - values[i - 1];
+		const uint64 z = zigzag(d - delta);
+		delta = d;
+		if (z == 0)
+			w.write(0, 1);
+		else if (z < (1 << 7))
+			w.write((0b10ull << 7) | z, 9);
+		else if (z < (1 << 9))
+			w.write((0b110ull << 9) | z, 12);
+		else if (z < (1 << 12))
+			w.write((0b1110ull << 12) | z, 16);
+		else {
+			w.write(0b1111, 4);
+			w.write(z, 64);
+		}
+	}
+	w.flush();
+}
+
+static void decodeDeltaOfDelta(const uint8* p, const uint8* end, int64* values, size_t n) {
+	BitReader r{ p, end };
+	values[0] = (int64)r.read(64);
+	int64 delta = 0;
+	for (size_t i = 1; i < n; i++) {
+		if (r.readBit()) {
+			int bits = 7;
+			if (r.readBit()) {
+				bits = 9;
+				if (r.readBit())
+					bits = r.readBit() ? 64 : 12;
+			}
+			delta += unzigzag(r.read(bits));
+		}
+		values[i] = values[i - 1] + delta;
+	}
+}
+
+static void encodeVarint(const int64* values, size_t n, std::vector<uint8>& out) {
+	for (size_t i = 0; i < n; i++) {
+		uint64 v = zigzag(values[i]);
+		while (v >= 0x80) {
+			out.push_back((uint8)(v | 0x80));
+			v >>= 7;
+		}
+		out.push_back((uint8)v);
+	}
+}
+
+// returns the end of the values read
+static const uint8* decodeVarint(const uint8* p, const uint8* end, int64* values, size_t n) {
+	for (size_t i = 0; i < n; i++) {
+		uint64 v = 0;
+		for (int shift = 0; p < end; shift += 7) {
+			const uint8 b = *p++;
+			v |= (uint64)(b & 0x7f) << shift;
+			if (b < 0x80)
+				break;
+		}
+		values[i] = unzigzag(v);
+	}
+	return p;
+}
+
+// first value raw, then value ^ previous : 0 -> '0', inside the previous meaningful bits -> '10' + them,
+// else '11' + leading zeros (6 bits) + meaningful length - 1 (6 bits) + the meaningful bits
+static void encodeXor(const double* values, size_t n, std::vector<uint8>& out) {
+	BitWriter w{ out };
+	uint64 prev = std::bit_cast<uint64>(values[0]);
+	w.write(prev, 64);
+	int leading = -1, trailing = 0;
+	for (size_t i = 1; i < n; i++) {
+		const uint64 v = std::bit_cast<uint64>(values[i]);
+		const uint64 x = v ^ prev;
+		prev = v;
+		if (x == 0) {
+			w.write(0, 1);
+			continue;
+		}
+		const int lz = std::countl_zero(x);
+		const int tz = std::countr_zero(x);
+		if (leading >= 0 && lz >= leading && tz >= trailing) {
+			w.write(0b10, 2);
+			w.write(x >> trailing, 64 - leading - trailing);
+			continue;
+		}
+		leading = lz;
+		trailing = tz;
+		const int meaningful = 64 - lz - tz;
+		w.write(0b11, 2);
+		w.write((uint64)lz, 6);
+		w.write((uint64)(meaningful - 1), 6);
+		w.write(x >> tz, meaningful);
+	}
+	w.flush();
+}
+
+static void decodeXor(const uint8* p, const uint8* end, double* values, size_t n) {
+	BitReader r{ p, end };
+	uint64 prev = r.read(64);
+	values[0] = std::bit_cast<double>(prev);
+	int leading = 0, trailing = 0;
+	for (size_t i = 1; i < n; i++) {
+		if (r.readBit()) {
+			if (r.readBit()) {
+				leading = (int)r.read(6);
+				trailing = 64 - leading - ((int)r.read(6) + 1);
+			}
+			prev ^= r.read(64 - leading - trailing) << trailing;
+		}
+		values[i] = std::bit_cast<double>(prev);
+	}
+}
+
+// prices and quantities parsed from decimal text : value * 10^digits is an integer that gives the
+// exact same double back, below 2^53. -1 when no digits up to maxDecimalDigits do for every value
+static constexpr int maxDecimalDigits = 8;
+static const double powersOf10[maxDecimalDigits + 1] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8 };
+
+static bool isExactDecimal(double v, int digits) {
+	const double m = std::round(v * powersOf10[digits]);
+	return std::abs(m) < 9007199254740992.0 && std::bit_cast<uint64>(m / powersOf10[digits]) == std::bit_cast<uint64>(v);
+}
+
+static int findDecimalDigits(const double* values, size_t n) {
+	int digits = 0;
+	for (size_t i = 0; i < n; i++) {
+		while (!isExactDecimal(values[i], digits))
+			if (++digits > maxDecimalDigits)
+				return -1;
+	}
+	// the values before the last raise were only checked with fewer digits, a large one
+	// exact as an integer may not fit 2^53 once scaled (quote volumes)
+	for (size_t i = 0; i < n; i++)
+		if (!isExactDecimal(values[i], digits))
+			return -1;
+	return digits;
+}
+
+// one byte of digits, then the deltas of the integers as varints (a random walk of small steps),
+// or 0xff then the XOR encoding
+static void encodeFloat(const double* values, size_t n, std::vector<uint8>& out) {
+	const int digits = findDecimalDigits(values, n);
+	if (digits < 0) {
+		out.push_back(0xff);
+		encodeXor(values, n, out);
+		return;
+	}
+	out.push_back((uint8)digits);
+	int64 prev = 0;
+	for (size_t i = 0; i < n; i++) {
+		const int64 m = (int64)std::round(values[i] * powersOf10[digits]);
+		const int64 delta = m - prev;
+		encodeVarint(&delta, 1, out);
+		prev = m;
+	}
+}
+
+static void decodeFloat(const uint8* p, const uint8* end, double* values, size_t n) {
+	const uint8 digits = *p++;
+	if (digits == 0xff) {
+		decodeXor(p, end, values, n);
+		return;
+	}
+	const double scale = powersOf10[digits];
+	int64 m = 0;
+	for (size_t i = 0; i < n; i++) {
+		int64 delta;
+		p = decodeVarint(p, end, &delta, 1);
+		m += delta;
+		values[i] = (double)m / scale;
+	}
+}
+
+CompressedKlineStore::Ptr CompressedKlineStore::compress(const KlineStore& store, size_t blockRows) {
+	Ptr r(new CompressedKlineStore());
+	r->_numRows = store.size();
+	r->_blockRows = jmax((size_t)1, blockRows);
+	r->_symbol = store.getSymbol();
+	r->_interval = store.getInterval();
+	r->_lastOpenTime = store.getLastOpenTime();
+	const size_t numBlocks = (r->_numRows + r->_blockRows - 1) / r->_blockRows;
+	for (size_t b = 0; b < numBlocks; b++)
+		r->_firstTimes.push_back(store.getOpenTime()[b * r->_blockRows]);
+
+	// one task per column, its blocks one after the other in a single stream
+	TaskPool::getInstance().parallelFor(KlineStore::numColumns, 1, [&](size_t first, size_t last) {
+		for (size_t c = first; c < last; c++) {
+			const auto column = (KlineStore::Column)c;
+			auto& data = r->_columns[c];
+			data.bytes.reserve(r->_numRows * 2);
+			data.offsets.resize(numBlocks + 1);
+			for (size_t b = 0; b < numBlocks; b++) {
+				data.offsets[b] = data.bytes.size();
+				const size_t row = b * r->_blockRows;
+				const size_t n = r->_getNumRows(b);
+				switch (getCodec(column)) {
+					case Codec::deltaOfDelta: encodeDeltaOfDelta(store.getIntColumn(column) + row, n, data.bytes); break;
+					case Codec::varint: encodeVarint(store.getIntColumn(column) + row, n, data.bytes); break;
+					case Codec::floating: encodeFloat(store.getDoubleColumn(column) + row, n, data.bytes); break;
+				}
+			}
+			data.offsets[numBlocks] = data.bytes.size();
+			data.bytes.shrink_to_fit();
+		}
+	});
+	r->_accountedBytes = r->getCompressedBytes();
+	MemoryBudget::getInstance().add(MemoryBudget::stores, (int64)r->_accountedBytes);
+	return r;
+}
+
+CompressedKlineStore::CompressedKlineStore() {
+	MemoryBudget::getInstance().addClient(MemoryBudget::decodedBlocks, this);
+}
+
+CompressedKlineStore::~CompressedKlineStore() {
+	MemoryBudget::getInstance().removeClient(this);
+	MemoryBudget::getInstance().add(MemoryBudget::stores, -(int64)_accountedBytes);
+}
+
+size_t CompressedKlineStore::releaseMemory(size_t bytes) {
+	const ScopedLock sl(_cacheLock);
+	size_t freed = 0, n = 0;
+	// a block still used elsewhere is only forgotten by the cache, its bytes go with its last user
+	while (n < _cache.size() && freed < bytes) {
+		if (_cache[n].rows.use_count() == 1)
+			freed += _cache[n].rows->size() * KlineStore::elementSize * KlineStore::numColumns;
+		n++;
+	}
+	_cache.erase(_cache.begin(), _cache.begin() + (ptrdiff_t)n);
+	return freed;
+}
+
+size_t CompressedKlineStore::getCompressedBytes() const {
+	size_t bytes = 0;
+	for (const auto& c : _columns)
+		bytes += c.bytes.size() + c.offsets.size() * sizeof(size_t);
+	return bytes + _firstTimes.size() * sizeof(int64);
+}
+
+size_t CompressedKlineStore::_getNumRows(size_t block) const {
+	return jmin(_blockRows, _numRows - block * _blockRows);
+}
+
+void CompressedKlineStore::_decodeBlock(size_t block, KlineStore& out, size_t firstRow) const {
+	const size_t n = _getNumRows(block);
+	for (int c = 0; c < KlineStore::numColumns; c++) {
+		const auto column = (KlineStore::Column)c;
+		const auto& data = _columns[c];
+		const uint8* p = data.bytes.data() + data.offsets[block];
+		const uint8* end = data.bytes.data() + data.offsets[block + 1];
+		switch (getCodec(column)) {
+			case Codec::deltaOfDelta: decodeDeltaOfDelta(p, end, out.getWritableIntColumn(column) + firstRow, n); break;
+			case Codec::varint: decodeVarint(p, end, out.getWritableIntColumn(column) + firstRow, n); break;
+			case Codec::floating: decodeFloat(p, end, out.getWritableDoubleColumn(column) + firstRow, n); break;
+		}
+	}
+}
+
+KlineStore::Ptr CompressedKlineStore::getBlock(size_t block) const {
+	if (block >= getNumBlocks())
+		return nullptr;
+	{
+		const ScopedLock sl(_cacheLock);
+		for (size_t i = _cache.size(); i-- > 0;) {
+			if (_cache[i].block == block) {
+				auto hit = std::move(_cache[i]);
+				_cache.erase(_cache.begin() + (ptrdiff_t)i);
+				_cache.push_back(std::move(hit));
+				return _cache.back().rows;
+			}
+		}
+	}
+	// decoded outside the lock, another thread may insert the same block meanwhile (it is only dropped sooner)
+	auto rows = KlineStore::allocate(_getNumRows(block), MemoryBudget::decodedBlocks);
+	_decodeBlock(block, *rows, 0);
+	rows->setSymbol(_symbol);
+	rows->setInterval(_interval);
+	const ScopedLock sl(_cacheLock);
+	_cache.push_back({ block, rows });
+	if ((int)_cache.size() > _cacheSize)
+		_cache.erase(_cache.begin(), _cache.begin() + (ptrdiff_t)(_cache.size() - (size_t)_cacheSize));
+	return rows;
+}
+
+KlineStore::Ptr CompressedKlineStore::getRows(size_t first, size_t last) const {
+	last = jmin(last, _numRows);
+	first = jmin(first, last);
+	const size_t n = last - first;
+	const size_t firstBlock = first / _blockRows;
+	if (n > 0 && (last - 1) / _blockRows == firstBlock) {
+		// a view into the cached block, which it keeps alive
+		auto block = getBlock(firstBlock);
+		const size_t offset = first - firstBlock * _blockRows;
+		const void* columns[KlineStore::numColumns];
+		for (int c = 0; c < KlineStore::numColumns; c++)
+			columns[c] = static_cast<const char*>(block->getColumnData((KlineStore::Column)c)) + offset * KlineStore::elementSize;
+		auto rows = KlineStore::wrapExternal(block, columns, n);
+		rows->setSymbol(_symbol);
+		rows->setInterval(_interval);
+		return rows;
+	}
+	auto rows = KlineStore::allocate(n);
+	for (size_t b = firstBlock; n > 0 && b * _blockRows < last; b++) {
+		const auto block = getBlock(b);
+		const size_t blockFirst = b * _blockRows;
+		const size_t from = jmax(first, blockFirst);
+		const size_t to = jmin(last, blockFirst + block->size());
+		for (int c = 0; c < KlineStore::numColumns; c++) {
+			const auto column = (KlineStore::Column)c;
+			std::memcpy(static_cast<char*>(rows->getWritableColumnData(column)) + (from - first) * KlineStore::elementSize,
+						static_cast<const char*>(block->getColumnData(column)) + (from - blockFirst) * KlineStore::elementSize,
+						(to - from) * KlineStore::elementSize);
+		}
+	}
+	rows->setSymbol(_symbol);
+	rows->setInterval(_interval);
+	return rows;
+}
+
+KlineStore::Ptr CompressedKlineStore::decompress() const {
+	auto rows = KlineStore::allocate(_numRows);
+	TaskPool::getInstance().parallelFor(getNumBlocks(), 16, [&](size_t first, size_t last) {
+		for (size_t b = first; b < last; b++)
+			_decodeBlock(b, *rows, b * _blockRows);
+	});
+	rows->setSymbol(_symbol);
+	rows->setInterval(_interval);
+	return rows;
+}
+
+void CompressedKlineStore::setCacheSize(int numBlocks) {
+	const ScopedLock sl(_cacheLock);
+	_cacheSize = jmax(1, numBlocks);
+	if ((int)_cache.size() > _cacheSize)
+		_cache.erase(_cache.begin(), _cache.begin() + (ptrdiff_t)(_cache.size() - (size_t)_cacheSize));
+}
+
+int CompressedKlineStore::getCacheSize() const {
+	const ScopedLock sl(_cacheLock);
+	return _cacheSize;
+}
+
+size_t CompressedKlineStore::_search(int64 time, bool upper) const {
+	// the block before the first one starting past time holds the answer, or it is that block's first row
+	const auto it = upper ? std::upper_bound(_firstTimes.begin(), _firstTimes.end(), time)
+						  : std::lower_bound(_firstTimes.begin(), _firstTimes.end(), time);
+	const size_t next = (size_t)(it - _firstTimes.begin());
+	if (next == 0)
+		return 0;
+	const auto block = getBlock(next - 1);
+	const int64* times = block->getOpenTime();
+	const uint64 row = TimeSearch::search([times](uint64 r) { return times[r]; }, 0, block->size(), time, upper);
+	return (next - 1) * _blockRows + (size_t)row;
+}
+
+size_t CompressedKlineStore::lowerBound(int64 time) const {
+	return _search(time, false);
+}
+
+size_t CompressedKlineStore::upperBound(int64 time) const {
+	return _search(time, true);
+}
+
+SeriesRange CompressedKlineStore::findRange(int64 startTime, int64 endTime) const {
+	SeriesRange r;
+	r.first = _search(startTime, false);
+	r.last = jmax(r.first, (uint64)_search(endTime, true));
+	return r;
+}
@@ -0,0 +1,118 @@
+/*
+  ==============================================================================
+
+    CompressedKlineStore.h
+    Created: 15 Oct 2026 10:12:47pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+#include "KlineStore.h"
+
+/*
+	Read-only KlineStore kept compressed in memory, to hold the history of a
+	whole universe of symbols where the raw columns would not fit.
+
+	Rows are cut in blocks of blockRows, each column of a block is encoded on
+	its own (a block decodes without its neighbours) :
+		open_time, close_time    delta of delta (Gorilla) : a constant stride is 1 bit per row
+		number_of_trades         varint
+		prices and volumes       decimals (the exchange sends text) : value * 10^digits as
+		                         varint deltas, the fewest digits giving every double back;
+		                         else XOR with the previous value (Gorilla) : equal values
+		                         are 1 bit, close ones only store their meaningful bits
+	Decoding is lossless. A 1m series with 2 decimal prices takes 3 to 4 times
+	less memory than the raw columns.
+
+	Blocks are decoded on demand into a small LRU of KlineStores, the blocks of
+	the visible range stay hot so reading them again costs a lookup :
+
+		auto packed = CompressedKlineStore::compress(*store);
+		auto rows = packed->getRows(first, last);  // zero copy inside one block
+
+	The chart of the current symbol takes decompress() once (on the pool), its
+	pan and zoom then read plain columns as before.
+
+	The encoded columns count in MemoryBudget::stores, the decoded blocks in
+	MemoryBudget::decodedBlocks : a trim drops the least recently used blocks
+	(the rows handed out stay valid, they keep their block alive).
+
+	Every method can be called from any thread.
+*/
+
+class CompressedKlineStore : private MemoryBudget::Client {
+public:
+	using Ptr = SPtr<CompressedKlineStore>;
+
+	static constexpr size_t defaultBlockRows = 4096;
+	static constexpr int defaultCacheBlocks = 64;
+
+	static Ptr compress(const KlineStore& store, size_t blockRows = defaultBlockRows);
+
+	~CompressedKlineStore() override;
+
+	size_t size() const { return _numRows; }
+	bool isEmpty() const { return _numRows == 0; }
+	size_t getBlockRows() const { return _blockRows; }
+	size_t getNumBlocks() const { return _firstTimes.size(); }
+	// encoded bytes of every column, against size() * numColumns * elementSize raw
+	size_t getCompressedBytes() const;
+
+	const String& getSymbol() const { return _symbol; }
+	const String& getInterval() const { return _interval; }
+
+	int64 getFirstOpenTime() const { return _firstTimes.empty() ? 0 : _firstTimes.front(); }
+	int64 getLastOpenTime() const { return _lastOpenTime; }
+	// first row with open_time >= time / > time, decodes at most one block
+	size_t lowerBound(int64 time) const;
+	size_t upperBound(int64 time) const;
+	// rows whose open_time is in [startTime, endTime]
+	SeriesRange findRange(int64 startTime, int64 endTime) const;
+
+	// the rows of one block, through the cache
+	KlineStore::Ptr getBlock(size_t block) const;
+	// rows [first, last) : a view of the cached block when they fit in one, else a copy
+	KlineStore::Ptr getRows(size_t first, size_t last) const;
+	// every row at once, the blocks decoded in parallel (not cached)
+	KlineStore::Ptr decompress() const;
+
+	// most recently used blocks kept decoded
+	void setCacheSize(int numBlocks);
+	int getCacheSize() const;
+
+private:
+	struct ColumnData {
+		std::vector<uint8> bytes;
+		std::vector<size_t> offsets; // block b is bytes [offsets[b], offsets[b + 1])
+	};
+
+	struct CachedBlock {
+		size_t block = 0;
+		KlineStore::Ptr rows;
+	};
+
+	CompressedKlineStore();
+	size_t releaseMemory(size_t bytes) override;
+	size_t _getNumRows(size_t block) const;
+	void _decodeBlock(size_t block, KlineStore& out, size_t firstRow) const;
+	size_t _search(int64 time, bool upper) const;
+
+	size_t _numRows = 0;
+	size_t _blockRows = defaultBlockRows;
+	ColumnData _columns[KlineStore::numColumns];
+	std::vector<int64> _firstTimes; // open_time of the first row of each block
+	int64 _lastOpenTime = 0;
+	String _symbol;
+	String _interval;
+	size_t _accountedBytes = 0; // getCompressedBytes() once compressed
+
+	// most recent last
+	mutable CriticalSection _cacheLock;
+	mutable std::vector<CachedBlock> _cache;
+	int _cacheSize = defaultCacheBlocks;
+
+	JUCE_DECLARE_NON_COPYABLE(CompressedKlineStore)
+};
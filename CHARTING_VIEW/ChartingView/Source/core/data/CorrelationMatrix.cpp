@@ -0,0 +1,109 @@
+/*
+  ==============================================================================
+
+    CorrelationMatrix.cpp
+    Created: 16 Oct 2026 10:14:52pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "CorrelationMatrix.h"
+#include "../utils/Simd.h"
+
+CorrelationMatrix::CorrelationMatrix(int numSymbols, int window)
+	: _n(jmax(0, numSymbols)), _window(jmax(2, window)) {
+	const size_t n = (size_t)_n;
+	_ring.assign((size_t)_window * n, 0.0);
+	_valid.assign((size_t)_window * n, 0.0);
+	for (auto* v : { &_leaving, &_leavingValid, &_squares, &_leavingSquares, &_zeros, &_sum })
+		v->assign(n, 0.0);
+	for (auto* m : { &_sumXY, &_numCommon, &_sumOver, &_sumSqOver })
+		m->assign(n * n, 0.0);
+}
+
+void CorrelationMatrix::clear() {
+	_numPushed = 0;
+	for (auto* v : { &_ring, &_valid, &_sum, &_sumXY, &_numCommon, &_sumOver, &_sumSqOver })
+		std::fill(v->begin(), v->end(), 0.0);
+}
+
+void CorrelationMatrix::push(const double* returns) {
+	const size_t n = (size_t)_n;
+	const size_t slot = (size_t)(_numPushed % (uint64)_window) * n;
+	double* x = _ring.data() + slot;
+	double* v = _valid.data() + slot;
+	// the slot of the new bar holds the bar leaving the window (zeros while it fills)
+	std::copy(x, x + n, _leaving.begin());
+	std::copy(v, v + n, _leavingValid.begin());
+	for (size_t i = 0; i < n; i++) {
+		const bool missing = std::isnan(returns[i]);
+		x[i] = missing ? 0.0 : returns[i];
+		v[i] = missing ? 0.0 : 1.0;
+		_squares[i] = x[i] * x[i];
+		_leavingSquares[i] = _leaving[i] * _leaving[i];
+	}
+	_numPushed++;
+
+	if (_numPushed % (uint64)_window == 0) {
+		_resync();
+		return;
+	}
+	_add(x, v, _squares.data(), _leaving.data(), _leavingValid.data(), _leavingSquares.data());
+}
+
+void CorrelationMatrix::_add(const double* x, const double* v, const double* sq, const double* o, const double* ov, const double* osq) {
+	const size_t n = (size_t)_n;
+	for (size_t i = 0; i < n; i++) {
+		_sum[i] += x[i] - o[i];
+		Simd::addProductDifference(_sumXY.data() + i * n + i, x[i], x + i, o[i], o + i, n - i);
+		Simd::addProductDifference(_numCommon.data() + i * n + i, v[i], v + i, ov[i], ov + i, n - i);
+		Simd::addProductDifference(_sumOver.data() + i * n, x[i], v, o[i], ov, n);
+		Simd::addProductDifference(_sumSqOver.data() + i * n, sq[i], v, osq[i], ov, n);
+	}
+}
+
+void CorrelationMatrix::_resync() {
+	const size_t n = (size_t)_n;
+	for (auto* m : { &_sum, &_sumXY, &_numCommon, &_sumOver, &_sumSqOver })
+		std::fill(m->begin(), m->end(), 0.0);
+	const double* z = _zeros.data();
+	for (int k = 0; k < _window; k++) {
+		const double* x = _ring.data() + (size_t)k * n;
+		for (size_t i = 0; i < n; i++)
+			_squares[i] = x[i] * x[i];
+		_add(x, _valid.data() + (size_t)k * n, _squares.data(), z, z, z);
+	}
+}
+
+double CorrelationMatrix::getCorrelation(int a, int b) const {
+	const double m = _getPair(_numCommon, a, b);
+	if (m < 2.0)
+		return std::numeric_limits<double>::quiet_NaN();
+	const size_t n = (size_t)_n;
+	const size_t ab = (size_t)a * n + (size_t)b, ba = (size_t)b * n + (size_t)a;
+	const double sa = _sumOver[ab], sb = _sumOver[ba];
+	const double va = m * _sumSqOver[ab] - sa * sa;
+	const double vb = m * _sumSqOver[ba] - sb * sb;
+	// a flat symbol (or the drift of one) has no correlation
+	if (va <= 1e-18 || vb <= 1e-18)
+		return std::numeric_limits<double>::quiet_NaN();
+	return jlimit(-1.0, 1.0, (m * _getPair(_sumXY, a, b) - sa * sb) / std::sqrt(va * vb));
+}
+
+double CorrelationMatrix::getWindowReturn(int a) const {
+	return std::expm1(_sum[(size_t)a]);
+}
+
+void CorrelationMatrix::getMatrix(std::vector<float>& out) const {
+	const int n = _n;
+	out.resize((size_t)n * (size_t)n);
+	for (int a = 0; a < n; a++) {
+		out[(size_t)a * (size_t)n + (size_t)a] = 1.0f;
+		for (int b = a + 1; b < n; b++) {
+			const float c = (float)getCorrelation(a, b);
+			out[(size_t)a * (size_t)n + (size_t)b] = c;
+			out[(size_t)b * (size_t)n + (size_t)a] = c;
+		}
+	}
+}
@@ -0,0 +1,81 @@
+/*
+  ==============================================================================
+
+    CorrelationMatrix.h
+    Created: 16 Oct 2026 10:14:52pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+
+/*
+	Rolling Pearson correlation of the returns of N symbols over the last
+	window bars, updated per bar instead of computed again over the window.
+
+	A pair is correlated over the bars both symbols have : a symbol without a
+	bar (illiquid, listed during the window) has a NaN return, which is left
+	out of its pairs rather than counted as no move. Per pair the bars in
+	common and the sum of x * y, per ordered pair (i, j) the sums of x[i] and
+	x[i]^2 over the bars j has, over the bars in the window. A new bar adds
+	its returns and removes the ones of the bar leaving the window (kept in a
+	ring of window x N, a missing return as 0 with a 0 in a ring of masks) :
+		sumXY[i][j] += x[i] * x[j] - old[i] * old[j]
+	O(3 N^2) per bar (the pair sums on the upper triangle, the ordered ones
+	on every row, each row in SIMD over j), about 270k products for 300
+	symbols. The sums drift with the adds and removes, they are computed
+	again from the ring every window bars (O(N^2) per bar amortized).
+
+		CorrelationMatrix m(symbols.size(), 100);
+		m.push(returns.data());          // per closed bar, log returns of every symbol
+		m.getCorrelation(a, b);
+
+	Not thread safe, WCorrelationView updates it on the TaskPool.
+*/
+
+class CorrelationMatrix {
+public:
+	CorrelationMatrix(int numSymbols, int window);
+
+	int getNumSymbols() const { return _n; }
+	int getWindow() const { return _window; }
+	// bars in the window
+	int getNumBars() const { return (int)jmin((uint64)_window, _numPushed); }
+	uint64 getNumPushed() const { return _numPushed; }
+
+	// one bar, returns[i] of symbol i
+	void push(const double* returns);
+	void clear();
+
+	// bars of the window both a and b have
+	int getNumBars(int a, int b) const { return (int)_getPair(_numCommon, a, b); }
+	// over the bars both have, NaN under 2 of them or for a flat symbol
+	double getCorrelation(int a, int b) const;
+	// compounded return of the window, exp(sum of the log returns) - 1, its bars only
+	double getWindowReturn(int a) const;
+	// every correlation, row-major N x N (the diagonal is 1)
+	void getMatrix(std::vector<float>& out) const;
+
+private:
+	// upper triangle of a symmetric N x N
+	double _getPair(const std::vector<double>& m, int a, int b) const { return a <= b ? m[(size_t)a * (size_t)_n + (size_t)b] : m[(size_t)b * (size_t)_n + (size_t)a]; }
+	// the new bar x, v (mask), sq (x^2) in, the leaving one o, ov, osq out of every sum
+	void _add(const double* x, const double* v, const double* sq, const double* o, const double* ov, const double* osq);
+	void _resync();
+
+	int _n = 0;
+	int _window = 0;
+	uint64 _numPushed = 0;
+	std::vector<double> _ring;      // window x N, bar k at row k % window, 0 without a bar
+	std::vector<double> _valid;     // window x N, 1 with a bar, 0 without
+	std::vector<double> _leaving, _leavingValid, _squares, _leavingSquares, _zeros;
+	std::vector<double> _sum;       // per symbol, over its bars
+	std::vector<double> _sumXY;     // N x N, upper triangle (j >= i)
+	std::vector<double> _numCommon; // N x N, upper triangle
+	std::vector<double> _sumOver;   // N x N, [i][j] sum of x[i] over the bars j has
+	std::vector<double> _sumSqOver; // N x N, [i][j] sum of x[i]^2 over the bars j has
+
+	JUCE_DECLARE_NON_COPYABLE(CorrelationMatrix)
+};
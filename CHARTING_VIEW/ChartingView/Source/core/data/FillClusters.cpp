@@ -0,0 +1,118 @@
+/*
+  ==============================================================================
+
+    FillClusters.cpp
+    Created: 16 Oct 2026 4:36:08pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "FillClusters.h"
+
+static int64 floorDiv(int64 a, int64 b) {
+	const int64 q = a / b;
+	return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+}
+
+FillClusters::Cluster FillClusters::Cluster::fromFill(const Fill& f) {
+	Cluster c;
+	c.firstTime = c.lastTime = c.time = f.time;
+	c.price = c.low = c.high = f.price;
+	c.count = 1;
+	c.numBuys = f.qty > 0.0 ? 1 : 0;
+	c.netQty = f.qty;
+	c.volume = std::abs(f.qty);
+	c.pnl = f.pnl;
+	return c;
+}
+
+void FillClusters::Cluster::merge(const Cluster& other) {
+	const uint32 total = count + other.count;
+	// relative to time, epoch ms times a count would lose the low digits in a double
+	time += (int64)std::llround((double)(other.time - time) * (double)other.count / (double)total);
+	if (volume + other.volume > 0.0)
+		price = (price * volume + other.price * other.volume) / (volume + other.volume);
+	firstTime = jmin(firstTime, other.firstTime);
+	lastTime = jmax(lastTime, other.lastTime);
+	low = jmin(low, other.low);
+	high = jmax(high, other.high);
+	count = total;
+	numBuys += other.numBuys;
+	netQty += other.netQty;
+	volume += other.volume;
+	pnl += other.pnl;
+}
+
+FillClusters::FillClusters(std::vector<Fill> fills) {
+	std::stable_sort(fills.begin(), fills.end(), [](const Fill& a, const Fill& b) { return a.time < b.time; });
+	Level fine;
+	fine.shift = -1;
+	fine.clusters.reserve(fills.size());
+	for (const auto& f : fills)
+		fine.clusters.push_back(Cluster::fromFill(f));
+	_levels.push_back(std::move(fine));
+
+	// every shift is merged from the previous one, a previous bucket is inside one of the next
+	std::vector<Cluster> current = _levels[0].clusters;
+	std::vector<Cluster> next;
+	size_t lastKept = current.size();
+	for (int shift = 0; shift < 63 && current.size() > 1; shift++) {
+		next.clear();
+		int64 bucket = 0;
+		for (const auto& c : current) {
+			const int64 b = floorDiv(c.firstTime, (int64)1 << shift);
+			if (!next.empty() && b == bucket)
+				next.back().merge(c);
+			else
+				next.push_back(c);
+			bucket = b;
+		}
+		std::swap(current, next);
+		if (current.size() * 2 <= lastKept) {
+			_levels.push_back({ shift, current });
+			lastKept = current.size();
+		}
+	}
+}
+
+int64 FillClusters::getFirstTime() const {
+	return size() > 0 ? _levels[0].clusters.front().time : 0;
+}
+
+int64 FillClusters::getLastTime() const {
+	return size() > 0 ? _levels[0].clusters.back().time : 0;
+}
+
+int FillClusters::_chooseLevel(double bucketMs) const {
+	int best = 0;
+	for (int i = 1; i < (int)_levels.size(); i++) {
+		if ((double)((int64)1 << _levels[(size_t)i].shift) > bucketMs)
+			break;
+		best = i;
+	}
+	return best;
+}
+
+void FillClusters::query(int64 t0, int64 t1, double bucketMs, std::vector<Cluster>& out) const {
+	out.clear();
+	if (size() == 0 || t1 < t0)
+		return;
+	// the clusters of a level are disjoint and in time order
+	const auto& clusters = _levels[(size_t)_chooseLevel(bucketMs)].clusters;
+	auto first = std::lower_bound(clusters.begin(), clusters.end(), t0, [](const Cluster& c, int64 t) { return c.lastTime < t; });
+	auto last = std::upper_bound(first, clusters.end(), t1, [](int64 t, const Cluster& c) { return t < c.firstTime; });
+	if (bucketMs <= 0.0) {
+		out.assign(first, last);
+		return;
+	}
+	double bucket = 0.0;
+	for (auto it = first; it != last; ++it) {
+		const double b = std::floor((double)it->time / bucketMs);
+		if (!out.empty() && b == bucket)
+			out.back().merge(*it);
+		else
+			out.push_back(*it);
+		bucket = b;
+	}
+}
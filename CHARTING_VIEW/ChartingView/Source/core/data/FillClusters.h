@@ -0,0 +1,79 @@
+/*
+  ==============================================================================
+
+    FillClusters.h
+    Created: 16 Oct 2026 4:36:08pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+
+/*
+	Hierarchy of the fills of an order history (OrdersCsvLoader), for drawing
+	years of fills over a chart without thousands of overlapping markers.
+
+	Level 0 is the fills, sorted by time. A level above merges the clusters of
+	the previous one falling in the same bucket of 2^shift ms from the epoch,
+	and is only kept once it has at most half the clusters of the last kept
+	one : the whole hierarchy is less than twice the fills, built once.
+
+	A query picks the coarsest level whose buckets are not wider than the
+	requested one (same as LodPyramid::chooseLevel), finds the visible clusters
+	by binary search and merges the neighbours landing in the same bucket of
+	the requested width, aligned on the epoch so panning does not regroup
+	them. The cost is the visible clusters, about one per bucket, whatever the
+	number of fills.
+*/
+
+class FillClusters {
+public:
+	using Ptr = SPtr<const FillClusters>;
+
+	struct Fill {
+		int64 time = 0;
+		double price = 0.0;
+		double qty = 0.0;   // > 0 buy, < 0 sell
+		double pnl = 0.0;   // realized by this fill, in quote
+	};
+
+	struct Cluster {
+		int64 firstTime = 0, lastTime = 0;
+		int64 time = 0;         // mean time of the fills
+		double price = 0.0;     // average price weighted by quantity
+		double low = 0.0, high = 0.0;
+		uint32 count = 0;
+		uint32 numBuys = 0;
+		double netQty = 0.0;    // bought - sold
+		double volume = 0.0;    // sum of |qty|
+		double pnl = 0.0;
+
+		bool isSingle() const { return count == 1; }
+		void merge(const Cluster& other);
+		static Cluster fromFill(const Fill& f);
+	};
+
+	// fills in any order
+	explicit FillClusters(std::vector<Fill> fills);
+
+	size_t size() const { return _levels.empty() ? 0 : _levels[0].clusters.size(); }
+	const std::vector<Cluster>& getFills() const { return _levels[0].clusters; }
+	int getNumLevels() const { return (int)_levels.size(); }
+	int64 getFirstTime() const;
+	int64 getLastTime() const;
+
+	// clusters of [t0, t1] merged per bucketMs bucket (bucketMs <= 0 : the fills), in time order
+	void query(int64 t0, int64 t1, double bucketMs, std::vector<Cluster>& out) const;
+
+private:
+	struct Level {
+		int shift = 0; // buckets of 2^shift ms, -1 for the fills
+		std::vector<Cluster> clusters;
+	};
+
+	int _chooseLevel(double bucketMs) const;
+
+	std::vector<Level> _levels;
+};
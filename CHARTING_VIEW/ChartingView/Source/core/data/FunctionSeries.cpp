@@ -0,0 +1,148 @@
+/*
+  ==============================================================================
+
+    FunctionSeries.cpp
+    Created: 16 Oct 2026 2:17:52pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "FunctionSeries.h"
+#include "../utils/TaskPool.h"
+
+static int64 floorDiv(int64 a, int64 b) {
+	const int64 q = a / b;
+	return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+}
+
+FunctionSeries::FunctionSeries(Evaluate evaluate, size_t maxBytes)
+	: _evaluate(std::move(evaluate))
+	, _maxBytes(maxBytes)
+{
+	MemoryBudget::getInstance().addClient(MemoryBudget::samples, this);
+}
+
+FunctionSeries::~FunctionSeries() {
+	MemoryBudget::getInstance().removeClient(this);
+	MemoryBudget::getInstance().add(MemoryBudget::samples, -(int64)_numBytes);
+}
+
+FunctionSeries::Ptr FunctionSeries::fromFunction(std::function<double(int64 time)> f) {
+	return std::make_shared<FunctionSeries>([f = std::move(f)](int64 start, int64 step, double* values, size_t n) {
+		for (size_t i = 0; i < n; i++)
+			values[i] = f(start + (int64)i * step);
+	});
+}
+
+int64 FunctionSeries::getStep(double msPerSample) {
+	if (!(msPerSample >= 2.0))
+		return 1;
+	// below 2^62 : the sample times stay in range
+	return (int64)1 << jmin(62, (int)std::floor(std::log2(msPerSample)));
+}
+
+void FunctionSeries::getSamples(int64 step, int64 first, int64 last, double* values) {
+	if (last <= first)
+		return;
+	const int64 chunk = (int64)chunkSamples;
+	const int64 firstChunk = floorDiv(first, chunk);
+	const int64 lastChunk = floorDiv(last - 1, chunk) + 1;
+
+	// copies the cached chunks, the others are evaluated below
+	std::vector<int64> missing;
+	uint64 version;
+	auto copy = [&](int64 index, const std::vector<double>& chunkValues) {
+		const int64 from = jmax(first, index * chunk);
+		const int64 to = jmin(last, (index + 1) * chunk);
+		std::memcpy(values + (from - first), chunkValues.data() + (from - index * chunk), (size_t)(to - from) * sizeof(double));
+		return (uint64)(to - from);
+	};
+	uint64 numCached = 0;
+	{
+		const ScopedLock sl(_lock);
+		version = _version;
+		for (int64 c = firstChunk; c < lastChunk; c++) {
+			if (const auto* found = _find(step, c))
+				numCached += copy(c, *found->values);
+			else
+				missing.push_back(c);
+		}
+	}
+	_cached.fetch_add(numCached, std::memory_order_relaxed);
+	if (missing.empty())
+		return;
+
+	// whole chunks, so they can be cached
+	std::vector<SPtr<std::vector<double>>> evaluated(missing.size());
+	TaskPool::getInstance().parallelFor(missing.size(), 1, [&](size_t a, size_t b) {
+		for (size_t i = a; i < b; i++) {
+			auto v = std::make_shared<std::vector<double>>(chunkSamples);
+			_evaluate(missing[i] * chunk * step, step, v->data(), chunkSamples);
+			evaluated[i] = std::move(v);
+		}
+	}, TaskPool::Priority::high);
+	_evaluated.fetch_add((uint64)missing.size() * chunkSamples, std::memory_order_relaxed);
+
+	const ScopedLock sl(_lock);
+	for (size_t i = 0; i < missing.size(); i++) {
+		copy(missing[i], *evaluated[i]);
+		// another thread may have added it meanwhile, or the function changed
+		if (version != _version || _find(step, missing[i]) != nullptr)
+			continue;
+		_chunks.push_back({ step, missing[i], std::move(evaluated[i]), ++_useCounter });
+		_numBytes += _getBytes();
+		MemoryBudget::getInstance().add(MemoryBudget::samples, (int64)_getBytes());
+	}
+	_evict(_maxBytes);
+}
+
+void FunctionSeries::invalidate() {
+	const ScopedLock sl(_lock);
+	_version++;
+	_evict(0);
+}
+
+void FunctionSeries::setMaxBytes(size_t maxBytes) {
+	const ScopedLock sl(_lock);
+	_maxBytes = maxBytes;
+	_evict(_maxBytes);
+}
+
+size_t FunctionSeries::getNumBytes() const {
+	const ScopedLock sl(_lock);
+	return _numBytes;
+}
+
+const FunctionSeries::Chunk* FunctionSeries::_find(int64 step, int64 index) {
+	for (auto& c : _chunks) {
+		if (c.index == index && c.step == step) {
+			c.lastUsed = ++_useCounter;
+			return &c;
+		}
+	}
+	return nullptr;
+}
+
+size_t FunctionSeries::_evict(size_t maxBytes) {
+	size_t freed = 0;
+	if (maxBytes == 0) {
+		freed = _numBytes;
+		_chunks.clear();
+	}
+	else if (_numBytes > maxBytes) {
+		// most recently used first, the tail goes
+		std::sort(_chunks.begin(), _chunks.end(), [](const Chunk& a, const Chunk& b) { return a.lastUsed > b.lastUsed; });
+		const size_t keep = maxBytes / _getBytes();
+		freed = (_chunks.size() - keep) * _getBytes();
+		_chunks.resize(keep);
+	}
+	_numBytes -= freed;
+	MemoryBudget::getInstance().add(MemoryBudget::samples, -(int64)freed);
+	return freed;
+}
+
+size_t FunctionSeries::releaseMemory(size_t bytes) {
+	const ScopedLock sl(_lock);
+	return _evict(_numBytes - jmin(bytes, _numBytes));
+}
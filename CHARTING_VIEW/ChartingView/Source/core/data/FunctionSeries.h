@@ -0,0 +1,95 @@
+/*
+  ==============================================================================
+
+    FunctionSeries.h
+    Created: 16 Oct 2026 2:17:52pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+#include "../utils/MemoryBudget.h"
+
+/*
+	A series given by a function of time (synthetic signals, model outputs,
+	analytic curves) instead of stored rows : only the samples a frame draws
+	are ever evaluated.
+
+	Samples are taken every step ms from the epoch, the step being a power of
+	two : a view asks for the step of about one sample per pixel column
+	(getStep(msPerPixel)) over its visible range. Sample i of a step is at
+	i * step, so the samples of a view panned or drawn as tiles are the same.
+
+	They are evaluated in chunks of chunkSamples, the chunks of a request
+	missing from the cache in parallel on the TaskPool, and kept in an LRU
+	keyed by (step, chunk) : a pan evaluates the chunks entering the view
+	only, a zoom back to a step finds its chunks again.
+
+		auto sine = FunctionSeries::fromFunction([](int64 t) { return 100.0 + std::sin((double)t * 1e-6); });
+		chart.addCurve(sine, { WChartCurve::Style::line, Colours::cyan });
+
+	The chunks count in MemoryBudget::samples, evicted by a trim like the
+	tiles. Every method can be called from any thread.
+*/
+
+class FunctionSeries : private MemoryBudget::Client {
+public:
+	using Ptr = SPtr<FunctionSeries>;
+
+	// values[i] = f(start + i * step), NaN where the function has no value. Called
+	// from the pool workers, several chunks at once
+	using Evaluate = std::function<void(int64 start, int64 step, double* values, size_t n)>;
+
+	static constexpr size_t chunkSamples = 256;
+	static constexpr size_t defaultMaxBytes = (size_t)32 << 20;
+
+	explicit FunctionSeries(Evaluate evaluate, size_t maxBytes = defaultMaxBytes);
+	~FunctionSeries() override;
+
+	// one call per sample
+	static Ptr fromFunction(std::function<double(int64 time)> f);
+
+	// largest power of two ms at most msPerSample, 1 at least
+	static int64 getStep(double msPerSample);
+
+	// samples [first, last) of step : values[i] = f((first + i) * step)
+	void getSamples(int64 step, int64 first, int64 last, double* values);
+
+	// the function changed : the cached samples are dropped, the evaluations in
+	// flight are not cached (the charts drawing it repaint with WChartCurve::setFunction)
+	void invalidate();
+
+	void setMaxBytes(size_t maxBytes);
+	size_t getNumBytes() const;
+	// samples evaluated so far, against the ones read from the cache
+	uint64 getNumEvaluated() const { return _evaluated.load(std::memory_order_relaxed); }
+	uint64 getNumCached() const { return _cached.load(std::memory_order_relaxed); }
+
+private:
+	struct Chunk {
+		int64 step = 0;
+		int64 index = 0; // samples [index, index + 1) * chunkSamples
+		SPtr<const std::vector<double>> values;
+		uint64 lastUsed = 0;
+	};
+
+	const Chunk* _find(int64 step, int64 index);
+	// least recently used first down to maxBytes, returns the bytes freed
+	size_t _evict(size_t maxBytes);
+	size_t releaseMemory(size_t bytes) override;
+	static size_t _getBytes() { return chunkSamples * sizeof(double); }
+
+	Evaluate _evaluate;
+	mutable CriticalSection _lock;
+	std::vector<Chunk> _chunks;
+	size_t _numBytes = 0;
+	size_t _maxBytes;
+	uint64 _useCounter = 0;
+	uint64 _version = 0; // invalidate() count
+	std::atomic<uint64> _evaluated{ 0 };
+	std::atomic<uint64> _cached{ 0 };
+
+	JUCE_DECLARE_NON_COPYABLE(FunctionSeries)
+};
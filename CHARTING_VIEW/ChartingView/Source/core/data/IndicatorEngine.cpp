@@ -0,0 +1,356 @@
+/*
+  ==============================================================================
+
+    IndicatorEngine.cpp
+    Created: 15 Oct 2026 2:26:09am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "IndicatorEngine.h"
+#include "IndicatorKernels.h"
+
+static constexpr double missing = std::numeric_limits<double>::quiet_NaN();
+
+Indicator::Indicator(const String& name, const StringArray& outputNames)
+	: _name(name)
+	, _outputNames(outputNames)
+{
+	for (int i = 0; i < outputNames.size(); i++)
+		_outputs.push_back(std::make_shared<std::vector<double>>());
+	_data.resize(_outputs.size(), nullptr);
+}
+
+void Indicator::_reserve(size_t numRows) {
+	for (size_t i = 0; i < _outputs.size(); i++) {
+		auto& out = _outputs[i];
+		if (out->capacity() < numRows) {
+			// a new vector, curves may still hold the old one
+			auto grown = std::make_shared<std::vector<double>>();
+			grown->reserve(jmax(numRows, out->capacity() * 2));
+			grown->assign(out->begin(), out->begin() + (std::ptrdiff_t)jmin(out->size(), _numRows));
+			out = grown;
+		}
+		out->resize(numRows, missing);
+		_data[i] = out->data();
+	}
+}
+
+void Indicator::update(const double* input, size_t numRows, size_t fromRow) {
+	// the committed state holds rows before the last one of the previous update
+	if (fromRow < _numCommitted || numRows < _numCommitted) {
+		_reset();
+		_numCommitted = 0;
+	}
+	_reserve(numRows);
+	_numRows = numRows;
+	if (numRows == 0)
+		return;
+	if (_numCommitted == 0) {
+		// the output of another indicator starts with its warm-up NaNs (an EMA of an RSI) :
+		// the rows before its first value are NaN and the state starts at it
+		_start = 0;
+		while (_start < numRows && std::isnan(input[_start])) {
+			for (auto* data : _data)
+				data[_start] = missing;
+			_start++;
+		}
+		if (_start == numRows)
+			return;
+	}
+	// the indicators see their rows from _start (_write() and _getData() too)
+	const double* values = input + _start;
+	const size_t n = numRows - _start;
+	const size_t committed = jmax(_numCommitted, _start) - _start;
+	if (committed == 0 && n >= minRowsForKernels && _computeAll(values, n)) {
+		_numCommitted = numRows - 1;
+		return;
+	}
+	for (size_t row = committed; row + 1 < n; row++)
+		_step(values, row, true);
+	_numCommitted = numRows - 1;
+	_step(values, n - 1, false);
+}
+
+void Indicator::clear() {
+	_reset();
+	_start = 0;
+	_numCommitted = 0;
+	_numRows = 0;
+	_reserve(0);
+}
+
+std::vector<double> Indicator::getState() const {
+	std::vector<double> state;
+	_saveState(state);
+	state.insert(state.begin(), (double)_start);
+	return state;
+}
+
+bool Indicator::restore(std::vector<std::vector<double>> outputs, size_t numRows, size_t numCommitted, const std::vector<double>& state) {
+	clear();
+	const size_t start = state.empty() ? 0 : (size_t)state[0];
+	const bool fits = outputs.size() == _outputs.size() && numCommitted <= numRows && !state.empty() && start <= numCommitted
+		&& std::all_of(outputs.begin(), outputs.end(), [numRows](const std::vector<double>& o) { return o.size() == numRows; });
+	if (!fits || !_loadState(std::vector<double>(state.begin() + 1, state.end()))) {
+		_reset();
+		return false;
+	}
+	// new vectors, like a reallocation
+	for (size_t i = 0; i < _outputs.size(); i++) {
+		_outputs[i] = std::make_shared<std::vector<double>>(std::move(outputs[i]));
+		_data[i] = _outputs[i]->data();
+	}
+	_numRows = numRows;
+	_numCommitted = numCommitted;
+	_start = start;
+	return true;
+}
+
+// SMA
+
+SmaIndicator::SmaIndicator(int period)
+	: Indicator("sma_" + String(period), { "sma" })
+	, _period(jmax(1, period))
+{
+}
+
+void SmaIndicator::_reset() {
+	_sum = 0.0;
+}
+
+void SmaIndicator::_saveState(std::vector<double>& state) const {
+	state = { _sum };
+}
+
+bool SmaIndicator::_loadState(const std::vector<double>& state) {
+	if (state.size() != 1)
+		return false;
+	_sum = state[0];
+	return true;
+}
+
+void SmaIndicator::_step(const double* input, size_t row, bool commit) {
+	double sum = _sum + input[row];
+	if (row >= (size_t)_period)
+		sum -= input[row - (size_t)_period];
+	_write(0, row, row + 1 >= (size_t)_period ? sum / _period : missing);
+	if (commit)
+		_sum = sum;
+}
+
+bool SmaIndicator::_computeAll(const double* input, size_t numRows) {
+	IndicatorKernels::PrefixSums sums;
+	sums.compute(input, numRows);
+	IndicatorKernels::sma(sums, _period, _getData(0));
+	// committed state : the window ending at the row before the last one
+	_sum = 0.0;
+	for (size_t r = numRows - 1 > (size_t)_period ? numRows - 1 - (size_t)_period : 0; r + 1 < numRows; r++)
+		_sum += input[r];
+	return true;
+}
+
+// EMA
+
+EmaIndicator::EmaIndicator(int period)
+	: Indicator("ema_" + String(period), { "ema" })
+	, _alpha(2.0 / (jmax(1, period) + 1.0))
+{
+}
+
+void EmaIndicator::_reset() {
+	_ema = 0.0;
+}
+
+void EmaIndicator::_saveState(std::vector<double>& state) const {
+	state = { _ema };
+}
+
+bool EmaIndicator::_loadState(const std::vector<double>& state) {
+	if (state.size() != 1)
+		return false;
+	_ema = state[0];
+	return true;
+}
+
+void EmaIndicator::_step(const double* input, size_t row, bool commit) {
+	const double ema = row == 0 ? input[0] : _ema + _alpha * (input[row] - _ema);
+	_write(0, row, ema);
+	if (commit)
+		_ema = ema;
+}
+
+bool EmaIndicator::_computeAll(const double* input, size_t numRows) {
+	auto* out = _getData(0);
+	IndicatorKernels::ema(input, numRows, _alpha, out);
+	_ema = numRows > 1 ? out[numRows - 2] : 0.0;
+	return true;
+}
+
+// Bollinger
+
+BollingerIndicator::BollingerIndicator(int period, double deviations)
+	: Indicator("bollinger_" + String(period), { "middle", "upper", "lower" })
+	, _period(jmax(1, period))
+	, _deviations(deviations)
+{
+}
+
+String BollingerIndicator::getKey() const {
+	return getName() + "_" + String(_deviations);
+}
+
+void BollingerIndicator::_reset() {
+	_mean = 0.0;
+	_m2 = 0.0;
+}
+
+void BollingerIndicator::_saveState(std::vector<double>& state) const {
+	state = { _mean, _m2 };
+}
+
+bool BollingerIndicator::_loadState(const std::vector<double>& state) {
+	if (state.size() != 2)
+		return false;
+	_mean = state[0];
+	_m2 = state[1];
+	return true;
+}
+
+void BollingerIndicator::_step(const double* input, size_t row, bool commit) {
+	const double x = input[row];
+	double mean, m2;
+	if (row < (size_t)_period) {
+		// filling the window, plain Welford
+		const double n = (double)(row + 1);
+		const double delta = x - _mean;
+		mean = _mean + delta / n;
+		m2 = _m2 + delta * (x - mean);
+	}
+	else {
+		// x enters, old leaves, same count
+		const double old = input[row - (size_t)_period];
+		mean = _mean + (x - old) / _period;
+		m2 = _m2 + (x - old) * (x - mean + old - _mean);
+	}
+	if (row + 1 >= (size_t)_period) {
+		const double sd = std::sqrt(jmax(0.0, m2) / _period);
+		_write(middle, row, mean);
+		_write(upper, row, mean + _deviations * sd);
+		_write(lower, row, mean - _deviations * sd);
+	}
+	else {
+		for (int o : { middle, upper, lower })
+			_write(o, row, missing);
+	}
+	if (commit) {
+		_mean = mean;
+		_m2 = m2;
+	}
+}
+
+bool BollingerIndicator::_computeAll(const double* input, size_t numRows) {
+	IndicatorKernels::PrefixSums sums;
+	sums.compute(input, numRows);
+	IndicatorKernels::bollinger(sums, _period, _deviations, _getData(middle), _getData(upper), _getData(lower));
+	// committed state : Welford over the window ending at the row before the last one
+	_mean = 0.0;
+	_m2 = 0.0;
+	double n = 0.0;
+	for (size_t r = numRows - 1 > (size_t)_period ? numRows - 1 - (size_t)_period : 0; r + 1 < numRows; r++) {
+		n++;
+		const double delta = input[r] - _mean;
+		_mean += delta / n;
+		_m2 += delta * (input[r] - _mean);
+	}
+	return true;
+}
+
+// RSI
+
+RsiIndicator::RsiIndicator(int period)
+	: Indicator("rsi_" + String(period), { "rsi" })
+	, _period(jmax(1, period))
+{
+}
+
+void RsiIndicator::_reset() {
+	_gain = 0.0;
+	_loss = 0.0;
+}
+
+void RsiIndicator::_saveState(std::vector<double>& state) const {
+	state = { _gain, _loss };
+}
+
+bool RsiIndicator::_loadState(const std::vector<double>& state) {
+	if (state.size() != 2)
+		return false;
+	_gain = state[0];
+	_loss = state[1];
+	return true;
+}
+
+void RsiIndicator::_step(const double* input, size_t row, bool commit) {
+	if (row == 0) {
+		_write(0, row, missing);
+		return;
+	}
+	const double delta = input[row] - input[row - 1];
+	const double up = jmax(0.0, delta);
+	const double down = jmax(0.0, -delta);
+	double gain, loss;
+	if (row <= (size_t)_period) {
+		// first averages are plain means of the first period changes
+		gain = _gain + up / _period;
+		loss = _loss + down / _period;
+	}
+	else {
+		gain = (_gain * (_period - 1) + up) / _period;
+		loss = (_loss * (_period - 1) + down) / _period;
+	}
+	if (row < (size_t)_period)
+		_write(0, row, missing);
+	else
+		_write(0, row, loss == 0.0 ? 100.0 : 100.0 - 100.0 / (1.0 + gain / loss));
+	if (commit) {
+		_gain = gain;
+		_loss = loss;
+	}
+}
+
+// engine
+
+IndicatorEngine::Id IndicatorEngine::add(UPtr<Indicator> indicator, const Input& input) {
+	// inputs come first, update() runs the nodes in order
+	jassert(input.indicator < (Id)_nodes.size());
+	jassert(input.indicator >= 0 || !KlineStore::isIntegerColumn(input.column));
+	_nodes.push_back({ std::move(indicator), input });
+	return (Id)_nodes.size() - 1;
+}
+
+void IndicatorEngine::update(const KlineStore& store, size_t fromRow) {
+	if (onChanging)
+		onChanging();
+	const size_t n = store.size();
+	for (auto& node : _nodes) {
+		const auto& in = node.input;
+		// an output changes from the same row as its inputs
+		const double* values = in.indicator >= 0
+			? get(in.indicator)->getOutput(in.output)->data()
+			: store.getDoubleColumn(in.column);
+		if (values == nullptr) {
+			node.indicator->clear();
+			continue;
+		}
+		node.indicator->update(values, n, fromRow);
+	}
+	if (onChanged)
+		onChanged();
+}
+
+void IndicatorEngine::clear() {
+	for (auto& node : _nodes)
+		node.indicator->clear();
+}
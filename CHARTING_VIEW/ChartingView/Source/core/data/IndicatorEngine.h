@@ -0,0 +1,218 @@
+/*
+  ==============================================================================
+
+    IndicatorEngine.h
+    Created: 15 Oct 2026 2:26:09am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+#include "KlineStore.h"
+
+/*
+	Native indicators of a kline store (the Python DisplayKlines/indicators.py
+	ones), updated in O(1) per new or changed row.
+
+	Each indicator keeps a rolling state (running sums, sliding Welford mean /
+	variance, Wilder averages) committed up to the row before the last one :
+	the last row may still be forming, it is computed again from the committed
+	state on every update. Rewriting anything older recomputes from scratch.
+
+	A recompute from scratch over many rows goes through the IndicatorKernels
+	(pool + SIMD passes) for the SMA, EMA and Bollinger.
+
+	Outputs are columns (values[row], NaN during the warm-up) that WChart::addCurve
+	draws directly. Outputs are written in place and only reallocated (a new
+	vector, the previous one stays valid for its readers) when they grow past
+	their capacity.
+
+	An input starting with NaNs (the warm-up of the indicator it is the output
+	of) is read from its first value : the rows before are NaN and the rolling
+	state starts there, the NaNs never enter a running sum.
+
+	The outputs and the committed state can be saved and restored (DerivedCache) :
+	a restored indicator goes on from its committed row like after an update.
+*/
+
+class Indicator {
+public:
+	// from scratch recomputes of at least this many rows use _computeAll()
+	static constexpr size_t minRowsForKernels = 4096;
+
+	virtual ~Indicator() = default;
+
+	const String& getName() const { return _name; }
+	int getNumOutputs() const { return (int)_outputs.size(); }
+	const String& getOutputName(int output) const { return _outputNames[output]; }
+	SPtr<const std::vector<double>> getOutput(int output) const { return _outputs[(size_t)output]; }
+	size_t size() const { return _numRows; }
+
+	// input rows [fromRow, numRows) are new or changed, the rows before are unchanged.
+	// O(numRows - fromRow) when fromRow is at least the last row of the previous update
+	void update(const double* input, size_t numRows, size_t fromRow);
+	void clear();
+
+	// name and every parameter, what a saved indicator must match to be restored
+	virtual String getKey() const { return _name; }
+	size_t getNumCommitted() const { return _numCommitted; }
+	// the first input row and the rolling state of the rows before getNumCommitted()
+	std::vector<double> getState() const;
+	// outputs of numRows rows and the state saved with them, false (and cleared) when they don't fit
+	bool restore(std::vector<std::vector<double>> outputs, size_t numRows, size_t numCommitted, const std::vector<double>& state);
+
+protected:
+	Indicator(const String& name, const StringArray& outputNames);
+
+	// back to the state before the first row
+	virtual void _reset() = 0;
+	// writes the outputs of row from the committed state (rows < row), and commits
+	// row into the state when commit. Input and rows start at the first input value
+	virtual void _step(const double* input, size_t row, bool commit) = 0;
+	// full recompute with the IndicatorKernels : writes every row and commits the rows
+	// but the last one, false to step through the rows instead
+	virtual bool _computeAll(const double*, size_t) { return false; }
+	virtual void _saveState(std::vector<double>& state) const = 0;
+	virtual bool _loadState(const std::vector<double>& state) = 0;
+
+	void _write(int output, size_t row, double value) { _data[(size_t)output][_start + row] = value; }
+	double* _getData(int output) const { return _data[(size_t)output] + _start; }
+
+private:
+	void _reserve(size_t numRows);
+
+	String _name;
+	StringArray _outputNames;
+	std::vector<SPtr<std::vector<double>>> _outputs;
+	std::vector<double*> _data;
+	size_t _numRows = 0;
+	size_t _numCommitted = 0;
+	size_t _start = 0; // first row of the input that is not NaN
+};
+
+// simple moving average, running sum
+class SmaIndicator : public Indicator {
+public:
+	explicit SmaIndicator(int period);
+
+protected:
+	void _reset() override;
+	void _step(const double* input, size_t row, bool commit) override;
+	void _saveState(std::vector<double>& state) const override;
+	bool _loadState(const std::vector<double>& state) override;
+	bool _computeAll(const double* input, size_t numRows) override;
+
+private:
+	int _period;
+	double _sum = 0.0;
+};
+
+// exponential moving average, seeded with the first value (pandas ewm(span, adjust=False))
+class EmaIndicator : public Indicator {
+public:
+	explicit EmaIndicator(int period);
+
+protected:
+	void _reset() override;
+	void _step(const double* input, size_t row, bool commit) override;
+	void _saveState(std::vector<double>& state) const override;
+	bool _loadState(const std::vector<double>& state) override;
+	bool _computeAll(const double* input, size_t numRows) override;
+
+private:
+	double _alpha;
+	double _ema = 0.0;
+};
+
+// middle (sma), upper and lower bands at deviations standard deviations (ddof 0),
+// sliding window Welford mean and M2
+class BollingerIndicator : public Indicator {
+public:
+	enum Output { middle = 0, upper, lower };
+
+	BollingerIndicator(int period, double deviations = 2.0);
+	String getKey() const override;
+
+protected:
+	void _reset() override;
+	void _step(const double* input, size_t row, bool commit) override;
+	void _saveState(std::vector<double>& state) const override;
+	bool _loadState(const std::vector<double>& state) override;
+	bool _computeAll(const double* input, size_t numRows) override;
+
+private:
+	int _period;
+	double _deviations;
+	double _mean = 0.0;
+	double _m2 = 0.0;
+};
+
+// relative strength index, Wilder smoothing of the gains and losses
+class RsiIndicator : public Indicator {
+public:
+	explicit RsiIndicator(int period);
+
+protected:
+	void _reset() override;
+	void _step(const double* input, size_t row, bool commit) override;
+	void _saveState(std::vector<double>& state) const override;
+	bool _loadState(const std::vector<double>& state) override;
+
+private:
+	int _period;
+	double _gain = 0.0;
+	double _loss = 0.0;
+};
+
+/*
+	Graph of indicators over a store : an indicator reads a store column or
+	the output of an indicator added before it (an EMA of an RSI...), update()
+	runs them in order.
+
+		IndicatorEngine engine;
+		auto bb = engine.addBollinger(20);
+		engine.update(*store, 0);
+		chart.addCurve(store, engine.getOutput(bb, BollingerIndicator::upper));
+		...
+		engine.update(*store, store->size() - 1); // forming candle changed, O(1)
+*/
+
+class IndicatorEngine {
+public:
+	using Id = int;
+
+	struct Input {
+		KlineStore::Column column = KlineStore::close;
+		Id indicator = -1; // instead of the column when set
+		int output = 0;
+	};
+
+	Id add(UPtr<Indicator> indicator, const Input& input = {});
+	Id addSma(int period, const Input& input = {}) { return add(std::make_unique<SmaIndicator>(period), input); }
+	Id addEma(int period, const Input& input = {}) { return add(std::make_unique<EmaIndicator>(period), input); }
+	Id addBollinger(int period, double deviations = 2.0, const Input& input = {}) { return add(std::make_unique<BollingerIndicator>(period, deviations), input); }
+	Id addRsi(int period, const Input& input = {}) { return add(std::make_unique<RsiIndicator>(period), input); }
+
+	int getNumIndicators() const { return (int)_nodes.size(); }
+	Indicator* get(Id id) const { return _nodes[(size_t)id].indicator.get(); }
+	SPtr<const std::vector<double>> getOutput(Id id, int output = 0) const { return get(id)->getOutput(output); }
+	const Input& getInput(Id id) const { return _nodes[(size_t)id].input; }
+
+	// same series grown or with its tail rewritten from fromRow (like LodPyramid::update)
+	void update(const KlineStore& store, size_t fromRow);
+	void clear();
+
+	// around the writes of update(), the outputs may be read elsewhere (WChartCurve::onChanging)
+	std::function<void()> onChanging;
+	std::function<void()> onChanged;
+
+private:
+	struct Node {
+		UPtr<Indicator> indicator;
+		Input input;
+	};
+
+	std::vector<Node> _nodes;
+};
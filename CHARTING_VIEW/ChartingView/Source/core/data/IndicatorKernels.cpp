@@ -0,0 +1,213 @@
+/*
+  ==============================================================================
+
+    IndicatorKernels.cpp
+    Created: 15 Oct 2026 3:05:41am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "IndicatorKernels.h"
+#include "../utils/Simd.h"
+#include "../utils/TaskPool.h"
+
+static constexpr double missing = std::numeric_limits<double>::quiet_NaN();
+
+// fn(first, last) over [0, n) in chunks, with the index of the chunk
+template <typename Fn>
+static void forEachChunk(size_t n, size_t chunk, Fn&& fn) {
+	const size_t numChunks = (n + chunk - 1) / chunk;
+	TaskPool::getInstance().parallelFor(numChunks, 1, [&](size_t firstChunk, size_t lastChunk) {
+		for (size_t c = firstChunk; c < lastChunk; c++)
+			fn(c, c * chunk, jmin(n, (c + 1) * chunk));
+	});
+}
+
+void IndicatorKernels::PrefixSums::compute(const double* x, size_t n) {
+	shift = n > 0 ? x[0] : 0.0;
+	sum.resize(n + 1);
+	sumSq.resize(n + 1);
+	sum[0] = sumSq[0] = 0.0;
+	if (n == 0)
+		return;
+
+	// local scans, then the totals of the previous chunks are added
+	const size_t numChunks = (n + chunkSize - 1) / chunkSize;
+	std::vector<double> totals(numChunks * 2, 0.0);
+	forEachChunk(n, chunkSize, [&](size_t c, size_t first, size_t last) {
+		double s = 0.0, s2 = 0.0;
+		for (size_t i = first; i < last; i++) {
+			const double d = x[i] - shift;
+			s += d;
+			s2 += d * d;
+			sum[i + 1] = s;
+			sumSq[i + 1] = s2;
+		}
+		totals[c * 2] = s;
+		totals[c * 2 + 1] = s2;
+	});
+	double carry = 0.0, carrySq = 0.0;
+	for (size_t c = 0; c < numChunks; c++) {
+		const double t = totals[c * 2], t2 = totals[c * 2 + 1];
+		totals[c * 2] = carry;
+		totals[c * 2 + 1] = carrySq;
+		carry += t;
+		carrySq += t2;
+	}
+	forEachChunk(n, chunkSize, [&](size_t c, size_t first, size_t last) {
+		const double o = totals[c * 2], o2 = totals[c * 2 + 1];
+		if (o == 0.0 && o2 == 0.0)
+			return;
+		size_t i = first + 1;
+	   #if W_USE_SSE2
+		const __m128d vo = _mm_set1_pd(o), vo2 = _mm_set1_pd(o2);
+		for (; i + 2 <= last + 1; i += 2) {
+			_mm_storeu_pd(&sum[i], _mm_add_pd(_mm_loadu_pd(&sum[i]), vo));
+			_mm_storeu_pd(&sumSq[i], _mm_add_pd(_mm_loadu_pd(&sumSq[i]), vo2));
+		}
+	   #endif
+		for (; i <= last; i++) {
+			sum[i] += o;
+			sumSq[i] += o2;
+		}
+	});
+}
+
+void IndicatorKernels::sma(const PrefixSums& s, int period, double* out) {
+	const size_t n = s.size();
+	const size_t p = (size_t)jmax(1, period);
+	const double inv = 1.0 / (double)p;
+	forEachChunk(n, chunkSize, [&](size_t, size_t first, size_t last) {
+		size_t i = first;
+		for (; i < last && i + 1 < p; i++)
+			out[i] = missing;
+		// window [i + 1 - p, i] : sum[i + 1] - sum[i + 1 - p]
+		const double* sum = s.sum.data();
+	   #if W_USE_SSE2
+		const __m128d vInv = _mm_set1_pd(inv), vShift = _mm_set1_pd(s.shift);
+		for (; i + 2 <= last; i += 2) {
+			const __m128d m = _mm_mul_pd(_mm_sub_pd(_mm_loadu_pd(sum + i + 1), _mm_loadu_pd(sum + i + 1 - p)), vInv);
+			_mm_storeu_pd(out + i, _mm_add_pd(m, vShift));
+		}
+	   #endif
+		for (; i < last; i++)
+			out[i] = (sum[i + 1] - sum[i + 1 - p]) * inv + s.shift;
+	});
+}
+
+void IndicatorKernels::bollinger(const PrefixSums& s, int period, double deviations, double* middle, double* upper, double* lower) {
+	const size_t n = s.size();
+	const size_t p = (size_t)jmax(1, period);
+	const double inv = 1.0 / (double)p;
+	forEachChunk(n, chunkSize, [&](size_t, size_t first, size_t last) {
+		size_t i = first;
+		for (; i < last && i + 1 < p; i++)
+			middle[i] = upper[i] = lower[i] = missing;
+		const double* sum = s.sum.data();
+		const double* sumSq = s.sumSq.data();
+	   #if W_USE_SSE2
+		const __m128d vInv = _mm_set1_pd(inv), vShift = _mm_set1_pd(s.shift), vK = _mm_set1_pd(deviations), zero = _mm_setzero_pd();
+		for (; i + 2 <= last; i += 2) {
+			const __m128d m = _mm_mul_pd(_mm_sub_pd(_mm_loadu_pd(sum + i + 1), _mm_loadu_pd(sum + i + 1 - p)), vInv);
+			const __m128d m2 = _mm_mul_pd(_mm_sub_pd(_mm_loadu_pd(sumSq + i + 1), _mm_loadu_pd(sumSq + i + 1 - p)), vInv);
+			const __m128d sd = _mm_mul_pd(_mm_sqrt_pd(_mm_max_pd(_mm_sub_pd(m2, _mm_mul_pd(m, m)), zero)), vK);
+			const __m128d mid = _mm_add_pd(m, vShift);
+			_mm_storeu_pd(middle + i, mid);
+			_mm_storeu_pd(upper + i, _mm_add_pd(mid, sd));
+			_mm_storeu_pd(lower + i, _mm_sub_pd(mid, sd));
+		}
+	   #endif
+		for (; i < last; i++) {
+			const double m = (sum[i + 1] - sum[i + 1 - p]) * inv;
+			const double sd = std::sqrt(jmax(0.0, (sumSq[i + 1] - sumSq[i + 1 - p]) * inv - m * m)) * deviations;
+			middle[i] = m + s.shift;
+			upper[i] = middle[i] + sd;
+			lower[i] = middle[i] - sd;
+		}
+	});
+}
+
+void IndicatorKernels::ema(const double* x, size_t n, double alpha, double* out) {
+	if (n == 0)
+		return;
+	const double decay = 1.0 - alpha;
+	// y[i] = alpha * x[i] + decay * y[i - 1], y[-1] = x[0] : each chunk from y = 0, then
+	// y[i] += decay^(i - first + 1) * y[first - 1]
+	const size_t numChunks = (n + chunkSize - 1) / chunkSize;
+	forEachChunk(n, chunkSize, [&](size_t c, size_t first, size_t last) {
+		double y = c == 0 ? x[0] : 0.0;
+		for (size_t i = first; i < last; i++) {
+			y = alpha * x[i] + decay * y;
+			out[i] = y;
+		}
+	});
+	if (numChunks == 1)
+		return;
+	std::vector<double> carry(numChunks, 0.0);
+	for (size_t c = 1; c < numChunks; c++) {
+		const size_t first = c * chunkSize;
+		const size_t last = jmin(n, first + chunkSize);
+		carry[c] = out[first - 1];
+		// the end of this chunk with its carry, for the next one
+		out[last - 1] += std::pow(decay, (double)(last - first)) * carry[c];
+	}
+	forEachChunk(n, chunkSize, [&](size_t c, size_t first, size_t last) {
+		if (c == 0 || carry[c] == 0.0)
+			return;
+		// the last row already has its carry
+		double w = decay * carry[c];
+		for (size_t i = first; i + 1 < last; i++) {
+			out[i] += w;
+			w *= decay;
+		}
+	});
+}
+
+void IndicatorKernels::rollingMinMax(const double* x, size_t n, int period, double* outMin, double* outMax) {
+	const size_t p = (size_t)jmax(1, period);
+	if (n == 0)
+		return;
+	// blocks of p rows : g = running extreme from the block start, h = from the block end,
+	// the window [i - p + 1, i] is h[i - p + 1] combined with g[i]
+	std::vector<double> gMin, hMin, gMax, hMax;
+	for (auto* v : { &gMin, &hMin, &gMax, &hMax })
+		v->resize(n);
+	// chunks of whole blocks
+	const size_t chunk = jmax((size_t)1, chunkSize / p) * p;
+	forEachChunk(n, chunk, [&](size_t, size_t first, size_t last) {
+		for (size_t b = first; b < last; b += p) {
+			const size_t e = jmin(last, b + p);
+			gMin[b] = gMax[b] = x[b];
+			for (size_t i = b + 1; i < e; i++) {
+				gMin[i] = jmin(gMin[i - 1], x[i]);
+				gMax[i] = jmax(gMax[i - 1], x[i]);
+			}
+			hMin[e - 1] = hMax[e - 1] = x[e - 1];
+			for (size_t i = e - 1; i-- > b;) {
+				hMin[i] = jmin(hMin[i + 1], x[i]);
+				hMax[i] = jmax(hMax[i + 1], x[i]);
+			}
+		}
+	});
+	forEachChunk(n, chunkSize, [&](size_t, size_t first, size_t last) {
+		size_t i = first;
+		for (; i < last && i + 1 < p; i++) {
+			if (outMin) outMin[i] = missing;
+			if (outMax) outMax[i] = missing;
+		}
+		const size_t lag = p - 1;
+	   #if W_USE_SSE2
+		for (; i + 2 <= last; i += 2) {
+			if (outMin)
+				_mm_storeu_pd(outMin + i, _mm_min_pd(_mm_loadu_pd(&hMin[i - lag]), _mm_loadu_pd(&gMin[i])));
+			if (outMax)
+				_mm_storeu_pd(outMax + i, _mm_max_pd(_mm_loadu_pd(&hMax[i - lag]), _mm_loadu_pd(&gMax[i])));
+		}
+	   #endif
+		for (; i < last; i++) {
+			if (outMin) outMin[i] = jmin(hMin[i - lag], gMin[i]);
+			if (outMax) outMax[i] = jmax(hMax[i - lag], gMax[i]);
+		}
+	});
+}
@@ -0,0 +1,51 @@
+/*
+  ==============================================================================
+
+    IndicatorKernels.h
+    Created: 15 Oct 2026 3:05:41am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+
+/*
+	Whole column indicator passes, for the full recomputes (new parameters,
+	another symbol) : chunks on the TaskPool, SSE2 inner loops.
+
+	- SMA / Bollinger read the prefix sums of the values and of their squares,
+	  computed once : a parameter sweep (period, deviations) is then a single
+	  vectorized pass per step. Values are shifted by the first one before
+	  summing, the sums of a price series stay small enough for the windowed
+	  differences to keep ~1e-10 relative precision.
+	- EMA is a blocked scan : each chunk runs from a zero start, then the
+	  carried value of the previous chunks is added with its decay.
+	- Rolling min / max (Donchian channels) use the van Herk / Gil-Werman
+	  blocks, O(n) whatever the period.
+
+	Outputs are NaN during the warm-up, like the Indicator ones.
+*/
+
+struct IndicatorKernels {
+	// sum[i] / sumSq[i] : sums of (x - shift) and (x - shift)^2 over rows [0, i), n + 1 entries
+	struct PrefixSums {
+		double shift = 0.0;
+		std::vector<double> sum, sumSq;
+
+		size_t size() const { return sum.empty() ? 0 : sum.size() - 1; }
+		void compute(const double* x, size_t n);
+	};
+
+	static void sma(const PrefixSums& s, int period, double* out);
+	// population standard deviation (ddof 0), like bollinger_stra.py
+	static void bollinger(const PrefixSums& s, int period, double deviations, double* middle, double* upper, double* lower);
+	// seeded with x[0] (pandas ewm(span, adjust=False)), alpha = 2 / (period + 1)
+	static void ema(const double* x, size_t n, double alpha, double* out);
+	// extremes of the last period values, either output may be null
+	static void rollingMinMax(const double* x, size_t n, int period, double* outMin, double* outMax);
+
+	// rows per pool task
+	static constexpr size_t chunkSize = 1 << 16;
+};
@@ -0,0 +1,226 @@
+/*
+  ==============================================================================
+
+    KlineResampler.cpp
+    Created: 14 Oct 2026 7:02:18pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "KlineResampler.h"
+
+static int64 floorToPeriod(int64 time, int64 period) {
+	const int64 r = time % period;
+	return time - (r < 0 ? r + period : r);
+}
+
+int64 KlineResampler::parseInterval(const String& interval) {
+	const String s = interval.trim();
+	if (s.length() < 2)
+		return 0;
+	const int64 n = s.dropLastCharacters(1).getLargeIntValue();
+	switch (s.getLastCharacter()) {
+		case 's': return n * 1000;
+		case 'm': return n * 60000;
+		case 'h': return n * 3600000;
+		case 'd': return n * 86400000;
+		default: return 0; // weeks and months are not epoch aligned on Binance
+	}
+}
+
+String KlineResampler::formatInterval(int64 period) {
+	if (period > 0 && period % 86400000 == 0) return String(period / 86400000) + "d";
+	if (period > 0 && period % 3600000 == 0) return String(period / 3600000) + "h";
+	if (period > 0 && period % 60000 == 0) return String(period / 60000) + "m";
+	return String(period / 1000) + "s";
+}
+
+bool KlineResampler::setSource(KlineStore::Ptr source) {
+	const bool sameHistory = _source && source && !source->isEmpty() && !_source->isEmpty()
+		&& source->getFirstOpenTime() == _source->getFirstOpenTime() && source->size() >= _source->size();
+	if (!sameHistory)
+		_timeframes.clear();
+	_source = std::move(source);
+
+	_sourcePeriod = 0;
+	if (_source) {
+		const int64* t = _source->getOpenTime();
+		const size_t n = jmin(_source->size(), (size_t)64);
+		for (size_t i = 1; i < n; i++)
+			if (t[i] > t[i - 1] && (_sourcePeriod == 0 || t[i] - t[i - 1] < _sourcePeriod))
+				_sourcePeriod = t[i] - t[i - 1];
+	}
+	return sameHistory;
+}
+
+KlineStore::Ptr KlineResampler::get(int64 period) {
+	if (!_source)
+		return nullptr;
+	if (period <= _sourcePeriod || _source->isEmpty())
+		return _source;
+	// a period that isn't a multiple of the source one mixes candles across buckets
+	jassert(_sourcePeriod == 0 || period % _sourcePeriod == 0);
+
+	for (auto& tf : _timeframes)
+		if (tf.period == period)
+			return tf.store;
+
+	Timeframe& tf = _timeframes.emplace_back();
+	tf.period = period;
+	_sync(tf);
+	return tf.store;
+}
+
+void KlineResampler::sync() {
+	for (auto& tf : _timeframes)
+		_sync(tf);
+}
+
+size_t KlineResampler::getNumClosed(int64 period) const {
+	for (const auto& tf : _timeframes)
+		if (tf.period == period)
+			return tf.numClosed;
+	return 0;
+}
+
+KlineStore::Ptr KlineResampler::restore(int64 period, KlineStore::Ptr closed) {
+	if (!_source || period <= _sourcePeriod || _source->isEmpty() || !closed || closed->isEmpty())
+		return get(period);
+	const size_t n = _source->size();
+	const int64* t = _source->getOpenTime();
+	const int64 lastClosed = closed->getOpenTime()[closed->size() - 1];
+	// same first candle, and the source goes on past the last closed one
+	const size_t consumed = _source->lowerBound(lastClosed + period);
+	if (closed->getOpenTime()[0] != floorToPeriod(t[0], period) || consumed + 1 > n)
+		return get(period);
+
+	_timeframes.erase(std::remove_if(_timeframes.begin(), _timeframes.end(), [period](const Timeframe& tf) {
+		return tf.period == period;
+	}), _timeframes.end());
+	Timeframe& tf = _timeframes.emplace_back();
+	tf.period = period;
+	tf.numClosed = closed->size();
+	tf.consumed = consumed;
+	closed->setSymbol(_source->getSymbol());
+	closed->setInterval(formatInterval(period));
+	tf.store = std::move(closed);
+	_sync(tf);
+	return tf.store;
+}
+
+void KlineResampler::clear() {
+	_source = nullptr;
+	_sourcePeriod = 0;
+	_timeframes.clear();
+}
+
+void KlineResampler::_sync(Timeframe& tf) {
+	const size_t n = _source->size();
+	if (n == 0)
+		return;
+	const int64* t = _source->getOpenTime();
+	const int64 p = tf.period;
+
+	// at most one output row per period spanned by the new rows
+	_reserve(tf, tf.numClosed + (size_t)((t[n - 1] - t[jmin(tf.consumed, n - 1)]) / p) + 2);
+
+	// whole buckets of final rows at a time
+	for (size_t r = tf.consumed; r + 1 < n;) {
+		const int64 b = floorToPeriod(t[r], p);
+		if (!tf.acc.isEmpty && b != tf.acc.openTime) {
+			_write(tf, tf.numClosed++, tf.acc);
+			tf.acc = {};
+		}
+		const size_t e = _findBucketEnd(r, n - 1, b + p);
+		_add(tf.acc, b, r, e);
+		r = e;
+	}
+	tf.consumed = jmax(tf.consumed, n - 1);
+
+	// the last source row may still be forming, it is folded into a copy
+	const int64 b = floorToPeriod(t[n - 1], p);
+	if (!tf.acc.isEmpty && b != tf.acc.openTime) {
+		_write(tf, tf.numClosed++, tf.acc);
+		tf.acc = {};
+	}
+	Candle tail = tf.acc;
+	_add(tail, b, n - 1, n);
+	_write(tf, tf.numClosed, tail);
+	tf.store->setSize(tf.numClosed + 1);
+}
+
+size_t KlineResampler::_findBucketEnd(size_t row, size_t end, int64 bucketEnd) const {
+	const int64* t = _source->getOpenTime();
+	// without gaps the end is where the source period says, checked in O(1)
+	if (_sourcePeriod > 0) {
+		const size_t guess = jlimit(row + 1, end, row + (size_t)((bucketEnd - t[row] + _sourcePeriod - 1) / _sourcePeriod));
+		if (t[guess - 1] < bucketEnd && (guess == end || t[guess] >= bucketEnd))
+			return guess;
+	}
+	return (size_t)(std::lower_bound(t + row, t + end, bucketEnd) - t);
+}
+
+void KlineResampler::_add(Candle& c, int64 bucketTime, size_t first, size_t last) const {
+	const auto& s = *_source;
+	if (first >= last)
+		return;
+	if (c.isEmpty) {
+		c.isEmpty = false;
+		c.openTime = bucketTime;
+		c.open = s.getOpen()[first];
+		c.high = s.getHigh()[first];
+		c.low = s.getLow()[first];
+	}
+	c.close = s.getClose()[last - 1];
+
+	const double* h = s.getHigh();
+	const double* l = s.getLow();
+	const double* v = s.getVolume();
+	const double* qv = s.getDoubleColumn(KlineStore::quoteVolume);
+	const int64* tr = s.getIntColumn(KlineStore::trades);
+	const double* tbv = s.getDoubleColumn(KlineStore::takerBuyBaseVolume);
+	const double* tqv = s.getDoubleColumn(KlineStore::takerBuyQuoteVolume);
+	// one pass with independent accumulators, summed in row order whatever the
+	// batch size so a synced timeframe matches a fresh one exactly
+	Candle r = c;
+	for (size_t i = first; i < last; i++) {
+		r.high = jmax(r.high, h[i]);
+		r.low = jmin(r.low, l[i]);
+		r.volume += v[i];
+		r.quoteVolume += qv[i];
+		r.trades += tr[i];
+		r.takerBuyBaseVolume += tbv[i];
+		r.takerBuyQuoteVolume += tqv[i];
+	}
+	c = r;
+}
+
+void KlineResampler::_write(Timeframe& tf, size_t row, const Candle& c) {
+	auto& s = *tf.store;
+	s.getWritableIntColumn(KlineStore::openTime)[row] = c.openTime;
+	s.getWritableDoubleColumn(KlineStore::open)[row] = c.open;
+	s.getWritableDoubleColumn(KlineStore::high)[row] = c.high;
+	s.getWritableDoubleColumn(KlineStore::low)[row] = c.low;
+	s.getWritableDoubleColumn(KlineStore::close)[row] = c.close;
+	s.getWritableDoubleColumn(KlineStore::volume)[row] = c.volume;
+	s.getWritableIntColumn(KlineStore::closeTime)[row] = c.openTime + tf.period - 1;
+	s.getWritableDoubleColumn(KlineStore::quoteVolume)[row] = c.quoteVolume;
+	s.getWritableIntColumn(KlineStore::trades)[row] = c.trades;
+	s.getWritableDoubleColumn(KlineStore::takerBuyBaseVolume)[row] = c.takerBuyBaseVolume;
+	s.getWritableDoubleColumn(KlineStore::takerBuyQuoteVolume)[row] = c.takerBuyQuoteVolume;
+}
+
+void KlineResampler::_reserve(Timeframe& tf, size_t numRows) {
+	if (tf.store && tf.store->getCapacity() >= numRows)
+		return;
+	const size_t used = tf.store ? tf.store->size() : 0;
+	auto grown = KlineStore::allocate(jmax(numRows, (tf.store ? tf.store->getCapacity() : 0) * 2));
+	for (int c = 0; c < KlineStore::numColumns; c++)
+		if (used > 0)
+			std::memcpy(grown->getWritableColumnData((KlineStore::Column)c), tf.store->getColumnData((KlineStore::Column)c), used * KlineStore::elementSize);
+	grown->setSize(used);
+	grown->setSymbol(_source->getSymbol());
+	grown->setInterval(formatInterval(tf.period));
+	tf.store = std::move(grown);
+}
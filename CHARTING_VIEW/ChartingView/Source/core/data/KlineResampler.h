@@ -0,0 +1,94 @@
+/*
+  ==============================================================================
+
+    KlineResampler.h
+    Created: 14 Oct 2026 7:02:18pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+#include "KlineStore.h"
+
+/*
+	Higher timeframes (5m, 15m, 1h, 4h, 1d...) derived from the 1m store, so a
+	timeframe switch never downloads or reloads anything.
+
+	Candles are aligned on multiples of the period since the epoch (UTC), like
+	the Binance ones : open = first open, high / low = extremes, close = last
+	close, volumes and trades are summed, close_time = open_time + period - 1.
+
+	A timeframe is aggregated on its first get() then cached. sync() folds the
+	source rows added since into every cached timeframe with a streaming
+	aggregator, O(1) per new source row : the rows before the last one are
+	final, the last one may still be forming and is re-read on every sync.
+	Outputs are owned stores that grow in place (setSize), only reallocated
+	when their capacity is exceeded.
+*/
+
+class KlineResampler {
+public:
+	struct Preset {
+		const char* name;
+		int64 period;
+	};
+	static constexpr Preset presets[] = {
+		{ "1m", 60000 }, { "5m", 300000 }, { "15m", 900000 },
+		{ "1h", 3600000 }, { "4h", 14400000 }, { "1d", 86400000 }
+	};
+
+	// "15m" -> 900000, 0 when not understood (s, m, h, d, w units)
+	static int64 parseInterval(const String& interval);
+	static String formatInterval(int64 period);
+
+	KlineResampler() = default;
+
+	// a grown version of the current source (same first open_time) keeps the caches
+	// and returns true, anything else clears them
+	bool setSource(KlineStore::Ptr source);
+	const KlineStore::Ptr& getSource() const { return _source; }
+	// open_time step of the source rows
+	int64 getSourcePeriod() const { return _sourcePeriod; }
+
+	// the source itself for periods up to getSourcePeriod(), null without source
+	KlineStore::Ptr get(int64 period);
+	// folds the new source rows into the cached timeframes, O(new rows)
+	void sync();
+	// rows of get(period) that can't change anymore, 0 when the timeframe isn't cached
+	size_t getNumClosed(int64 period) const;
+	// a timeframe saved from its closed rows (DerivedCache) instead of aggregated : only the
+	// source rows after the last closed candle are folded. closed is owned (KlineStore::allocate)
+	// and grows in place, a saving that doesn't fit the source is dropped. Returns get(period)
+	KlineStore::Ptr restore(int64 period, KlineStore::Ptr closed);
+	void clear();
+
+private:
+	struct Candle {
+		int64 openTime = 0;
+		int64 trades = 0;
+		double open = 0, high = 0, low = 0, close = 0;
+		double volume = 0, quoteVolume = 0, takerBuyBaseVolume = 0, takerBuyQuoteVolume = 0;
+		bool isEmpty = true;
+	};
+
+	struct Timeframe {
+		int64 period = 0;
+		KlineStore::Ptr store;
+		size_t numClosed = 0;     // output rows that can't change anymore
+		size_t consumed = 0;      // final source rows folded into numClosed + acc
+		Candle acc;               // final source rows of the candle after numClosed
+	};
+
+	void _sync(Timeframe& tf);
+	size_t _findBucketEnd(size_t row, size_t end, int64 bucketEnd) const;
+	// folds the source rows [first, last) into c, one column at a time
+	void _add(Candle& c, int64 bucketTime, size_t first, size_t last) const;
+	void _write(Timeframe& tf, size_t row, const Candle& c);
+	void _reserve(Timeframe& tf, size_t numRows);
+
+	KlineStore::Ptr _source;
+	int64 _sourcePeriod = 0;
+	std::vector<Timeframe> _timeframes;
+};
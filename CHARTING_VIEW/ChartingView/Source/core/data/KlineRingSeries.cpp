@@ -0,0 +1,259 @@
+/*
+  ==============================================================================
+
+    KlineRingSeries.cpp
+    Created: 14 Oct 2026 3:18:52pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "KlineRingSeries.h"
+
+static constexpr size_t cacheLine = 64;
+
+static size_t alignUp(size_t v) {
+	return (v + cacheLine - 1) & ~(cacheLine - 1);
+}
+
+KlineRingSeries::KlineRingSeries(size_t capacity) {
+	_capacity = (size_t)nextPowerOfTwo((int)jmax((size_t)minBucketsPerLevel << firstLevel, capacity));
+	_mask = _capacity - 1;
+
+	_numLevels = 1;
+	while (_numLevels < maxLevels && (_capacity >> _numLevels) >= minBucketsPerLevel)
+		_numLevels++;
+	jassert(_numLevels > firstLevel);
+
+	// one block for everything, each column / level on its own cache lines
+	const size_t columnBytes = alignUp(_capacity * sizeof(double));
+	size_t total = columnBytes * 6;
+	for (int l = firstLevel; l < _numLevels; l++)
+		total += alignUp((_capacity >> l) * sizeof(Bucket));
+	_numBytes = total + cacheLine;
+	_memory.calloc(_numBytes);
+	MemoryBudget::getInstance().add(MemoryBudget::stores, (int64)_numBytes);
+
+	char* p = reinterpret_cast<char*>(alignUp(reinterpret_cast<size_t>(_memory.get())));
+	auto take = [&p](size_t bytes) { char* r = p; p += alignUp(bytes); return r; };
+	_openTime = reinterpret_cast<int64*>(take(columnBytes));
+	_open = reinterpret_cast<double*>(take(columnBytes));
+	_high = reinterpret_cast<double*>(take(columnBytes));
+	_low = reinterpret_cast<double*>(take(columnBytes));
+	_close = reinterpret_cast<double*>(take(columnBytes));
+	_volume = reinterpret_cast<double*>(take(columnBytes));
+	for (int l = firstLevel; l < _numLevels; l++) {
+		const size_t n = _capacity >> l;
+		_levels[l].buckets = reinterpret_cast<Bucket*>(take(n * sizeof(Bucket)));
+		_levels[l].mask = n - 1;
+	}
+}
+
+KlineRingSeries::~KlineRingSeries() {
+	MemoryBudget::getInstance().add(MemoryBudget::stores, -(int64)_numBytes);
+}
+
+void KlineRingSeries::push(const Kline& k) {
+	const uint64 head = _head.load(std::memory_order_relaxed);
+	const uint32 seq = _seq.load(std::memory_order_relaxed);
+	_seq.store(seq + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	if (head == 0)
+		_originTime = k.openTime;
+	_write(head, k);
+	_updateTail(head);
+	_head.store(head + 1, std::memory_order_release);
+
+	_seq.store(seq + 2, std::memory_order_release);
+}
+
+void KlineRingSeries::update(const Kline& k) {
+	const uint64 head = _head.load(std::memory_order_relaxed);
+	if (head == 0 || k.openTime > _openTime[(head - 1) & _mask]) {
+		push(k);
+		return;
+	}
+	if (k.openTime < _openTime[(head - 1) & _mask])
+		return;
+
+	const uint32 seq = _seq.load(std::memory_order_relaxed);
+	_seq.store(seq + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	_write(head - 1, k);
+	_updateTail(head - 1);
+
+	_seq.store(seq + 2, std::memory_order_release);
+}
+
+void KlineRingSeries::_write(uint64 row, const Kline& k) {
+	const size_t i = (size_t)(row & _mask);
+	_openTime[i] = k.openTime;
+	_open[i] = k.open;
+	_high[i] = k.high;
+	_low[i] = k.low;
+	_close[i] = k.close;
+	_volume[i] = k.volume;
+}
+
+void KlineRingSeries::_updateTail(uint64 row) {
+	for (int l = firstLevel; l < _numLevels; l++) {
+		const uint64 b = row >> l;
+		_levels[l].buckets[b & _levels[l].mask] = _computeBucket(l, b, row);
+	}
+}
+
+KlineRingSeries::Bucket KlineRingSeries::_computeBucket(int level, uint64 bucket, uint64 lastRow) const {
+	if (level == firstLevel) {
+		const uint64 first = bucket << level;
+		const uint64 last = jmin(((bucket + 1) << level) - 1, lastRow);
+		const size_t i0 = (size_t)(first & _mask);
+		Bucket r{ _open[i0], _high[i0], _low[i0], _close[i0] };
+		for (uint64 row = first + 1; row <= last; row++) {
+			const size_t i = (size_t)(row & _mask);
+			r.merge({ _open[i], _high[i], _low[i], _close[i] });
+		}
+		return r;
+	}
+	// merge the two children, the second one may not exist yet
+	const int child = level - 1;
+	Bucket r = _bucketAt(child, bucket * 2);
+	if (((bucket * 2 + 1) << child) <= lastRow)
+		r.merge(_bucketAt(child, bucket * 2 + 1));
+	return r;
+}
+
+KlineRingSeries::Bucket KlineRingSeries::_bucketAt(int level, uint64 bucket) const {
+	return _levels[level].buckets[bucket & _levels[level].mask];
+}
+
+KlineRingSeries::Snapshot KlineRingSeries::getSnapshot() const {
+	Snapshot s;
+	s._series = this;
+	s._numLevels = _numLevels;
+	for (;;) {
+		const uint32 seq = _seq.load(std::memory_order_acquire);
+		if (seq & 1) {
+			Thread::yield();
+			continue;
+		}
+		const uint64 head = _head.load(std::memory_order_relaxed);
+		s.end = head;
+		s.originTime = _originTime;
+		if (head > 0) {
+			const uint64 last = head - 1;
+			const size_t i = (size_t)(last & _mask);
+			s._last = { _openTime[i], _open[i], _high[i], _low[i], _close[i], _volume[i] };
+			for (int l = firstLevel; l < _numLevels; l++)
+				s._tails[l] = _bucketAt(l, last >> l);
+		}
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (_seq.load(std::memory_order_relaxed) == seq)
+			break;
+	}
+	const uint64 usable = (uint64)(_capacity - _capacity / 8);
+	s.begin = s.end > usable ? s.end - usable : 0;
+	return s;
+}
+
+//==============================================================================
+int64 KlineRingSeries::Snapshot::getOpenTime(uint64 row) const {
+	jassert(row >= begin && row < end);
+	return row + 1 == end ? _last.openTime : _series->_openTime[row & _series->_mask];
+}
+
+KlineRingSeries::Kline KlineRingSeries::Snapshot::getRow(uint64 row) const {
+	jassert(row >= begin && row < end);
+	if (row + 1 == end)
+		return _last;
+	const size_t i = (size_t)(row & _series->_mask);
+	const auto& r = *_series;
+	return { r._openTime[i], r._open[i], r._high[i], r._low[i], r._close[i], r._volume[i] };
+}
+
+double KlineRingSeries::Snapshot::getVolume(uint64 row) const {
+	return row + 1 == end ? _last.volume : _series->_volume[row & _series->_mask];
+}
+
+KlineRingSeries::Bucket KlineRingSeries::Snapshot::getBucket(int level, uint64 bucket) const {
+	if (level < firstLevel) {
+		const auto k = getRow(bucket);
+		return { k.open, k.high, k.low, k.close };
+	}
+	if (bucket == ((end - 1) >> level))
+		return _tails[level];
+	return _series->_bucketAt(level, bucket);
+}
+
+int KlineRingSeries::Snapshot::chooseLevel(double maxRowsPerBucket) const {
+	if (maxRowsPerBucket < (double)((uint64)1 << firstLevel))
+		return 0;
+	int level = firstLevel;
+	while (level + 1 < _numLevels && (double)((uint64)1 << (level + 1)) <= maxRowsPerBucket)
+		level++;
+	return level;
+}
+
+uint64 KlineRingSeries::Snapshot::lowerBound(int64 time) const {
+	return TimeSearch::lowerBound([this](uint64 row) { return getOpenTime(row); }, begin, end, time);
+}
+
+uint64 KlineRingSeries::Snapshot::upperBound(int64 time) const {
+	return TimeSearch::upperBound([this](uint64 row) { return getOpenTime(row); }, begin, end, time);
+}
+
+SeriesRange KlineRingSeries::Snapshot::findRange(int64 startTime, int64 endTime) const {
+	return TimeSearch::findRange([this](uint64 row) { return getOpenTime(row); }, begin, end, startTime, endTime);
+}
+
+Range<double> KlineRingSeries::Snapshot::computePriceRange(uint64 first, uint64 last) const {
+	first = jmax(first, begin);
+	last = jmin(last, end);
+	double low = std::numeric_limits<double>::infinity();
+	double high = -low;
+	if (first < last) {
+		// start where at most two buckets fit in the range
+		int level = 0;
+		while (level + 1 < _numLevels && ((uint64)2 << level) <= last - first)
+			level++;
+		_accumulate(level, first, last, low, high);
+	}
+	return low <= high ? Range<double>(low, high) : Range<double>();
+}
+
+void KlineRingSeries::Snapshot::_accumulate(int level, uint64 first, uint64 last, double& low, double& high) const {
+	if (first >= last)
+		return;
+	if (level < firstLevel) {
+		// a few rows at the edges
+		for (uint64 i = first; i < last; i++) {
+			const auto k = getRow(i);
+			low = jmin(low, k.low);
+			high = jmax(high, k.high);
+		}
+		return;
+	}
+	// whole buckets inside the range, the tail one from the snapshot
+	const uint64 a = (first + ((uint64)1 << level) - 1) >> level;
+	const uint64 b = last >> level;
+	if (a >= b) {
+		_accumulate(level - 1, first, last, low, high);
+		return;
+	}
+	for (uint64 i = a; i < b; i++) {
+		const auto bucket = getBucket(level, i);
+		low = jmin(low, bucket.low);
+		high = jmax(high, bucket.high);
+	}
+	_accumulate(level - 1, first, a << level, low, high);
+	_accumulate(level - 1, b << level, last, low, high);
+}
+
+uint64 KlineRingSeries::Snapshot::getFirstChangedRow(const Snapshot& previous) const {
+	if (previous._series != _series || previous.isEmpty() || previous.originTime != originTime || previous.end > end)
+		return begin;
+	if (previous.end == end && previous._last == _last)
+		return end;
+	return jmax(begin, previous.end - 1);
+}
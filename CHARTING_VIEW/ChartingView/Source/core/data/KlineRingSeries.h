@@ -0,0 +1,137 @@
+/*
+  ==============================================================================
+
+    KlineRingSeries.h
+    Created: 14 Oct 2026 3:18:52pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+#include "LodPyramid.h"
+#include "SeriesRange.h"
+
+/*
+	Fixed capacity ring of klines for live views, single producer / single
+	consumer : a feed thread pushes closed candles and updates the forming one,
+	the paint path reads a Snapshot. Nothing is reallocated once constructed.
+
+	Rows are addressed by their logical index (number of rows pushed before
+	them). The series keeps its own min/max pyramid as rings too, a push or an
+	update only recomputes the tail bucket of each level.
+
+	Consistency : the forming row and the tail buckets are read through a
+	sequence lock (copied in the Snapshot), older rows are immutable until the
+	ring wraps. A Snapshot leaves getCapacity() / 8 rows of margin, so it stays
+	valid as long as the producer pushes less than that while it is used.
+
+	The ring counts in MemoryBudget::stores.
+*/
+
+class KlineRingSeries {
+public:
+	using Ptr = SPtr<KlineRingSeries>;
+	using Bucket = LodPyramid::Bucket;
+
+	struct Kline {
+		int64 openTime = 0;
+		double open = 0, high = 0, low = 0, close = 0, volume = 0;
+
+		bool operator==(const Kline&) const = default;
+	};
+
+	static constexpr int firstLevel = LodPyramid::firstLevel;
+	static constexpr int maxLevels = 40;
+	static constexpr size_t minBucketsPerLevel = 16;
+
+	class Snapshot {
+	public:
+		// logical rows [begin, end), end - 1 is the forming candle
+		uint64 begin = 0;
+		uint64 end = 0;
+		int64 originTime = 0;
+
+		size_t size() const { return (size_t)(end - begin); }
+		bool isEmpty() const { return end == begin; }
+
+		int64 getOpenTime(uint64 row) const;
+		Kline getRow(uint64 row) const;
+		double getVolume(uint64 row) const;
+		// rows of level 0 are returned as single row buckets
+		Bucket getBucket(int level, uint64 bucket) const;
+
+		int getNumLevels() const { return _numLevels; }
+		int chooseLevel(double maxRowsPerBucket) const;
+
+		// first row with openTime >= time / > time
+		uint64 lowerBound(int64 time) const;
+		uint64 upperBound(int64 time) const;
+		SeriesRange findRange(int64 startTime, int64 endTime) const;
+		// exact low / high of rows [first, last) from the pyramid, as LodPyramid::computePriceRange.
+		// Range() when there is none
+		Range<double> computePriceRange(uint64 first, uint64 last) const;
+
+		// first row that may differ from an older snapshot of the same series : rows
+		// before its forming candle are final. end when nothing changed, begin when unrelated
+		uint64 getFirstChangedRow(const Snapshot& previous) const;
+
+	private:
+		friend class KlineRingSeries;
+		void _accumulate(int level, uint64 first, uint64 last, double& low, double& high) const;
+
+		const KlineRingSeries* _series = nullptr;
+		Kline _last;
+		Bucket _tails[maxLevels];
+		int _numLevels = 0;
+	};
+
+	// capacity is rounded up to a power of two
+	explicit KlineRingSeries(size_t capacity);
+	~KlineRingSeries();
+
+	size_t getCapacity() const { return _capacity; }
+	// total number of rows pushed so far
+	uint64 getNumPushed() const { return _head.load(std::memory_order_acquire); }
+
+	// producer thread only
+	void push(const Kline& k);
+	// replaces the forming candle when open_time matches, pushes a newer one, ignores older ones
+	void update(const Kline& k);
+
+	// consumer side, any thread
+	Snapshot getSnapshot() const;
+
+private:
+	struct LevelRing {
+		Bucket* buckets = nullptr;
+		uint64 mask = 0;
+	};
+
+	void _write(uint64 row, const Kline& k);
+	void _updateTail(uint64 row);
+	Bucket _computeBucket(int level, uint64 bucket, uint64 lastRow) const;
+	Bucket _bucketAt(int level, uint64 bucket) const;
+
+	size_t _capacity = 0;
+	uint64 _mask = 0;
+	int _numLevels = 0;
+	int64 _originTime = 0;
+
+	HeapBlock<char> _memory;
+	size_t _numBytes = 0; // of _memory, in MemoryBudget::stores
+	int64* _openTime = nullptr;
+	double* _open = nullptr;
+	double* _high = nullptr;
+	double* _low = nullptr;
+	double* _close = nullptr;
+	double* _volume = nullptr;
+	LevelRing _levels[maxLevels];
+
+	// written by the producer, kept away from the read-mostly fields above
+	alignas(64) std::atomic<uint64> _head{ 0 };
+	alignas(64) std::atomic<uint32> _seq{ 0 };
+
+	JUCE_DECLARE_NON_COPYABLE(KlineRingSeries)
+};
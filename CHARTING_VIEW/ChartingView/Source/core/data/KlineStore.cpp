@@ -0,0 +1,159 @@
+/*
+  ==============================================================================
+
+    KlineStore.cpp
+    Created: 14 Oct 2026 9:12:03am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "KlineStore.h"
+
+bool KlineStore::isIntegerColumn(Column c) {
+	return c == openTime || c == closeTime || c == trades;
+}
+
+String KlineStore::getColumnFileName(Column c) {
+	static const char* names[numColumns] = {
+		"open_time", "open", "high", "low", "close", "volume",
+		"close_time", "quote_asset_volume", "number_of_trades",
+		"taker_buy_base_asset_volume", "taker_buy_quote_asset_volume"
+	};
+	return String(names[c]) + (isIntegerColumn(c) ? ".i64" : ".f64");
+}
+
+KlineStore::Ptr KlineStore::openMapped(const File& directory) {
+	Ptr store(new KlineStore());
+	size_t numRows = std::numeric_limits<size_t>::max();
+
+	for (int c = 0; c < numColumns; c++) {
+		const auto f = directory.getChildFile(getColumnFileName((Column)c));
+		if (!f.existsAsFile())
+			return nullptr;
+		auto map = std::make_unique<MemoryMappedFile>(f, MemoryMappedFile::readOnly);
+		if (map->getData() == nullptr && f.getSize() > 0)
+			return nullptr;
+		numRows = jmin(numRows, map->getSize() / elementSize);
+		store->_columns[c] = map->getData();
+		store->_maps.push_back(std::move(map));
+	}
+
+	store->_numRows = store->_capacity = numRows;
+	return store;
+}
+
+KlineStore::Ptr KlineStore::allocate(size_t numRows, MemoryBudget::Subsystem subsystem) {
+	Ptr store(new KlineStore());
+	store->_ownedBytes = jmax((size_t)1, numRows) * elementSize * numColumns;
+	store->_owned.malloc(store->_ownedBytes);
+	store->_budgetSubsystem = subsystem;
+	MemoryBudget::getInstance().add(subsystem, (int64)store->_ownedBytes);
+	for (int c = 0; c < numColumns; c++)
+		store->_columns[c] = store->_owned.get() + (size_t)c * numRows * elementSize;
+	store->_numRows = store->_capacity = numRows;
+	return store;
+}
+
+KlineStore::Ptr KlineStore::wrapMapped(UPtr<MemoryMappedFile> map, const void* const* columns, size_t numRows) {
+	if (map == nullptr || map->getData() == nullptr)
+		return nullptr;
+	Ptr store(new KlineStore());
+	for (int c = 0; c < numColumns; c++)
+		store->_columns[c] = columns[c];
+	store->_maps.push_back(std::move(map));
+	store->_numRows = store->_capacity = numRows;
+	return store;
+}
+
+KlineStore::Ptr KlineStore::wrapExternal(SPtr<void> owner, const void* const* columns, size_t numRows) {
+	Ptr store(new KlineStore());
+	store->_owner = std::move(owner);
+	for (int c = 0; c < numColumns; c++) {
+		if (columns[c] == nullptr && store->_owned.get() == nullptr) {
+			store->_ownedBytes = jmax((size_t)1, numRows) * elementSize;
+			store->_owned.calloc(store->_ownedBytes);
+			MemoryBudget::getInstance().add(store->_budgetSubsystem, (int64)store->_ownedBytes);
+		}
+		store->_columns[c] = columns[c] != nullptr ? columns[c] : store->_owned.get();
+	}
+	store->_numRows = store->_capacity = numRows;
+	return store;
+}
+
+KlineStore::~KlineStore() {
+	if (_ownedBytes > 0)
+		MemoryBudget::getInstance().add(_budgetSubsystem, -(int64)_ownedBytes);
+}
+
+bool KlineStore::saveColumns(const File& directory) const {
+	if (directory.createDirectory().failed())
+		return false;
+	for (int c = 0; c < numColumns; c++) {
+		const auto f = directory.getChildFile(getColumnFileName((Column)c));
+		if (!f.replaceWithData(_columns[c], _numRows * elementSize))
+			return false;
+	}
+	return true;
+}
+
+void* KlineStore::getWritableColumnData(Column c) {
+	jassert(!isMapped());
+	return isMapped() ? nullptr : const_cast<void*>(_columns[c]);
+}
+
+void KlineStore::setSize(size_t numRows) {
+	jassert(!isMapped() && numRows <= _capacity);
+	_numRows = jmin(numRows, _capacity);
+}
+
+Range<double> KlineStore::computePriceRange(size_t first, size_t last) const {
+	last = jmin(last, _numRows);
+	if (first >= last)
+		return {};
+	const double* lo = getLow();
+	const double* hi = getHigh();
+	double minV = lo[first], maxV = hi[first];
+	for (size_t i = first + 1; i < last; i++) {
+		minV = jmin(minV, lo[i]);
+		maxV = jmax(maxV, hi[i]);
+	}
+	return { minV, maxV };
+}
+
+void KlineStore::setTimeIndex(const int64* index, size_t indexSize, size_t stride) {
+	_timeIndex = stride > 0 ? index : nullptr;
+	_timeIndexSize = indexSize;
+	_timeIndexStride = stride;
+}
+
+uint64 KlineStore::_search(int64 time, bool upper) const {
+	const int64* t = getOpenTime();
+	auto timeAt = [t](uint64 row) { return t[row]; };
+	uint64 first = 0, last = _numRows;
+	if (_timeIndex != nullptr && _timeIndexSize > 0) {
+		// narrow down to one block with the index (stays in cache and touches a single page of the column)
+		const int64* idx = _timeIndex;
+		const size_t block = (size_t)(upper
+			? std::upper_bound(idx, idx + _timeIndexSize, time) - idx
+			: std::lower_bound(idx, idx + _timeIndexSize, time) - idx);
+		first = block > 0 ? (uint64)((block - 1) * _timeIndexStride) : 0;
+		last = jmin((uint64)_numRows, (uint64)(block * _timeIndexStride + 1));
+	}
+	return TimeSearch::search(timeAt, first, last, time, upper);
+}
+
+size_t KlineStore::lowerBound(int64 time) const {
+	return (size_t)_search(time, false);
+}
+
+size_t KlineStore::upperBound(int64 time) const {
+	return (size_t)_search(time, true);
+}
+
+SeriesRange KlineStore::findRange(int64 startTime, int64 endTime) const {
+	SeriesRange r;
+	r.first = _search(startTime, false);
+	r.last = jmax(r.first, _search(endTime, true));
+	return r;
+}
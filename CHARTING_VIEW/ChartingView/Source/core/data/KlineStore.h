@@ -0,0 +1,126 @@
+/*
+  ==============================================================================
+
+    KlineStore.h
+    Created: 14 Oct 2026 9:12:03am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+#include "SeriesRange.h"
+#include "../utils/MemoryBudget.h"
+
+/*
+	Column store for klines (struct-of-arrays), one column per Binance field.
+
+	Columns are either memory mapped (zero copy, the OS only pages in what is
+	actually read) or owned (e.g. the result of a csv parse). Owned columns
+	count in the MemoryBudget.
+	Every column is 8 bytes per row (int64 or double), rows sorted by open_time.
+
+	On-disk layout of a mapped store: one directory, one raw file per column
+		<dir>/open_time.i64, <dir>/open.f64, ...
+*/
+
+class KlineStore {
+public:
+	using Ptr = SPtr<KlineStore>;
+
+	enum Column {
+		openTime = 0,
+		open,
+		high,
+		low,
+		close,
+		volume,
+		closeTime,
+		quoteVolume,
+		trades,
+		takerBuyBaseVolume,
+		takerBuyQuoteVolume,
+		numColumns
+	};
+
+	static constexpr size_t elementSize = 8;
+
+	static bool isIntegerColumn(Column c);
+	static String getColumnFileName(Column c);
+
+	// zero-copy open of a column directory previously written by saveColumns()
+	static Ptr openMapped(const File& directory);
+	// owned, writable storage for numRows rows (contents uninitialised), its bytes counted in subsystem
+	static Ptr allocate(size_t numRows, MemoryBudget::Subsystem subsystem = MemoryBudget::stores);
+	// columns living inside an already mapped file (see KlineFile), the store keeps the mapping alive
+	static Ptr wrapMapped(UPtr<MemoryMappedFile> map, const void* const* columns, size_t numRows);
+	// read-only columns owned by someone else (e.g. a SharedSeries), kept alive by owner,
+	// null columns read as zeros
+	static Ptr wrapExternal(SPtr<void> owner, const void* const* columns, size_t numRows);
+
+	~KlineStore();
+
+	bool saveColumns(const File& directory) const;
+
+	size_t size() const { return _numRows; }
+	// rows an owned store can grow to with setSize()
+	size_t getCapacity() const { return _capacity; }
+	bool isEmpty() const { return _numRows == 0; }
+	bool isMapped() const { return !_maps.empty() || _owner != nullptr; }
+
+	const String& getSymbol() const { return _symbol; }
+	const String& getInterval() const { return _interval; }
+	void setSymbol(const String& s) { _symbol = s; }
+	void setInterval(const String& s) { _interval = s; }
+
+	const void* getColumnData(Column c) const { return _columns[c]; }
+	const int64* getIntColumn(Column c) const { jassert(isIntegerColumn(c)); return static_cast<const int64*>(_columns[c]); }
+	const double* getDoubleColumn(Column c) const { jassert(!isIntegerColumn(c)); return static_cast<const double*>(_columns[c]); }
+
+	const int64* getOpenTime() const { return getIntColumn(openTime); }
+	const double* getOpen() const { return getDoubleColumn(open); }
+	const double* getHigh() const { return getDoubleColumn(high); }
+	const double* getLow() const { return getDoubleColumn(low); }
+	const double* getClose() const { return getDoubleColumn(close); }
+	const double* getVolume() const { return getDoubleColumn(volume); }
+
+	// only valid for owned stores
+	void* getWritableColumnData(Column c);
+	int64* getWritableIntColumn(Column c) { return static_cast<int64*>(getWritableColumnData(c)); }
+	double* getWritableDoubleColumn(Column c) { return static_cast<double*>(getWritableColumnData(c)); }
+	// changes the visible row count of an owned store, up to getCapacity() (no reallocation)
+	void setSize(size_t numRows);
+
+	int64 getFirstOpenTime() const { return _numRows > 0 ? getOpenTime()[0] : 0; }
+	int64 getLastOpenTime() const { return _numRows > 0 ? getOpenTime()[_numRows - 1] : 0; }
+	Range<double> computePriceRange(size_t first, size_t last) const;
+
+	// optional sparse index : index[i] = open_time of row i * stride
+	void setTimeIndex(const int64* index, size_t indexSize, size_t stride);
+	// first row with open_time >= time / > time
+	size_t lowerBound(int64 time) const;
+	size_t upperBound(int64 time) const;
+	// rows whose open_time is in [startTime, endTime], O(log n)
+	SeriesRange findRange(int64 startTime, int64 endTime) const;
+
+private:
+	KlineStore() = default;
+	uint64 _search(int64 time, bool upper) const;
+
+	size_t _numRows = 0;
+	size_t _capacity = 0;
+	const void* _columns[numColumns] = {};
+	std::vector<UPtr<MemoryMappedFile>> _maps;
+	HeapBlock<char> _owned;
+	size_t _ownedBytes = 0;
+	MemoryBudget::Subsystem _budgetSubsystem = MemoryBudget::stores;
+	SPtr<void> _owner;
+	const int64* _timeIndex = nullptr;
+	size_t _timeIndexSize = 0;
+	size_t _timeIndexStride = 0;
+	String _symbol;
+	String _interval;
+
+	JUCE_DECLARE_NON_COPYABLE(KlineStore)
+};
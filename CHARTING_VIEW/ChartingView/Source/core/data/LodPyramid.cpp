@@ -0,0 +1,327 @@
+/*
+  ==============================================================================
+
+    LodPyramid.cpp
+    Created: 14 Oct 2026 2:05:31pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "LodPyramid.h"
+#include "../utils/TaskPool.h"
+
+// LogScale::minValue : prices <= 0 are drawn at the bottom
+static constexpr double minLogPrice = 1e-300;
+
+LodPyramid::LodPyramid(const KlineStore& store) {
+	build(store);
+}
+
+LodPyramid::~LodPyramid() {
+	MemoryBudget::getInstance().add(MemoryBudget::lodLevels, -(int64)_numBytes);
+}
+
+void LodPyramid::clear() {
+	_store = nullptr;
+	_numRows = 0;
+	_numLevels = 0;
+	_levels.clear();
+	_logLevels.clear();
+	_released = false;
+	_account();
+}
+
+void LodPyramid::build(const KlineStore& store) {
+	clear();
+	_store = &store;
+	_numRows = store.size();
+	_compute(0);
+}
+
+bool LodPyramid::restore(const KlineStore& store, size_t numRows, std::vector<std::vector<double>> columns) {
+	clear();
+	if (numRows > store.size() || columns.size() % 4 != 0)
+		return false;
+	// the sizes _compute() gives : none up to one bucket of rows, then halved down to a single bucket
+	const size_t bucket = (size_t)1 << firstLevel;
+	std::vector<Storage> levels(columns.size() / 4);
+	size_t size = numRows > bucket ? (numRows + bucket - 1) / bucket : 0;
+	for (size_t k = 0; k < levels.size(); k++) {
+		for (size_t c = 0; c < 4; c++)
+			if (size == 0 || columns[k * 4 + c].size() != size)
+				return false;
+		levels[k].open = std::move(columns[k * 4]);
+		levels[k].high = std::move(columns[k * 4 + 1]);
+		levels[k].low = std::move(columns[k * 4 + 2]);
+		levels[k].close = std::move(columns[k * 4 + 3]);
+		size = size > 1 ? (size + 1) / 2 : 0;
+	}
+	if (size != 0)
+		return false;
+
+	_store = &store;
+	_numRows = numRows;
+	_levels = std::move(levels);
+	_numLevels = _levels.empty() ? (numRows > 0 ? 1 : 0) : firstLevel + (int)_levels.size();
+	if (_logPrices)
+		_computeLog(0);
+	_account();
+	return true;
+}
+
+void LodPyramid::update(const KlineStore& store, size_t fromRow) {
+	if (_store == nullptr || fromRow == 0 || store.size() < _numRows) {
+		build(store);
+		return;
+	}
+	_store = &store;
+	if (_released) {
+		// rebuilt whole by restoreFineLevels()
+		_numRows = store.size();
+		return;
+	}
+	fromRow = jmin(fromRow, _numRows);
+	_numRows = store.size();
+	_compute(fromRow);
+}
+
+void LodPyramid::_compute(size_t fromRow) {
+	_numLevels = _numRows > 0 ? 1 : 0;
+	if (_numRows <= ((size_t)1 << firstLevel)) {
+		_levels.clear();
+		_logLevels.clear();
+		_account();
+		return;
+	}
+
+	// first level straight from the rows
+	size_t from = fromRow >> firstLevel;
+	{
+		const size_t bucket = (size_t)1 << firstLevel;
+		const size_t size = (_numRows + bucket - 1) / bucket;
+		const double* o = _store->getOpen();
+		const double* h = _store->getHigh();
+		const double* l = _store->getLow();
+		const double* c = _store->getClose();
+
+		if (_levels.empty())
+			_levels.emplace_back();
+		Storage& s = _levels[0];
+		s.resize(size);
+		// the only pass over every row, split on the pool for a full build (live updates touch a few buckets)
+		TaskPool::getInstance().parallelFor(size - from, parallelGrain, [&](size_t firstBucket, size_t lastBucket) {
+			for (size_t i = from + firstBucket; i < from + lastBucket; i++) {
+				const size_t first = i * bucket;
+				const size_t last = jmin(first + bucket, _numRows);
+				double hi = h[first], lo = l[first];
+				for (size_t r = first + 1; r < last; r++) {
+					hi = jmax(hi, h[r]);
+					lo = jmin(lo, l[r]);
+				}
+				s.open[i] = o[first];
+				s.high[i] = hi;
+				s.low[i] = lo;
+				s.close[i] = c[last - 1];
+			}
+		});
+	}
+
+	// then each level merges pairs of the previous one, from the parent of the first changed bucket
+	size_t level = 0;
+	while (_levels[level].size() > 1) {
+		if (level + 1 == _levels.size())
+			_levels.emplace_back();
+		const Storage& p = _levels[level];
+		Storage& s = _levels[level + 1];
+		const size_t prevSize = p.size();
+		const size_t size = (prevSize + 1) / 2;
+		from >>= 1;
+		s.resize(size);
+		for (size_t i = from; i < size; i++) {
+			const size_t a = i * 2;
+			const size_t b = jmin(a + 1, prevSize - 1);
+			s.open[i] = p.open[a];
+			s.high[i] = jmax(p.high[a], p.high[b]);
+			s.low[i] = jmin(p.low[a], p.low[b]);
+			s.close[i] = p.close[b];
+		}
+		level++;
+	}
+	_levels.resize(level + 1);
+
+	_numLevels = firstLevel + (int)_levels.size();
+	if (_logPrices)
+		_computeLog(fromRow);
+	_account();
+}
+
+void LodPyramid::_computeLog(size_t fromRow) {
+	_logLevels.resize(_levels.size());
+	for (size_t k = 0; k < _levels.size(); k++) {
+		const Storage& p = _levels[k];
+		Storage& s = _logLevels[k];
+		const size_t from = jmin(fromRow >> (firstLevel + (int)k), p.size());
+		s.resize(p.size());
+		TaskPool::getInstance().parallelFor(p.size() - from, parallelGrain, [&](size_t first, size_t last) {
+			for (size_t i = from + first; i < from + last; i++) {
+				s.open[i] = std::log(jmax(p.open[i], minLogPrice));
+				s.high[i] = std::log(jmax(p.high[i], minLogPrice));
+				s.low[i] = std::log(jmax(p.low[i], minLogPrice));
+				s.close[i] = std::log(jmax(p.close[i], minLogPrice));
+			}
+		});
+	}
+}
+
+void LodPyramid::setLogPricesEnabled(bool shouldBeEnabled) {
+	if (shouldBeEnabled == _logPrices)
+		return;
+	_logPrices = shouldBeEnabled;
+	if (_released)
+		_logLevels.clear();
+	else if (_logPrices)
+		_computeLog(0);
+	else
+		_logLevels = {};
+	_account();
+}
+
+size_t LodPyramid::releaseFineLevels() {
+	// the coarsest level stays, a pyramid of a few levels keeps at least one
+	const size_t n = jmin((size_t)numFineLevels, _levels.size() > 0 ? _levels.size() - 1 : 0);
+	if (_released || n == 0)
+		return 0;
+	const size_t before = _numBytes;
+	for (size_t k = 0; k < n; k++) {
+		_levels[k] = {};
+		if (k < _logLevels.size())
+			_logLevels[k] = {};
+	}
+	_released = true;
+	_account();
+	return before - _numBytes;
+}
+
+void LodPyramid::restoreFineLevels() {
+	if (!_released)
+		return;
+	_released = false;
+	if (_store == nullptr)
+		return;
+	_compute(0);
+}
+
+void LodPyramid::_account() {
+	size_t bytes = 0;
+	for (const auto& s : _levels)
+		bytes += s.getNumBytes();
+	for (const auto& s : _logLevels)
+		bytes += s.getNumBytes();
+	MemoryBudget::getInstance().add(MemoryBudget::lodLevels, (int64)bytes - (int64)_numBytes);
+	_numBytes = bytes;
+}
+
+LodPyramid::Level LodPyramid::getLevel(int level) const {
+	Level r;
+	if (_store == nullptr || level < 0 || level >= _numLevels)
+		return r;
+	r.shift = level;
+	if (level < firstLevel) {
+		// intermediate levels are not stored, fall back to the rows
+		r.shift = 0;
+		r.size = _numRows;
+		r.open = _store->getOpen();
+		r.high = _store->getHigh();
+		r.low = _store->getLow();
+		r.close = _store->getClose();
+		return r;
+	}
+	const Storage& s = _levels[(size_t)(level - firstLevel)];
+	r.size = s.open.size();
+	r.open = s.open.data();
+	r.high = s.high.data();
+	r.low = s.low.data();
+	r.close = s.close.data();
+	return r;
+}
+
+Range<double> LodPyramid::computePriceRange(size_t first, size_t last) const {
+	if (_store == nullptr)
+		return {};
+	last = jmin(last, _store->size());
+	double low = std::numeric_limits<double>::infinity();
+	double high = -low;
+	if (_released) {
+		// the fine levels are missing, the coarse ones alone would not split
+		_accumulate(0, first, last, low, high);
+	}
+	else if (first < last) {
+		// start where at most two buckets fit in the range
+		int level = 0;
+		while (level + 1 < _numLevels && ((size_t)2 << level) <= last - first)
+			level++;
+		const size_t split = jmin(last, _numRows);
+		_accumulate(level, first, split, low, high);
+		_accumulate(0, jmax(first, split), last, low, high);
+	}
+	return low <= high ? Range<double>(low, high) : Range<double>();
+}
+
+void LodPyramid::_accumulate(int level, size_t first, size_t last, double& low, double& high) const {
+	if (first >= last)
+		return;
+	if (level < firstLevel) {
+		// a few rows at the edges (or the released levels)
+		const double* lo = _store->getLow();
+		const double* hi = _store->getHigh();
+		for (size_t i = first; i < last; i++) {
+			// false for NaN
+			if (lo[i] < low) low = lo[i];
+			if (hi[i] > high) high = hi[i];
+		}
+		return;
+	}
+	const Storage& s = _levels[(size_t)(level - firstLevel)];
+	const size_t bucket = (size_t)1 << level;
+	// whole buckets inside the range (a partial last bucket ends past it)
+	const size_t a = (first + bucket - 1) >> level;
+	const size_t b = last >> level;
+	if (a >= b) {
+		_accumulate(level - 1, first, last, low, high);
+		return;
+	}
+	for (size_t i = a; i < b; i++) {
+		if (std::isnan(s.low[i]) || std::isnan(s.high[i])) {
+			_accumulate(level - 1, i << level, (i + 1) << level, low, high);
+			continue;
+		}
+		low = jmin(low, s.low[i]);
+		high = jmax(high, s.high[i]);
+	}
+	_accumulate(level - 1, first, a << level, low, high);
+	_accumulate(level - 1, b << level, last, low, high);
+}
+
+LodPyramid::Level LodPyramid::getLogLevel(int level) const {
+	Level r;
+	if (!_logPrices || level < firstLevel || level >= _numLevels)
+		return r;
+	const Storage& s = _logLevels[(size_t)(level - firstLevel)];
+	r.shift = level;
+	r.size = s.open.size();
+	r.open = s.open.data();
+	r.high = s.high.data();
+	r.low = s.low.data();
+	r.close = s.close.data();
+	return r;
+}
+
+int LodPyramid::chooseLevel(double maxRowsPerBucket) const {
+	if (_numLevels <= firstLevel || maxRowsPerBucket < (double)((size_t)1 << firstLevel))
+		return 0;
+	int level = firstLevel;
+	while (level + 1 < _numLevels && (double)((size_t)1 << (level + 1)) <= maxRowsPerBucket)
+		level++;
+	return level;
+}
@@ -0,0 +1,143 @@
+/*
+  ==============================================================================
+
+    LodPyramid.h
+    Created: 14 Oct 2026 2:05:31pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+#include "KlineStore.h"
+#include "../utils/MemoryBudget.h"
+
+/*
+	Multi-resolution view of a KlineStore, used to draw a bounded number of
+	primitives whatever the number of rows in the visible range.
+
+	Level k merges 2^k consecutive rows into one bucket :
+		open = first open, high = max, low = min, close = last close
+	Level 0 is the store itself, levels start at firstLevel (4 rows per bucket)
+	and stop when a single bucket is left. The last bucket of a level may be
+	partial. Total memory is about half of the 4 price columns.
+
+	For a log price axis the stored levels can also keep the log of their
+	prices (same buckets, the log is monotonic). They are computed once with
+	the levels, so drawing a frame maps them with the linear FMA instead of a
+	log per point. The row levels have no log copy, the few rows they show per
+	frame are mapped with the log.
+
+	The levels are also a segment tree of the rows (bucket i of level k is
+	buckets 2i and 2i + 1 of level k - 1) : computePriceRange() answers the
+	low / high of any row range from at most two buckets per level, O(log n)
+	whatever the zoom, for the y autoscale of every frame. Buckets holding a
+	NaN (indicator warm-up wrapped by WChartCurve) are split down to the rows.
+
+	The levels count in MemoryBudget::lodLevels. The owner of a pyramid off
+	screen can free its numFineLevels finest stored levels (most of its
+	memory) with releaseFineLevels() : until restoreFineLevels() rebuilds
+	them, update() only follows the store and the levels must not be read.
+*/
+
+class LodPyramid {
+public:
+	static constexpr int firstLevel = 2;
+	// first level buckets per pool task
+	static constexpr size_t parallelGrain = 1 << 16;
+	// stored levels freed by releaseFineLevels(), 7/8 of the level memory
+	static constexpr int numFineLevels = 3;
+
+	struct Bucket {
+		double open = 0, high = 0, low = 0, close = 0;
+
+		Bucket& merge(const Bucket& next) {
+			high = jmax(high, next.high);
+			low = jmin(low, next.low);
+			close = next.close;
+			return *this;
+		}
+	};
+
+	struct Level {
+		int shift = 0; // bucket i covers rows [i << shift, (i + 1) << shift)
+		size_t size = 0;
+		const double* open = nullptr;
+		const double* high = nullptr;
+		const double* low = nullptr;
+		const double* close = nullptr;
+
+		size_t getBucketSize() const { return (size_t)1 << shift; }
+		size_t getFirstRow(size_t bucket) const { return bucket << shift; }
+		Bucket getBucket(size_t bucket) const { return { open[bucket], high[bucket], low[bucket], close[bucket] }; }
+	};
+
+	LodPyramid() = default;
+	explicit LodPyramid(const KlineStore& store);
+	~LodPyramid();
+
+	void build(const KlineStore& store);
+	// same series grown or with its tail rewritten : only the buckets from fromRow
+	// on are recomputed, rows before it must be unchanged (store may be a new wrapper)
+	void update(const KlineStore& store, size_t fromRow);
+	void clear();
+	// the stored levels of the first numRows rows of store, saved from getLevel() (open, high,
+	// low, close of each level from firstLevel up), instead of build(). False (and cleared)
+	// when their sizes don't match, follow with update(store, numRows - 1) for newer rows
+	bool restore(const KlineStore& store, size_t numRows, std::vector<std::vector<double>> columns);
+
+	bool isEmpty() const { return _numRows == 0; }
+	size_t getNumRows() const { return _numRows; }
+	// includes level 0 (the store rows)
+	int getNumLevels() const { return _numLevels; }
+	Level getLevel(int level) const;
+
+	// keeps the log prices of the stored levels from now on, through build() and update()
+	// (as much memory again as the levels). Disabling frees them
+	void setLogPricesEnabled(bool shouldBeEnabled);
+	bool isLogPricesEnabled() const { return _logPrices; }
+	// std::log of the prices of a level (clamped like LogScale), size 0 for the row levels
+	// or while the log prices are disabled
+	Level getLogLevel(int level) const;
+
+	// coarsest level whose buckets hold at most maxRowsPerBucket rows
+	int chooseLevel(double maxRowsPerBucket) const;
+	// lowest low and highest high of the rows [first, last), NaN ignored, O(log n).
+	// Empty when no row has a value. The rows past getNumRows() are scanned
+	Range<double> computePriceRange(size_t first, size_t last) const;
+
+	// bytes of the stored levels and their log copies
+	size_t getNumBytes() const { return _numBytes; }
+	// frees the finest stored levels (and their log copies), returns the bytes freed
+	size_t releaseFineLevels();
+	bool hasReleasedLevels() const { return _released; }
+	// builds the released levels again from the store, O(rows) on the pool
+	void restoreFineLevels();
+
+private:
+	struct Storage {
+		std::vector<double> open, high, low, close;
+
+		size_t size() const { return open.size(); }
+		size_t getNumBytes() const { return open.capacity() * 4 * sizeof(double); }
+		void resize(size_t n) { open.resize(n); high.resize(n); low.resize(n); close.resize(n); }
+	};
+
+	void _compute(size_t fromRow);
+	void _accumulate(int level, size_t first, size_t last, double& low, double& high) const;
+	void _computeLog(size_t fromRow);
+	// the level bytes changed, updates the budget
+	void _account();
+
+	const KlineStore* _store = nullptr;
+	size_t _numRows = 0;
+	int _numLevels = 0;
+	std::vector<Storage> _levels; // _levels[0] is firstLevel
+	bool _logPrices = false;
+	std::vector<Storage> _logLevels; // same sizes as _levels when _logPrices
+	bool _released = false;
+	size_t _numBytes = 0;
+
+	JUCE_DECLARE_NON_COPYABLE(LodPyramid)
+};
@@ -0,0 +1,204 @@
+/*
+  ==============================================================================
+
+    OrderBook.cpp
+    Created: 15 Oct 2026 8:02:19pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "OrderBook.h"
+#include <bit>
+
+double OrderBook::Snapshot::getMid() const {
+	if (!bids.empty() && !asks.empty())
+		return (bids.front().price + asks.front().price) * 0.5;
+	if (!bids.empty())
+		return bids.front().price;
+	return asks.empty() ? 0.0 : asks.front().price;
+}
+
+OrderBook::OrderBook(double tickSize, int numTicks)
+	: _tickSize(tickSize > 0.0 ? tickSize : 1.0)
+	, _numTicks((jmax(64, numTicks) + 63) / 64 * 64)
+	, _numWords(_numTicks / 64)
+{
+	for (auto* side : { &_bids, &_asks }) {
+		side->quantities.calloc((size_t)_numTicks);
+		side->bits.calloc((size_t)_numWords);
+	}
+}
+
+void OrderBook::beginUpdate() {
+	const uint32 seq = _seq.load(std::memory_order_relaxed);
+	jassert((seq & 1) == 0);
+	_seq.store(seq + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+}
+
+void OrderBook::endUpdate(uint64 updateId, int64 time) {
+	// the best prices near an edge : centered again before the next move leaves the window
+	const int margin = _numTicks / 8;
+	const int low = _bids.best >= 0 ? _bids.best : _asks.best;
+	const int high = _asks.best >= 0 ? _asks.best : _bids.best;
+	if (low >= 0 && (low < margin || high >= _numTicks - margin))
+		_recenter(_firstTick + (low + high) / 2);
+	_updateId = updateId;
+	_time = time;
+	_seq.store(_seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void OrderBook::clear() {
+	for (auto* side : { &_bids, &_asks }) {
+		side->quantities.clear((size_t)_numTicks);
+		side->bits.clear((size_t)_numWords);
+		side->best = -1;
+	}
+	_placed = false;
+	_updateId = 0;
+}
+
+void OrderBook::set(bool isBid, double price, double quantity) {
+	jassert(_seq.load(std::memory_order_relaxed) & 1);
+	if (!(price > 0.0))
+		return;
+	const int64 tick = (int64)std::llround(price / _tickSize);
+	if (!_placed) {
+		if (!(quantity > 0.0))
+			return;
+		_recenter(tick);
+		_placed = true;
+	}
+	int64 index = tick - _firstTick;
+	if (index < 0 || index >= _numTicks) {
+		if (!(quantity > 0.0))
+			return;
+		// a new best price out of the window (the market jumped) moves it, far levels are dropped
+		const Side& side = isBid ? _bids : _asks;
+		const bool atTouch = side.best < 0 || (isBid ? index > side.best : index < side.best);
+		if (!atTouch)
+			return;
+		_recenter(tick);
+		index = tick - _firstTick;
+	}
+	_setLevel(isBid ? _bids : _asks, isBid, (int)index, quantity > 0.0 ? quantity : 0.0);
+}
+
+void OrderBook::_setLevel(Side& side, bool isBid, int index, double quantity) {
+	side.quantities[index] = quantity;
+	uint64& word = side.bits[index >> 6];
+	const uint64 mask = (uint64)1 << (index & 63);
+	if (quantity > 0.0) {
+		word |= mask;
+		if (side.best < 0 || (isBid ? index > side.best : index < side.best))
+			side.best = index;
+	}
+	else {
+		word &= ~mask;
+		if (index == side.best)
+			side.best = _findBest(side, isBid, index);
+	}
+}
+
+int OrderBook::_findBest(const Side& side, bool isBid, int from) const {
+	from = jlimit(0, _numTicks - 1, from);
+	int w = from >> 6;
+	const int bit = from & 63;
+	if (isBid) {
+		// highest set bit at or below from
+		uint64 word = side.bits[w] & (bit == 63 ? ~(uint64)0 : (((uint64)1 << (bit + 1)) - 1));
+		for (;;) {
+			if (word != 0)
+				return w * 64 + 63 - std::countl_zero(word);
+			if (--w < 0)
+				return -1;
+			word = side.bits[w];
+		}
+	}
+	// lowest set bit at or above from
+	uint64 word = side.bits[w] & (~(uint64)0 << bit);
+	for (;;) {
+		if (word != 0)
+			return w * 64 + std::countr_zero(word);
+		if (++w >= _numWords)
+			return -1;
+		word = side.bits[w];
+	}
+}
+
+void OrderBook::_recenter(int64 centerTick) {
+	// whole words, so the bits move with the quantities
+	int64 first = centerTick - _numTicks / 2;
+	first -= ((first % 64) + 64) % 64;
+	const int64 shift = first - _firstTick;
+	_firstTick = first;
+	if (shift == 0)
+		return;
+	for (auto* side : { &_bids, &_asks }) {
+		const bool isBid = side == &_bids;
+		if (std::abs(shift) >= (int64)_numTicks) {
+			side->quantities.clear((size_t)_numTicks);
+			side->bits.clear((size_t)_numWords);
+			side->best = -1;
+			continue;
+		}
+		const int n = (int)std::abs(shift);
+		const int words = n / 64;
+		double* q = side->quantities.get();
+		uint64* bits = side->bits.get();
+		if (shift > 0) {
+			// the window moves up, the lowest ticks fall out
+			std::memmove(q, q + n, (size_t)(_numTicks - n) * sizeof(double));
+			std::fill(q + _numTicks - n, q + _numTicks, 0.0);
+			std::memmove(bits, bits + words, (size_t)(_numWords - words) * sizeof(uint64));
+			std::fill(bits + _numWords - words, bits + _numWords, (uint64)0);
+		}
+		else {
+			std::memmove(q + n, q, (size_t)(_numTicks - n) * sizeof(double));
+			std::fill(q, q + n, 0.0);
+			std::memmove(bits + words, bits, (size_t)(_numWords - words) * sizeof(uint64));
+			std::fill(bits, bits + words, (uint64)0);
+		}
+		if (side->best >= 0) {
+			const int64 best = (int64)side->best - shift;
+			if (best >= 0 && best < _numTicks)
+				side->best = (int)best;
+			else
+				side->best = _findBest(*side, isBid, isBid ? _numTicks - 1 : 0);
+		}
+	}
+}
+
+void OrderBook::_copy(const Side& side, bool isBid, std::vector<Level>& out, int maxLevels) const {
+	out.clear();
+	// best may be stale while the producer writes, the walk stays inside the ladder and the
+	// sequence check drops the copy
+	int index = side.best;
+	while (index >= 0 && index < _numTicks && (int)out.size() < maxLevels) {
+		const double quantity = side.quantities[index];
+		if (quantity > 0.0)
+			out.push_back({ (double)(_firstTick + index) * _tickSize, quantity });
+		index = isBid ? (index > 0 ? _findBest(side, true, index - 1) : -1)
+					  : (index + 1 < _numTicks ? _findBest(side, false, index + 1) : -1);
+	}
+}
+
+void OrderBook::getSnapshot(Snapshot& s, int maxLevels) const {
+	s.bids.reserve((size_t)maxLevels);
+	s.asks.reserve((size_t)maxLevels);
+	for (;;) {
+		const uint32 seq = _seq.load(std::memory_order_acquire);
+		if (seq & 1) {
+			Thread::yield();
+			continue;
+		}
+		s.updateId = _updateId;
+		s.time = _time;
+		_copy(_bids, true, s.bids, maxLevels);
+		_copy(_asks, false, s.asks, maxLevels);
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (_seq.load(std::memory_order_relaxed) == seq)
+			break;
+	}
+}
@@ -0,0 +1,94 @@
+/*
+  ==============================================================================
+
+    OrderBook.h
+    Created: 15 Oct 2026 8:02:19pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+
+/*
+	Price levels of one symbol for the depth views, mutated by a feed thread
+	(BinanceDepthFeed, single producer) and read by the renderer.
+
+	The book is a ladder : one quantity per tick over a window of numTicks
+	ticks, bids and asks apart, with one bit per non empty tick so a walk from
+	the best price skips 64 empty ticks at a time. A level update is an index,
+	a store and a bit. When the best prices come near an edge the window is
+	moved to center them again, the levels that fall out are dropped (they are
+	far from the touch). Nothing is allocated after construction.
+
+	Readers never block the producer : getSnapshot() copies the levels near the
+	touch through a sequence lock and copies again if an update ran meanwhile.
+	The producer groups the levels of one message between beginUpdate() and
+	endUpdate(), so a snapshot is always a whole book state.
+
+	tickSize must be the symbol's price step (or a divisor of it).
+*/
+
+class OrderBook {
+public:
+	using Ptr = SPtr<OrderBook>;
+
+	struct Level {
+		double price = 0.0;
+		double quantity = 0.0;
+	};
+
+	struct Snapshot {
+		uint64 updateId = 0;      // of the last applied update, 0 while the book is empty
+		int64 time = 0;           // event time (ms) of that update
+		std::vector<Level> bids;  // best (highest) first
+		std::vector<Level> asks;  // best (lowest) first
+
+		bool isEmpty() const { return bids.empty() && asks.empty(); }
+		double getMid() const;
+	};
+
+	// numTicks is rounded up to a multiple of 64
+	explicit OrderBook(double tickSize, int numTicks = 1 << 16);
+
+	double getTickSize() const { return _tickSize; }
+	int getNumTicks() const { return _numTicks; }
+
+	// producer thread only. quantity 0 removes the level
+	void beginUpdate();
+	void set(bool isBid, double price, double quantity);
+	void endUpdate(uint64 updateId, int64 time);
+	// between beginUpdate() / endUpdate(), before a full book (resync)
+	void clear();
+
+	// any thread : up to maxLevels levels per side, storage of s reused
+	void getSnapshot(Snapshot& s, int maxLevels) const;
+	// changes with every endUpdate(), to skip the snapshot of an unchanged book
+	uint32 getVersion() const { return _seq.load(std::memory_order_acquire) >> 1; }
+
+private:
+	struct Side {
+		HeapBlock<double> quantities;
+		HeapBlock<uint64> bits;   // tick t is not empty : bits[t / 64] & (1 << t % 64)
+		int best = -1;            // index of the best level, -1 when empty
+	};
+
+	void _setLevel(Side& side, bool isBid, int index, double quantity);
+	int _findBest(const Side& side, bool isBid, int from) const;
+	void _recenter(int64 centerTick);
+	void _copy(const Side& side, bool isBid, std::vector<Level>& out, int maxLevels) const;
+
+	const double _tickSize;
+	const int _numTicks;
+	const int _numWords;
+	int64 _firstTick = 0;     // tick of index 0
+	bool _placed = false;     // window centered once
+	Side _bids, _asks;
+	uint64 _updateId = 0;
+	int64 _time = 0;
+
+	alignas(64) std::atomic<uint32> _seq{ 0 };
+
+	JUCE_DECLARE_NON_COPYABLE(OrderBook)
+};
@@ -0,0 +1,105 @@
+/*
+  ==============================================================================
+
+    SeriesRange.h
+    Created: 14 Oct 2026 4:47:09pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+
+/*
+	Slice of a series, rows [first, last), resolved once per frame from the
+	x viewport and shared by every layer drawing that series.
+*/
+
+struct SeriesRange {
+	uint64 first = 0;
+	uint64 last = 0;
+
+	uint64 size() const { return last - first; }
+	bool isEmpty() const { return last <= first; }
+	bool contains(uint64 row) const { return row >= first && row < last; }
+	bool operator==(const SeriesRange& o) const { return first == o.first && last == o.last; }
+	bool operator!=(const SeriesRange& o) const { return !operator==(o); }
+};
+
+/*
+	Searches on a sorted time column given as an accessor (row -> open_time),
+	so it works on contiguous columns as well as rings.
+
+	Klines are almost evenly spaced : the row is first guessed by interpolation,
+	then bracketed by galloping around the guess and finished by a binary
+	search. Regular data costs O(1) probes, gaps degrade to O(log gap).
+*/
+
+struct TimeSearch {
+	// first row in [first, last) with time >= t (or > t when upper)
+	template <typename TimeAt>
+	static uint64 search(const TimeAt& timeAt, uint64 first, uint64 last, int64 t, bool upper) {
+		auto before = [&](uint64 row) { return upper ? timeAt(row) <= t : timeAt(row) < t; };
+		if (first >= last || !before(first))
+			return first;
+		if (before(last - 1))
+			return last;
+
+		// before(first) && !before(last - 1)
+		const int64 t0 = timeAt(first);
+		const int64 t1 = timeAt(last - 1);
+		const double f = t1 > t0 ? (double)(t - t0) / (double)(t1 - t0) : 0.0;
+		uint64 guess = first + (uint64)jlimit(0.0, (double)(last - 1 - first), f * (double)(last - 1 - first));
+
+		// bracket : before(lo) && !before(hi)
+		uint64 lo = first, hi = last - 1;
+		if (before(guess)) {
+			lo = guess;
+			for (uint64 step = 1; lo + step < hi; step *= 2) {
+				if (!before(lo + step)) {
+					hi = lo + step;
+					break;
+				}
+				lo += step;
+			}
+		}
+		else {
+			hi = guess;
+			for (uint64 step = 1; hi > lo + step; step *= 2) {
+				if (before(hi - step)) {
+					lo = hi - step;
+					break;
+				}
+				hi -= step;
+			}
+		}
+		while (hi - lo > 1) {
+			const uint64 mid = lo + (hi - lo) / 2;
+			if (before(mid))
+				lo = mid;
+			else
+				hi = mid;
+		}
+		return hi;
+	}
+
+	template <typename TimeAt>
+	static uint64 lowerBound(const TimeAt& timeAt, uint64 first, uint64 last, int64 t) {
+		return search(timeAt, first, last, t, false);
+	}
+
+	template <typename TimeAt>
+	static uint64 upperBound(const TimeAt& timeAt, uint64 first, uint64 last, int64 t) {
+		return search(timeAt, first, last, t, true);
+	}
+
+	// rows whose open_time is in [start, end]
+	template <typename TimeAt>
+	static SeriesRange findRange(const TimeAt& timeAt, uint64 first, uint64 last, int64 start, int64 end) {
+		SeriesRange r;
+		r.first = lowerBound(timeAt, first, last, start);
+		r.last = jmax(r.first, upperBound(timeAt, r.first, last, end));
+		return r;
+	}
+};
@@ -0,0 +1,668 @@
+/*
+  ==============================================================================
+
+    SignalEngine.cpp
+    Created: 15 Oct 2026 4:12:36pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "SignalEngine.h"
+#include "IndicatorEngine.h"
+#include "IndicatorKernels.h"
+#include "../utils/TaskPool.h"
+
+static constexpr double missing = std::numeric_limits<double>::quiet_NaN();
+
+// NaN is false
+static inline bool isTrue(double v) {
+	return v < 0.0 || v > 0.0;
+}
+
+enum class Op {
+	column, number, parameter,
+	neg, notOp, abs,
+	add, sub, mul, div, lt, le, gt, ge, eq, ne, andOp, orOp,
+	prev, crossOver, crossUnder,
+	ema, sma, rsi, rollingMin, rollingMax, stddev, // whole column kernels
+	load, constant                                  // program only
+};
+
+static bool isKernel(Op op) {
+	return op >= Op::ema && op <= Op::stddev;
+}
+
+static const char* getOpText(Op op) {
+	switch (op) {
+	case Op::neg: return "-";
+	case Op::notOp: return "not ";
+	case Op::abs: return "abs";
+	case Op::add: return " + ";
+	case Op::sub: return " - ";
+	case Op::mul: return " * ";
+	case Op::div: return " / ";
+	case Op::lt: return " < ";
+	case Op::le: return " <= ";
+	case Op::gt: return " > ";
+	case Op::ge: return " >= ";
+	case Op::eq: return " == ";
+	case Op::ne: return " != ";
+	case Op::andOp: return " and ";
+	case Op::orOp: return " or ";
+	case Op::prev: return "prev";
+	case Op::crossOver: return "crossover";
+	case Op::crossUnder: return "crossunder";
+	case Op::ema: return "ema";
+	case Op::sma: return "sma";
+	case Op::rsi: return "rsi";
+	case Op::rollingMin: return "min";
+	case Op::rollingMax: return "max";
+	case Op::stddev: return "stddev";
+	default: return "";
+	}
+}
+
+struct SignalEngine::Node {
+	Op op = Op::number;
+	int a = -1, b = -1;       // operands, a function argument and its period / count
+	KlineStore::Column column = KlineStore::close;
+	double value = 0.0;
+	int parameter = -1;
+};
+
+struct SignalEngine::Program {
+	struct Instr {
+		Op op = Op::constant;
+		int dst = 0, a = 0, b = 0; // registers
+		const double* source = nullptr;
+		size_t shift = 0;          // load : rows before
+		double value = 0.0;        // constant
+	};
+	std::vector<Instr> code;
+	int numRegs = 1;
+
+	void add(const Instr& i) {
+		code.push_back(i);
+		numRegs = jmax(numRegs, i.dst + 1, i.a + 1, i.b + 1);
+	}
+};
+
+SignalEngine::SignalEngine() = default;
+SignalEngine::~SignalEngine() = default;
+
+int SignalEngine::_getParameterIndex(const String& name) {
+	const int i = _parameterNames.indexOf(name);
+	if (i >= 0)
+		return i;
+	_parameterNames.add(name);
+	_parameterValues.push_back(0.0);
+	return _parameterNames.size() - 1;
+}
+
+void SignalEngine::setParameter(const String& name, double value) {
+	_parameterValues[(size_t)_getParameterIndex(name)] = value;
+}
+
+double SignalEngine::getParameter(const String& name) const {
+	const int i = _parameterNames.indexOf(name);
+	return i >= 0 ? _parameterValues[(size_t)i] : 0.0;
+}
+
+StringArray SignalEngine::getParameterNames() const {
+	return _parameterNames;
+}
+
+bool SignalEngine::setRules(const String& longEntry, const String& shortEntry, String* error) {
+	const auto nodes = _nodes;
+	_nodes.clear();
+	const int longRoot = _parse(longEntry, error);
+	const int shortRoot = longRoot == -2 ? -2 : _parse(shortEntry, error);
+	if (longRoot == -2 || shortRoot == -2) {
+		_nodes = nodes;
+		return false;
+	}
+	_longRoot = longRoot;
+	_shortRoot = shortRoot;
+	return true;
+}
+
+// recursive descent, -1 for an empty rule, -2 on error
+int SignalEngine::_parse(const String& text, String* error) {
+	struct Parser {
+		SignalEngine& engine;
+		const std::string s;
+		size_t pos = 0;
+		String failure;
+
+		void skipSpaces() {
+			while (pos < s.size() && std::isspace((unsigned char)s[pos]))
+				pos++;
+		}
+		bool accept(const char* token) {
+			skipSpaces();
+			const size_t n = std::strlen(token);
+			if (s.compare(pos, n, token) != 0)
+				return false;
+			// words end on a non identifier character
+			if (std::isalpha((unsigned char)token[0]) && pos + n < s.size() && (std::isalnum((unsigned char)s[pos + n]) || s[pos + n] == '_'))
+				return false;
+			pos += n;
+			return true;
+		}
+		int fail(const String& message) {
+			if (failure.isEmpty())
+				failure = message + " at " + String((int)pos + 1);
+			return -2;
+		}
+		String identifier() {
+			skipSpaces();
+			const size_t start = pos;
+			while (pos < s.size() && (std::isalnum((unsigned char)s[pos]) || s[pos] == '_'))
+				pos++;
+			return String(s.substr(start, pos - start).c_str()).toLowerCase();
+		}
+		int add(Op op, int a = -1, int b = -1) {
+			if (a == -2 || b == -2)
+				return -2;
+			Node n;
+			n.op = op;
+			n.a = a;
+			n.b = b;
+			engine._nodes.push_back(n);
+			return (int)engine._nodes.size() - 1;
+		}
+
+		int orExpr() {
+			int a = andExpr();
+			while (a != -2 && (accept("or") || accept("||")))
+				a = add(Op::orOp, a, andExpr());
+			return a;
+		}
+		int andExpr() {
+			int a = notExpr();
+			while (a != -2 && (accept("and") || accept("&&")))
+				a = add(Op::andOp, a, notExpr());
+			return a;
+		}
+		int notExpr() {
+			if (accept("not") || (peek('!') && !peekAt(1, '=') && accept("!")))
+				return add(Op::notOp, notExpr());
+			return comparison();
+		}
+		bool peek(char c) { skipSpaces(); return pos < s.size() && s[pos] == c; }
+		bool peekAt(size_t offset, char c) const { return pos + offset < s.size() && s[pos + offset] == c; }
+		int comparison() {
+			const int a = sum();
+			if (a == -2)
+				return a;
+			static const std::pair<const char*, Op> ops[] = {
+				{ "<=", Op::le }, { ">=", Op::ge }, { "==", Op::eq }, { "!=", Op::ne }, { "<", Op::lt }, { ">", Op::gt }
+			};
+			for (const auto& [token, op] : ops)
+				if (accept(token))
+					return add(op, a, sum());
+			return a;
+		}
+		int sum() {
+			int a = product();
+			for (;;) {
+				if (a == -2)
+					return a;
+				if (accept("+"))
+					a = add(Op::add, a, product());
+				else if (accept("-"))
+					a = add(Op::sub, a, product());
+				else
+					return a;
+			}
+		}
+		int product() {
+			int a = unary();
+			for (;;) {
+				if (a == -2)
+					return a;
+				if (accept("*"))
+					a = add(Op::mul, a, unary());
+				else if (accept("/"))
+					a = add(Op::div, a, unary());
+				else
+					return a;
+			}
+		}
+		int unary() {
+			if (accept("-"))
+				return add(Op::neg, unary());
+			return primary();
+		}
+		int number() {
+			skipSpaces();
+			const char* begin = s.c_str() + pos;
+			char* end = nullptr;
+			const double v = std::strtod(begin, &end);
+			if (end == begin)
+				return fail("number expected");
+			pos += (size_t)(end - begin);
+			const int n = add(Op::number);
+			engine._nodes[(size_t)n].value = v;
+			return n;
+		}
+		int parameter() {
+			const auto name = identifier();
+			if (name.isEmpty())
+				return fail("parameter name expected");
+			const int n = add(Op::parameter);
+			engine._nodes[(size_t)n].parameter = engine._getParameterIndex(name);
+			return n;
+		}
+		// a number or a $parameter
+		int period() {
+			if (accept("$"))
+				return parameter();
+			return number();
+		}
+		int primary() {
+			skipSpaces();
+			if (pos >= s.size())
+				return fail("unexpected end");
+			if (accept("(")) {
+				const int e = orExpr();
+				if (e != -2 && !accept(")"))
+					return fail("')' expected");
+				return e;
+			}
+			if (accept("$"))
+				return parameter();
+			if (std::isdigit((unsigned char)s[pos]) || s[pos] == '.')
+				return number();
+			const size_t start = pos;
+			const auto name = identifier();
+			if (name.isEmpty())
+				return fail("unexpected '" + String::charToString((juce_wchar)s[pos]) + "'");
+
+			static const std::pair<const char*, KlineStore::Column> columns[] = {
+				{ "open", KlineStore::open }, { "high", KlineStore::high }, { "low", KlineStore::low }, { "close", KlineStore::close },
+				{ "volume", KlineStore::volume }, { "quote_volume", KlineStore::quoteVolume },
+				{ "taker_buy_base", KlineStore::takerBuyBaseVolume }, { "taker_buy_quote", KlineStore::takerBuyQuoteVolume }
+			};
+			for (const auto& [columnName, column] : columns) {
+				if (name == columnName) {
+					const int n = add(Op::column);
+					engine._nodes[(size_t)n].column = column;
+					return n;
+				}
+			}
+			static const std::pair<const char*, Op> functions[] = {
+				{ "ema", Op::ema }, { "sma", Op::sma }, { "rsi", Op::rsi }, { "min", Op::rollingMin }, { "max", Op::rollingMax },
+				{ "stddev", Op::stddev }, { "prev", Op::prev }, { "crossover", Op::crossOver }, { "crossunder", Op::crossUnder },
+				{ "abs", Op::abs }
+			};
+			for (const auto& [functionName, op] : functions) {
+				if (name != functionName)
+					continue;
+				if (!accept("("))
+					return fail("'(' expected");
+				const int a = orExpr();
+				int b = -1;
+				if (a == -2)
+					return a;
+				if (op == Op::abs) {
+				}
+				else if (op == Op::crossOver || op == Op::crossUnder) {
+					if (!accept(","))
+						return fail("',' expected");
+					b = orExpr();
+				}
+				else if (accept(",")) {
+					b = period();
+				}
+				else if (op == Op::prev) {
+					b = add(Op::number);
+					engine._nodes[(size_t)b].value = 1.0;
+				}
+				else {
+					return fail("',' expected");
+				}
+				if (b == -2)
+					return b;
+				if (!accept(")"))
+					return fail("')' expected");
+				return add(op, a, b);
+			}
+			pos = start;
+			return fail("unknown name '" + name + "'");
+		}
+	};
+
+	Parser p{ *this, text.toStdString() };
+	p.skipSpaces();
+	if (p.pos == p.s.size())
+		return -1;
+	int root = p.orExpr();
+	p.skipSpaces();
+	if (root != -2 && p.pos != p.s.size())
+		root = p.fail("unexpected '" + String::charToString((juce_wchar)p.s[p.pos]) + "'");
+	if (root == -2 && error != nullptr)
+		*error = p.failure;
+	return root;
+}
+
+String SignalEngine::_getKey(int node) const {
+	const auto& n = _nodes[(size_t)node];
+	switch (n.op) {
+	case Op::column: return KlineStore::getColumnFileName(n.column).upToFirstOccurrenceOf(".", false, false);
+	case Op::number: return String(n.value);
+	case Op::parameter: return String(_parameterValues[(size_t)n.parameter]);
+	case Op::neg:
+	case Op::notOp: return getOpText(n.op) + _getKey(n.a);
+	default: break;
+	}
+	if (n.op >= Op::add && n.op <= Op::orOp)
+		return "(" + _getKey(n.a) + getOpText(n.op) + _getKey(n.b) + ")";
+	return getOpText(n.op) + String("(") + _getKey(n.a) + (n.b >= 0 ? ", " + _getKey(n.b) : String()) + ")";
+}
+
+size_t SignalEngine::_getPeriod(int node) const {
+	const auto& n = _nodes[(size_t)node];
+	const double v = n.op == Op::parameter ? _parameterValues[(size_t)n.parameter] : n.value;
+	return (size_t)jmax(0, roundToInt(v));
+}
+
+// whole column of the node, computed once per key
+const double* SignalEngine::_getSource(int node) {
+	const auto& n = _nodes[(size_t)node];
+	if (n.op == Op::column)
+		return _store->getDoubleColumn(n.column);
+	if (isKernel(n.op))
+		return _getSeries(node);
+	const auto key = _getKey(node);
+	auto it = _columns.find(key);
+	if (it != _columns.end())
+		return it->second.data();
+
+	Program program;
+	_emit(node, program, 0);
+	std::vector<double> column(_store->size());
+	_run(program, [&](size_t, size_t first, size_t last, const double* values) {
+		std::copy(values, values + (last - first), column.data() + first);
+	});
+	return _columns.emplace(key, std::move(column)).first->second.data();
+}
+
+const double* SignalEngine::_getSeries(int node) {
+	const auto key = _getKey(node);
+	auto it = _columns.find(key);
+	if (it != _columns.end())
+		return it->second.data();
+
+	const auto& n = _nodes[(size_t)node];
+	const double* x = _getSource(n.a);
+	const int period = (int)jmax((size_t)1, _getPeriod(n.b));
+	const size_t numRows = _store->size();
+	std::vector<double> out(numRows, missing);
+	// the warm-up rows of the input stay NaN
+	size_t first = 0;
+	while (first < numRows && std::isnan(x[first]))
+		first++;
+	const size_t count = numRows - first;
+	if (count > 0) {
+		x += first;
+		double* y = out.data() + first;
+		switch (n.op) {
+		case Op::ema:
+			IndicatorKernels::ema(x, count, 2.0 / ((double)period + 1.0), y);
+			break;
+		case Op::sma:
+		case Op::stddev: {
+			IndicatorKernels::PrefixSums sums;
+			sums.compute(x, count);
+			if (n.op == Op::sma) {
+				IndicatorKernels::sma(sums, period, y);
+			}
+			else {
+				std::vector<double> middle(count), lower(count);
+				IndicatorKernels::bollinger(sums, period, 1.0, middle.data(), y, lower.data());
+				for (size_t i = 0; i < count; i++)
+					y[i] -= middle[i];
+			}
+			break;
+		}
+		case Op::rollingMin:
+		case Op::rollingMax:
+			IndicatorKernels::rollingMinMax(x, count, period, n.op == Op::rollingMin ? y : nullptr, n.op == Op::rollingMax ? y : nullptr);
+			break;
+		case Op::rsi: {
+			RsiIndicator rsi(period);
+			rsi.update(x, count, 0);
+			const auto values = rsi.getOutput(0);
+			std::copy(values->begin(), values->begin() + (ptrdiff_t)count, y);
+			break;
+		}
+		default:
+			break;
+		}
+	}
+	return _columns.emplace(key, std::move(out)).first->second.data();
+}
+
+// code leaving the value of node in register reg, the registers above are scratch
+void SignalEngine::_emit(int node, Program& program, int reg) {
+	const auto& n = _nodes[(size_t)node];
+	Program::Instr i;
+	i.dst = i.a = reg;
+	i.b = reg + 1;
+	auto load = [&](int r, const double* source, size_t shift) {
+		Program::Instr l;
+		l.op = Op::load;
+		l.dst = l.a = l.b = r;
+		l.source = source;
+		l.shift = shift;
+		program.add(l);
+	};
+	auto binary = [&](Op op, int dst, int a, int b) {
+		Program::Instr x;
+		x.op = op;
+		x.dst = dst;
+		x.a = a;
+		x.b = b;
+		program.add(x);
+	};
+
+	switch (n.op) {
+	case Op::number:
+	case Op::parameter:
+		i.op = Op::constant;
+		i.value = n.op == Op::number ? n.value : _parameterValues[(size_t)n.parameter];
+		program.add(i);
+		return;
+	case Op::column:
+		load(reg, _getSource(node), 0);
+		return;
+	case Op::neg:
+	case Op::notOp:
+	case Op::abs:
+		_emit(n.a, program, reg);
+		i.op = n.op;
+		program.add(i);
+		return;
+	case Op::prev:
+		load(reg, _getSource(n.a), _getPeriod(n.b));
+		return;
+	case Op::crossOver:
+	case Op::crossUnder: {
+		// over : a[-1] <= b[-1] and a > b, under : a[-1] >= b[-1] and a < b
+		const double* a = _getSource(n.a);
+		const double* b = _getSource(n.b);
+		const bool over = n.op == Op::crossOver;
+		load(reg, a, 1);
+		load(reg + 1, b, 1);
+		binary(over ? Op::le : Op::ge, reg, reg, reg + 1);
+		load(reg + 1, a, 0);
+		load(reg + 2, b, 0);
+		binary(over ? Op::gt : Op::lt, reg + 1, reg + 1, reg + 2);
+		binary(Op::andOp, reg, reg, reg + 1);
+		return;
+	}
+	default:
+		break;
+	}
+	if (isKernel(n.op)) {
+		load(reg, _getSeries(node), 0);
+		return;
+	}
+	_emit(n.a, program, reg);
+	_emit(n.b, program, reg + 1);
+	i.op = n.op;
+	program.add(i);
+}
+
+void SignalEngine::_run(const Program& program, const std::function<void(size_t, size_t, size_t, const double*)>& sink) const {
+	const size_t numRows = _store->size();
+	const size_t numChunks = (numRows + chunkSize - 1) / chunkSize;
+	TaskPool::getInstance().parallelFor(numChunks, 1, [&](size_t firstChunk, size_t lastChunk) {
+		std::vector<double> registers((size_t)program.numRegs * chunkSize);
+		for (size_t c = firstChunk; c < lastChunk; c++) {
+			const size_t first = c * chunkSize;
+			const size_t n = jmin(numRows, first + chunkSize) - first;
+			for (const auto& i : program.code) {
+				double* d = registers.data() + (size_t)i.dst * chunkSize;
+				const double* x = registers.data() + (size_t)i.a * chunkSize;
+				const double* y = registers.data() + (size_t)i.b * chunkSize;
+				switch (i.op) {
+				case Op::load: {
+					// rows before the start of the series are NaN
+					const size_t before = first >= i.shift ? 0 : jmin(n, i.shift - first);
+					std::fill(d, d + before, missing);
+					if (before < n)
+						std::copy(i.source + first + before - i.shift, i.source + first + n - i.shift, d + before);
+					break;
+				}
+				case Op::constant: std::fill(d, d + n, i.value); break;
+				case Op::neg:    for (size_t k = 0; k < n; k++) d[k] = -x[k]; break;
+				case Op::abs:    for (size_t k = 0; k < n; k++) d[k] = std::abs(x[k]); break;
+				case Op::notOp:  for (size_t k = 0; k < n; k++) d[k] = isTrue(x[k]) ? 0.0 : 1.0; break;
+				case Op::add:    for (size_t k = 0; k < n; k++) d[k] = x[k] + y[k]; break;
+				case Op::sub:    for (size_t k = 0; k < n; k++) d[k] = x[k] - y[k]; break;
+				case Op::mul:    for (size_t k = 0; k < n; k++) d[k] = x[k] * y[k]; break;
+				case Op::div:    for (size_t k = 0; k < n; k++) d[k] = x[k] / y[k]; break;
+				case Op::lt:     for (size_t k = 0; k < n; k++) d[k] = x[k] < y[k] ? 1.0 : 0.0; break;
+				case Op::le:     for (size_t k = 0; k < n; k++) d[k] = x[k] <= y[k] ? 1.0 : 0.0; break;
+				case Op::gt:     for (size_t k = 0; k < n; k++) d[k] = x[k] > y[k] ? 1.0 : 0.0; break;
+				case Op::ge:     for (size_t k = 0; k < n; k++) d[k] = x[k] >= y[k] ? 1.0 : 0.0; break;
+				case Op::eq:     for (size_t k = 0; k < n; k++) d[k] = x[k] == y[k] ? 1.0 : 0.0; break;
+				case Op::ne:     for (size_t k = 0; k < n; k++) d[k] = x[k] != y[k] ? 1.0 : 0.0; break;
+				case Op::andOp:  for (size_t k = 0; k < n; k++) d[k] = isTrue(x[k]) && isTrue(y[k]) ? 1.0 : 0.0; break;
+				case Op::orOp:   for (size_t k = 0; k < n; k++) d[k] = isTrue(x[k]) || isTrue(y[k]) ? 1.0 : 0.0; break;
+				default: break;
+				}
+			}
+			sink(c, first, first + n, registers.data());
+		}
+	});
+}
+
+std::vector<size_t> SignalEngine::_collect(int root) {
+	std::vector<size_t> rows;
+	if (root < 0)
+		return rows;
+	Program program;
+	_emit(root, program, 0);
+	const size_t numChunks = (_store->size() + chunkSize - 1) / chunkSize;
+	std::vector<std::vector<size_t>> chunks(numChunks);
+	_run(program, [&](size_t c, size_t first, size_t last, const double* values) {
+		for (size_t i = first; i < last; i++)
+			if (isTrue(values[i - first]))
+				chunks[c].push_back(i);
+	});
+	size_t total = 0;
+	for (const auto& c : chunks)
+		total += c.size();
+	rows.reserve(total);
+	for (const auto& c : chunks)
+		rows.insert(rows.end(), c.begin(), c.end());
+	return rows;
+}
+
+SignalEngine::Result SignalEngine::evaluate(const KlineStore& store, const Backtest& backtest) {
+	// the same rows : same columns, same size, same last candle
+	if (&store != _store || store.getColumnData(KlineStore::close) != _cachedData || store.size() != _cachedRows || store.getLastOpenTime() != _cachedLastTime)
+		_columns.clear();
+	_store = &store;
+	_cachedData = store.getColumnData(KlineStore::close);
+	_cachedRows = store.size();
+	_cachedLastTime = store.getLastOpenTime();
+
+	Result result;
+	if (store.isEmpty())
+		return result;
+	result.longSignals = _collect(_longRoot);
+	result.shortSignals = _collect(_shortRoot);
+	_simulate(result, backtest, result.trades);
+	return result;
+}
+
+void SignalEngine::clearCache() {
+	_columns.clear();
+	_store = nullptr;
+}
+
+void SignalEngine::_simulate(const Result& signals, const Backtest& backtest, std::vector<Trade>& trades) const {
+	const size_t numRows = _store->size();
+	const int64* t = _store->getOpenTime();
+	const double* o = _store->getOpen();
+	const double* h = _store->getHigh();
+	const double* l = _store->getLow();
+	const bool usePct = backtest.stopLossPct > 0.0 && backtest.takeProfitPct > 0.0;
+	const auto& longs = signals.longSignals;
+	const auto& shorts = signals.shortSignals;
+	size_t nextLong = 0, nextShort = 0;
+	size_t from = 0; // first row a signal can enter on the next open
+
+	for (;;) {
+		while (nextLong < longs.size() && longs[nextLong] < from)
+			nextLong++;
+		while (nextShort < shorts.size() && shorts[nextShort] < from)
+			nextShort++;
+		const size_t longRow = nextLong < longs.size() ? longs[nextLong] : numRows;
+		const size_t shortRow = nextShort < shorts.size() ? shorts[nextShort] : numRows;
+		// a long signal wins over a short one on the same candle
+		const size_t signal = jmin(longRow, shortRow);
+		if (signal + 1 >= numRows)
+			return;
+
+		Trade trade;
+		trade.isLong = longRow <= shortRow;
+		trade.entryRow = signal + 1;
+		trade.entryTime = t[trade.entryRow];
+		trade.entryPrice = o[trade.entryRow];
+		const double side = trade.isLong ? 1.0 : -1.0;
+		if (usePct) {
+			trade.stopLoss = trade.entryPrice * (1.0 - side * backtest.stopLossPct / 100.0);
+			trade.takeProfit = trade.entryPrice * (1.0 + side * backtest.takeProfitPct / 100.0);
+		}
+		else {
+			trade.stopLoss = trade.isLong ? l[signal] : h[signal];
+			trade.takeProfit = trade.entryPrice + 2.0 * (trade.entryPrice - trade.stopLoss);
+		}
+
+		// the stop wins when both are touched by the same candle
+		size_t row = trade.entryRow + 1;
+		for (; row < numRows; row++) {
+			const bool hitStop = trade.isLong ? l[row] <= trade.stopLoss : h[row] >= trade.stopLoss;
+			const bool hitTake = trade.isLong ? h[row] >= trade.takeProfit : l[row] <= trade.takeProfit;
+			if (hitStop || hitTake) {
+				trade.exitPrice = hitStop ? trade.stopLoss : trade.takeProfit;
+				break;
+			}
+		}
+		if (row >= numRows)
+			return; // still open
+		trade.exitRow = row;
+		trade.exitTime = t[row];
+		const double gross = side * (trade.exitPrice - trade.entryPrice);
+		const double fees = (trade.entryPrice + trade.exitPrice) * backtest.feeRate;
+		trade.returnPct = (gross - fees) / trade.entryPrice * 100.0;
+		trades.push_back(trade);
+		from = row;
+	}
+}
@@ -0,0 +1,112 @@
+/*
+  ==============================================================================
+
+    SignalEngine.h
+    Created: 15 Oct 2026 4:12:36pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+#include "KlineStore.h"
+
+/*
+	Entry rules in the spirit of Strategy/strategy.py evaluated over a kline
+	store, and the trades they lead to (same rules as backtest_strategy : enter
+	on the open after the signal candle, leave on the stop loss or the take
+	profit, one trade at a time).
+
+		SignalEngine engine;
+		engine.setRules("crossover(ema(close, 1), ema(close, $slow))"
+						" and (ema(close, 1) / prev(ema(close, 1), 5) - 1) * 100 >= $pct",
+						"crossunder(ema(close, 1), ema(close, $slow))");
+		engine.setParameter("slow", 30);
+		engine.setParameter("pct", 1.0);
+		auto result = engine.evaluate(*store);
+
+	Rules : + - * / < <= > >= == != and or not, numbers, $parameters, the
+	columns open high low close volume quote_volume taker_buy_base
+	taker_buy_quote, and the functions
+		ema sma rsi min max stddev (x, period)   whole column indicators
+		prev(x, n = 1)                            x n rows before, NaN before the start
+		crossover / crossunder (a, b)             a crosses above / below b on this row
+	Periods are numbers or $parameters.
+
+	Every function argument becomes a column (IndicatorKernels passes on the
+	TaskPool), cached by its text with the parameter values : changing a
+	threshold only runs the comparisons again. What is left of a rule is
+	compiled into a register program of column operations, run over chunks of
+	chunkSize rows in parallel. NaN (warm-up) compares false.
+*/
+
+class SignalEngine {
+public:
+	static constexpr size_t chunkSize = 4096;
+
+	struct Backtest {
+		double stopLossPct = 0.75;   // both 0 : stop at the low / high of the signal candle,
+		double takeProfitPct = 1.5;  // take profit at twice the risk
+		double feeRate = 0.001;      // per side
+	};
+
+	struct Trade {
+		bool isLong = true;
+		size_t entryRow = 0, exitRow = 0;
+		int64 entryTime = 0, exitTime = 0;
+		double entryPrice = 0.0, exitPrice = 0.0;
+		double stopLoss = 0.0, takeProfit = 0.0;
+		double returnPct = 0.0;      // per unit traded, net of fees
+	};
+
+	struct Result {
+		std::vector<size_t> longSignals;  // rows where the rule is true
+		std::vector<size_t> shortSignals;
+		std::vector<Trade> trades;        // closed ones
+	};
+
+	SignalEngine();
+	~SignalEngine();
+
+	// an empty rule never signals, false with the first syntax error (the rules are kept)
+	bool setRules(const String& longEntry, const String& shortEntry, String* error = nullptr);
+	// $name in the rules, unset parameters are 0
+	void setParameter(const String& name, double value);
+	double getParameter(const String& name) const;
+	StringArray getParameterNames() const;
+
+	// the columns are cached while the same store keeps its rows
+	Result evaluate(const KlineStore& store, const Backtest& backtest = {});
+	void clearCache();
+
+private:
+	struct Node;
+	struct Program;
+
+	int _parse(const String& text, String* error);
+	int _getParameterIndex(const String& name);
+	String _getKey(int node) const;
+	size_t _getPeriod(int node) const;
+	const double* _getSource(int node);
+	const double* _getSeries(int node);
+	void _emit(int node, Program& program, int reg);
+	void _run(const Program& program, const std::function<void(size_t, size_t, size_t, const double*)>& sink) const;
+	std::vector<size_t> _collect(int root);
+	void _simulate(const Result& signals, const Backtest& backtest, std::vector<Trade>& trades) const;
+
+	std::vector<Node> _nodes;
+	int _longRoot = -1;
+	int _shortRoot = -1;
+	StringArray _parameterNames;
+	std::vector<double> _parameterValues;
+
+	// evaluate() only
+	const KlineStore* _store = nullptr;
+	const void* _cachedData = nullptr;
+	size_t _cachedRows = 0;
+	int64 _cachedLastTime = 0;
+	std::map<String, std::vector<double>> _columns;
+
+	JUCE_DECLARE_NON_COPYABLE(SignalEngine)
+};
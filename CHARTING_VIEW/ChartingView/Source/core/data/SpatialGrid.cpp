@@ -0,0 +1,141 @@
+/*
+  ==============================================================================
+
+    SpatialGrid.cpp
+    Created: 15 Oct 2026 4:12:20am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "SpatialGrid.h"
+
+void SpatialGrid::setCellSize(double width, double height) {
+	jassert(_numItems == 0);
+	_cellWidth = width;
+	_cellHeight = height;
+}
+
+double SpatialGrid::getCellWidth(int level) const {
+	return _cellWidth * (double)((int64)1 << (2 * level));
+}
+
+double SpatialGrid::getCellHeight(int level) const {
+	return _cellHeight * (double)((int64)1 << (2 * level));
+}
+
+uint64 SpatialGrid::_getKey(int64 cx, int64 cy) {
+	// two cells sharing a key only mix their candidates, the bounds filter them anyway
+	return ((uint64)cx * 0x9E3779B97F4A7C15ull) ^ ((uint64)cy + 0x632BE59BD9B4E019ull + ((uint64)cx << 6));
+}
+
+SpatialGrid::CellRange SpatialGrid::_getCells(int level, const Box& b) const {
+	const double w = getCellWidth(level);
+	const double h = getCellHeight(level);
+	return { (int64)std::floor(b.x0 / w), (int64)std::floor(b.y0 / h), (int64)std::floor(b.x1 / w), (int64)std::floor(b.y1 / h) };
+}
+
+void SpatialGrid::_erase(std::vector<uint32>& ids, uint32 id) {
+	auto it = std::find(ids.begin(), ids.end(), id);
+	if (it == ids.end())
+		return;
+	*it = ids.back();
+	ids.pop_back();
+}
+
+void SpatialGrid::insert(uint32 id, const Box& bounds) {
+	if (contains(id))
+		remove(id);
+	if (_cellWidth <= 0.0 || _cellHeight <= 0.0) {
+		// fallback : a fine cell a bit larger than the first item
+		_cellWidth = jmax(bounds.x1 - bounds.x0, std::abs(bounds.x0) * 1e-9, 1e-9);
+		_cellHeight = jmax(bounds.y1 - bounds.y0, std::abs(bounds.y0) * 1e-5, 1e-9);
+	}
+	if (id >= _items.size())
+		_items.resize((size_t)id + 1);
+	_items[id] = { bounds, true };
+	_numItems++;
+
+	for (int l = 0; l < numLevels; l++) {
+		auto& level = _levels[l];
+		const auto r = _getCells(l, bounds);
+		if (r.x1 - r.x0 >= maxCellsPerAxis || r.y1 - r.y0 >= maxCellsPerAxis) {
+			level.oversized.push_back(id);
+			continue;
+		}
+		for (int64 cx = r.x0; cx <= r.x1; cx++)
+			for (int64 cy = r.y0; cy <= r.y1; cy++)
+				level.cells[_getKey(cx, cy)].push_back(id);
+	}
+}
+
+void SpatialGrid::remove(uint32 id) {
+	if (!contains(id))
+		return;
+	auto& item = _items[id];
+	for (int l = 0; l < numLevels; l++) {
+		auto& level = _levels[l];
+		const auto r = _getCells(l, item.bounds);
+		if (r.x1 - r.x0 >= maxCellsPerAxis || r.y1 - r.y0 >= maxCellsPerAxis) {
+			_erase(level.oversized, id);
+			continue;
+		}
+		for (int64 cx = r.x0; cx <= r.x1; cx++) {
+			for (int64 cy = r.y0; cy <= r.y1; cy++) {
+				auto it = level.cells.find(_getKey(cx, cy));
+				if (it == level.cells.end())
+					continue;
+				_erase(it->second, id);
+				if (it->second.empty())
+					level.cells.erase(it);
+			}
+		}
+	}
+	item.inserted = false;
+	_numItems--;
+}
+
+void SpatialGrid::clear() {
+	for (auto& level : _levels) {
+		level.cells.clear();
+		level.oversized.clear();
+	}
+	_items.clear();
+	_numItems = 0;
+}
+
+void SpatialGrid::query(const Box& box, std::vector<uint32>& out) const {
+	if (_numItems == 0)
+		return;
+	const size_t start = out.size();
+	auto add = [&](const std::vector<uint32>& ids) {
+		for (auto id : ids)
+			if (_items[id].bounds.intersects(box))
+				out.push_back(id);
+	};
+
+	// finest level where the box spans a few cells, the last one otherwise
+	int l = 0;
+	while (l < numLevels - 1 && (box.x1 - box.x0 > getCellWidth(l) * maxCellsPerAxis || box.y1 - box.y0 > getCellHeight(l) * maxCellsPerAxis))
+		l++;
+	const auto& level = _levels[l];
+	const auto r = _getCells(l, box);
+	add(level.oversized);
+	if (r.getNumCells() > (int64)level.cells.size()) {
+		// wider than the whole content at the coarsest level
+		for (const auto& cell : level.cells)
+			add(cell.second);
+	}
+	else {
+		for (int64 cx = r.x0; cx <= r.x1; cx++) {
+			for (int64 cy = r.y0; cy <= r.y1; cy++) {
+				auto it = level.cells.find(_getKey(cx, cy));
+				if (it != level.cells.end())
+					add(it->second);
+			}
+		}
+	}
+	// items spanning two cells were seen twice
+	std::sort(out.begin() + (ptrdiff_t)start, out.end());
+	out.erase(std::unique(out.begin() + (ptrdiff_t)start, out.end()), out.end());
+}
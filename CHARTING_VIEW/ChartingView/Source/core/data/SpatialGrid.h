@@ -0,0 +1,85 @@
+/*
+  ==============================================================================
+
+    SpatialGrid.h
+    Created: 15 Oct 2026 4:12:20am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+
+/*
+	Hierarchical uniform grid over world units (time x price), for hit-testing
+	the shapes of a chart at any zoom.
+
+	Level l cells are 4^l times the finest cell. An item is inserted in every
+	level, in the cells its bounds overlap as long as they span at most
+	maxCellsPerAxis cells per axis, in the oversized list of the level otherwise
+	(only large rects / paths, at the fine levels).
+	A query reads the finest level where the box spans at most maxCellsPerAxis
+	cells per axis, so a bounded number of cells whatever the zoom.
+
+	Inserts and removes are incremental, O(numLevels). Ids are small integers
+	(indices in the owner's pool), the bounds are kept per id.
+	Queries are const and thread safe against each other, not against inserts.
+*/
+
+class SpatialGrid {
+public:
+	static constexpr int numLevels = 12;
+	static constexpr int maxCellsPerAxis = 2;
+
+	struct Box {
+		double x0 = 0.0, y0 = 0.0, x1 = 0.0, y1 = 0.0;
+
+		bool intersects(const Box& o) const { return x0 <= o.x1 && o.x0 <= x1 && y0 <= o.y1 && o.y0 <= y1; }
+		Box getUnion(const Box& o) const { return { jmin(x0, o.x0), jmin(y0, o.y0), jmax(x1, o.x1), jmax(y1, o.y1) }; }
+	};
+
+	SpatialGrid() = default;
+
+	// finest cell, set before the first insert (derived from the first box otherwise)
+	void setCellSize(double width, double height);
+	double getCellWidth(int level = 0) const;
+	double getCellHeight(int level = 0) const;
+
+	void insert(uint32 id, const Box& bounds);
+	void remove(uint32 id);
+	void clear();
+	size_t size() const { return _numItems; }
+	bool contains(uint32 id) const { return id < _items.size() && _items[id].inserted; }
+	const Box& getBounds(uint32 id) const { return _items[id].bounds; }
+
+	// ids whose bounds intersect box, appended to out, sorted without duplicates
+	void query(const Box& box, std::vector<uint32>& out) const;
+
+private:
+	struct Item {
+		Box bounds;
+		bool inserted = false;
+	};
+	struct Level {
+		std::unordered_map<uint64, std::vector<uint32>> cells;
+		std::vector<uint32> oversized;
+	};
+	struct CellRange {
+		int64 x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+
+		int64 getNumCells() const { return (x1 - x0 + 1) * (y1 - y0 + 1); }
+	};
+
+	CellRange _getCells(int level, const Box& b) const;
+	static uint64 _getKey(int64 cx, int64 cy);
+	static void _erase(std::vector<uint32>& ids, uint32 id);
+
+	double _cellWidth = 0.0;
+	double _cellHeight = 0.0;
+	Level _levels[numLevels];
+	std::vector<Item> _items;
+	size_t _numItems = 0;
+
+	JUCE_DECLARE_NON_COPYABLE(SpatialGrid)
+};
@@ -0,0 +1,194 @@
+/*
+  ==============================================================================
+
+    VolumeProfile.cpp
+    Created: 15 Oct 2026 6:08:44pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "VolumeProfile.h"
+#include "../utils/TaskPool.h"
+
+namespace {
+	constexpr size_t parallelGrain = 1 << 16;
+	// log margin around the prices of build(), so that a growing series keeps its buckets a while
+	constexpr double priceMargin = 0.05;
+
+	double typicalPrice(const KlineStore& store, size_t row) {
+		return (store.getHigh()[row] + store.getLow()[row] + store.getClose()[row]) / 3.0;
+	}
+}
+
+void VolumeProfile::clear() {
+	_store = nullptr;
+	_numRows = 0;
+	_numBuckets = 0;
+	_bucketOf.clear();
+	_checkpoints.clear();
+	_first = _last = 0;
+	_incrementalSteps = 0;
+	_buy.clear();
+	_sell.clear();
+}
+
+void VolumeProfile::build(const KlineStore& store, int numBuckets) {
+	clear();
+	if (store.isEmpty())
+		return;
+	_store = &store;
+	_numRows = store.size();
+	_numBuckets = jlimit(1, 65536, numBuckets);
+
+	const Range<double> prices = store.computePriceRange(0, _numRows);
+	const double low = std::log(jmax(prices.getStart(), 1e-12));
+	const double high = std::log(jmax(prices.getEnd(), prices.getStart() * 1.0001, 1e-12));
+	const double margin = (high - low) * priceMargin;
+	_logLow = low - margin;
+	_logStep = (high - low + 2.0 * margin) / (double)_numBuckets;
+
+	_buy.assign((size_t)_numBuckets, 0.0);
+	_sell.assign((size_t)_numBuckets, 0.0);
+	_computeBuckets(0);
+	_computeCheckpoints(0);
+	_incrementalSteps = maxIncrementalSteps;
+}
+
+void VolumeProfile::update(const KlineStore& store, size_t fromRow) {
+	if (_store != &store || _numRows == 0 || fromRow > _numRows) {
+		build(store, _numBuckets > 0 ? _numBuckets : defaultNumBuckets);
+		return;
+	}
+	const double lowest = getBucketPrice(0), highest = getBucketPrice(_numBuckets);
+	const size_t numRows = store.size();
+	for (size_t row = fromRow; row < numRows; ++row) {
+		const double price = typicalPrice(store, row);
+		if (!(price >= lowest && price < highest)) {
+			build(store, _numBuckets);
+			return;
+		}
+	}
+	_numRows = numRows;
+	_computeBuckets(fromRow);
+	_computeCheckpoints(fromRow / blockRows);
+	// the current sums may count rows that changed
+	_incrementalSteps = maxIncrementalSteps;
+	_first = jmin(_first, _numRows);
+	_last = jmin(_last, _numRows);
+}
+
+int VolumeProfile::getBucket(double price) const {
+	if (!(price > 0.0))
+		return 0;
+	return jlimit(0, _numBuckets - 1, (int)((std::log(price) - _logLow) / _logStep));
+}
+
+void VolumeProfile::_computeBuckets(size_t fromRow) {
+	_bucketOf.resize(_numRows);
+	TaskPool::getInstance().parallelFor(_numRows - fromRow, parallelGrain, [&](size_t first, size_t last) {
+		for (size_t row = fromRow + first; row < fromRow + last; ++row)
+			_bucketOf[row] = (uint16)getBucket(typicalPrice(*_store, row));
+	});
+}
+
+void VolumeProfile::_computeCheckpoints(size_t fromBlock) {
+	// boundary k holds the sums of the rows [0, k * blockRows)
+	const size_t numBoundaries = _numRows / blockRows + 1;
+	const size_t stride = (size_t)_numBuckets * 2;
+	_checkpoints.resize(numBoundaries * stride);
+	if (fromBlock == 0)
+		std::fill(_checkpoints.begin(), _checkpoints.begin() + (std::ptrdiff_t)stride, 0.0);
+	fromBlock = jmax((size_t)1, fromBlock + 1);
+	if (fromBlock >= numBoundaries)
+		return;
+
+	// the sums of every block apart, in parallel, then prefixed
+	const double* volume = _store->getVolume();
+	const double* buy = _store->getDoubleColumn(KlineStore::takerBuyBaseVolume);
+	TaskPool::getInstance().parallelFor(numBoundaries - fromBlock, 1, [&](size_t first, size_t last) {
+		for (size_t k = fromBlock + first; k < fromBlock + last; ++k) {
+			double* sums = _checkpoints.data() + k * stride;
+			std::fill(sums, sums + stride, 0.0);
+			for (size_t row = (k - 1) * blockRows; row < k * blockRows; ++row) {
+				double* bucket = sums + (size_t)_bucketOf[row] * 2;
+				bucket[0] += buy[row];
+				bucket[1] += volume[row] - buy[row];
+			}
+		}
+	});
+	for (size_t k = fromBlock; k < numBoundaries; ++k) {
+		const double* previous = _checkpoints.data() + (k - 1) * stride;
+		double* sums = _checkpoints.data() + k * stride;
+		for (size_t i = 0; i < stride; ++i)
+			sums[i] += previous[i];
+	}
+}
+
+void VolumeProfile::_addRows(size_t first, size_t last, double sign) {
+	const double* volume = _store->getVolume();
+	const double* buy = _store->getDoubleColumn(KlineStore::takerBuyBaseVolume);
+	for (size_t row = first; row < last; ++row) {
+		const uint16 b = _bucketOf[row];
+		_buy[b] += sign * buy[row];
+		_sell[b] += sign * (volume[row] - buy[row]);
+	}
+}
+
+void VolumeProfile::_fromCheckpoints(size_t first, size_t last) {
+	const size_t fromBlock = (first + blockRows - 1) / blockRows;
+	const size_t toBlock = last / blockRows;
+	if (fromBlock >= toBlock) {
+		std::fill(_buy.begin(), _buy.end(), 0.0);
+		std::fill(_sell.begin(), _sell.end(), 0.0);
+		_addRows(first, last, 1.0);
+		return;
+	}
+	const double* low = _checkpoints.data() + fromBlock * (size_t)_numBuckets * 2;
+	const double* high = _checkpoints.data() + toBlock * (size_t)_numBuckets * 2;
+	for (int b = 0; b < _numBuckets; ++b) {
+		_buy[(size_t)b] = high[b * 2] - low[b * 2];
+		_sell[(size_t)b] = high[b * 2 + 1] - low[b * 2 + 1];
+	}
+	_addRows(first, fromBlock * blockRows, 1.0);
+	_addRows(toBlock * blockRows, last, 1.0);
+}
+
+void VolumeProfile::setRange(size_t first, size_t last) {
+	if (_numRows == 0)
+		return;
+	last = jmin(last, _numRows);
+	first = jmin(first, last);
+	if (first == _first && last == _last && _incrementalSteps < maxIncrementalSteps)
+		return;
+
+	// S[first, last) = S[_first, _last) + S[first, _first) + S[_last, last), intervals signed
+	const size_t moved = (first > _first ? first - _first : _first - first)
+					   + (last > _last ? last - _last : _last - last);
+	if (_incrementalSteps < maxIncrementalSteps && moved < (size_t)_numBuckets + 2 * blockRows) {
+		if (first < _first) _addRows(first, _first, 1.0);
+		else _addRows(_first, first, -1.0);
+		if (last > _last) _addRows(_last, last, 1.0);
+		else _addRows(last, _last, -1.0);
+		++_incrementalSteps;
+	}
+	else {
+		_fromCheckpoints(first, last);
+		_incrementalSteps = 0;
+	}
+	_first = first;
+	_last = last;
+}
+
+int VolumeProfile::getPointOfControl() const {
+	int best = -1;
+	double bestVolume = 0.0;
+	for (int b = 0; b < (int)_buy.size(); ++b) {
+		const double v = _buy[(size_t)b] + _sell[(size_t)b];
+		if (v > bestVolume) {
+			bestVolume = v;
+			best = b;
+		}
+	}
+	return best;
+}
@@ -0,0 +1,79 @@
+/*
+  ==============================================================================
+
+    VolumeProfile.h
+    Created: 15 Oct 2026 6:08:44pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+#include "KlineStore.h"
+
+/*
+	Volume by price of a row range of a KlineStore, the buy (taker buy base)
+	and sell parts apart.
+
+	Prices are split in numBuckets buckets of the same ratio between the
+	lowest low and the highest high of the store (log buckets : 2048 of them
+	over a 10x range are 0.11% each, whatever the price zoom). The volume of a
+	row goes to the bucket of its typical price (high + low + close) / 3.
+
+	Every blockRows rows a checkpoint keeps the prefix sums of every bucket, so
+	the profile of any range is two checkpoints subtracted plus the rows of
+	the partial blocks at both ends : O(numBuckets + blockRows) whatever the
+	number of rows. setRange() is incremental on top of it : when the range
+	only moved a little, the rows that left are subtracted and the rows that
+	entered are added. Memory : 2 bytes per row + 16 bytes per bucket per block.
+*/
+
+class VolumeProfile {
+public:
+	static constexpr size_t blockRows = 8192;
+	static constexpr int defaultNumBuckets = 2048;
+	// incremental updates before the sums are taken from the checkpoints again (rounding)
+	static constexpr int maxIncrementalSteps = 256;
+
+	VolumeProfile() = default;
+
+	void build(const KlineStore& store, int numBuckets = defaultNumBuckets);
+	// same series grown or with its tail rewritten from fromRow, rebuilt when the new
+	// prices leave the buckets
+	void update(const KlineStore& store, size_t fromRow);
+	void clear();
+
+	bool isEmpty() const { return _numRows == 0; }
+	int getNumBuckets() const { return _numBuckets; }
+	// bucket b covers [getBucketPrice(b), getBucketPrice(b + 1))
+	double getBucketPrice(int bucket) const { return std::exp(_logLow + _logStep * (double)bucket); }
+	int getBucket(double price) const;
+
+	// volumes of the rows [first, last) per bucket
+	void setRange(size_t first, size_t last);
+	size_t getFirstRow() const { return _first; }
+	size_t getLastRow() const { return _last; }
+	const std::vector<double>& getBuyVolumes() const { return _buy; }
+	const std::vector<double>& getSellVolumes() const { return _sell; }
+	// bucket with the most volume (point of control), -1 when empty
+	int getPointOfControl() const;
+
+private:
+	void _computeBuckets(size_t fromRow);
+	void _computeCheckpoints(size_t fromBlock);
+	void _fromCheckpoints(size_t first, size_t last);
+	// adds (sign 1) or subtracts (-1) rows [first, last) to the current sums
+	void _addRows(size_t first, size_t last, double sign);
+
+	const KlineStore* _store = nullptr;
+	size_t _numRows = 0;
+	int _numBuckets = 0;
+	double _logLow = 0.0, _logStep = 1.0;
+	std::vector<uint16> _bucketOf;      // per row
+	std::vector<double> _checkpoints;   // (buy, sell) * numBuckets per block boundary
+
+	size_t _first = 0, _last = 0;
+	int _incrementalSteps = 0;
+	std::vector<double> _buy, _sell;
+};
@@ -0,0 +1,261 @@
+/*
+  ==============================================================================
+
+    BinanceDepthFeed.cpp
+    Created: 15 Oct 2026 8:47:53pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "BinanceDepthFeed.h"
+#include "../utils/NumberParsing.h"
+
+static constexpr int minReconnectDelayMs = 1000;
+static constexpr int maxReconnectDelayMs = 30000;
+// between two REST snapshots while out of sync (request weight)
+static constexpr uint32 minSnapshotIntervalMs = 1000;
+static constexpr int restTimeoutMs = 5000;
+
+static const char* findText(const char* p, const char* e, const char* text) {
+	return std::search(p, e, text, text + std::strlen(text));
+}
+
+// integer value of "key": (quoted or not), false when missing
+static bool findInt(const char* p, const char* e, const char* key, int64& value) {
+	const char* k = findText(p, e, key);
+	if (k == e)
+		return false;
+	p = k + std::strlen(key);
+	while (p < e && (*p == ':' || *p == ' ' || *p == '"'))
+		p++;
+	const char* end = p;
+	while (end < e && NumberParsing::isDigit(*end))
+		end++;
+	if (end == p)
+		return false;
+	value = NumberParsing::parseInt(p, end);
+	return true;
+}
+
+// [["price","quantity"],...] after "key":, false when missing or malformed
+static bool parseLevels(const char* p, const char* e, const char* key, std::vector<OrderBook::Level>& out) {
+	out.clear();
+	const char* k = findText(p, e, key);
+	if (k == e)
+		return false;
+	p = k + std::strlen(key);
+	while (p < e && *p != '[')
+		p++;
+	if (p == e)
+		return false;
+	p++;
+	auto nextString = [&](const char*& value) {
+		while (p < e && *p != '"' && *p != ']')
+			p++;
+		if (p >= e || *p == ']')
+			return (const char*)nullptr;
+		value = ++p;
+		while (p < e && *p != '"')
+			p++;
+		return p < e ? p++ : nullptr;
+	};
+	for (;;) {
+		while (p < e && (*p == ',' || *p == ' '))
+			p++;
+		if (p >= e)
+			return false;
+		if (*p == ']')
+			return true;
+		if (*p++ != '[')
+			return false;
+		const char* price;
+		const char* quantity;
+		const char* priceEnd = nextString(price);
+		const char* quantityEnd = priceEnd ? nextString(quantity) : nullptr;
+		if (quantityEnd == nullptr)
+			return false;
+		out.push_back({ NumberParsing::parseDouble(price, priceEnd), NumberParsing::parseDouble(quantity, quantityEnd) });
+		while (p < e && *p != ']')
+			p++;
+		p++;
+	}
+}
+
+BinanceDepthFeed::BinanceDepthFeed() {
+}
+
+BinanceDepthFeed::~BinanceDepthFeed() {
+	stop();
+}
+
+void BinanceDepthFeed::start(const String& symbol, double tickSize, int numTicks, const String& url, const String& restUrl) {
+	stop();
+	_symbol = symbol.trim().toUpperCase();
+	_url = url + _symbol.toLowerCase() + "@depth@100ms";
+	_restUrl = restUrl + "?symbol=" + _symbol + "&limit=" + String(snapshotLevels);
+	// a new book : the views holding the previous one keep a consistent, frozen state
+	_book = std::make_shared<OrderBook>(tickSize, numTicks);
+	_lastId = 0;
+	if (_recordFile != File())
+		_recording = std::make_unique<FileOutputStream>(_recordFile);
+	_thread = std::make_unique<ThreadLambda>("BinanceDepthFeed", [this] { _run(); });
+	_thread->startThread();
+}
+
+void BinanceDepthFeed::stop() {
+	if (_thread == nullptr)
+		return;
+	_thread->signalThreadShouldExit();
+	_client.close();
+	_thread->notify();
+	_thread->stopThread(restTimeoutMs + 1000);
+	_thread = nullptr;
+	_synced = false;
+	_recording = nullptr;
+	_replayClock = nullptr;
+}
+
+void BinanceDepthFeed::startReplay(const File& recording, double tickSize, ReplayClock::Ptr clock, int numTicks) {
+	stop();
+	_replayFile = recording;
+	_replayClock = clock != nullptr ? clock : std::make_shared<ReplayClock>();
+	_replayFinished = false;
+	_book = std::make_shared<OrderBook>(tickSize, numTicks);
+	_lastId = 0;
+	_thread = std::make_unique<ThreadLambda>("BinanceDepthFeed", [this] { _runReplay(); });
+	_thread->startThread();
+}
+
+void BinanceDepthFeed::_run() {
+	MemoryBlock buffer(64 << 10);
+	size_t size = 0;
+	int delay = minReconnectDelayMs;
+	while (!_thread->threadShouldExit()) {
+		_synced = false;
+		if (!_client.connect(_url)) {
+			_thread->wait(delay);
+			delay = jmin(delay * 2, maxReconnectDelayMs);
+			continue;
+		}
+		delay = minReconnectDelayMs;
+		// the events received while the snapshot is fetched wait in the socket
+		bool needSnapshot = true;
+		uint32 nextSnapshot = 0;
+		while (!_thread->threadShouldExit() && _client.receive(buffer, size)) {
+			if (!parseDiff(static_cast<const char*>(buffer.getData()), size, _update))
+				continue;
+			_received.fetch_add(1, std::memory_order_relaxed);
+			if (needSnapshot && Time::getMillisecondCounter() >= nextSnapshot) {
+				nextSnapshot = Time::getMillisecondCounter() + minSnapshotIntervalMs;
+				needSnapshot = !_fetchSnapshot();
+			}
+			// after the snapshot it follows, a replay applies them in the same order
+			_record(static_cast<const char*>(buffer.getData()), size);
+			if (!needSnapshot)
+				needSnapshot = !_handleDiff(_update);
+		}
+		_client.close();
+	}
+}
+
+void BinanceDepthFeed::_runReplay() {
+	// mapped : the lines are parsed in place
+	MemoryMappedFile map(_replayFile, MemoryMappedFile::readOnly);
+	const char* p = static_cast<const char*>(map.getData());
+	const char* e = p + (p != nullptr ? map.getSize() : 0);
+	bool needSnapshot = true;
+	while (p < e && !_thread->threadShouldExit()) {
+		const char* line = p;
+		while (p < e && *p != '\n')
+			p++;
+		const size_t size = (size_t)(p - line);
+		p++;
+		if (parseDiff(line, size, _update)) {
+			if (!_replayClock->waitUntil(_update.time, *_thread))
+				return;
+			_received.fetch_add(1, std::memory_order_relaxed);
+			if (!needSnapshot)
+				needSnapshot = !_handleDiff(_update);
+		}
+		else if (parseSnapshot(line, size, _snapshot)) {
+			_apply(_snapshot, true);
+			_lastId = _snapshot.lastId;
+			needSnapshot = false;
+		}
+	}
+	_replayFinished = true;
+}
+
+bool BinanceDepthFeed::_handleDiff(const Update& update) {
+	// already in the snapshot
+	if (update.lastId <= _lastId)
+		return true;
+	if (update.firstId > _lastId + 1) {
+		_synced = false;
+		_resyncs.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+	_apply(update, false);
+	_lastId = update.lastId;
+	_synced = true;
+	return true;
+}
+
+void BinanceDepthFeed::_record(const char* text, size_t size) {
+	if (_recording == nullptr)
+		return;
+	_recording->write(text, size);
+	_recording->write("\n", 1);
+}
+
+bool BinanceDepthFeed::_fetchSnapshot() {
+	auto stream = URL(_restUrl).createInputStream(URL::InputStreamOptions(URL::ParameterHandling::inAddress)
+		.withConnectionTimeoutMs(restTimeoutMs));
+	if (stream == nullptr)
+		return false;
+	const String text = stream->readEntireStreamAsString();
+	if (!parseSnapshot(text.toRawUTF8(), text.getNumBytesAsUTF8(), _snapshot))
+		return false;
+	_record(text.toRawUTF8(), text.getNumBytesAsUTF8());
+	_apply(_snapshot, true);
+	_lastId = _snapshot.lastId;
+	return true;
+}
+
+void BinanceDepthFeed::_apply(const Update& update, bool replace) {
+	auto& book = *_book;
+	book.beginUpdate();
+	if (replace)
+		book.clear();
+	for (const auto& l : update.bids)
+		book.set(true, l.price, l.quantity);
+	for (const auto& l : update.asks)
+		book.set(false, l.price, l.quantity);
+	book.endUpdate(update.lastId, update.time);
+}
+
+bool BinanceDepthFeed::parseDiff(const char* text, size_t size, Update& update) {
+	const char* e = text + size;
+	const char* p = findText(text, e, "\"e\":\"depthUpdate\"");
+	if (p == e)
+		return false;
+	int64 first = 0, last = 0, time = 0;
+	if (!findInt(p, e, "\"U\"", first) || !findInt(p, e, "\"u\"", last))
+		return false;
+	findInt(p, e, "\"E\"", time);
+	update.firstId = (uint64)first;
+	update.lastId = (uint64)last;
+	update.time = time;
+	return parseLevels(p, e, "\"b\"", update.bids) && parseLevels(p, e, "\"a\"", update.asks);
+}
+
+bool BinanceDepthFeed::parseSnapshot(const char* text, size_t size, Update& update) {
+	const char* e = text + size;
+	int64 id = 0;
+	if (!findInt(text, e, "\"lastUpdateId\"", id))
+		return false;
+	update.firstId = update.lastId = (uint64)id;
+	update.time = 0;
+	return parseLevels(text, e, "\"bids\"", update.bids) && parseLevels(text, e, "\"asks\"", update.asks);
+}
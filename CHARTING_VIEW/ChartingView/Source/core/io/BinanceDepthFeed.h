@@ -0,0 +1,111 @@
+/*
+  ==============================================================================
+
+    BinanceDepthFeed.h
+    Created: 15 Oct 2026 8:47:53pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+#include "WebSocketClient.h"
+#include "ReplayClock.h"
+#include "../data/OrderBook.h"
+#include "../utils/ThreadLambda.h"
+
+/*
+	Local order book of one symbol kept from the Binance diff depth stream
+	(<symbol>@depth@100ms), following the documented procedure : open the
+	stream, fetch a REST snapshot (/api/v3/depth), drop the events it already
+	contains, then apply every event in order. A gap in the update ids (a lost
+	message) fetches a new snapshot.
+
+	The ingestion thread is the single producer of the OrderBook : it decodes
+	each message in place (no allocation once warmed up) and applies its levels
+	as one update, readers take snapshots without ever blocking it.
+
+		feed.start("BTCUSDT", 0.01);
+		depthView.setBook(feed.getBook());
+
+	A recording (setRecordFile) keeps the snapshots and events as received, one
+	message per line, in the order they were applied. startReplay() reads it
+	back through the same parsing, syncing and book updates at the speed of a
+	ReplayClock, the event times (E) set the pace.
+*/
+
+class BinanceDepthFeed {
+public:
+	static constexpr const char* defaultUrl = "wss://stream.binance.com:9443/ws/";
+	static constexpr const char* defaultRestUrl = "https://api.binance.com/api/v3/depth";
+	static constexpr int snapshotLevels = 1000;
+
+	// one diff event or REST snapshot, the level storage is reused between messages
+	struct Update {
+		uint64 firstId = 0;     // U, lastUpdateId for a snapshot
+		uint64 lastId = 0;      // u, lastUpdateId for a snapshot
+		int64 time = 0;         // E, 0 for a snapshot
+		std::vector<OrderBook::Level> bids, asks;  // quantity 0 removes the level
+	};
+
+	BinanceDepthFeed();
+	~BinanceDepthFeed();
+
+	// message thread. tickSize is the price step of the symbol; restarts with a new book
+	void start(const String& symbol, double tickSize, int numTicks = 1 << 16,
+			   const String& url = defaultUrl, const String& restUrl = defaultRestUrl);
+	void stop();
+	bool isRunning() const { return _thread != nullptr; }
+
+	// message thread, before start() : the next connections append their messages to file,
+	// none after a default File
+	void setRecordFile(const File& file) { _recordFile = file; }
+	// message thread. A recording written by setRecordFile() instead of the stream, a new book
+	void startReplay(const File& recording, double tickSize, ReplayClock::Ptr clock = nullptr, int numTicks = 1 << 16);
+	bool isReplaying() const { return isRunning() && _replayClock != nullptr; }
+	// the last message of the recording was applied
+	bool isReplayFinished() const { return _replayFinished.load(std::memory_order_acquire); }
+
+	const String& getSymbol() const { return _symbol; }
+	OrderBook::Ptr getBook() const { return _book; }
+
+	// the book follows the stream (a snapshot was applied and no id is missing since)
+	bool isSynced() const { return _synced.load(std::memory_order_relaxed); }
+	bool isConnected() const { return _client.isConnected(); }
+	uint64 getNumReceived() const { return _received.load(std::memory_order_relaxed); }
+	uint64 getNumResyncs() const { return _resyncs.load(std::memory_order_relaxed); }
+
+	// decode a diff event ({"e":"depthUpdate",...}, raw or in a combined stream) / a REST snapshot
+	static bool parseDiff(const char* text, size_t size, Update& update);
+	static bool parseSnapshot(const char* text, size_t size, Update& update);
+
+private:
+	void _run();
+	void _runReplay();
+	bool _fetchSnapshot();
+	// the next event of the stream, false when a snapshot is needed first (a gap)
+	bool _handleDiff(const Update& update);
+	void _record(const char* text, size_t size);
+	// one book update, replace : the whole book (snapshot)
+	void _apply(const Update& update, bool replace);
+
+	String _symbol;
+	String _url, _restUrl;
+	OrderBook::Ptr _book;
+	UPtr<ThreadLambda> _thread;
+	WebSocketClient _client;
+	// ingestion thread only
+	Update _update, _snapshot;
+	uint64 _lastId = 0;
+	File _recordFile, _replayFile;
+	UPtr<FileOutputStream> _recording;
+	ReplayClock::Ptr _replayClock;
+	std::atomic<bool> _replayFinished{ false };
+
+	std::atomic<bool> _synced{ false };
+	std::atomic<uint64> _received{ 0 };
+	std::atomic<uint64> _resyncs{ 0 };
+
+	JUCE_DECLARE_NON_COPYABLE(BinanceDepthFeed)
+};
@@ -0,0 +1,340 @@
+/*
+  ==============================================================================
+
+    BinanceKlineFeed.cpp
+    Created: 14 Oct 2026 6:15:21pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "BinanceKlineFeed.h"
+#include "../utils/NumberParsing.h"
+
+static constexpr int minReconnectDelayMs = 1000;
+static constexpr int maxReconnectDelayMs = 30000;
+
+static const char* findText(const char* p, const char* e, const char* text) {
+	return std::search(p, e, text, text + std::strlen(text));
+}
+
+static void copySymbol(char* dest, const char* p, const char* e) {
+	int n = 0;
+	while (p + n < e && n < BinanceKlineFeed::maxSymbolLength) {
+		dest[n] = p[n];
+		n++;
+	}
+	dest[n] = 0;
+}
+
+BinanceKlineFeed::BinanceKlineFeed(size_t queueCapacity, size_t seriesCapacity)
+	: _seriesCapacity(seriesCapacity), _queue(queueCapacity) {
+	_drainer.onAsyncUpdate = [this] { _drain(); };
+}
+
+BinanceKlineFeed::~BinanceKlineFeed() {
+	stop();
+}
+
+void BinanceKlineFeed::start(const StringArray& symbols, const String& interval, const String& url) {
+	stop();
+	StringArray names;
+	for (const auto& s : symbols)
+		names.add(s.trim().toUpperCase());
+	names.removeEmptyStrings();
+	names.removeDuplicates(false);
+	_setSymbols(names);
+	_interval = interval;
+
+	for (int first = 0; first < _symbols.size(); first += maxStreamsPerConnection) {
+		auto c = std::make_unique<Connection>();
+		String streams;
+		for (int i = first; i < jmin(first + maxStreamsPerConnection, _symbols.size()); i++)
+			streams << (i > first ? "/" : "") << _symbols[i].toLowerCase() << "@kline_" << interval;
+		c->url = url + streams;
+		Connection* raw = c.get();
+		c->thread.onRun = [this, raw] { _run(*raw); };
+		_connections.push_back(std::move(c));
+	}
+	for (auto& c : _connections)
+		c->thread.startThread();
+}
+
+void BinanceKlineFeed::startReplay(const StringArray& symbols, const std::vector<KlineStore::Ptr>& stores, const Replay& replay) {
+	stop();
+	// the stores follow the symbols : no cleanup of the names
+	jassert(symbols.size() == (int)stores.size());
+	StringArray names;
+	for (const auto& s : symbols)
+		names.add(s.trim().toUpperCase());
+	_setSymbols(names);
+	_interval = !stores.empty() && stores[0] != nullptr ? stores[0]->getInterval() : String();
+
+	_replayStores = stores;
+	_replayStores.resize((size_t)_symbols.size());
+	_ticksPerKline = jmax(1, replay.ticksPerKline);
+	_replayClock = replay.clock != nullptr ? replay.clock : std::make_shared<ReplayClock>();
+	_replayFinished = false;
+	auto c = std::make_unique<Connection>();
+	Connection* raw = c.get();
+	c->thread.onRun = [this, raw] { _runReplay(*raw); };
+	_connections.push_back(std::move(c));
+	_connections.back()->thread.startThread();
+}
+
+void BinanceKlineFeed::_setSymbols(const StringArray& symbols) {
+	_symbols = symbols;
+	_series.clear();
+	_keys.clear();
+	for (int i = 0; i < _symbols.size(); i++) {
+		_series.push_back(std::make_shared<KlineRingSeries>(_seriesCapacity));
+		SymbolKey key = {};
+		_symbols[i].copyToUTF8(key.name, sizeof(key.name));
+		key.index = i;
+		_keys.push_back(key);
+	}
+	std::sort(_keys.begin(), _keys.end(), [](const SymbolKey& a, const SymbolKey& b) {
+		return std::memcmp(a.name, b.name, sizeof(a.name)) < 0;
+	});
+}
+
+void BinanceKlineFeed::stop() {
+	for (auto& c : _connections) {
+		c->thread.signalThreadShouldExit();
+		c->client.close();
+		c->thread.notify();
+	}
+	for (auto& c : _connections)
+		c->thread.stopThread(4000);
+	_connections.clear();
+
+	// the indices of the queued events belong to the previous symbols
+	_drainer.cancelPendingUpdate();
+	Event e;
+	while (_queue.tryPop(e)) {}
+	_drainPending = false;
+	_replayStores.clear();
+	_replayClock = nullptr;
+}
+
+void BinanceKlineFeed::drain() {
+	_drainer.cancelPendingUpdate();
+	_drain();
+}
+
+KlineRingSeries::Ptr BinanceKlineFeed::getSeries(int index) const {
+	return isPositiveAndBelow(index, (int)_series.size()) ? _series[(size_t)index] : nullptr;
+}
+
+int BinanceKlineFeed::getNumConnected() const {
+	int n = 0;
+	for (auto& c : _connections)
+		n += c->client.isConnected() ? 1 : 0;
+	return n;
+}
+
+void BinanceKlineFeed::_run(Connection& c) {
+	MemoryBlock buffer(64 << 10);
+	size_t size = 0;
+	Event event;
+	int delay = minReconnectDelayMs;
+	while (!c.thread.threadShouldExit()) {
+		if (!c.client.connect(c.url)) {
+			c.thread.wait(delay);
+			delay = jmin(delay * 2, maxReconnectDelayMs);
+			continue;
+		}
+		delay = minReconnectDelayMs;
+		// Binance drops the connections after 24h, the loop reconnects
+		while (!c.thread.threadShouldExit() && c.client.receive(buffer, size)) {
+			if (!parseMessage(static_cast<const char*>(buffer.getData()), size, event))
+				continue;
+			event.symbolIndex = _findSymbol(event.symbol);
+			if (event.symbolIndex >= 0) {
+				_received.fetch_add(1, std::memory_order_relaxed);
+				if (!_push(event))
+					_dropped.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+		c.client.close();
+	}
+}
+
+void BinanceKlineFeed::_runReplay(Connection& c) {
+	struct Cursor {
+		int64 time = 0;   // of the next event
+		int symbol = 0;
+		size_t row = 0;
+		int tick = 0;
+	};
+	// the candle span, from the next row (the previous one for the last row)
+	auto getSpan = [](const KlineStore& store, size_t row) {
+		const int64* times = store.getOpenTime();
+		if (row + 1 < store.size())
+			return jmax((int64)1, times[row + 1] - times[row]);
+		return row > 0 ? jmax((int64)1, times[row] - times[row - 1]) : (int64)60000;
+	};
+	const int n = _ticksPerKline;
+	// the tick t of a candle goes out at the t + 1 / n of its span, the last one at its close time
+	auto getTickTime = [n](int64 openTime, int64 span, int tick) {
+		return tick == n - 1 ? openTime + span - 1 : openTime + span * (tick + 1) / n;
+	};
+	auto later = [](const Cursor& a, const Cursor& b) {
+		return a.time != b.time ? a.time > b.time : a.symbol > b.symbol;
+	};
+
+	std::vector<Cursor> heap;
+	for (int i = 0; i < (int)_replayStores.size(); i++) {
+		const auto& store = _replayStores[(size_t)i];
+		if (store != nullptr && !store->isEmpty())
+			heap.push_back({ getTickTime(store->getOpenTime()[0], getSpan(*store, 0), 0), i, 0, 0 });
+	}
+	std::make_heap(heap.begin(), heap.end(), later);
+
+	Event event;
+	while (!heap.empty()) {
+		std::pop_heap(heap.begin(), heap.end(), later);
+		Cursor& cursor = heap.back();
+		if (!_replayClock->waitUntil(cursor.time, c.thread))
+			return;
+
+		const auto& store = *_replayStores[(size_t)cursor.symbol];
+		const size_t r = cursor.row;
+		const int64 openTime = store.getOpenTime()[r];
+		const int64 span = getSpan(store, r);
+		const double open = store.getOpen()[r];
+		const double close = store.getClose()[r];
+		event = Event();
+		_symbols[cursor.symbol].copyToUTF8(event.symbol, sizeof(event.symbol));
+		event.symbolIndex = cursor.symbol;
+		event.openTime = openTime;
+		event.closeTime = openTime + span - 1;
+		event.closed = cursor.tick == n - 1;
+		event.open = open;
+		if (event.closed) {
+			event.high = store.getHigh()[r];
+			event.low = store.getLow()[r];
+			event.close = close;
+			event.volume = store.getVolume()[r];
+		}
+		else {
+			// the forming candle walks from the open to the close, inside the recorded range
+			const double f = (double)(cursor.tick + 1) / (double)n;
+			event.close = open + (close - open) * f;
+			event.high = jmax(open, event.close);
+			event.low = jmin(open, event.close);
+			event.volume = store.getVolume()[r] * f;
+		}
+		// the replay waits on a full queue : as fast as possible is as fast as the drain
+		while (!_push(event)) {
+			if (c.thread.threadShouldExit())
+				return;
+			c.thread.wait(1);
+		}
+		_received.fetch_add(1, std::memory_order_relaxed);
+
+		if (++cursor.tick == n) {
+			cursor.tick = 0;
+			cursor.row++;
+		}
+		if (cursor.row < store.size()) {
+			cursor.time = getTickTime(store.getOpenTime()[cursor.row], getSpan(store, cursor.row), cursor.tick);
+			std::push_heap(heap.begin(), heap.end(), later);
+		}
+		else
+			heap.pop_back();
+	}
+	_replayFinished = true;
+}
+
+bool BinanceKlineFeed::_push(const Event& event) {
+	const bool pushed = _queue.tryPush(event);
+	// only the first push since the last drain posts a message
+	if (!_drainPending.exchange(true))
+		_drainer.triggerAsyncUpdate();
+	return pushed;
+}
+
+void BinanceKlineFeed::_drain() {
+	// reset before popping : a push landing after the last pop triggers the next drain
+	_drainPending = false;
+	Event e;
+	int n = 0;
+	while (_queue.tryPop(e)) {
+		_series[(size_t)e.symbolIndex]->update({ e.openTime, e.open, e.high, e.low, e.close, e.volume });
+		if (onKline)
+			onKline(e);
+		n++;
+	}
+	_applied.fetch_add((uint64)n, std::memory_order_relaxed);
+	if (n > 0 && onUpdated)
+		onUpdated();
+}
+
+int BinanceKlineFeed::_findSymbol(const char* name) const {
+	SymbolKey key = {};
+	copySymbol(key.name, name, name + std::strlen(name));
+	auto it = std::lower_bound(_keys.begin(), _keys.end(), key, [](const SymbolKey& a, const SymbolKey& b) {
+		return std::memcmp(a.name, b.name, sizeof(a.name)) < 0;
+	});
+	return it != _keys.end() && std::memcmp(it->name, key.name, sizeof(key.name)) == 0 ? it->index : -1;
+}
+
+bool BinanceKlineFeed::parseMessage(const char* text, size_t size, Event& event) {
+	const char* e = text + size;
+	const char* k = findText(text, e, "\"k\":{");
+	if (k == e)
+		return false;
+
+	event = Event();
+	bool hasOpenTime = false;
+	// the payload is flat : "t":123,"s":"BTCUSDT","o":"0.0010",...,"x":false
+	const char* p = k + 5;
+	while (p < e && *p != '}') {
+		while (p < e && *p != '"' && *p != '}')
+			p++;
+		if (p >= e || *p == '}')
+			break;
+		const char* key = ++p;
+		while (p < e && *p != '"')
+			p++;
+		const size_t keySize = (size_t)(p - key);
+		p++;
+		while (p < e && (*p == ':' || *p == ' '))
+			p++;
+
+		const char* value = p;
+		const char* valueEnd;
+		if (p < e && *p == '"') {
+			value = ++p;
+			while (p < e && *p != '"')
+				p++;
+			valueEnd = p++;
+		}
+		else {
+			while (p < e && *p != ',' && *p != '}')
+				p++;
+			valueEnd = p;
+		}
+		if (keySize != 1)
+			continue;
+
+		switch (*key) {
+			case 't': event.openTime = NumberParsing::parseInt(value, valueEnd); hasOpenTime = true; break;
+			case 'T': event.closeTime = NumberParsing::parseInt(value, valueEnd); break;
+			case 's': copySymbol(event.symbol, value, valueEnd); break;
+			case 'o': event.open = NumberParsing::parseDouble(value, valueEnd); break;
+			case 'h': event.high = NumberParsing::parseDouble(value, valueEnd); break;
+			case 'l': event.low = NumberParsing::parseDouble(value, valueEnd); break;
+			case 'c': event.close = NumberParsing::parseDouble(value, valueEnd); break;
+			case 'v': event.volume = NumberParsing::parseDouble(value, valueEnd); break;
+			case 'n': event.numberOfTrades = NumberParsing::parseInt(value, valueEnd); break;
+			case 'x': event.closed = value < valueEnd && *value == 't'; break;
+			case 'q': event.quoteAssetVolume = NumberParsing::parseDouble(value, valueEnd); break;
+			case 'V': event.takerBuyBaseAssetVolume = NumberParsing::parseDouble(value, valueEnd); break;
+			case 'Q': event.takerBuyQuoteAssetVolume = NumberParsing::parseDouble(value, valueEnd); break;
+			default: break;
+		}
+	}
+	return hasOpenTime && event.symbol[0] != 0;
+}
@@ -0,0 +1,153 @@
+/*
+  ==============================================================================
+
+    BinanceKlineFeed.h
+    Created: 14 Oct 2026 6:15:21pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+#include "WebSocketClient.h"
+#include "ReplayClock.h"
+#include "../data/KlineRingSeries.h"
+#include "../data/KlineStore.h"
+#include "../utils/MpscQueue.h"
+#include "../utils/ThreadLambda.h"
+#include "../utils/AsyncUpdaterLambda.h"
+
+/*
+	Live klines of N symbols from the Binance combined streams
+	(<symbol>@kline_<interval>), the native replacement of the polling done by
+	crypto_monitor2.py and the html tools.
+
+	One ingestion thread per websocket connection (maxStreamsPerConnection
+	symbols each) decodes the messages in place into fixed size Events and
+	pushes them on a lock-free MPSC queue. The message thread drains the queue
+	in one go : the first push after a drain triggers the async update, the
+	following ones only enqueue, so a burst from 100+ symbols costs one message
+	loop callback per frame instead of one per tick.
+
+	The drain applies the events to one KlineRingSeries per symbol (the message
+	thread is their single producer), then calls onKline / onUpdated.
+
+		feed.start({ "BTCUSDT", "ETHUSDT" }, "1m");
+		chart.setLiveSeries(feed.getSeries("BTCUSDT"));
+		feed.onUpdated = [&] { chart.updateLiveSeries(); };
+
+	startReplay() feeds recorded klines to the same queue and drain instead of
+	the sockets : the views, indicators and repaints downstream see a live
+	feed, at the speed of a ReplayClock (ChartingBench replay/ is the load test).
+*/
+
+class BinanceKlineFeed {
+public:
+	static constexpr const char* defaultUrl = "wss://stream.binance.com:9443/stream?streams=";
+	static constexpr int maxStreamsPerConnection = 200;
+	static constexpr int maxSymbolLength = 15;
+
+	struct Event {
+		char symbol[maxSymbolLength + 1] = {};
+		int symbolIndex = -1;
+		bool closed = false;        // false while the candle is still forming
+		int64 openTime = 0;
+		int64 closeTime = 0;
+		int64 numberOfTrades = 0;
+		double open = 0, high = 0, low = 0, close = 0, volume = 0;
+		double quoteAssetVolume = 0;
+		double takerBuyBaseAssetVolume = 0;
+		double takerBuyQuoteAssetVolume = 0;
+	};
+
+	struct Replay {
+		// updates of the forming candle, the last one closes it (the stream sends one every ~2 s)
+		int ticksPerKline = 1;
+		// shared with a depth replay to keep them in step, a 1x one when null
+		ReplayClock::Ptr clock;
+	};
+
+	explicit BinanceKlineFeed(size_t queueCapacity = 1 << 14, size_t seriesCapacity = 1 << 16);
+	~BinanceKlineFeed();
+
+	// message thread. Restarts the connections, the series of the previous symbols are dropped
+	void start(const StringArray& symbols, const String& interval, const String& url = defaultUrl);
+	void stop();
+	bool isRunning() const { return !_connections.empty(); }
+
+	// message thread. The rows of stores[i] published as symbols[i], all of them in time
+	// order, through the queue and drain of the streams. Restarts like start()
+	void startReplay(const StringArray& symbols, const std::vector<KlineStore::Ptr>& stores, const Replay& replay);
+	bool isReplaying() const { return isRunning() && _replayClock != nullptr; }
+	// the last row of every store was published
+	bool isReplayFinished() const { return _replayFinished.load(std::memory_order_acquire); }
+	const ReplayClock::Ptr& getReplayClock() const { return _replayClock; }
+
+	const StringArray& getSymbols() const { return _symbols; }
+	const String& getInterval() const { return _interval; }
+	int indexOf(const String& symbol) const { return _symbols.indexOf(symbol, true); }
+	KlineRingSeries::Ptr getSeries(int index) const;
+	KlineRingSeries::Ptr getSeries(const String& symbol) const { return getSeries(indexOf(symbol)); }
+
+	int getNumConnected() const;
+	// events lost because the queue was full (the message thread stalled)
+	uint64 getNumDropped() const { return _dropped.load(std::memory_order_relaxed); }
+	uint64 getNumReceived() const { return _received.load(std::memory_order_relaxed); }
+	// events drained into the series
+	uint64 getNumApplied() const { return _applied.load(std::memory_order_relaxed); }
+
+	// message thread, drains the queue now instead of on the next message loop callback
+	// (headless loops : benchmarks, tests)
+	void drain();
+
+	// message thread, for every drained event in arrival order
+	std::function<void(const Event& event)> onKline;
+	// message thread, once per drain that applied events
+	std::function<void()> onUpdated;
+
+	// decodes a combined stream ({"stream":..,"data":{..}}) or raw kline message, no allocation
+	static bool parseMessage(const char* text, size_t size, Event& event);
+
+private:
+	struct Connection {
+		Connection() : thread("BinanceKlineFeed") {}
+		ThreadLambda thread;
+		WebSocketClient client;
+		String url;
+	};
+
+	struct SymbolKey {
+		char name[maxSymbolLength + 1];
+		int index;
+	};
+
+	void _run(Connection& c);
+	void _runReplay(Connection& c);
+	void _setSymbols(const StringArray& symbols);
+	// false when the queue is full
+	bool _push(const Event& event);
+	void _drain();
+	int _findSymbol(const char* name) const;
+
+	StringArray _symbols;
+	String _interval;
+	std::vector<SymbolKey> _keys;   // sorted by name, read by the ingestion threads
+	std::vector<KlineRingSeries::Ptr> _series;
+	std::vector<UPtr<Connection>> _connections;
+	size_t _seriesCapacity = 0;
+	// replay thread only once started
+	std::vector<KlineStore::Ptr> _replayStores;
+	int _ticksPerKline = 1;
+	ReplayClock::Ptr _replayClock;
+	std::atomic<bool> _replayFinished{ false };
+
+	MpscQueue<Event> _queue;
+	std::atomic<bool> _drainPending{ false };
+	std::atomic<uint64> _dropped{ 0 };
+	std::atomic<uint64> _received{ 0 };
+	std::atomic<uint64> _applied{ 0 };
+	AsyncUpdaterLambda _drainer;
+
+	JUCE_DECLARE_NON_COPYABLE(BinanceKlineFeed)
+};
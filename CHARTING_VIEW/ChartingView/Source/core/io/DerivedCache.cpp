@@ -0,0 +1,298 @@
+/*
+  ==============================================================================
+
+    DerivedCache.cpp
+    Created: 16 Oct 2026 6:24:15pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "DerivedCache.h"
+#include "../utils/TaskPool.h"
+
+namespace {
+
+struct Header {
+	char magic[4] = { 'T', 'D', 'R', 'V' };
+	uint32 version = DerivedCache::currentVersion;
+	int64 fileSize = 0;
+	int64 modTime = 0;
+	uint64 numRows = 0;
+	uint64 tailHash = 0;
+	uint32 numColumns = 0;
+	uint32 numState = 0;
+	uint32 paramsSize = 0;
+	char reserved[12] = {};
+
+	bool isValid() const {
+		return std::memcmp(magic, "TDRV", 4) == 0 && version == DerivedCache::currentVersion;
+	}
+};
+
+static_assert(sizeof(Header) == 64, "DerivedCache header is part of the file format");
+
+// FNV-1a
+uint64 hashBytes(uint64 h, const void* data, size_t size) {
+	const auto* p = static_cast<const uint8*>(data);
+	for (size_t i = 0; i < size; i++)
+		h = (h ^ p[i]) * 0x100000001b3ull;
+	return h;
+}
+
+String getIndicatorParams(const IndicatorEngine& engine, const KlineStore& store) {
+	String params = store.getInterval();
+	for (int i = 0; i < engine.getNumIndicators(); i++) {
+		const auto& in = engine.getInput(i);
+		params << ";" << engine.get(i)->getKey() << "@";
+		if (in.indicator >= 0)
+			params << in.indicator << "." << in.output;
+		else
+			params << (int)in.column;
+	}
+	return params;
+}
+
+}
+
+DerivedCache::Key DerivedCache::makeKey(const File& source, const KlineStore& store, size_t numRows) {
+	Key key;
+	key.fileSize = source.getSize();
+	key.modTime = source.getLastModificationTime().toMilliseconds();
+	key.numRows = numRows;
+	key.tailHash = hashTail(store, numRows);
+	return key;
+}
+
+uint64 DerivedCache::hashTail(const KlineStore& store, size_t numRows) {
+	uint64 h = hashBytes(0xcbf29ce484222325ull, &numRows, sizeof(numRows));
+	if (numRows < 2 || numRows > store.size())
+		return h;
+	const size_t last = numRows - 1;
+	const size_t first = last > tailRows ? last - tailRows : 0;
+	for (int c = 0; c < KlineStore::numColumns; c++) {
+		const auto* column = static_cast<const char*>(store.getColumnData((KlineStore::Column)c));
+		if (column != nullptr)
+			h = hashBytes(h, column + first * KlineStore::elementSize, (last - first) * KlineStore::elementSize);
+	}
+	return h;
+}
+
+File DerivedCache::getFile(const File& source, const String& kind, const String& params) {
+	return source.getParentDirectory()
+		.getChildFile(source.getFileName() + directoryExtension)
+		.getChildFile(kind + "_" + String::toHexString(params.hashCode64()) + ".bin");
+}
+
+size_t DerivedCache::read(const File& source, const String& kind, const String& params, const KlineStore& store, Entry& entry) {
+	entry = {};
+	FileInputStream in(getFile(source, kind, params));
+	Header h;
+	if (!in.openedOk() || in.read(&h, (int)sizeof(Header)) != (int)sizeof(Header) || !h.isValid())
+		return 0;
+	MemoryBlock savedParams(h.paramsSize);
+	if (in.read(savedParams.getData(), (int)h.paramsSize) != (int)h.paramsSize || savedParams.toString() != params)
+		return 0;
+	if (h.numRows == 0 || h.numRows > store.size())
+		return 0;
+
+	// the same file, or the rows it was computed from still end the same way
+	const bool unchanged = h.fileSize == source.getSize() && h.modTime == source.getLastModificationTime().toMilliseconds()
+		&& h.numRows == store.size();
+	if (!unchanged && h.tailHash != hashTail(store, (size_t)h.numRows))
+		return 0;
+
+	std::vector<uint64> sizes(h.numColumns);
+	entry.state.resize(h.numState);
+	bool ok = in.read(sizes.data(), (int)(sizes.size() * sizeof(uint64))) == (int)(sizes.size() * sizeof(uint64))
+		&& in.read(entry.state.data(), (int)(entry.state.size() * sizeof(double))) == (int)(entry.state.size() * sizeof(double));
+	entry.columns.resize(h.numColumns);
+	for (size_t c = 0; c < sizes.size() && ok; c++) {
+		// a truncated file is stale
+		if (sizes[c] * sizeof(double) > (uint64)in.getNumBytesRemaining()) {
+			ok = false;
+			break;
+		}
+		entry.columns[c].resize((size_t)sizes[c]);
+		const size_t bytes = (size_t)sizes[c] * sizeof(double);
+		ok = (size_t)in.read(entry.columns[c].data(), bytes) == bytes;
+	}
+	if (!ok) {
+		entry = {};
+		return 0;
+	}
+	return (size_t)h.numRows;
+}
+
+bool DerivedCache::write(const File& source, const String& kind, const String& params, const Key& key, const Entry& entry, String* error) {
+	const File file = getFile(source, kind, params);
+	if (!file.getParentDirectory().createDirectory()) {
+		if (error) *error = "Cannot create " + file.getParentDirectory().getFullPathName();
+		return false;
+	}
+	Header h;
+	h.fileSize = key.fileSize;
+	h.modTime = key.modTime;
+	h.numRows = key.numRows;
+	h.tailHash = key.tailHash;
+	h.numColumns = (uint32)entry.columns.size();
+	h.numState = (uint32)entry.state.size();
+	const auto paramsUtf8 = params.toUTF8();
+	h.paramsSize = (uint32)paramsUtf8.sizeInBytes() - 1;
+
+	// written next to the target and swapped in at the end, like KlineFile
+	TemporaryFile temp(file);
+	{
+		FileOutputStream out(temp.getFile());
+		if (!out.openedOk()) {
+			if (error) *error = "Cannot write " + temp.getFile().getFullPathName();
+			return false;
+		}
+		bool ok = out.write(&h, sizeof(Header)) && out.write(paramsUtf8.getAddress(), h.paramsSize);
+		for (const auto& c : entry.columns) {
+			const uint64 size = c.size();
+			ok = ok && out.write(&size, sizeof(size));
+		}
+		ok = ok && out.write(entry.state.data(), entry.state.size() * sizeof(double));
+		for (const auto& c : entry.columns)
+			ok = ok && out.write(c.data(), c.size() * sizeof(double));
+		out.flush();
+		if (!ok) {
+			if (error) *error = "Write failed " + temp.getFile().getFullPathName();
+			return false;
+		}
+	}
+	if (!temp.overwriteTargetFileWithTemporary()) {
+		if (error) *error = "Cannot replace " + file.getFullPathName();
+		return false;
+	}
+	return true;
+}
+
+void DerivedCache::writeInBackground(const File& source, const String& kind, const String& params, const Key& key, Entry entry) {
+	auto shared = std::make_shared<Entry>(std::move(entry));
+	TaskPool::getInstance().submit([source, kind, params, key, shared]() {
+		String error;
+		if (!write(source, kind, params, key, *shared, &error))
+			DBG("DerivedCache: " << error);
+	}, TaskPool::Priority::low);
+}
+
+void DerivedCache::buildLod(LodPyramid& lod, const KlineStore& store, const File& source) {
+	const String params = store.getInterval() + ";" + String(LodPyramid::firstLevel);
+	Entry entry;
+	const size_t cached = source.existsAsFile() ? read(source, "lod", params, store, entry) : 0;
+	if (cached > 0 && lod.restore(store, cached, std::move(entry.columns))) {
+		if (cached == store.size())
+			return;
+		lod.update(store, cached - 1);
+	}
+	else {
+		lod.build(store);
+	}
+	if (!source.existsAsFile() || store.size() < 2)
+		return;
+
+	// a copy of the stored levels, the pyramid goes on being updated meanwhile
+	Entry saved;
+	for (int level = LodPyramid::firstLevel; level < lod.getNumLevels(); level++) {
+		const auto l = lod.getLevel(level);
+		for (const double* column : { l.open, l.high, l.low, l.close })
+			saved.columns.emplace_back(column, column + l.size);
+	}
+	writeInBackground(source, "lod", params, makeKey(source, store, store.size()), std::move(saved));
+}
+
+KlineStore::Ptr DerivedCache::getTimeframe(KlineResampler& resampler, int64 period, const File& source) {
+	const auto& from = resampler.getSource();
+	if (!from || from->isEmpty() || period <= resampler.getSourcePeriod() || !source.existsAsFile())
+		return resampler.get(period);
+	const String params = from->getInterval() + ">" + KlineResampler::formatInterval(period);
+
+	// already aggregated in this session
+	if (resampler.getNumClosed(period) > 0)
+		return resampler.get(period);
+
+	Entry entry;
+	const size_t cached = read(source, "timeframe", params, *from, entry);
+	// every column the same size, a corrupt entry is aggregated again (and written over)
+	const bool valid = cached > 0 && entry.columns.size() == (size_t)KlineStore::numColumns && !entry.columns[0].empty()
+		&& std::all_of(entry.columns.begin(), entry.columns.end(), [&entry](const std::vector<double>& c) { return c.size() == entry.columns[0].size(); });
+	KlineStore::Ptr store;
+	size_t numClosed = 0;
+	if (valid) {
+		numClosed = entry.columns[0].size();
+		auto closed = KlineStore::allocate(numClosed + 1);
+		for (int c = 0; c < KlineStore::numColumns; c++)
+			std::memcpy(closed->getWritableColumnData((KlineStore::Column)c), entry.columns[(size_t)c].data(), numClosed * KlineStore::elementSize);
+		closed->setSize(numClosed);
+		store = resampler.restore(period, std::move(closed));
+	}
+	else {
+		store = resampler.get(period);
+	}
+
+	// written back when it has more closed candles than the cache
+	const size_t closedNow = resampler.getNumClosed(period);
+	if (!store || closedNow == 0 || (cached == from->size() && closedNow == numClosed))
+		return store;
+	Entry saved;
+	for (int c = 0; c < KlineStore::numColumns; c++) {
+		const auto* column = static_cast<const double*>(store->getColumnData((KlineStore::Column)c));
+		saved.columns.emplace_back(column, column + closedNow);
+	}
+	writeInBackground(source, "timeframe", params, makeKey(source, *from, from->size()), std::move(saved));
+	return store;
+}
+
+void DerivedCache::updateIndicators(IndicatorEngine& engine, const KlineStore& store, const File& source) {
+	if (!source.existsAsFile() || engine.getNumIndicators() == 0 || store.size() < 2) {
+		engine.update(store, 0);
+		return;
+	}
+	const String params = getIndicatorParams(engine, store);
+
+	// outputs of every indicator in order, state : per indicator its committed rows, state size and state
+	Entry entry;
+	const size_t cached = read(source, "indicators", params, store, entry);
+	bool restored = cached > 0;
+	size_t column = 0, s = 0;
+	for (int i = 0; i < engine.getNumIndicators() && restored; i++) {
+		auto* indicator = engine.get(i);
+		const size_t numOutputs = (size_t)indicator->getNumOutputs();
+		if (column + numOutputs > entry.columns.size() || s + 2 > entry.state.size()) {
+			restored = false;
+			break;
+		}
+		const size_t numCommitted = (size_t)entry.state[s];
+		const size_t stateSize = (size_t)entry.state[s + 1];
+		if (s + 2 + stateSize > entry.state.size()) {
+			restored = false;
+			break;
+		}
+		std::vector<std::vector<double>> outputs;
+		for (size_t o = 0; o < numOutputs; o++)
+			outputs.push_back(std::move(entry.columns[column + o]));
+		const std::vector<double> state(entry.state.begin() + (std::ptrdiff_t)(s + 2), entry.state.begin() + (std::ptrdiff_t)(s + 2 + stateSize));
+		restored = indicator->restore(std::move(outputs), cached, numCommitted, state);
+		column += numOutputs;
+		s += 2 + stateSize;
+	}
+	if (restored && cached == store.size())
+		return;
+	engine.update(store, restored ? cached - 1 : 0);
+
+	Entry saved;
+	for (int i = 0; i < engine.getNumIndicators(); i++) {
+		const auto* indicator = engine.get(i);
+		for (int o = 0; o < indicator->getNumOutputs(); o++) {
+			const auto output = indicator->getOutput(o);
+			saved.columns.emplace_back(output->begin(), output->begin() + (std::ptrdiff_t)indicator->size());
+		}
+		const auto state = indicator->getState();
+		saved.state.push_back((double)indicator->getNumCommitted());
+		saved.state.push_back((double)state.size());
+		saved.state.insert(saved.state.end(), state.begin(), state.end());
+	}
+	writeInBackground(source, "indicators", params, makeKey(source, store, store.size()), std::move(saved));
+}
@@ -0,0 +1,85 @@
+/*
+  ==============================================================================
+
+    DerivedCache.h
+    Created: 16 Oct 2026 6:24:15pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+#include "../data/KlineStore.h"
+#include "../data/LodPyramid.h"
+#include "../data/KlineResampler.h"
+#include "../data/IndicatorEngine.h"
+
+/*
+	On-disk cache of what is computed from a kline file (pyramids, resampled
+	timeframes, indicator columns), so opening the file again computes
+	nothing, or only the rows appended since.
+
+	One file per artifact in <source>.derived/ next to the source, named by
+	its kind and a hash of its parameters (the parameters are also stored and
+	compared). An entry is computed from the first numRows rows of a store and
+	keyed by the source identity :
+		size and mtime of the source file
+		hash of the tailRows rows before its last one (every column)
+	The last row may still be forming (the cached artifacts follow the
+	update(fromRow) contract of the data layer), it is always recomputed.
+
+	Reading an entry gives the rows it covers : all of them when the file did
+	not change, its numRows when the file changed but the rows it covers still
+	end with the same tail (appended to, like the downloader's csv and the
+	.klines cache), 0 when it is missing or stale. The artifact is restored
+	then extended from there, and written back when it grew.
+
+		DerivedCache::buildLod(lod, *store, file);               // instead of lod.build(*store)
+		auto h1 = DerivedCache::getTimeframe(resampler, 3600000, file);
+		DerivedCache::updateIndicators(engine, *h1, file);     // instead of engine.update(*h1, 0)
+
+	Writes go through a temporary file swapped in at the end, on the
+	TaskPool (low priority) with a copy of the columns : a reader sees the
+	previous entry or the new one.
+*/
+
+class DerivedCache {
+public:
+	static constexpr const char* directoryExtension = ".derived";
+	static constexpr uint32 currentVersion = 2;
+	static constexpr size_t tailRows = 256;
+
+	struct Key {
+		int64 fileSize = 0;
+		int64 modTime = 0;
+		uint64 numRows = 0;
+		uint64 tailHash = 0;
+	};
+
+	// columns of 8 byte values, int64 ones copied bit for bit
+	struct Entry {
+		std::vector<std::vector<double>> columns;
+		std::vector<double> state; // a few values the artifact needs to go on
+	};
+
+	// the source now and the first numRows rows of store
+	static Key makeKey(const File& source, const KlineStore& store, size_t numRows);
+	// hash of the rows [numRows - 1 - tailRows, numRows - 1)
+	static uint64 hashTail(const KlineStore& store, size_t numRows);
+	// <source>.derived/<kind>_<hash of params>.bin
+	static File getFile(const File& source, const String& kind, const String& params);
+
+	// rows of store the entry was computed from, 0 when missing or stale
+	static size_t read(const File& source, const String& kind, const String& params, const KlineStore& store, Entry& entry);
+	static bool write(const File& source, const String& kind, const String& params, const Key& key, const Entry& entry, String* error = nullptr);
+	// write() on the TaskPool, errors are dropped (the entry is computed again next time)
+	static void writeInBackground(const File& source, const String& kind, const String& params, const Key& key, Entry entry);
+
+	// lod.build(store), restored from the cache when it can be
+	static void buildLod(LodPyramid& lod, const KlineStore& store, const File& source);
+	// resampler.get(period) (source set), restored from the cache when it can be
+	static KlineStore::Ptr getTimeframe(KlineResampler& resampler, int64 period, const File& source);
+	// engine.update(store, 0), restored from the cache when it can be
+	static void updateIndicators(IndicatorEngine& engine, const KlineStore& store, const File& source);
+};
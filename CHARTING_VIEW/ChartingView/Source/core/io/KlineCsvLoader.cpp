@@ -0,0 +1,446 @@
+/*
+  ==============================================================================
+
+    KlineCsvLoader.cpp
+    Created: 14 Oct 2026 11:22:47am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "KlineCsvLoader.h"
+#include "KlineFile.h"
+#include "../utils/Simd.h"
+#include "../utils/NumberParsing.h"
+#include "../utils/TaskPool.h"
+
+namespace {
+
+constexpr int numCsvColumns = KlineStore::numColumns; // the 12th "ignore" column is skipped
+constexpr size_t minChunkSize = 1 << 20;
+constexpr size_t progressStep = 4 << 20;
+
+struct Chunk {
+	const char* begin = nullptr;
+	const char* end = nullptr;
+	size_t firstRow = 0;
+	size_t numRows = 0;   // upper bound from the newline count
+	size_t parsedRows = 0;
+};
+
+size_t countLines(const char* p, const char* e) {
+	size_t n = 0;
+	while (p + 16 <= e) {
+		n += (size_t)Simd::countBits(Simd::matchMask16(p, '\n'));
+		p += 16;
+	}
+	while (p < e)
+		n += *p++ == '\n';
+	return n;
+}
+
+bool hasContent(const char* p, const char* e) {
+	for (; p < e; p++)
+		if (*p != '\n' && *p != '\r' && *p != ' ')
+			return true;
+	return false;
+}
+
+class ChunkParser {
+public:
+	ChunkParser(Chunk& chunk, void* const* columns, const KlineCsvLoader::Options& options, std::atomic<size_t>& bytesDone, size_t totalBytes)
+		: _chunk(chunk), _columns(columns), _options(options), _bytesDone(bytesDone), _totalBytes(totalBytes) {
+		_row = chunk.firstRow;
+		_rowEnd = chunk.firstRow + chunk.numRows;
+	}
+
+	void run() {
+		const char* p = _chunk.begin;
+		const char* e = _chunk.end;
+		const char* fieldStart = p;
+		const char* lastReport = p;
+
+		while (p + 16 <= e) {
+			uint32 m = Simd::matchMask16(p, ',', '\n');
+			while (m != 0) {
+				const char* sep = p + Simd::countTrailingZeros(m);
+				m &= m - 1;
+				_onField(fieldStart, sep);
+				fieldStart = sep + 1;
+				if (*sep == '\n')
+					_onEndOfLine();
+			}
+			p += 16;
+
+			if (p - lastReport >= (ptrdiff_t)progressStep) {
+				if (_shouldCancel())
+					return;
+				_report((size_t)(p - lastReport));
+				lastReport = p;
+			}
+		}
+		for (; p < e; p++) {
+			if (*p == ',' || *p == '\n') {
+				_onField(fieldStart, p);
+				fieldStart = p + 1;
+				if (*p == '\n')
+					_onEndOfLine();
+			}
+		}
+		if (fieldStart < e && hasContent(fieldStart, e)) {
+			_onField(fieldStart, e);
+			_onEndOfLine();
+		}
+		_report((size_t)(e - lastReport));
+		_chunk.parsedRows = _row - _chunk.firstRow;
+	}
+
+private:
+	void _onField(const char* b, const char* e) {
+		if (_field < numCsvColumns && _row < _rowEnd) {
+			void* col = _columns[_field];
+			if (KlineStore::isIntegerColumn((KlineStore::Column)_field))
+				static_cast<int64*>(col)[_row] = NumberParsing::parseInt(b, e);
+			else
+				static_cast<double*>(col)[_row] = NumberParsing::parseDouble(b, e);
+		}
+		_field++;
+	}
+
+	void _onEndOfLine() {
+		// partial lines (blank, truncated by a crash of the downloader) are dropped
+		if (_field >= KlineStore::closeTime && _row < _rowEnd) {
+			for (int f = _field; f < numCsvColumns; f++)
+				static_cast<int64*>(_columns[f])[_row] = 0;
+			_row++;
+		}
+		_field = 0;
+	}
+
+	bool _shouldCancel() const {
+		return _options.shouldCancel != nullptr && _options.shouldCancel->load(std::memory_order_relaxed);
+	}
+
+	void _report(size_t bytes) {
+		const size_t done = _bytesDone.fetch_add(bytes) + bytes;
+		if (_options.progress)
+			_options.progress((float)((double)done / (double)jmax((size_t)1, _totalBytes)));
+	}
+
+	Chunk& _chunk;
+	void* const* _columns;
+	const KlineCsvLoader::Options& _options;
+	std::atomic<size_t>& _bytesDone;
+	size_t _totalBytes;
+	size_t _row = 0;
+	size_t _rowEnd = 0;
+	int _field = 0;
+};
+
+// rows are sorted by open_time : binary search the first line with open_time > time
+const char* findFirstLineAfter(const char* p, const char* e, int64 time) {
+	const char* lo = p;
+	const char* hi = e;
+	while (lo < hi) {
+		const char* line = lo + (hi - lo) / 2;
+		while (line > lo && line[-1] != '\n')
+			line--;
+		if (NumberParsing::parseInt(line, hi) <= time) {
+			while (line < hi && *line != '\n')
+				line++;
+			lo = line < hi ? line + 1 : hi;
+		}
+		else {
+			hi = line;
+		}
+	}
+	return lo;
+}
+
+// start of the line numRows lines before end, data when there are fewer
+const char* findLinesBefore(const char* data, const char* end, size_t numRows) {
+	const char* p = end;
+	while (p > data && (p[-1] == '\n' || p[-1] == '\r'))
+		p--;
+	for (size_t n = 0; p > data; p--)
+		if (p[-1] == '\n' && ++n == numRows)
+			return p;
+	return data;
+}
+
+void setNames(KlineStore& store, const File& file) {
+	String symbol, interval;
+	if (KlineCsvLoader::parseFileName(file, symbol, interval)) {
+		store.setSymbol(symbol);
+		store.setInterval(interval);
+	}
+}
+
+template <typename Fn>
+void runParallel(int numTasks, Fn&& fn) {
+	// chunks on the shared pool, this thread parses the first one and helps with the others
+	TaskPool::Group group;
+	auto& pool = TaskPool::getInstance();
+	for (int i = 1; i < numTasks; i++)
+		pool.submit([&fn, i]() { fn(i); }, TaskPool::Priority::normal, &group);
+	fn(0);
+	group.wait();
+}
+
+}
+
+KlineStore::Ptr KlineCsvLoader::parseFile(const File& file, const Options& options, String* error) {
+	if (!file.existsAsFile()) {
+		if (error) *error = "File not found: " + file.getFullPathName();
+		return nullptr;
+	}
+	MemoryMappedFile map(file, MemoryMappedFile::readOnly);
+	if (map.getData() == nullptr) {
+		if (error) *error = "Cannot map " + file.getFullPathName();
+		return nullptr;
+	}
+	auto store = parseBuffer(static_cast<const char*>(map.getData()), map.getSize(), options, error);
+	if (store)
+		setNames(*store, file);
+	return store;
+}
+
+KlineStore::Ptr KlineCsvLoader::parseFileProgressive(const File& file, size_t firstRows, const std::function<void(KlineStore::Ptr)>& onRows,
+	const Options& options, String* error) {
+	if (firstRows == 0 || options.afterOpenTime != std::numeric_limits<int64>::min())
+		return parseFile(file, options, error);
+	if (!file.existsAsFile()) {
+		if (error) *error = "File not found: " + file.getFullPathName();
+		return nullptr;
+	}
+	MemoryMappedFile map(file, MemoryMappedFile::readOnly);
+	if (map.getData() == nullptr) {
+		if (error) *error = "Cannot map " + file.getFullPathName();
+		return nullptr;
+	}
+	const char* data = static_cast<const char*>(map.getData());
+	const char* e = data + map.getSize();
+	const double totalBytes = (double)jmax((size_t)1, map.getSize());
+
+	const char* begin = findLinesBefore(data, e, firstRows);
+	size_t rows = firstRows;
+	double done = 0.0;
+	for (;;) {
+		// the progress of a step goes from what the previous one covered to what it covers
+		Options stepOptions = options;
+		if (options.progress) {
+			const double covered = (double)(e - begin) / totalBytes;
+			stepOptions.progress = [&options, done, covered](float p) { options.progress((float)(done + (covered - done) * p)); };
+			done = covered;
+		}
+		auto store = parseBuffer(begin, (size_t)(e - begin), stepOptions, error);
+		if (store == nullptr)
+			return nullptr;
+		setNames(*store, file);
+		if (begin == data)
+			return store;
+		if (onRows)
+			onRows(store);
+
+		// the next step starts about 16 times further, on a line start
+		const double bytesPerRow = (double)(e - begin) / (double)jmax((size_t)1, store->size());
+		const auto step = (size_t)(bytesPerRow * (double)(rows * 15));
+		begin = step >= (size_t)(begin - data) ? data : begin - step;
+		while (begin > data && begin[-1] != '\n')
+			begin--;
+		rows *= 16;
+	}
+}
+
+KlineStore::Ptr KlineCsvLoader::parseBuffer(const char* data, size_t size, const Options& options, String* error) {
+	const char* e = data + size;
+	const char* p = data;
+
+	// header line
+	const char* firstValue = NumberParsing::skipQuoteAndSpace(p, e);
+	if (firstValue < e && !NumberParsing::isDigit(*firstValue) && *firstValue != '-') {
+		while (p < e && *p != '\n')
+			p++;
+		if (p < e)
+			p++;
+	}
+	if (options.afterOpenTime != std::numeric_limits<int64>::min())
+		p = findFirstLineAfter(p, e, options.afterOpenTime);
+
+	const size_t bodySize = (size_t)(e - p);
+	int numChunks = options.numThreads > 0 ? options.numThreads : SystemStats::getNumCpus();
+	numChunks = jlimit(1, jmax(1, (int)(bodySize / minChunkSize)), numChunks);
+
+	std::vector<Chunk> chunks((size_t)numChunks);
+	const char* chunkStart = p;
+	for (int i = 0; i < numChunks; i++) {
+		const char* chunkEnd = i == numChunks - 1 ? e : jmax(chunkStart, p + bodySize * (size_t)(i + 1) / (size_t)numChunks);
+		while (chunkEnd < e && chunkEnd[-1] != '\n')
+			chunkEnd++;
+		chunks[(size_t)i].begin = chunkStart;
+		chunks[(size_t)i].end = chunkEnd;
+		chunkStart = chunkEnd;
+	}
+
+	runParallel(numChunks, [&](int i) {
+		auto& c = chunks[(size_t)i];
+		c.numRows = countLines(c.begin, c.end);
+		if (c.end > c.begin && c.end[-1] != '\n' && hasContent(c.begin, c.end))
+			c.numRows++;
+	});
+
+	size_t totalRows = 0;
+	for (auto& c : chunks) {
+		c.firstRow = totalRows;
+		totalRows += c.numRows;
+	}
+
+	auto store = KlineStore::allocate(totalRows);
+	void* columns[KlineStore::numColumns];
+	for (int c = 0; c < KlineStore::numColumns; c++)
+		columns[c] = store->getWritableColumnData((KlineStore::Column)c);
+
+	std::atomic<size_t> bytesDone{ 0 };
+	runParallel(numChunks, [&](int i) {
+		ChunkParser(chunks[(size_t)i], columns, options, bytesDone, bodySize).run();
+	});
+
+	if (options.shouldCancel != nullptr && options.shouldCancel->load()) {
+		if (error) *error = "Cancelled";
+		return nullptr;
+	}
+
+	// close the gaps left by dropped lines
+	size_t rows = 0;
+	for (auto& c : chunks) {
+		if (c.firstRow != rows && c.parsedRows > 0) {
+			for (int col = 0; col < KlineStore::numColumns; col++) {
+				auto* d = static_cast<int64*>(columns[col]);
+				std::memmove(d + rows, d + c.firstRow, c.parsedRows * KlineStore::elementSize);
+			}
+		}
+		rows += c.parsedRows;
+	}
+	store->setSize(rows);
+	return store;
+}
+
+bool KlineCsvLoader::parseFileName(const File& file, String& symbol, String& interval) {
+	const auto tokens = StringArray::fromTokens(file.getFileNameWithoutExtension(), "_", "");
+	if (tokens.size() < 3 || tokens[0] != "klines")
+		return false;
+	symbol = tokens[1];
+	interval = tokens[2];
+	return true;
+}
+
+KlineCsvLoader::KlineCsvLoader()
+	: _thread("KlineCsvLoader")
+	// a result that landed after cancel() is dropped : the thread may still be finishing
+	, _progressUpdater([this]() {
+		if (onProgress && !_cancel)
+			onProgress(_progress.load());
+	})
+	, _partialUpdater([this]() {
+		KlineStore::Ptr partial;
+		{
+			const ScopedLock sl(_resultLock);
+			partial = std::move(_partial);
+		}
+		if (partial && onPartial && !_cancel)
+			onPartial(std::move(partial));
+	})
+	, _loadedUpdater([this]() {
+		KlineStore::Ptr result;
+		String error;
+		{
+			const ScopedLock sl(_resultLock);
+			result = std::move(_result);
+			error = _error;
+			_partial = nullptr;
+		}
+		_partialUpdater.cancelPendingUpdate();
+		if (_cancel)
+			return;
+		_loading = false;
+		if (onLoaded)
+			onLoaded(std::move(result), error);
+	})
+{
+}
+
+KlineCsvLoader::~KlineCsvLoader() {
+	cancel();
+	_thread.stopThread(4000);
+}
+
+void KlineCsvLoader::loadAsync(const File& file) {
+	cancel();
+	_thread.stopThread(4000);
+	_partialUpdater.cancelPendingUpdate();
+	_loadedUpdater.cancelPendingUpdate();
+	_partial = nullptr;
+	_cancel = false;
+	_loading = true;
+	_progress = 0.0f;
+
+	_thread.restart([this, file]() {
+		Options options;
+		options.shouldCancel = &_cancel;
+		options.progress = [this](float p) {
+			_progress = p;
+			_progressUpdater.triggerAsyncUpdate();
+		};
+		String error;
+		KlineStore::Ptr store;
+		const auto cache = KlineFile::getCacheFileFor(file);
+		if (useBinaryCache && KlineFile::getLastOpenTime(cache) >= 0) {
+			// only the rows newer than the cache are parsed, then the cache is mapped
+			if (KlineFile::updateFromCsv(file, cache, options, &error))
+				store = KlineFile::open(cache, &error);
+		}
+		if (!store && !_cancel) {
+			// nothing to map yet : the latest rows are shown while the history is parsed
+			store = parseFileProgressive(file, previewRows, [this](KlineStore::Ptr rows) {
+				if (_cancel)
+					return;
+				{
+					const ScopedLock sl(_resultLock);
+					_partial = std::move(rows);
+				}
+				_partialUpdater.triggerAsyncUpdate();
+			}, options, &error);
+			// mapped for the next loads, the parsed columns are released
+			if (store && useBinaryCache && !_cancel && KlineFile::write(cache, *store)) {
+				if (auto mapped = KlineFile::open(cache))
+					store = std::move(mapped);
+			}
+		}
+		if (_cancel)
+			return;
+		{
+			const ScopedLock sl(_resultLock);
+			_result = std::move(store);
+			_error = error;
+		}
+		_loadedUpdater.triggerAsyncUpdate();
+	});
+}
+
+void KlineCsvLoader::cancel() {
+	_cancel = true;
+	_loading = false;
+	_partialUpdater.cancelPendingUpdate();
+	_loadedUpdater.cancelPendingUpdate();
+	const ScopedLock sl(_resultLock);
+	_partial = nullptr;
+	_result = nullptr;
+}
+
+bool KlineCsvLoader::isLoading() const {
+	return _loading;
+}
+
+float KlineCsvLoader::getProgress() const {
+	return _progress;
+}
@@ -0,0 +1,83 @@
+/*
+  ==============================================================================
+
+    KlineCsvLoader.h
+    Created: 14 Oct 2026 11:22:47am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+#include "../data/KlineStore.h"
+#include "../utils/ThreadLambda.h"
+#include "../utils/AsyncUpdaterLambda.h"
+
+/*
+	Loader for the klines_{symbol}_{interval}_*.csv files written by
+	TickersDownloader/DownloaderTool.py (12 Binance columns, optional header).
+
+	The file is memory mapped and split in chunks on newline boundaries, each
+	chunk is parsed by its own thread straight into the columns of an owned
+	KlineStore : delimiters are found 16 bytes at a time, numbers are parsed in
+	place, no String is created per field.
+
+	Big files load from the end (parseFileProgressive) : the last rows come
+	first, in a few ms whatever the size of the file, then history grows 16
+	times at every step until the whole file is parsed. Every step parses from
+	its first row to the end of the file again, about 7% more work overall and
+	no copy between steps.
+*/
+
+class KlineCsvLoader {
+public:
+	struct Options {
+		int numThreads = 0; // 0 = one per core
+		std::function<void(float)> progress; // called from the parsing threads
+		const std::atomic<bool>* shouldCancel = nullptr;
+		// only rows with a greater open_time are parsed, the start is found by binary search
+		int64 afterOpenTime = std::numeric_limits<int64>::min();
+	};
+
+	static KlineStore::Ptr parseFile(const File& file, const Options& options = {}, String* error = nullptr);
+	static KlineStore::Ptr parseBuffer(const char* data, size_t size, const Options& options = {}, String* error = nullptr);
+	// onRows gets the last firstRows rows, then 16 times more at every step (calling thread),
+	// the whole file is returned
+	static KlineStore::Ptr parseFileProgressive(const File& file, size_t firstRows, const std::function<void(KlineStore::Ptr)>& onRows,
+		const Options& options = {}, String* error = nullptr);
+	// klines_{symbol}_{interval}_... -> symbol, interval
+	static bool parseFileName(const File& file, String& symbol, String& interval);
+
+	KlineCsvLoader();
+	~KlineCsvLoader();
+
+	// parses on a background thread, onProgress, onPartial and onLoaded are called on the message thread
+	void loadAsync(const File& file);
+	// message thread, the callbacks of the load in progress are not called anymore
+	void cancel();
+	bool isLoading() const;
+	float getProgress() const;
+
+	std::function<void(float)> onProgress;
+	// the latest rows of a file without binary cache, then more history, before onLoaded
+	std::function<void(KlineStore::Ptr)> onPartial;
+	std::function<void(KlineStore::Ptr, const String&)> onLoaded;
+	// keeps a .klines file next to the csv (see KlineFile), later loads only parse the new rows
+	bool useBinaryCache = true;
+	// rows of the first onPartial, 0 parses the whole file at once
+	size_t previewRows = 4096;
+
+private:
+	ThreadLambda _thread;
+	AsyncUpdaterLambda _progressUpdater;
+	AsyncUpdaterLambda _partialUpdater;
+	AsyncUpdaterLambda _loadedUpdater;
+	std::atomic<float> _progress{ 0.0f };
+	std::atomic<bool> _cancel{ false };
+	std::atomic<bool> _loading{ false };
+	CriticalSection _resultLock;
+	KlineStore::Ptr _partial;
+	KlineStore::Ptr _result;
+	String _error;
+};
@@ -0,0 +1,218 @@
+/*
+  ==============================================================================
+
+    KlineFile.cpp
+    Created: 14 Oct 2026 4:02:18pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "KlineFile.h"
+
+static_assert(sizeof(KlineFile::Header) == 128, "KlineFile::Header is part of the file format");
+
+static constexpr uint64 pageSize = 4096;
+
+static uint64 roundUp(uint64 v, uint64 multiple) {
+	return (v + multiple - 1) / multiple * multiple;
+}
+
+// room for a quarter more rows before the file has to be rewritten
+static uint64 capacityFor(uint64 numRows) {
+	return roundUp(jmax(numRows + numRows / 4, KlineFile::indexStride * 16), KlineFile::indexStride);
+}
+
+static String readFixedString(const char* s, size_t maxSize) {
+	size_t n = 0;
+	while (n < maxSize && s[n] != 0)
+		n++;
+	return String::fromUTF8(s, (int)n);
+}
+
+static bool fail(String* error, const String& message) {
+	if (error) *error = message;
+	return false;
+}
+
+bool KlineFile::Header::isValid() const {
+	return std::memcmp(magic, "TKLN", 4) == 0
+		&& version == currentVersion
+		&& numColumns == (uint32)KlineStore::numColumns
+		&& elementSize == (uint32)KlineStore::elementSize
+		&& indexStride > 0
+		&& numRows <= capacity
+		&& dataOffset >= sizeof(Header) + getIndexSize() * sizeof(int64);
+}
+
+bool KlineFile::readHeader(const File& file, Header& header) {
+	FileInputStream in(file);
+	if (!in.openedOk() || in.read(&header, (int)sizeof(Header)) != (int)sizeof(Header))
+		return false;
+	return header.isValid() && (uint64)file.getSize() >= header.getFileSize();
+}
+
+int64 KlineFile::getLastOpenTime(const File& file) {
+	Header h;
+	if (!readHeader(file, h) || h.numRows == 0)
+		return -1;
+	return h.lastOpenTime;
+}
+
+KlineStore::Ptr KlineFile::open(const File& file, String* error) {
+	auto map = std::make_unique<MemoryMappedFile>(file, MemoryMappedFile::readOnly);
+	if (map->getData() == nullptr || map->getSize() < sizeof(Header)) {
+		fail(error, "Cannot map " + file.getFullPathName());
+		return nullptr;
+	}
+	const char* data = static_cast<const char*>(map->getData());
+	Header h;
+	std::memcpy(&h, data, sizeof(Header));
+	if (!h.isValid() || map->getSize() < h.getFileSize()) {
+		fail(error, "Invalid kline file " + file.getFullPathName());
+		return nullptr;
+	}
+
+	const void* columns[KlineStore::numColumns];
+	for (int c = 0; c < KlineStore::numColumns; c++)
+		columns[c] = data + h.getColumnOffset(c);
+	const auto* index = reinterpret_cast<const int64*>(data + sizeof(Header));
+
+	auto store = KlineStore::wrapMapped(std::move(map), columns, (size_t)h.numRows);
+	store->setTimeIndex(index, (size_t)((h.numRows + h.indexStride - 1) / h.indexStride), (size_t)h.indexStride);
+	store->setSymbol(readFixedString(h.symbol, sizeof(h.symbol)));
+	store->setInterval(readFixedString(h.interval, sizeof(h.interval)));
+	return store;
+}
+
+bool KlineFile::write(const File& file, const KlineStore& store, String* error) {
+	return _writeNew(file, store, 0, capacityFor(store.size()), error);
+}
+
+bool KlineFile::_writeNew(const File& file, const KlineStore& store, size_t first, uint64 capacity, String* error) {
+	const uint64 numRows = store.size() - first;
+	jassert(numRows <= capacity && capacity % indexStride == 0);
+	const int64* t = store.getOpenTime() + first;
+
+	Header h;
+	h.numRows = numRows;
+	h.capacity = capacity;
+	h.dataOffset = roundUp(sizeof(Header) + h.getIndexSize() * sizeof(int64), pageSize);
+	h.firstOpenTime = numRows > 0 ? t[0] : 0;
+	h.lastOpenTime = numRows > 0 ? t[numRows - 1] : 0;
+	store.getSymbol().copyToUTF8(h.symbol, sizeof(h.symbol));
+	store.getInterval().copyToUTF8(h.interval, sizeof(h.interval));
+
+	// written next to the target and swapped in at the end, a reader never sees a half written file
+	TemporaryFile temp(file);
+	{
+		FileOutputStream out(temp.getFile());
+		if (!out.openedOk())
+			return fail(error, "Cannot write " + temp.getFile().getFullPathName());
+
+		HeapBlock<int64> index(h.getIndexSize(), true);
+		for (uint64 i = 0; i * indexStride < numRows; i++)
+			index[i] = t[i * indexStride];
+
+		HeapBlock<char> zeros(pageSize, true);
+		auto writeZeros = [&](uint64 bytes) {
+			bool ok = true;
+			for (; bytes > 0 && ok; bytes -= jmin(bytes, pageSize))
+				ok = out.write(zeros, (size_t)jmin(bytes, pageSize));
+			return ok;
+		};
+
+		bool ok = out.write(&h, sizeof(Header))
+			&& out.write(index, h.getIndexSize() * sizeof(int64))
+			&& writeZeros(h.dataOffset - sizeof(Header) - h.getIndexSize() * sizeof(int64));
+		for (int c = 0; c < KlineStore::numColumns && ok; c++) {
+			const char* column = static_cast<const char*>(store.getColumnData((KlineStore::Column)c)) + first * KlineStore::elementSize;
+			ok = out.write(column, numRows * KlineStore::elementSize)
+				&& writeZeros((capacity - numRows) * KlineStore::elementSize);
+		}
+		out.flush();
+		if (!ok)
+			return fail(error, "Write failed " + temp.getFile().getFullPathName());
+	}
+	if (!temp.overwriteTargetFileWithTemporary())
+		return fail(error, "Cannot replace " + file.getFullPathName());
+	return true;
+}
+
+bool KlineFile::append(const File& file, const KlineStore& store, String* error) {
+	Header h;
+	if (!file.existsAsFile() || !readHeader(file, h))
+		return write(file, store, error);
+
+	const size_t first = h.numRows > 0 ? store.upperBound(h.lastOpenTime) : 0;
+	const uint64 count = store.size() - first;
+	if (count == 0)
+		return true;
+
+	if (h.numRows + count > h.capacity) {
+		// out of room : one rewrite with the merged rows
+		auto merged = KlineStore::allocate((size_t)(h.numRows + count));
+		{
+			auto existing = open(file, error);
+			if (!existing)
+				return false;
+			for (int c = 0; c < KlineStore::numColumns; c++) {
+				auto* d = static_cast<char*>(merged->getWritableColumnData((KlineStore::Column)c));
+				const auto* a = static_cast<const char*>(existing->getColumnData((KlineStore::Column)c));
+				const auto* b = static_cast<const char*>(store.getColumnData((KlineStore::Column)c)) + first * KlineStore::elementSize;
+				std::memcpy(d, a, (size_t)h.numRows * KlineStore::elementSize);
+				std::memcpy(d + h.numRows * KlineStore::elementSize, b, (size_t)count * KlineStore::elementSize);
+			}
+			merged->setSymbol(existing->getSymbol().isNotEmpty() ? existing->getSymbol() : store.getSymbol());
+			merged->setInterval(existing->getInterval().isNotEmpty() ? existing->getInterval() : store.getInterval());
+		}
+		return _writeNew(file, *merged, 0, capacityFor(merged->size()), error);
+	}
+
+	FileOutputStream out(file);
+	if (!out.openedOk())
+		return fail(error, "Cannot write " + file.getFullPathName());
+
+	bool ok = true;
+	for (int c = 0; c < KlineStore::numColumns && ok; c++) {
+		const char* column = static_cast<const char*>(store.getColumnData((KlineStore::Column)c)) + first * KlineStore::elementSize;
+		ok = out.setPosition((int64)(h.getColumnOffset(c) + h.numRows * KlineStore::elementSize))
+			&& out.write(column, (size_t)count * KlineStore::elementSize);
+	}
+
+	const int64* t = store.getOpenTime() + first;
+	for (uint64 row = roundUp(h.numRows, indexStride); row < h.numRows + count && ok; row += indexStride) {
+		ok = out.setPosition((int64)(sizeof(Header) + row / indexStride * sizeof(int64)))
+			&& out.write(t + (row - h.numRows), sizeof(int64));
+	}
+	if (!ok)
+		return fail(error, "Append failed " + file.getFullPathName());
+	out.flush();
+
+	// the header goes last : an interrupted append leaves the previous rows valid
+	if (h.numRows == 0)
+		h.firstOpenTime = t[0];
+	h.numRows += count;
+	h.lastOpenTime = t[count - 1];
+	if (h.symbol[0] == 0)
+		store.getSymbol().copyToUTF8(h.symbol, sizeof(h.symbol));
+	if (h.interval[0] == 0)
+		store.getInterval().copyToUTF8(h.interval, sizeof(h.interval));
+	ok = out.setPosition(0) && out.write(&h, sizeof(Header));
+	out.flush();
+	return ok || fail(error, "Append failed " + file.getFullPathName());
+}
+
+bool KlineFile::updateFromCsv(const File& csv, const File& file, KlineCsvLoader::Options options, String* error) {
+	const int64 last = getLastOpenTime(file);
+	if (last >= 0)
+		options.afterOpenTime = last;
+	auto rows = KlineCsvLoader::parseFile(csv, options, error);
+	if (!rows)
+		return false;
+	return append(file, *rows, error);
+}
+
+File KlineFile::getCacheFileFor(const File& csv) {
+	return csv.withFileExtension(fileExtension);
+}
@@ -0,0 +1,74 @@
+/*
+  ==============================================================================
+
+    KlineFile.h
+    Created: 14 Oct 2026 4:02:18pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+#include "../data/KlineStore.h"
+#include "KlineCsvLoader.h"
+
+/*
+	Native binary kline file (.klines), opened zero copy as a mapped KlineStore.
+
+	Layout (little endian) :
+		Header          128 bytes
+		time index      capacity / indexStride int64, open_time of every indexStride-th row
+		columns         KlineStore::numColumns columns of capacity * 8 bytes, page aligned
+
+	Columns are allocated for `capacity` rows so appending only writes the new
+	tails, the index entries and the header (row count last). The file is only
+	rewritten when the capacity is exceeded (it then grows by half).
+*/
+
+class KlineFile {
+public:
+	static constexpr const char* fileExtension = ".klines";
+	static constexpr uint32 currentVersion = 1;
+	static constexpr uint64 indexStride = 1024;
+
+	struct Header {
+		char magic[4] = { 'T', 'K', 'L', 'N' };
+		uint32 version = currentVersion;
+		uint32 numColumns = KlineStore::numColumns;
+		uint32 elementSize = (uint32)KlineStore::elementSize;
+		uint64 numRows = 0;
+		uint64 capacity = 0;
+		uint64 indexStride = KlineFile::indexStride;
+		uint64 dataOffset = 0;
+		int64 firstOpenTime = 0;
+		int64 lastOpenTime = 0;
+		char symbol[24] = {};
+		char interval[8] = {};
+		char reserved[32] = {};
+
+		bool isValid() const;
+		uint64 getIndexSize() const { return capacity / indexStride; }
+		uint64 getColumnOffset(int column) const { return dataOffset + (uint64)column * capacity * KlineStore::elementSize; }
+		uint64 getFileSize() const { return getColumnOffset(KlineStore::numColumns); }
+	};
+
+	static bool readHeader(const File& file, Header& header);
+	// open_time of the last row, -1 if the file is missing or invalid
+	// (same contract as DownloaderTool._get_last_open_time_from_file)
+	static int64 getLastOpenTime(const File& file);
+
+	static KlineStore::Ptr open(const File& file, String* error = nullptr);
+	// creates or overwrites
+	static bool write(const File& file, const KlineStore& store, String* error = nullptr);
+	// appends the rows of store newer than the last row of the file, creates it if needed
+	static bool append(const File& file, const KlineStore& store, String* error = nullptr);
+
+	// converts a DownloaderTool csv, only the rows newer than the existing binary file are parsed
+	static bool updateFromCsv(const File& csv, const File& file, KlineCsvLoader::Options options, String* error = nullptr);
+	// <csv name>.klines next to the csv
+	static File getCacheFileFor(const File& csv);
+
+private:
+	static bool _writeNew(const File& file, const KlineStore& store, size_t first, uint64 capacity, String* error);
+};
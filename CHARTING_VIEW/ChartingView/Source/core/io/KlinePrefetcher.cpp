@@ -0,0 +1,246 @@
+/*
+  ==============================================================================
+
+    KlinePrefetcher.cpp
+    Created: 15 Oct 2026 11:04:36pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "KlinePrefetcher.h"
+#include "KlineFile.h"
+#include "KlineCsvLoader.h"
+#include "../data/KlineResampler.h"
+
+// a mapping costs nothing, its page faults are the load : taken on the pool rather than in the first frame
+static void touchPages(const KlineStore& store, const std::atomic<bool>* shouldCancel) {
+	volatile char sink = 0;
+	const size_t bytes = store.size() * KlineStore::elementSize;
+	for (int c = 0; c < KlineStore::numColumns; c++) {
+		if (shouldCancel && *shouldCancel)
+			return;
+		const char* p = static_cast<const char*>(store.getColumnData((KlineStore::Column)c));
+		for (size_t i = 0; i < bytes; i += 4096)
+			sink = sink + p[i];
+	}
+}
+
+KlinePrefetcher::KlinePrefetcher(const Options& options) : _options(options) {
+	_loadedUpdater.onAsyncUpdate = [this]() { _takeLoaded(); };
+}
+
+KlinePrefetcher::~KlinePrefetcher() {
+	clear();
+	_loadedUpdater.cancelPendingUpdate();
+}
+
+KlineStore::Ptr KlinePrefetcher::load(const File& file, const std::atomic<bool>* shouldCancel, String* error) {
+	if (file.hasFileExtension(KlineFile::fileExtension)) {
+		auto store = KlineFile::open(file, error);
+		if (store)
+			touchPages(*store, shouldCancel);
+		return store;
+	}
+	KlineCsvLoader::Options options;
+	options.shouldCancel = shouldCancel;
+	KlineStore::Ptr store;
+	const auto cache = KlineFile::getCacheFileFor(file);
+	// same path as KlineCsvLoader::loadAsync : the new rows into the cache, then mapped
+	if (KlineFile::getLastOpenTime(cache) >= 0 && KlineFile::updateFromCsv(file, cache, options, error))
+		store = KlineFile::open(cache, error);
+	if (!store && !(shouldCancel && *shouldCancel)) {
+		store = KlineCsvLoader::parseFile(file, options, error);
+		if (store && !(shouldCancel && *shouldCancel) && KlineFile::write(cache, *store)) {
+			if (auto mapped = KlineFile::open(cache))
+				store = std::move(mapped);
+		}
+	}
+	return shouldCancel && *shouldCancel ? nullptr : store;
+}
+
+File KlinePrefetcher::findAdjacentInterval(const File& file, int direction) {
+	String symbol, interval;
+	if (!KlineCsvLoader::parseFileName(file, symbol, interval))
+		return {};
+	const int64 period = KlineResampler::parseInterval(interval);
+	if (period <= 0)
+		return {};
+	File best;
+	int64 bestPeriod = 0;
+	for (const auto& f : file.getParentDirectory().findChildFiles(File::findFiles, false, "klines_" + symbol + "_*")) {
+		String s, i;
+		const bool isCsv = f.hasFileExtension("csv");
+		if (!(isCsv || f.hasFileExtension(KlineFile::fileExtension)) || !KlineCsvLoader::parseFileName(f, s, i) || s != symbol)
+			continue;
+		// a csv loads through its cache, the cache alone is taken when the csv is gone
+		if (!isCsv && f.withFileExtension("csv").existsAsFile())
+			continue;
+		const int64 p = KlineResampler::parseInterval(i);
+		if (p <= 0 || (direction > 0 ? p <= period : p >= period))
+			continue;
+		if (best == File() || (direction > 0 ? p < bestPeriod : p > bestPeriod)) {
+			best = f;
+			bestPeriod = p;
+		}
+	}
+	return best;
+}
+
+KlineStore::Ptr KlinePrefetcher::get(const File& file) const {
+	const auto it = _entries.find(file.getFullPathName());
+	return it != _entries.end() ? it->second.store : nullptr;
+}
+
+bool KlinePrefetcher::isLoading(const File& file) const {
+	const auto it = _entries.find(file.getFullPathName());
+	return it != _entries.end() && it->second.cancel != nullptr;
+}
+
+int KlinePrefetcher::getNumResident() const {
+	int n = 0;
+	for (const auto& e : _entries)
+		n += e.second.store != nullptr ? 1 : 0;
+	return n;
+}
+
+void KlinePrefetcher::request(const File& file) {
+	if (!_requests.contains(file))
+		_requests.add(file);
+	_update();
+}
+
+void KlinePrefetcher::setVisibleSymbols(const Array<File>& list, Range<int> visible, float velocity) {
+	_listWants.clear();
+	const int n = list.size();
+	visible = visible.getIntersectionWith({ 0, n });
+	for (int i = visible.getStart(); i < visible.getEnd(); i++)
+		_listWants.push_back({ list[i], TaskPool::Priority::high });
+	// ahead in the scroll direction (down when still), more the faster it scrolls
+	const int ahead = _options.minAhead + (int)std::ceil(std::abs(velocity) * _options.lookaheadSeconds);
+	const bool up = velocity < 0.0f;
+	for (int k = 0; k < ahead; k++) {
+		const int i = up ? visible.getStart() - 1 - k : visible.getEnd() + k;
+		if (isPositiveAndBelow(i, n))
+			_listWants.push_back({ list[i], TaskPool::Priority::normal });
+	}
+	for (int k = 0; k < _options.behind; k++) {
+		const int i = up ? visible.getEnd() + k : visible.getStart() - 1 - k;
+		if (isPositiveAndBelow(i, n))
+			_listWants.push_back({ list[i], TaskPool::Priority::low });
+	}
+	_update();
+}
+
+void KlinePrefetcher::setCurrent(const File& file) {
+	_currentWants.clear();
+	if (file != File()) {
+		_currentWants.push_back({ file, TaskPool::Priority::high });
+		for (int direction : { 1, -1 }) {
+			const auto adjacent = findAdjacentInterval(file, direction);
+			if (adjacent != File())
+				_currentWants.push_back({ adjacent, TaskPool::Priority::low });
+		}
+	}
+	_update();
+}
+
+void KlinePrefetcher::clear() {
+	for (auto& e : _entries)
+		if (e.second.cancel)
+			*e.second.cancel = true;
+	_tasks.cancel();
+	_tasks.wait();
+	_tasks.reset();
+	_entries.clear();
+	_requests.clear();
+	_listWants.clear();
+	_currentWants.clear();
+	const ScopedLock sl(_loadedLock);
+	_loaded.clear();
+}
+
+void KlinePrefetcher::_want(const File& file, TaskPool::Priority priority) {
+	auto& e = _entries[file.getFullPathName()];
+	e.wantedAt = _wantCounter;
+	if (e.store || e.failed)
+		return;
+	// already loading at this priority or a higher one (high < normal < low)
+	if (e.cancel && (int)e.priority <= (int)priority)
+		return;
+	if (e.cancel)
+		*e.cancel = true;
+	e.priority = priority;
+	e.cancel = std::make_shared<std::atomic<bool>>(false);
+	TaskPool::getInstance().submit([this, file, cancel = e.cancel]() {
+		if (*cancel)
+			return;
+		auto store = load(file, cancel.get());
+		if (*cancel)
+			return;
+		{
+			const ScopedLock sl(_loadedLock);
+			_loaded.push_back({ file, cancel, std::move(store) });
+		}
+		_loadedUpdater.triggerAsyncUpdate();
+	}, priority, &_tasks);
+}
+
+void KlinePrefetcher::_update() {
+	_wantCounter++;
+	for (const auto& f : _requests)
+		_want(f, TaskPool::Priority::high);
+	for (const auto* wants : { &_currentWants, &_listWants })
+		for (const auto& w : *wants)
+			_want(w.file, w.priority);
+
+	// the user moved on : the loads no longer wanted stop (and a failed one may be retried later)
+	for (auto it = _entries.begin(); it != _entries.end();) {
+		auto& e = it->second;
+		if (e.store == nullptr && e.wantedAt != _wantCounter) {
+			if (e.cancel)
+				*e.cancel = true;
+			it = _entries.erase(it);
+		}
+		else {
+			++it;
+		}
+	}
+	_evict();
+}
+
+void KlinePrefetcher::_evict() {
+	int resident = getNumResident();
+	while (resident > _options.maxResident) {
+		// least recently wanted, never one of the current wants
+		auto oldest = _entries.end();
+		for (auto it = _entries.begin(); it != _entries.end(); ++it)
+			if (it->second.store && it->second.wantedAt != _wantCounter && (oldest == _entries.end() || it->second.wantedAt < oldest->second.wantedAt))
+				oldest = it;
+		if (oldest == _entries.end())
+			return;
+		_entries.erase(oldest);
+		resident--;
+	}
+}
+
+void KlinePrefetcher::_takeLoaded() {
+	std::vector<Loaded> loaded;
+	{
+		const ScopedLock sl(_loadedLock);
+		loaded.swap(_loaded);
+	}
+	for (auto& l : loaded) {
+		const auto it = _entries.find(l.file.getFullPathName());
+		// cancelled or loaded again at another priority meanwhile
+		if (it == _entries.end() || it->second.cancel != l.cancel)
+			continue;
+		it->second.store = l.store;
+		it->second.cancel = nullptr;
+		it->second.failed = l.store == nullptr;
+		_requests.removeFirstMatchingValue(l.file);
+		if (onLoaded)
+			onLoaded(l.file, l.store);
+	}
+	_evict();
+}
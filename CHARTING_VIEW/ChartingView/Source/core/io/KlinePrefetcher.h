@@ -0,0 +1,116 @@
+/*
+  ==============================================================================
+
+    KlinePrefetcher.h
+    Created: 15 Oct 2026 11:04:36pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+#include "../data/KlineStore.h"
+#include "../utils/TaskPool.h"
+#include "../utils/AsyncUpdaterLambda.h"
+
+/*
+	Keeps the stores the user is likely to open next already loaded : the
+	symbols around the visible part of the watchlist and the next coarser /
+	finer timeframe of the symbol on the chart.
+
+	Every wanted file is opened and decoded by its own TaskPool task, several
+	files load at once (a csv also splits its parse on the pool) :
+		Priority::high     request(), the visible symbols
+		Priority::normal   the symbols ahead in the scroll direction, more of
+		                   them the faster the list scrolls (lookaheadSeconds)
+		Priority::low      the symbols behind, the adjacent timeframes
+	A file that is no longer wanted is cancelled : skipped if its task did not
+	start, its csv parse stops at the next chunk otherwise.
+
+	Loaded stores stay resident up to maxResident files, the least recently
+	wanted go first (a chart showing one keeps its own reference).
+
+		prefetcher.onLoaded = [](const File& f, KlineStore::Ptr s) { ... };
+		grid.onVisibleSymbolsChanged = [&](Range<int> visible, float velocity) {
+			prefetcher.setVisibleSymbols(files, visible, velocity);
+		};
+		if (auto store = prefetcher.get(file)) chart.setStore(store);
+		else prefetcher.request(file);
+
+	Message thread only, but the loads.
+*/
+
+class KlinePrefetcher {
+public:
+	struct Options {
+		int maxResident = 48;
+		float lookaheadSeconds = 0.5f;  // of list scrolling loaded ahead
+		int minAhead = 8;               // symbols past the visible ones, in the scroll direction
+		int behind = 4;                 // symbols before the visible ones
+	};
+
+	explicit KlinePrefetcher(const Options& options = {});
+	~KlinePrefetcher();
+
+	// nullptr while not loaded (the file is not requested)
+	KlineStore::Ptr get(const File& file) const;
+	bool isLoading(const File& file) const;
+	int getNumResident() const;
+
+	// load now, before anything prefetched
+	void request(const File& file);
+	// the watchlist files in list order, the indexes of the visible ones and the
+	// scroll speed in symbols per second (positive toward the end of the list)
+	void setVisibleSymbols(const Array<File>& list, Range<int> visible, float velocity);
+	// the file on the chart, its adjacent timeframes are prefetched
+	void setCurrent(const File& file);
+	// cancels every load and drops the resident stores
+	void clear();
+
+	// called when a wanted file was loaded (nullptr on error)
+	std::function<void(const File&, KlineStore::Ptr)> onLoaded;
+
+	// the file of the same symbol in the same folder with the next coarser (direction > 0)
+	// or finer (< 0) interval, File() when there is none
+	static File findAdjacentInterval(const File& file, int direction);
+	// any thread : a .klines mapped (its pages touched), a csv through its binary cache
+	static KlineStore::Ptr load(const File& file, const std::atomic<bool>* shouldCancel, String* error = nullptr);
+
+private:
+	struct Entry {
+		KlineStore::Ptr store;
+		SPtr<std::atomic<bool>> cancel;  // while loading
+		TaskPool::Priority priority = TaskPool::Priority::low;
+		uint32 wantedAt = 0;             // _wantCounter of the last time it was wanted
+		bool failed = false;             // not retried while it stays wanted
+	};
+	struct Want {
+		File file;
+		TaskPool::Priority priority;
+	};
+	struct Loaded {
+		File file;
+		SPtr<std::atomic<bool>> cancel;
+		KlineStore::Ptr store;
+	};
+
+	// every want applied, the loads no longer wanted cancelled
+	void _update();
+	void _want(const File& file, TaskPool::Priority priority);
+	void _evict();
+	void _takeLoaded();
+
+	Options _options;
+	std::map<String, Entry> _entries; // by full path
+	uint32 _wantCounter = 0;
+	Array<File> _requests;  // until loaded
+	std::vector<Want> _listWants, _currentWants;
+
+	TaskPool::Group _tasks;
+	CriticalSection _loadedLock;
+	std::vector<Loaded> _loaded;
+	AsyncUpdaterLambda _loadedUpdater;
+
+	JUCE_DECLARE_NON_COPYABLE(KlinePrefetcher)
+};
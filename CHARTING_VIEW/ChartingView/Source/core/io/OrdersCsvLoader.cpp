@@ -0,0 +1,139 @@
+/*
+  ==============================================================================
+
+    OrdersCsvLoader.cpp
+    Created: 16 Oct 2026 4:52:30pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "OrdersCsvLoader.h"
+
+namespace {
+
+// "YYYY-MM-DD HH:MM:SS", local time, -1 when malformed
+int64 parseLocalTime(const String& s) {
+	const auto t = s.trim().unquoted();
+	if (t.length() < 19)
+		return -1;
+	const int year = t.substring(0, 4).getIntValue();
+	const int month = t.substring(5, 7).getIntValue();
+	const int day = t.substring(8, 10).getIntValue();
+	if (year <= 0 || month < 1 || month > 12 || day < 1)
+		return -1;
+	return Time(year, month - 1, day, t.substring(11, 13).getIntValue(), t.substring(14, 16).getIntValue(),
+		t.substring(17, 19).getIntValue(), 0, true).toMilliseconds();
+}
+
+}
+
+std::vector<FillClusters::Fill> OrdersCsvLoader::parseFile(const File& file, const String& symbol, String* error) {
+	if (!file.existsAsFile()) {
+		if (error)
+			*error = "file not found: " + file.getFullPathName();
+		return {};
+	}
+	return parseText(file.loadFileAsString(), symbol, error);
+}
+
+std::vector<FillClusters::Fill> OrdersCsvLoader::parseText(const String& text, const String& symbol, String* error) {
+	StringArray lines;
+	lines.addLines(text);
+	lines.removeEmptyStrings();
+	if (lines.isEmpty()) {
+		if (error)
+			*error = "empty file";
+		return {};
+	}
+
+	StringArray header;
+	header.addTokens(lines[0], ",", "\"");
+	header.trim();
+	const int symbolCol = header.indexOf("symbol");
+	const int sideCol = header.indexOf("side");
+	const int priceCol = header.indexOf("price");
+	const int qtyCol = header.indexOf("qty");
+	const int commissionCol = header.indexOf("commission");
+	const int commissionAssetCol = header.indexOf("commission_asset");
+	const int timeCol = header.indexOf("time");
+	if (symbolCol < 0 || sideCol < 0 || priceCol < 0 || qtyCol < 0 || timeCol < 0) {
+		if (error)
+			*error = "not an OrdersGetter export (missing symbol, side, price, qty or time column)";
+		return {};
+	}
+
+	// per symbol, each replayed on its own
+	std::map<String, std::vector<FillClusters::Fill>> bySymbol;
+	std::map<String, std::vector<double>> fees;
+	int numSkipped = 0;
+	StringArray fields;
+	for (int i = 1; i < lines.size(); i++) {
+		fields.clearQuick();
+		fields.addTokens(lines[i], ",", "\"");
+		fields.trim();
+		const String rowSymbol = fields[symbolCol].unquoted();
+		if (symbol.isNotEmpty() && rowSymbol != symbol)
+			continue;
+		FillClusters::Fill f;
+		f.time = parseLocalTime(fields[timeCol]);
+		f.price = fields[priceCol].unquoted().getDoubleValue();
+		const double qty = fields[qtyCol].unquoted().getDoubleValue();
+		if (f.time < 0 || f.price <= 0.0 || qty <= 0.0) {
+			numSkipped++;
+			continue;
+		}
+		f.qty = fields[sideCol].unquoted().equalsIgnoreCase("SELL") ? -qty : qty;
+		double fee = 0.0;
+		if (commissionCol >= 0 && commissionAssetCol >= 0) {
+			const String asset = fields[commissionAssetCol].unquoted();
+			// quote fees only, a fee in the base asset or BNB is not in the pnl currency
+			if (asset.isNotEmpty() && rowSymbol.endsWith(asset))
+				fee = fields[commissionCol].unquoted().getDoubleValue();
+		}
+		bySymbol[rowSymbol].push_back(f);
+		fees[rowSymbol].push_back(fee);
+	}
+
+	std::vector<FillClusters::Fill> result;
+	for (auto& [name, fills] : bySymbol) {
+		auto& symbolFees = fees[name];
+		std::vector<size_t> order(fills.size());
+		std::iota(order.begin(), order.end(), (size_t)0);
+		std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return fills[a].time < fills[b].time; });
+		std::vector<FillClusters::Fill> sorted;
+		sorted.reserve(fills.size());
+		for (auto i : order)
+			sorted.push_back(fills[i]);
+		computeRealizedPnl(sorted);
+		for (size_t i = 0; i < order.size(); i++)
+			sorted[i].pnl -= symbolFees[order[i]];
+		result.insert(result.end(), sorted.begin(), sorted.end());
+	}
+	std::stable_sort(result.begin(), result.end(), [](const FillClusters::Fill& a, const FillClusters::Fill& b) { return a.time < b.time; });
+	if (error && numSkipped > 0)
+		*error = String(numSkipped) + " malformed rows skipped";
+	return result;
+}
+
+void OrdersCsvLoader::computeRealizedPnl(std::vector<FillClusters::Fill>& fills) {
+	double position = 0.0;
+	double averageCost = 0.0;
+	for (auto& f : fills) {
+		f.pnl = 0.0;
+		// the part of the fill against the position closes it
+		if (position != 0.0 && (position > 0.0) != (f.qty > 0.0)) {
+			const double closed = jmin(std::abs(f.qty), std::abs(position));
+			f.pnl = (f.price - averageCost) * closed * (position > 0.0 ? 1.0 : -1.0);
+			const double left = f.qty + position;
+			// crossing zero opens the other side at the fill price
+			if (left != 0.0 && (left > 0.0) != (position > 0.0))
+				averageCost = f.price;
+			position = left;
+			continue;
+		}
+		const double size = std::abs(position) + std::abs(f.qty);
+		averageCost = (averageCost * std::abs(position) + f.price * std::abs(f.qty)) / size;
+		position += f.qty;
+	}
+}
@@ -0,0 +1,40 @@
+/*
+  ==============================================================================
+
+    OrdersCsvLoader.h
+    Created: 16 Oct 2026 4:52:30pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+#include "../data/FillClusters.h"
+
+/*
+	Loader for the binance_transactions_*.csv files written by
+	OrdersPNL/OrdersGetter.py : one fill per row (account_type, symbol,
+	order_type, side, price, qty, quote_qty, commission, commission_asset,
+	time), columns found by the header, time as "YYYY-MM-DD HH:MM:SS" in
+	local time.
+
+	The fills of one symbol are replayed in time order to give each its
+	realized PnL, average cost method : a fill reducing the position realizes
+	(price - average cost) * closed quantity, a fill crossing zero opens the
+	other side at its price. Commissions paid in the quote asset are taken off.
+
+		auto fills = OrdersCsvLoader::parseFile(file, "BTCUSDT");
+		chart.setFills(std::make_shared<FillClusters>(std::move(fills)));
+
+	A few thousand rows : parsed at once on the calling thread.
+*/
+
+class OrdersCsvLoader {
+public:
+	// fills of symbol (any when empty), in time order
+	static std::vector<FillClusters::Fill> parseFile(const File& file, const String& symbol, String* error = nullptr);
+	static std::vector<FillClusters::Fill> parseText(const String& text, const String& symbol, String* error = nullptr);
+	// sets the pnl of fills of one symbol in time order
+	static void computeRealizedPnl(std::vector<FillClusters::Fill>& fills);
+};
@@ -0,0 +1,76 @@
+/*
+  ==============================================================================
+
+    ReplayClock.cpp
+    Created: 16 Oct 2026 12:41:37am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "ReplayClock.h"
+
+// a speed change is seen within this delay by a waiting thread
+static constexpr double maxWaitStepMs = 50.0;
+
+ReplayClock::ReplayClock(double speed) : _speed(jmax(0.0, speed)) {
+}
+
+void ReplayClock::setSpeed(double speed) {
+	const double now = Time::getMillisecondCounterHiRes();
+	const SpinLock::ScopedLockType sl(_lock);
+	if (_started) {
+		_start = _getTime(now);
+		_wallStart = now;
+	}
+	_speed = jmax(0.0, speed);
+}
+
+double ReplayClock::getSpeed() const {
+	const SpinLock::ScopedLockType sl(_lock);
+	return _speed;
+}
+
+int64 ReplayClock::getTime() const {
+	const double now = Time::getMillisecondCounterHiRes();
+	const SpinLock::ScopedLockType sl(_lock);
+	return _getTime(now);
+}
+
+bool ReplayClock::isStarted() const {
+	const SpinLock::ScopedLockType sl(_lock);
+	return _started;
+}
+
+int64 ReplayClock::_getTime(double now) const {
+	if (!_started || _speed <= 0.0)
+		return _start;
+	return _start + (int64)((now - _wallStart) * _speed);
+}
+
+bool ReplayClock::waitUntil(int64 time, Thread& thread) {
+	for (;;) {
+		double waitMs;
+		{
+			const double now = Time::getMillisecondCounterHiRes();
+			const SpinLock::ScopedLockType sl(_lock);
+			if (!_started) {
+				_started = true;
+				_start = time;
+				_wallStart = now;
+			}
+			if (_speed <= 0.0) {
+				// the clock follows the events
+				_start = jmax(_start, time);
+				_wallStart = now;
+				return !thread.threadShouldExit();
+			}
+			waitMs = _wallStart + (double)(time - _start) / _speed - now;
+		}
+		if (thread.threadShouldExit())
+			return false;
+		if (waitMs <= 0.0)
+			return true;
+		thread.wait((int)std::ceil(jmin(waitMs, maxWaitStepMs)));
+	}
+}
@@ -0,0 +1,61 @@
+/*
+  ==============================================================================
+
+    ReplayClock.h
+    Created: 16 Oct 2026 12:41:37am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+
+/*
+	Time of a historical replay : the recorded times (ms) run speed times
+	faster than the wall clock, from the first time waited for. The replay
+	threads of the feeds (BinanceKlineFeed / BinanceDepthFeed::startReplay)
+	wait on it before publishing each event, one clock shared by both keeps
+	the klines and the book in step.
+
+		auto clock = std::make_shared<ReplayClock>(100.0);
+		klines.startReplay({ "BTCUSDT" }, { store }, { 30, clock });
+		depth.startReplay(recording, 0.01, clock);
+		...
+		clock->setSpeed(ReplayClock::asFastAsPossible);
+
+	As fast as possible never waits : the events go out as fast as the
+	pipeline takes them (the replays wait on a full queue instead of
+	dropping), which makes the replay a load test of the live path.
+*/
+
+class ReplayClock {
+public:
+	using Ptr = SPtr<ReplayClock>;
+
+	static constexpr double asFastAsPossible = 0.0;
+
+	explicit ReplayClock(double speed = 1.0);
+
+	// any thread, the recorded time goes on from where it is
+	void setSpeed(double speed);
+	double getSpeed() const;
+
+	// recorded time now, the last one waited for when as fast as possible
+	int64 getTime() const;
+	bool isStarted() const;
+
+	// replay threads : returns when time is due, false when thread should exit first
+	bool waitUntil(int64 time, Thread& thread);
+
+private:
+	int64 _getTime(double now) const;
+
+	mutable SpinLock _lock;
+	double _speed;
+	bool _started = false;
+	double _wallStart = 0.0; // ms, Time::getMillisecondCounterHiRes()
+	int64 _start = 0;        // recorded time at _wallStart
+
+	JUCE_DECLARE_NON_COPYABLE(ReplayClock)
+};
@@ -0,0 +1,134 @@
+/*
+  ==============================================================================
+
+    SharedSeries.cpp
+    Created: 14 Oct 2026 5:31:44pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "SharedSeries.h"
+
+static_assert(sizeof(SharedSeries::ColumnDesc) == 64, "SharedSeries::ColumnDesc is shared with SharedSeries.py");
+static_assert(sizeof(SharedSeries::Header) == 128 + 64 * SharedSeries::maxColumns, "SharedSeries::Header is shared with SharedSeries.py");
+static_assert(sizeof(SharedSeries::Header) <= SharedSeries::headerSize, "SharedSeries::Header does not fit its block");
+
+static String readFixedString(const char* s, size_t maxSize) {
+	size_t n = 0;
+	while (n < maxSize && s[n] != 0)
+		n++;
+	return String::fromUTF8(s, (int)n);
+}
+
+static SharedSeries::DataType parseDataType(const char* dtype, uint32 itemSize) {
+	// little endian only ('=' and '|' are native / not applicable)
+	if (dtype[0] != '<' && dtype[0] != '=' && dtype[0] != '|')
+		return SharedSeries::DataType::unknown;
+	if (dtype[1] == 'f' && dtype[2] == '8' && itemSize == 8) return SharedSeries::DataType::float64;
+	if (dtype[1] == 'i' && dtype[2] == '8' && itemSize == 8) return SharedSeries::DataType::int64;
+	if (dtype[1] == 'f' && dtype[2] == '4' && itemSize == 4) return SharedSeries::DataType::float32;
+	return SharedSeries::DataType::unknown;
+}
+
+SharedSeries::Ptr SharedSeries::open(const File& file, String* error) {
+	auto fail = [error](const String& message) {
+		if (error) *error = message;
+		return Ptr();
+	};
+
+	Ptr s(new SharedSeries());
+	s->_file = file;
+	s->_map = std::make_unique<MemoryMappedFile>(file, MemoryMappedFile::readOnly);
+	const auto* data = static_cast<const char*>(s->_map->getData());
+	const size_t size = s->_map->getSize();
+	if (data == nullptr || size < headerSize)
+		return fail("Cannot map " + file.getFullPathName());
+
+	// everything but the sequence and the row count is written once by the creator
+	Header h;
+	std::memcpy(&h, data, sizeof(Header));
+	if (std::memcmp(h.magic, "TTSS", 4) != 0 || h.version != currentVersion || h.headerSize != headerSize || h.numColumns > (uint32)maxColumns)
+		return fail("Not a shared series " + file.getFullPathName());
+
+	s->_capacity = (size_t)h.capacity;
+	s->_name = readFixedString(h.name, sizeof(h.name));
+	for (uint32 i = 0; i < h.numColumns; i++) {
+		const auto& d = h.columns[i];
+		if (d.offset < headerSize || d.offset + h.capacity * d.itemSize > size)
+			return fail("Column out of the mapped range in " + file.getFullPathName());
+		Column c;
+		c.name = readFixedString(d.name, sizeof(d.name));
+		c.type = parseDataType(d.dtype, d.itemSize);
+		c.data = data + d.offset;
+		s->_columns.push_back(c);
+	}
+
+	s->refresh();
+	return s;
+}
+
+bool SharedSeries::refresh() {
+	const volatile Header* h = _header();
+	for (int attempt = 0; attempt < 64; attempt++) {
+		const uint64 before = h->sequence;
+		if (before & 1)
+			return false; // being written, the next frame will get it
+		if (before == _sequence && _sequence != 0)
+			return false; // nothing new
+		std::atomic_thread_fence(std::memory_order_acquire);
+		const uint64 rows = h->numRows;
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (h->sequence != before)
+			continue;
+		const bool changed = before != _sequence || (size_t)rows != _numRows;
+		_sequence = before;
+		_numRows = (size_t)jmin(rows, (uint64)_capacity);
+		return changed;
+	}
+	return false;
+}
+
+int SharedSeries::findColumn(const String& name) const {
+	for (size_t i = 0; i < _columns.size(); i++)
+		if (_columns[i].name == name)
+			return (int)i;
+	return -1;
+}
+
+const double* SharedSeries::getDoubleColumn(int column) const {
+	const auto& c = _columns[(size_t)column];
+	return c.type == DataType::float64 ? static_cast<const double*>(c.data) : nullptr;
+}
+
+const int64* SharedSeries::getIntColumn(int column) const {
+	const auto& c = _columns[(size_t)column];
+	return c.type == DataType::int64 ? static_cast<const int64*>(c.data) : nullptr;
+}
+
+const float* SharedSeries::getFloatColumn(int column) const {
+	const auto& c = _columns[(size_t)column];
+	return c.type == DataType::float32 ? static_cast<const float*>(c.data) : nullptr;
+}
+
+KlineStore::Ptr SharedSeries::toKlineStore(const Ptr& series) {
+	if (!series)
+		return nullptr;
+	const void* columns[KlineStore::numColumns] = {};
+	for (int c = 0; c < KlineStore::numColumns; c++) {
+		const auto column = (KlineStore::Column)c;
+		const int i = series->findColumn(KlineStore::getColumnFileName(column).upToFirstOccurrenceOf(".", false, false));
+		if (i < 0)
+			continue;
+		const auto wanted = KlineStore::isIntegerColumn(column) ? DataType::int64 : DataType::float64;
+		if (series->getColumnType(i) == wanted)
+			columns[c] = series->getColumnData(i);
+	}
+	for (auto c : { KlineStore::openTime, KlineStore::open, KlineStore::high, KlineStore::low, KlineStore::close })
+		if (columns[c] == nullptr)
+			return nullptr;
+
+	auto store = KlineStore::wrapExternal(series, columns, series->size());
+	store->setSymbol(series->getName());
+	return store;
+}
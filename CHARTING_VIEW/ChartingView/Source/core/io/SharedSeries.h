@@ -0,0 +1,108 @@
+/*
+  ==============================================================================
+
+    SharedSeries.h
+    Created: 14 Oct 2026 5:31:44pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+#include "../data/KlineStore.h"
+
+/*
+	Reader side of the shared memory channel with the Python tools
+	(ProcessNewIndicators/SharedSeries.py is the writer).
+
+	The channel is a file mapped by both processes (put it on a ram disk /
+	/dev/shm to never touch the disk), holding a control block and numpy
+	compatible columns :
+		Header          4096 bytes : magic, sequence, row count, capacity, column descriptors
+		columns         capacity * itemsize bytes each, 64 bytes aligned, at ColumnDesc::offset
+
+	The writer makes the sequence odd while it writes and even when done, the
+	reader only picks up a new row count when it saw the same even sequence
+	before and after. The capacity is fixed when the writer creates the file.
+	Columns are read in place, nothing is copied.
+*/
+
+class SharedSeries {
+public:
+	using Ptr = SPtr<SharedSeries>;
+
+	static constexpr const char* fileExtension = ".ttss";
+	static constexpr uint32 currentVersion = 1;
+	static constexpr uint32 headerSize = 4096;
+	static constexpr int maxColumns = 32;
+
+	enum class DataType { unknown, float64, int64, float32 };
+
+	struct ColumnDesc {
+		char name[48];
+		char dtype[4];      // numpy dtype.str : "<f8", "<i8", "<f4"
+		uint32 itemSize;
+		uint64 offset;
+	};
+
+	struct Header {
+		char magic[4];      // "TTSS"
+		uint32 version;
+		uint32 headerSize;
+		uint32 numColumns;
+		uint64 sequence;    // odd while the writer is updating
+		uint64 numRows;
+		uint64 capacity;
+		char name[64];
+		char reserved[24];
+		ColumnDesc columns[maxColumns];
+	};
+
+	static Ptr open(const File& file, String* error = nullptr);
+
+	// picks up the last complete update of the writer, true when the data changed
+	bool refresh();
+
+	uint64 getSequence() const { return _sequence; }
+	size_t size() const { return _numRows; }
+	size_t getCapacity() const { return _capacity; }
+	const String& getName() const { return _name; }
+	const File& getFile() const { return _file; }
+
+	int getNumColumns() const { return (int)_columns.size(); }
+	int findColumn(const String& name) const;
+	const String& getColumnName(int column) const { return _columns[(size_t)column].name; }
+	DataType getColumnType(int column) const { return _columns[(size_t)column].type; }
+	const void* getColumnData(int column) const { return _columns[(size_t)column].data; }
+	// null on a type mismatch
+	const double* getDoubleColumn(int column) const;
+	const int64* getIntColumn(int column) const;
+	const float* getFloatColumn(int column) const;
+
+	// zero-copy KlineStore over the columns named like the DownloaderTool csv
+	// (open_time, open, high, low, close, ...), null if the ohlc columns are missing.
+	// The store keeps this series alive and sees size() rows.
+	static KlineStore::Ptr toKlineStore(const Ptr& series);
+
+private:
+	SharedSeries() = default;
+
+	struct Column {
+		String name;
+		DataType type = DataType::unknown;
+		const void* data = nullptr;
+	};
+
+	const volatile Header* _header() const { return static_cast<const volatile Header*>(_map->getData()); }
+
+	File _file;
+	UPtr<MemoryMappedFile> _map;
+	String _name;
+	std::vector<Column> _columns;
+	size_t _capacity = 0;
+	size_t _numRows = 0;
+	uint64 _sequence = 0;
+
+	JUCE_DECLARE_NON_COPYABLE(SharedSeries)
+};
@@ -0,0 +1,165 @@
+/*
+  ==============================================================================
+
+    WebSocketClient.cpp
+    Created: 14 Oct 2026 6:07:55pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "WebSocketClient.h"
+
+#if JUCE_WINDOWS
+ #ifndef NOMINMAX
+  #define NOMINMAX
+ #endif
+ #include <windows.h>
+ #include <winhttp.h>
+ #pragma comment(lib, "winhttp.lib")
+#endif
+
+#if JUCE_WINDOWS
+
+static constexpr size_t minReceiveChunk = 16 << 10;
+static constexpr DWORD handshakeTimeoutMs = 3000;
+
+struct WebSocketClient::Impl {
+	HINTERNET session = nullptr;
+	HINTERNET connection = nullptr;
+	HINTERNET socket = nullptr;
+	std::mutex lock;
+
+	HINTERNET getSocket() {
+		std::lock_guard<std::mutex> l(lock);
+		return socket;
+	}
+
+	void closeHandles() {
+		std::lock_guard<std::mutex> l(lock);
+		for (HINTERNET* h : { &socket, &connection, &session }) {
+			if (*h != nullptr)
+				WinHttpCloseHandle(*h);
+			*h = nullptr;
+		}
+	}
+};
+
+WebSocketClient::WebSocketClient() : _impl(std::make_unique<Impl>()) {
+}
+
+WebSocketClient::~WebSocketClient() {
+	close();
+}
+
+bool WebSocketClient::connect(const String& url, String* error) {
+	close();
+
+	const bool secure = url.startsWithIgnoreCase("wss://");
+	const String rest = url.fromFirstOccurrenceOf("://", false, false);
+	const String hostAndPort = rest.upToFirstOccurrenceOf("/", false, false);
+	const String path = rest.substring(hostAndPort.length()).isEmpty() ? String("/") : rest.substring(hostAndPort.length());
+	const String host = hostAndPort.upToFirstOccurrenceOf(":", false, false);
+	const int port = hostAndPort.containsChar(':') ? hostAndPort.fromFirstOccurrenceOf(":", false, false).getIntValue() : (secure ? 443 : 80);
+
+	// the handles are published after the handshake, close() never pulls them away mid-call
+	HINTERNET session = WinHttpOpen(L"TTools", WINHTTP_ACCESS_TYPE_AUTOMATIC_PROXY, WINHTTP_NO_PROXY_NAME, WINHTTP_NO_PROXY_BYPASS, 0);
+	HINTERNET connection = session != nullptr ? WinHttpConnect(session, host.toWideCharPointer(), (INTERNET_PORT)port, 0) : nullptr;
+	HINTERNET request = connection != nullptr ? WinHttpOpenRequest(connection, L"GET", path.toWideCharPointer(), nullptr,
+		WINHTTP_NO_REFERER, WINHTTP_DEFAULT_ACCEPT_TYPES, secure ? WINHTTP_FLAG_SECURE : 0) : nullptr;
+
+	DWORD status = 0;
+	DWORD statusSize = sizeof(status);
+	const bool upgraded = request != nullptr
+		&& WinHttpSetTimeouts(request, handshakeTimeoutMs, handshakeTimeoutMs, handshakeTimeoutMs, handshakeTimeoutMs)
+		&& WinHttpSetOption(request, WINHTTP_OPTION_UPGRADE_TO_WEB_SOCKET, nullptr, 0)
+		&& WinHttpSendRequest(request, WINHTTP_NO_ADDITIONAL_HEADERS, 0, nullptr, 0, 0, 0)
+		&& WinHttpReceiveResponse(request, nullptr)
+		&& WinHttpQueryHeaders(request, WINHTTP_QUERY_STATUS_CODE | WINHTTP_QUERY_FLAG_NUMBER,
+			WINHTTP_HEADER_NAME_BY_INDEX, &status, &statusSize, WINHTTP_NO_HEADER_INDEX)
+		&& status == 101;
+	HINTERNET socket = upgraded ? WinHttpWebSocketCompleteUpgrade(request, 0) : nullptr;
+	const DWORD lastError = GetLastError();
+	if (request != nullptr)
+		WinHttpCloseHandle(request);
+
+	{
+		std::lock_guard<std::mutex> l(_impl->lock);
+		_impl->session = session;
+		_impl->connection = connection;
+		_impl->socket = socket;
+	}
+	if (socket == nullptr) {
+		_impl->closeHandles();
+		if (error) *error = "Websocket handshake failed on " + url + (status != 0 ? ", http " + String((int)status) : ", error " + String((int)lastError));
+		return false;
+	}
+	_connected = true;
+	return true;
+}
+
+bool WebSocketClient::receive(MemoryBlock& buffer, size_t& size) {
+	size = 0;
+	for (;;) {
+		HINTERNET socket = _impl->getSocket();
+		if (socket == nullptr)
+			return false;
+		if (buffer.getSize() < size + minReceiveChunk)
+			buffer.ensureSize(jmax(size + minReceiveChunk, buffer.getSize() * 2), false);
+
+		DWORD read = 0;
+		WINHTTP_WEB_SOCKET_BUFFER_TYPE type;
+		const DWORD r = WinHttpWebSocketReceive(socket, static_cast<char*>(buffer.getData()) + size, (DWORD)(buffer.getSize() - size), &read, &type);
+		if (r != NO_ERROR || type == WINHTTP_WEB_SOCKET_CLOSE_BUFFER_TYPE) {
+			_connected = false;
+			return false;
+		}
+		size += read;
+		if (type == WINHTTP_WEB_SOCKET_UTF8_MESSAGE_BUFFER_TYPE || type == WINHTTP_WEB_SOCKET_BINARY_MESSAGE_BUFFER_TYPE)
+			return true;
+		// *_FRAGMENT_BUFFER_TYPE : the rest of the message follows
+	}
+}
+
+bool WebSocketClient::send(const char* text, size_t size) {
+	HINTERNET socket = _impl->getSocket();
+	return socket != nullptr
+		&& WinHttpWebSocketSend(socket, WINHTTP_WEB_SOCKET_UTF8_MESSAGE_BUFFER_TYPE, (PVOID)text, (DWORD)size) == NO_ERROR;
+}
+
+void WebSocketClient::close() {
+	// closing the handles aborts the pending WinHttpWebSocketReceive
+	_connected = false;
+	_impl->closeHandles();
+}
+
+#else
+
+struct WebSocketClient::Impl {
+};
+
+WebSocketClient::WebSocketClient() : _impl(std::make_unique<Impl>()) {
+}
+
+WebSocketClient::~WebSocketClient() {
+}
+
+bool WebSocketClient::connect(const String& url, String* error) {
+	if (error) *error = "No websocket transport on this platform for " + url;
+	return false;
+}
+
+bool WebSocketClient::receive(MemoryBlock&, size_t& size) {
+	size = 0;
+	return false;
+}
+
+bool WebSocketClient::send(const char*, size_t) {
+	return false;
+}
+
+void WebSocketClient::close() {
+	_connected = false;
+}
+
+#endif
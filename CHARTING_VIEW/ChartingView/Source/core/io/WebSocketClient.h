@@ -0,0 +1,48 @@
+/*
+  ==============================================================================
+
+    WebSocketClient.h
+    Created: 14 Oct 2026 6:07:55pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+
+/*
+	Minimal blocking websocket client for the market data feeds, one per
+	ingestion thread. JUCE has neither websockets nor TLS, so this uses the
+	WinHTTP websocket API on Windows (handshake, TLS, framing, ping / pong).
+	Other platforms fail at connect().
+
+	receive() reuses the caller's buffer, it only grows on unusually large
+	messages : no allocation per message once warmed up.
+*/
+
+class WebSocketClient {
+public:
+	WebSocketClient();
+	~WebSocketClient();
+
+	// blocking, url is ws://host[:port]/path or wss://host[:port]/path
+	bool connect(const String& url, String* error = nullptr);
+
+	// blocks until one whole message is in buffer[0, size), false once closed or on error
+	bool receive(MemoryBlock& buffer, size_t& size);
+
+	bool send(const char* text, size_t size);
+
+	// any thread, unblocks a pending receive()
+	void close();
+
+	bool isConnected() const { return _connected.load(); }
+
+private:
+	struct Impl;
+	UPtr<Impl> _impl;
+	std::atomic<bool> _connected{ false };
+
+	JUCE_DECLARE_NON_COPYABLE(WebSocketClient)
+};
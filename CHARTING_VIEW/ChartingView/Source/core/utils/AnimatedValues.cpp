@@ -0,0 +1,113 @@
+/*
+  ==============================================================================
+
+    AnimatedValues.cpp
+    Created: 16 Oct 2026 12:14:05am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "AnimatedValues.h"
+
+AnimatedValues::AnimatedValues(Component& target, AnimationCurve curve, double duration)
+	: _target(target), _curve(std::move(curve)), _duration(duration) {
+	if (!_curve.isBaked())
+		_curve.bake();
+}
+
+AnimatedValues::~AnimatedValues() {
+	Animator::getInstance().cancel(_animation);
+}
+
+void AnimatedValues::resize(size_t n) {
+	for (size_t k = _running.size(); k-- > 0;)
+		if (_running[k] >= n)
+			_stop(k);
+	_values.resize(n, 0.0f);
+	_slots.resize(n, -1);
+}
+
+void AnimatedValues::setCurve(AnimationCurve curve, double duration) {
+	_curve = std::move(curve);
+	if (!_curve.isBaked())
+		_curve.bake();
+	_duration = duration;
+}
+
+void AnimatedValues::start(size_t index, float from, float to) {
+	const double now = Time::getMillisecondCounterHiRes();
+	int k = _slots[index];
+	if (k < 0) {
+		k = (int)_running.size();
+		_slots[index] = k;
+		_running.push_back((uint32)index);
+		_start.push_back(now);
+		_from.push_back(from);
+		_to.push_back(to);
+	}
+	else {
+		_start[(size_t)k] = now;
+		_from[(size_t)k] = from;
+		_to[(size_t)k] = to;
+	}
+	_values[index] = from;
+	_ensureTicking();
+}
+
+void AnimatedValues::set(size_t index, float value) {
+	if (_slots[index] >= 0)
+		_stop((size_t)_slots[index]);
+	_values[index] = value;
+}
+
+void AnimatedValues::_stop(size_t k) {
+	// the last running one takes its place
+	const size_t last = _running.size() - 1;
+	_slots[_running[k]] = -1;
+	if (k != last) {
+		_running[k] = _running[last];
+		_start[k] = _start[last];
+		_from[k] = _from[last];
+		_to[k] = _to[last];
+		_slots[_running[k]] = (int)k;
+	}
+	_running.pop_back();
+	_start.pop_back();
+	_from.pop_back();
+	_to.pop_back();
+}
+
+void AnimatedValues::_ensureTicking() {
+	auto& animator = Animator::getInstance();
+	if (animator.isRunning(_animation))
+		return;
+	// the values started later than this animation keep it going when it ends
+	_animation = animator.start(_target, _duration, AnimationCurve::linear(),
+		[this](float) { _update(Time::getMillisecondCounterHiRes()); },
+		[this]() {
+			if (!_running.empty())
+				_ensureTicking();
+		});
+}
+
+void AnimatedValues::_update(double now) {
+	const size_t n = _running.size();
+	_progress.resize(n);
+	const double scale = _duration > 0.0 ? 1.0 / _duration : 0.0;
+	for (size_t k = 0; k < n; k++)
+		_progress[k] = scale > 0.0 ? (float)jmin(1.0, (now - _start[k]) * scale) : 1.0f;
+	// progress -> eased in place, one pass over the table
+	_curve.evaluate(_progress.data(), _progress.data(), n);
+	for (size_t k = 0; k < n; k++)
+		_values[_running[k]] = _from[k] + (_to[k] - _from[k]) * _progress[k];
+	// the finished ones at rest on their target
+	for (size_t k = n; k-- > 0;) {
+		if (now - _start[k] >= _duration) {
+			_values[_running[k]] = _to[k];
+			_stop(k);
+		}
+	}
+	if (onFrame)
+		onFrame();
+}
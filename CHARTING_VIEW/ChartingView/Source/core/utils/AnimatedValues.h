@@ -0,0 +1,73 @@
+/*
+  ==============================================================================
+
+    AnimatedValues.h
+    Created: 16 Oct 2026 12:14:05am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+#include "AnimationCurve.h"
+#include "Animator.h"
+
+/*
+	Many values of one component animated with the same curve and duration
+	(the flash of hundreds of watchlist cells on a price change...) : the
+	state is kept as arrays and a frame is one pass over the running values,
+	the progresses eased in one batch by the baked curve. One Animator
+	animation ticks them all and repaints the target once.
+
+		AnimatedValues flashes(list, AnimationCurve::easeOut(), 600.0);
+		flashes.resize(numRows);
+		flashes.start(row, 1.0f, 0.0f);             // on the price change
+		...
+		g.setColour(flash.withAlpha(flashes.get(row))); // paint
+
+	Message thread only.
+*/
+
+class AnimatedValues {
+public:
+	AnimatedValues(Component& target, AnimationCurve curve = AnimationCurve::easeOut(), double duration = 400.0);
+	~AnimatedValues();
+
+	// new values at rest at 0, the running ones past n stop
+	void resize(size_t n);
+	size_t size() const { return _values.size(); }
+	void setCurve(AnimationCurve curve, double duration);
+
+	// index goes from from to to, starting now (restarts a running one)
+	void start(size_t index, float from, float to);
+	// index at rest at value
+	void set(size_t index, float value);
+	float get(size_t index) const { return _values[index]; }
+	const float* getValues() const { return _values.data(); }
+	bool isRunning(size_t index) const { return _slots[index] >= 0; }
+	int getNumRunning() const { return (int)_running.size(); }
+
+	// after the values of a frame were updated, before the target repaints
+	std::function<void()> onFrame;
+
+private:
+	void _update(double now);
+	void _stop(size_t k);
+	void _ensureTicking();
+
+	Component& _target;
+	AnimationCurve _curve;
+	double _duration;
+
+	std::vector<float> _values;
+	std::vector<int> _slots;       // index in the running arrays, -1 at rest
+	// running values, packed : index, start time, from, to
+	std::vector<uint32> _running;
+	std::vector<double> _start;
+	std::vector<float> _from, _to;
+	std::vector<float> _progress;  // frame storage
+	Animator::Id _animation = 0;
+
+	JUCE_DECLARE_NON_COPYABLE(AnimatedValues)
+};
@@ -9,3 +9,133 @@
 */
 
 #include "AnimationCurve.h"
+
+static float bezier(float a, float b, float s) {
+	// 1D cubic from 0 to 1 with handles a and b
+	const float r = 1.0f - s;
+	return 3.0f * r * r * s * a + 3.0f * r * s * s * b + s * s * s;
+}
+
+static float bezierSlope(float a, float b, float s) {
+	const float r = 1.0f - s;
+	return 3.0f * r * r * a + 6.0f * r * s * (b - a) + 3.0f * s * s * (1.0f - b);
+}
+
+AnimationCurve AnimationCurve::cubicBezier(float x1, float y1, float x2, float y2) {
+	AnimationCurve c;
+	Keyframe first;
+	first.interpolation = Interpolation::bezier;
+	first.out = { jlimit(0.0f, 1.0f, x1), y1 };
+	first.in = { jlimit(0.0f, 1.0f, x2), y2 };
+	c.addKeyframe(first);
+	c.addKeyframe(1.0f, 1.0f);
+	return c;
+}
+
+AnimationCurve AnimationCurve::easeIn() {
+	static const auto curve = cubicBezier(0.42f, 0.0f, 1.0f, 1.0f).bake();
+	return curve;
+}
+
+AnimationCurve AnimationCurve::easeOut() {
+	static const auto curve = cubicBezier(0.0f, 0.0f, 0.58f, 1.0f).bake();
+	return curve;
+}
+
+AnimationCurve AnimationCurve::easeInOut() {
+	static const auto curve = cubicBezier(0.42f, 0.0f, 0.58f, 1.0f).bake();
+	return curve;
+}
+
+AnimationCurve& AnimationCurve::addKeyframe(const Keyframe& k) {
+	_table = nullptr;
+	auto it = std::lower_bound(_keys.begin(), _keys.end(), k.time, [](const Keyframe& a, float time) { return a.time < time; });
+	if (it != _keys.end() && it->time == k.time)
+		*it = k;
+	else
+		_keys.insert(it, k);
+	return *this;
+}
+
+AnimationCurve& AnimationCurve::addKeyframe(float time, float value, Interpolation interpolation) {
+	Keyframe k;
+	k.time = time;
+	k.value = value;
+	k.interpolation = interpolation;
+	return addKeyframe(k);
+}
+
+float AnimationCurve::solveBezier(Point<float> out, Point<float> in, float x) {
+	// newton first, x(s) is monotonic with handles inside [0, 1]
+	float s = x;
+	for (int i = 0; i < 8; i++) {
+		const float error = bezier(out.x, in.x, s) - x;
+		if (std::abs(error) < 1.0e-5f)
+			return bezier(out.y, in.y, s);
+		const float slope = bezierSlope(out.x, in.x, s);
+		if (std::abs(slope) < 1.0e-6f)
+			break;
+		s -= error / slope;
+	}
+	// flat spots, bisection
+	float lo = 0.0f, hi = 1.0f;
+	s = x;
+	for (int i = 0; i < 24; i++) {
+		if (bezier(out.x, in.x, s) < x)
+			lo = s;
+		else
+			hi = s;
+		s = 0.5f * (lo + hi);
+	}
+	return bezier(out.y, in.y, s);
+}
+
+AnimationCurve& AnimationCurve::bake(int numSamples) {
+	_table = nullptr;
+	if (_keys.size() < 2 || numSamples < 2)
+		return *this;
+	const float start = _keys.front().time;
+	const float span = _keys.back().time - start;
+	auto table = std::make_shared<std::vector<float>>((size_t)numSamples);
+	for (int i = 0; i < numSamples; i++)
+		(*table)[(size_t)i] = evaluateExact(start + span * (float)i / (float)(numSamples - 1));
+	_tableStart = start;
+	_tableScale = (float)(numSamples - 1) / span;
+	_table = std::move(table);
+	return *this;
+}
+
+float AnimationCurve::evaluate(float t) const {
+	return _table ? _lookup(t) : evaluateExact(t);
+}
+
+void AnimationCurve::evaluate(const float* t, float* out, size_t n) const {
+	if (_table) {
+		for (size_t i = 0; i < n; i++)
+			out[i] = _lookup(t[i]);
+		return;
+	}
+	for (size_t i = 0; i < n; i++)
+		out[i] = evaluateExact(t[i]);
+}
+
+float AnimationCurve::evaluateExact(float t) const {
+	if (_keys.empty())
+		return jlimit(0.0f, 1.0f, t);
+	if (t <= _keys.front().time)
+		return _keys.front().value;
+	if (t >= _keys.back().time)
+		return _keys.back().value;
+
+	auto next = std::upper_bound(_keys.begin(), _keys.end(), t, [](float time, const Keyframe& k) { return time < k.time; });
+	const auto& a = *std::prev(next);
+	const auto& b = *next;
+	const float x = (t - a.time) / (b.time - a.time);
+	float y = x;
+	switch (a.interpolation) {
+	case Interpolation::step: y = 0.0f; break;
+	case Interpolation::bezier: y = solveBezier(a.out, a.in, x); break;
+	default: break;
+	}
+	return a.value + (b.value - a.value) * y;
+}
@@ -9,3 +9,81 @@
 */
 
 #pragma once
+#include "JuceHeader.h"
+
+/*
+	Easing of an animation : maps its progress t in [0, 1] to a value through
+	keyframes, each segment being linear, held or a cubic bezier (the handles
+	of css cubic-bezier(), normalised to the segment).
+
+	Without keyframes the curve is linear from 0 to 1.
+
+	bake() samples the curve once into a table that copies share, evaluate()
+	is then two reads and a lerp instead of a bezier solve, whatever the
+	keyframes (a step is spread over one sample). The presets come baked.
+*/
+
+class AnimationCurve {
+public:
+	enum class Interpolation { linear, bezier, step };
+
+	struct Keyframe {
+		float time = 0.0f;
+		float value = 0.0f;
+		// towards the next keyframe
+		Interpolation interpolation = Interpolation::linear;
+		// bezier handles in the segment to the next keyframe, (0, 0) -> (1, 1) being this keyframe -> the next one
+		Point<float> out{ 1.0f / 3.0f, 1.0f / 3.0f };
+		Point<float> in{ 2.0f / 3.0f, 2.0f / 3.0f };
+	};
+
+	AnimationCurve() = default;
+
+	static AnimationCurve linear() { return {}; }
+	// css cubic-bezier(x1, y1, x2, y2) from 0 to 1
+	static AnimationCurve cubicBezier(float x1, float y1, float x2, float y2);
+	// baked once, copies share the table
+	static AnimationCurve easeIn();
+	static AnimationCurve easeOut();
+	static AnimationCurve easeInOut();
+
+	static constexpr int defaultBakeSize = 256;
+
+	// keeps the keyframes sorted by time, replaces one at the same time. Drops the baked table
+	AnimationCurve& addKeyframe(const Keyframe& k);
+	AnimationCurve& addKeyframe(float time, float value, Interpolation interpolation = Interpolation::linear);
+	AnimationCurve& clear() { _keys.clear(); _table = nullptr; return *this; }
+	const std::vector<Keyframe>& getKeyframes() const { return _keys; }
+
+	// samples the curve between its first and last keyframes, evaluate() interpolates them
+	AnimationCurve& bake(int numSamples = defaultBakeSize);
+	bool isBaked() const { return _table != nullptr; }
+
+	// value at t, clamped to the first / last keyframe outside of them
+	float evaluate(float t) const;
+	// out[i] = evaluate(t[i]), the table and the keyframes resolved once
+	void evaluate(const float* t, float* out, size_t n) const;
+	// from the keyframes, without the table
+	float evaluateExact(float t) const;
+
+	// bezier y at x of the (0, 0), out, in, (1, 1) curve
+	static float solveBezier(Point<float> out, Point<float> in, float x);
+
+private:
+	float _lookup(float t) const {
+		const auto& table = *_table;
+		const float x = (t - _tableStart) * _tableScale;
+		const int last = (int)table.size() - 1;
+		if (!(x > 0.0f))
+			return table.front();
+		if (x >= (float)last)
+			return table.back();
+		const int i = (int)x;
+		return table[(size_t)i] + (table[(size_t)i + 1] - table[(size_t)i]) * (x - (float)i);
+	}
+
+	std::vector<Keyframe> _keys;
+	SPtr<const std::vector<float>> _table;
+	float _tableStart = 0.0f;
+	float _tableScale = 1.0f;  // samples per unit of t
+};
@@ -0,0 +1,115 @@
+/*
+  ==============================================================================
+
+    Animator.cpp
+    Created: 15 Oct 2026 12:21:40am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "Animator.h"
+
+Animator::Animator() {
+	_detach.onAsyncUpdate = [this]() { _detachIdle(); };
+}
+
+Animator& Animator::getInstance() {
+	static Animator animator;
+	return animator;
+}
+
+Animator::Id Animator::start(Component& target, Animation animation) {
+	Component* window = target.getTopLevelComponent();
+	if (window == nullptr)
+		window = &target;
+	Running r;
+	r.id = _nextId++;
+	r.target = &target;
+	r.window = window;
+	r.startTime = Time::getMillisecondCounterHiRes();
+	r.animation = std::move(animation);
+	_running.push_back(std::move(r));
+	_attach(window);
+	return _running.back().id;
+}
+
+Animator::Id Animator::start(Component& target, double duration, AnimationCurve curve, std::function<void(float)> onFrame, std::function<void()> onFinished) {
+	Animation a;
+	a.duration = duration;
+	a.curve = std::move(curve);
+	a.onFrame = std::move(onFrame);
+	a.onFinished = std::move(onFinished);
+	return start(target, std::move(a));
+}
+
+void Animator::cancel(Id id) {
+	std::erase_if(_running, [id](const Running& r) { return r.id == id; });
+	_detach.triggerAsyncUpdate();
+}
+
+void Animator::cancelAll(Component& target) {
+	std::erase_if(_running, [&target](const Running& r) { return r.target.getComponent() == &target; });
+	_detach.triggerAsyncUpdate();
+}
+
+bool Animator::isRunning(Id id) const {
+	return std::any_of(_running.begin(), _running.end(), [id](const Running& r) { return r.id == id; });
+}
+
+void Animator::_attach(Component* window) {
+	for (const auto& w : _windows)
+		if (w.component.getComponent() == window)
+			return;
+	Window w;
+	w.component = window;
+	w.vblank = std::make_unique<VBlankAttachment>(window, [this, window]() { _tick(window); });
+	_windows.push_back(std::move(w));
+}
+
+void Animator::_tick(Component* window) {
+	const double now = Time::getMillisecondCounterHiRes();
+	_numFrames++;
+	_dirty.clear();
+
+	// onFrame may start or cancel animations, the running list is walked by id
+	_ticking.clear();
+	for (const auto& r : _running)
+		if (r.window == window)
+			_ticking.push_back(r.id);
+	for (Id id : _ticking) {
+		auto it = std::find_if(_running.begin(), _running.end(), [id](const Running& r) { return r.id == id; });
+		if (it == _running.end())
+			continue;
+		Component* target = it->target.getComponent();
+		if (target == nullptr) {
+			_running.erase(it);
+			continue;
+		}
+		const double progress = it->animation.duration > 0.0 ? jmin(1.0, (now - it->startTime) / it->animation.duration) : 1.0;
+		const bool done = progress >= 1.0;
+		auto onFinished = done ? std::move(it->animation.onFinished) : nullptr;
+		if (it->animation.onFrame)
+			it->animation.onFrame(it->animation.curve.evaluate((float)progress));
+		if (done)
+			std::erase_if(_running, [id](const Running& r) { return r.id == id; });
+		if (std::find(_dirty.begin(), _dirty.end(), target) == _dirty.end())
+			_dirty.push_back(target);
+		if (onFinished)
+			onFinished();
+	}
+
+	// one repaint per target for the frame
+	for (auto* c : _dirty)
+		c->repaint();
+	// not from inside the vblank callback of the attachment
+	_detach.triggerAsyncUpdate();
+}
+
+void Animator::_detachIdle() {
+	std::erase_if(_windows, [this](const Window& w) {
+		if (w.component.getComponent() == nullptr)
+			return true;
+		return std::none_of(_running.begin(), _running.end(), [&w](const Running& r) { return r.window == w.component.getComponent(); });
+	});
+}
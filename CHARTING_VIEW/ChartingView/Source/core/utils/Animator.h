@@ -0,0 +1,83 @@
+/*
+  ==============================================================================
+
+    Animator.h
+    Created: 15 Oct 2026 12:21:40am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+#include "AnimationCurve.h"
+#include "AsyncUpdaterLambda.h"
+
+/*
+	Every running animation of the app, ticked on the display refresh
+	(VBlankAttachment of the target's window) instead of a Timer per widget.
+
+	A frame first calls onFrame of every animation of the window, then
+	repaints each target once, however many of its animations ran. Nothing
+	ticks once the last animation of a window is done.
+
+	Message thread only.
+*/
+
+class Animator {
+public:
+	using Id = int;
+
+	struct Animation {
+		double duration = 200.0; // ms
+		AnimationCurve curve = AnimationCurve::easeOut();
+		// curve value of the progress, 1 at the last frame (curves may overshoot)
+		std::function<void(float)> onFrame;
+		// after the last onFrame, not called on cancel()
+		std::function<void()> onFinished;
+	};
+
+	static Animator& getInstance();
+
+	// runs on the window of target, repainting it every frame. The animation stops when
+	// target is deleted.
+	Id start(Component& target, Animation animation);
+	Id start(Component& target, double duration, AnimationCurve curve, std::function<void(float)> onFrame, std::function<void()> onFinished = nullptr);
+	void cancel(Id id);
+	// every animation of target
+	void cancelAll(Component& target);
+
+	bool isRunning(Id id) const;
+	int getNumRunning() const { return (int)_running.size(); }
+	// frames ticked so far (all windows)
+	uint64 getNumFrames() const { return _numFrames; }
+
+private:
+	Animator();
+
+	struct Running {
+		Id id = 0;
+		Component::SafePointer<Component> target;
+		Component* window = nullptr;
+		double startTime = 0.0;
+		Animation animation;
+	};
+	struct Window {
+		Component::SafePointer<Component> component;
+		UPtr<VBlankAttachment> vblank;
+	};
+
+	void _attach(Component* window);
+	void _tick(Component* window);
+	void _detachIdle();
+
+	std::vector<Running> _running;
+	std::vector<Window> _windows;
+	std::vector<Id> _ticking;
+	std::vector<Component*> _dirty;
+	AsyncUpdaterLambda _detach;
+	Id _nextId = 1;
+	uint64 _numFrames = 0;
+
+	JUCE_DECLARE_NON_COPYABLE(Animator)
+};
@@ -0,0 +1,195 @@
+/*
+  ==============================================================================
+
+    FrameProfiler.cpp
+    Created: 15 Oct 2026 12:20:44pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "FrameProfiler.h"
+
+FrameProfiler& FrameProfiler::getInstance() {
+	static FrameProfiler profiler;
+	return profiler;
+}
+
+const char* FrameProfiler::getSectionName(Section section) {
+	switch (section) {
+	case frame: return "frame";
+	case layout: return "layout";
+	case rangeQuery: return "rangeQuery";
+	case decimation: return "decimation";
+	case rasterization: return "rasterization";
+	case compositing: return "compositing";
+	default: return "?";
+	}
+}
+
+void FrameProfiler::setEnabled(bool shouldBeEnabled) {
+	_enabled = shouldBeEnabled;
+	// the next frame starts clean
+	_frameStart = 0;
+}
+
+FrameProfiler::Ring& FrameProfiler::_getRing() {
+	// one ring per thread for the life of the app, registered on its first event
+	thread_local Ring* ring = nullptr;
+	if (ring == nullptr) {
+		auto r = std::make_unique<Ring>();
+		if (MessageManager::existsAndIsCurrentThread())
+			r->threadName = "message";
+		else if (auto* t = Thread::getCurrentThread())
+			r->threadName = t->getThreadName();
+		else
+			r->threadName = "thread";
+		const ScopedLock sl(_ringsLock);
+		r->id = (int)_rings.size() + 1;
+		ring = r.get();
+		_rings.push_back(std::move(r));
+	}
+	return *ring;
+}
+
+void FrameProfiler::record(Section section, int64 start, int64 end) {
+	_sectionTicks[section].fetch_add(end - start, std::memory_order_relaxed);
+	auto& ring = _getRing();
+	const uint64 head = ring.head.load(std::memory_order_relaxed);
+	auto& slot = ring.slots[head % ringSize];
+	slot.section.store((int)section, std::memory_order_relaxed);
+	slot.start.store(start, std::memory_order_relaxed);
+	slot.end.store(end, std::memory_order_relaxed);
+	ring.head.store(head + 1, std::memory_order_release);
+}
+
+void FrameProfiler::_readRing(const Ring& ring, std::vector<Event>& out) const {
+	const uint64 head = ring.head.load(std::memory_order_acquire);
+	const uint64 first = head > ringSize ? head - ringSize : 0;
+	const size_t start = out.size();
+	for (uint64 i = first; i < head; i++) {
+		const auto& slot = ring.slots[i % ringSize];
+		out.push_back({ (Section)slot.section.load(std::memory_order_relaxed), slot.start.load(std::memory_order_relaxed), slot.end.load(std::memory_order_relaxed) });
+	}
+	// slots the writer went over while they were copied (the one it writes included)
+	const uint64 after = ring.head.load(std::memory_order_acquire);
+	const uint64 firstValid = after + 1 > ringSize ? after + 1 - ringSize : 0;
+	if (firstValid > first)
+		out.erase(out.begin() + (ptrdiff_t)start, out.begin() + (ptrdiff_t)(start + jmin((size_t)(firstValid - first), out.size() - start)));
+}
+
+void FrameProfiler::beginFrame() {
+	if (isEnabled())
+		_frameStart = Time::getHighResolutionTicks();
+}
+
+void FrameProfiler::endFrame() {
+	if (!isEnabled() || _frameStart == 0)
+		return;
+	const int64 end = Time::getHighResolutionTicks();
+	record(frame, _frameStart, end);
+	// the totals go to the frame they ended in, whichever thread produced them
+	auto& f = _history[_numFrames % historySize];
+	f.start = _frameStart;
+	f.end = end;
+	for (int s = 0; s < numSections; s++)
+		f.sectionTicks[s] = _sectionTicks[s].exchange(0, std::memory_order_relaxed);
+	for (int c = 0; c < numCounters; c++)
+		f.counters[c] = _counters[c].exchange(0, std::memory_order_relaxed);
+	_numFrames++;
+	_frameStart = 0;
+}
+
+FrameProfiler::Stats FrameProfiler::getStats() const {
+	Stats stats;
+	const size_t n = jmin(_numFrames, historySize);
+	stats.numFrames = (int)n;
+	if (n == 0)
+		return stats;
+	const double tickMs = 1000.0 / (double)Time::getHighResolutionTicksPerSecond();
+	const int64 now = Time::getHighResolutionTicks();
+	const int64 oneSecond = Time::getHighResolutionTicksPerSecond();
+
+	std::vector<double> times;
+	times.reserve(n);
+	int64 hits = 0, misses = 0;
+	for (size_t i = 0; i < n; i++) {
+		const auto& f = _history[(_numFrames - 1 - i) % historySize];
+		times.push_back((double)(f.end - f.start) * tickMs);
+		if (now - f.end <= oneSecond)
+			stats.fps += 1.0;
+		for (int s = 0; s < numSections; s++)
+			stats.sectionMs[s] += (double)f.sectionTicks[s] * tickMs / (double)n;
+		stats.pointsInRange += (double)f.counters[pointsInRange] / (double)n;
+		stats.pointsDrawn += (double)f.counters[pointsDrawn] / (double)n;
+		hits += f.counters[cacheHits];
+		misses += f.counters[cacheMisses];
+	}
+	std::sort(times.begin(), times.end());
+	auto percentile = [&](double p) { return times[jmin(n - 1, (size_t)(p * (double)n))]; };
+	stats.p50 = percentile(0.5);
+	stats.p90 = percentile(0.9);
+	stats.p99 = percentile(0.99);
+	stats.maxMs = times.back();
+	stats.cacheHitRate = hits + misses > 0 ? (double)hits / (double)(hits + misses) : 0.0;
+	return stats;
+}
+
+String FrameProfiler::toChromeTrace() const {
+	struct Track {
+		String name;
+		int id = 0;
+		std::vector<Event> events;
+	};
+	std::vector<Track> tracks;
+	{
+		const ScopedLock sl(_ringsLock);
+		for (const auto& ring : _rings) {
+			tracks.push_back({ ring->threadName, ring->id });
+			_readRing(*ring, tracks.back().events);
+		}
+	}
+	int64 origin = std::numeric_limits<int64>::max();
+	for (const auto& t : tracks)
+		for (const auto& e : t.events)
+			origin = jmin(origin, e.start);
+	const double tickUs = 1e6 / (double)Time::getHighResolutionTicksPerSecond();
+	auto toUs = [&](int64 ticks) { return String((double)(ticks - origin) * tickUs, 3); };
+
+	// complete events ("X") per thread, counters ("C") per frame, ts / dur in us
+	MemoryOutputStream out;
+	out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	bool first = true;
+	auto separator = [&]() {
+		if (!first)
+			out << ",\n";
+		first = false;
+	};
+	for (const auto& t : tracks) {
+		separator();
+		out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << t.id << ",\"args\":{\"name\":\"" << t.name.replace("\"", "'") << "\"}}";
+		for (const auto& e : t.events) {
+			separator();
+			out << "{\"name\":\"" << getSectionName(e.section) << "\",\"cat\":\"chart\",\"ph\":\"X\",\"pid\":1,\"tid\":" << t.id
+				<< ",\"ts\":" << toUs(e.start) << ",\"dur\":" << String((double)(e.end - e.start) * tickUs, 3) << "}";
+		}
+	}
+	if (origin != std::numeric_limits<int64>::max()) {
+		for (size_t i = jmin(_numFrames, historySize); i > 0; i--) {
+			const auto& f = _history[(_numFrames - i) % historySize];
+			if (f.end < origin)
+				continue;
+			separator();
+			out << "{\"name\":\"points\",\"ph\":\"C\",\"pid\":1,\"ts\":" << toUs(f.end) << ",\"args\":{\"inRange\":" << f.counters[pointsInRange]
+				<< ",\"drawn\":" << f.counters[pointsDrawn] << "}},\n";
+			out << "{\"name\":\"layer cache\",\"ph\":\"C\",\"pid\":1,\"ts\":" << toUs(f.end) << ",\"args\":{\"hits\":" << f.counters[cacheHits]
+				<< ",\"misses\":" << f.counters[cacheMisses] << "}}";
+		}
+	}
+	out << "\n]}\n";
+	return out.toString();
+}
+
+bool FrameProfiler::writeChromeTrace(const File& file) const {
+	return file.replaceWithText(toChromeTrace());
+}
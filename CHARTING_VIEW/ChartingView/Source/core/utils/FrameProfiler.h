@@ -0,0 +1,149 @@
+/*
+  ==============================================================================
+
+    FrameProfiler.h
+    Created: 15 Oct 2026 12:20:44pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+
+/*
+	Hot path instrumentation kept in release builds : scoped timers around the
+	sections of a frame and a few counters, read by WProfilerOverlay and dumped
+	as a Chrome / Perfetto trace (chrome://tracing, ui.perfetto.dev).
+
+		void WChartViewport::updateVisibleRange() {
+			const FrameProfiler::Scope scope(FrameProfiler::rangeQuery);
+			...
+
+	Every thread writes its events to its own ring (the last ringSize ones,
+	kept for the life of the app : the message thread, TaskPool workers and
+	render threads), without locks : a slot is written then published by the ring head, a
+	reader drops the slots the writer may have reused meanwhile. The section
+	totals and the counters are atomics folded into the frame history by
+	endFrame() (message thread).
+
+	Off by default : a disabled scope costs one relaxed load.
+*/
+
+class FrameProfiler {
+public:
+	enum Section {
+		frame = 0,     // a paint pass of the window, beginFrame() .. endFrame()
+		layout,
+		rangeQuery,
+		decimation,
+		rasterization,
+		compositing,   // layer images blitted to the window
+		numSections
+	};
+
+	enum Counter {
+		pointsInRange = 0, // rows of the visible ranges
+		pointsDrawn,       // candles / columns actually rasterized
+		cacheHits,         // layers drawn from their image
+		cacheMisses,       // layers rendered again, wholly or partly
+		numCounters
+	};
+
+	static constexpr size_t ringSize = 1 << 14;  // events per thread
+	static constexpr size_t historySize = 256;   // frames
+
+	class Scope {
+	public:
+		explicit Scope(Section section)
+			: _section(section)
+			, _start(getInstance().isEnabled() ? Time::getHighResolutionTicks() : 0) {
+		}
+		~Scope() { stop(); }
+
+		// ends the section before the end of the block
+		void stop() {
+			if (_start != 0)
+				getInstance().record(_section, _start, Time::getHighResolutionTicks());
+			_start = 0;
+		}
+
+	private:
+		Section _section;
+		int64 _start;
+
+		JUCE_DECLARE_NON_COPYABLE(Scope)
+	};
+
+	struct Event {
+		Section section = frame;
+		int64 start = 0;  // high resolution ticks
+		int64 end = 0;
+	};
+
+	struct Stats {
+		int numFrames = 0;             // in the history
+		double fps = 0.0;              // frames ended in the last second
+		double p50 = 0.0, p90 = 0.0, p99 = 0.0, maxMs = 0.0; // frame times
+		double sectionMs[numSections] = {}; // mean per frame
+		double pointsInRange = 0.0;    // mean per frame
+		double pointsDrawn = 0.0;
+		double cacheHitRate = 0.0;     // 0 .. 1
+	};
+
+	static FrameProfiler& getInstance();
+
+	void setEnabled(bool shouldBeEnabled);
+	bool isEnabled() const { return _enabled.load(std::memory_order_relaxed); }
+
+	// any thread, see Scope
+	void record(Section section, int64 start, int64 end);
+	void count(Counter counter, int64 amount = 1) {
+		if (isEnabled())
+			_counters[counter].fetch_add(amount, std::memory_order_relaxed);
+	}
+
+	// message thread, around a paint pass of the window
+	void beginFrame();
+	void endFrame();
+	Stats getStats() const;
+
+	// message thread, every event still in the rings and the frame counters
+	String toChromeTrace() const;
+	bool writeChromeTrace(const File& file) const;
+
+	static const char* getSectionName(Section section);
+
+private:
+	struct Slot {
+		std::atomic<int> section{ 0 };
+		std::atomic<int64> start{ 0 };
+		std::atomic<int64> end{ 0 };
+	};
+	struct Ring {
+		String threadName;
+		int id = 0;
+		std::atomic<uint64> head{ 0 }; // events written
+		Slot slots[ringSize];
+	};
+	struct FrameRecord {
+		int64 start = 0, end = 0;
+		int64 sectionTicks[numSections] = {};
+		int64 counters[numCounters] = {};
+	};
+
+	FrameProfiler() = default;
+	Ring& _getRing();
+	void _readRing(const Ring& ring, std::vector<Event>& out) const;
+
+	std::atomic<bool> _enabled{ false };
+	std::atomic<int64> _sectionTicks[numSections] = {};
+	std::atomic<int64> _counters[numCounters] = {};
+	CriticalSection _ringsLock; // registering a thread, reading the list
+	std::vector<UPtr<Ring>> _rings;
+	FrameRecord _history[historySize]; // message thread
+	size_t _numFrames = 0;
+	int64 _frameStart = 0;
+
+	JUCE_DECLARE_NON_COPYABLE(FrameProfiler)
+};
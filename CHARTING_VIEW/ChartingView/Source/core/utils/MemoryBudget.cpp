@@ -0,0 +1,85 @@
+/*
+  ==============================================================================
+
+    MemoryBudget.cpp
+    Created: 16 Oct 2026 10:03:18am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "MemoryBudget.h"
+
+// first evicted first
+static constexpr MemoryBudget::Subsystem evictionOrder[] = {
+	MemoryBudget::tiles,
+	MemoryBudget::samples,
+	MemoryBudget::decodedBlocks,
+	MemoryBudget::lodLevels
+};
+
+MemoryBudget& MemoryBudget::getInstance() {
+	// never destroyed : static caches and stores released at exit still account their bytes
+	static MemoryBudget* budget = new MemoryBudget();
+	return *budget;
+}
+
+MemoryBudget::MemoryBudget() {
+	const int64 physical = (int64)SystemStats::getMemorySizeInMegabytes() << 20;
+	setLimit(jmax((int64)512 << 20, physical / 4));
+}
+
+int64 MemoryBudget::getTotalUsage() const {
+	int64 total = 0;
+	for (const auto& u : _usage)
+		total += u.load(std::memory_order_relaxed);
+	return total;
+}
+
+void MemoryBudget::setLimit(int64 bytes) {
+	_limit.store(jmax((int64)0, bytes), std::memory_order_relaxed);
+}
+
+void MemoryBudget::addClient(Subsystem subsystem, Client* client) {
+	const ScopedLock sl(_lock);
+	_clients.push_back({ subsystem, client });
+}
+
+void MemoryBudget::removeClient(Client* client) {
+	const ScopedLock sl(_lock);
+	_clients.erase(std::remove_if(_clients.begin(), _clients.end(), [client](const Registration& r) {
+		return r.client == client;
+	}), _clients.end());
+}
+
+size_t MemoryBudget::trim() {
+	if (!isOverLimit())
+		return 0;
+	const int64 target = getLimit() - (int64)((double)getLimit() * trimMargin);
+	size_t freed = 0;
+	const ScopedLock sl(_lock);
+	for (auto subsystem : evictionOrder) {
+		for (const auto& r : _clients) {
+			const int64 excess = getTotalUsage() - target;
+			if (excess <= 0)
+				break;
+			if (r.subsystem == subsystem)
+				freed += r.client->releaseMemory((size_t)excess);
+		}
+	}
+	_released.fetch_add((uint64)freed, std::memory_order_relaxed);
+	return freed;
+}
+
+const char* MemoryBudget::getSubsystemName(Subsystem subsystem) {
+	switch (subsystem) {
+		case stores: return "stores";
+		case lodLevels: return "lod levels";
+		case decodedBlocks: return "decoded blocks";
+		case samples: return "function samples";
+		case tiles: return "tiles";
+		case glyphs: return "glyphs";
+		case gpuBuffers: return "gpu buffers";
+		default: return "";
+	}
+}
@@ -0,0 +1,102 @@
+/*
+  ==============================================================================
+
+    MemoryBudget.h
+    Created: 16 Oct 2026 10:03:18am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+
+/*
+	One accounting point for the memory the app grows over a session : each
+	subsystem adds and removes the bytes it allocates (lock-free counters),
+	read by WProfilerOverlay.
+
+	Above the limit, trim() asks the clients registered for the evictable
+	subsystems to give memory back, in this order :
+		tiles           WChartTileCache images, but the ones of the view in place
+		samples         FunctionSeries chunks, least recently used
+		decodedBlocks   CompressedKlineStore decoded blocks, least recently used
+		lodLevels       fine LodPyramid levels of the charts off screen, built
+		                again when they show up
+	and stops as soon as the usage is back under the limit minus some room
+	(trimMargin), so a session at the limit does not trim every frame. The
+	other subsystems are only accounted : stores (owned columns, compressed
+	data, live ring series), glyphs (TextCache), gpuBuffers (WChartGLRenderer).
+
+	WChartingView trims at the end of each frame, one relaxed load when under
+	the limit.
+
+		MemoryBudget::getInstance().add(MemoryBudget::tiles, bytes);
+		...
+		MemoryBudget::getInstance().add(MemoryBudget::tiles, -bytes);
+*/
+
+class MemoryBudget {
+public:
+	enum Subsystem {
+		stores = 0,
+		lodLevels,
+		decodedBlocks,
+		samples,
+		tiles,
+		glyphs,
+		gpuBuffers,
+		numSubsystems
+	};
+
+	// registered for an evictable subsystem, trim() calls it on the message thread
+	class Client {
+	public:
+		virtual ~Client() = default;
+		// frees about bytes (less when it can't, more is fine), returns the bytes freed.
+		// Must not add or remove clients
+		virtual size_t releaseMemory(size_t bytes) = 0;
+	};
+
+	// fraction of the limit freed below it by a trim
+	static constexpr double trimMargin = 0.125;
+
+	static MemoryBudget& getInstance();
+
+	// any thread
+	void add(Subsystem subsystem, int64 bytes) { _usage[subsystem].fetch_add(bytes, std::memory_order_relaxed); }
+	int64 getUsage(Subsystem subsystem) const { return _usage[subsystem].load(std::memory_order_relaxed); }
+	int64 getTotalUsage() const;
+	bool isOverLimit() const { return getTotalUsage() > getLimit(); }
+
+	// a quarter of the physical memory by default
+	void setLimit(int64 bytes);
+	int64 getLimit() const { return _limit.load(std::memory_order_relaxed); }
+
+	// any thread. The client is not called anymore once removeClient() returned
+	void addClient(Subsystem subsystem, Client* client);
+	void removeClient(Client* client);
+
+	// message thread, evicts in priority order while over the limit. Returns the bytes freed
+	size_t trim();
+	// bytes freed by the trims so far
+	uint64 getNumReleased() const { return _released.load(std::memory_order_relaxed); }
+
+	static const char* getSubsystemName(Subsystem subsystem);
+
+private:
+	struct Registration {
+		Subsystem subsystem;
+		Client* client;
+	};
+
+	MemoryBudget();
+
+	std::atomic<int64> _usage[numSubsystems] = {};
+	std::atomic<int64> _limit{ 0 };
+	std::atomic<uint64> _released{ 0 };
+	CriticalSection _lock; // the clients, held through a trim
+	std::vector<Registration> _clients;
+
+	JUCE_DECLARE_NON_COPYABLE(MemoryBudget)
+};
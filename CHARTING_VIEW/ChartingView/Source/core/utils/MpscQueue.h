@@ -0,0 +1,86 @@
+/*
+  ==============================================================================
+
+    MpscQueue.h
+    Created: 14 Oct 2026 6:04:12pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+
+/*
+	Bounded lock-free queue, many producer threads / one consumer thread.
+	Each cell carries a sequence number telling whose turn it is : producers
+	claim a position with one CAS on the tail, the consumer only touches its
+	own head. Nothing is allocated after construction, a full queue rejects
+	the push instead of blocking the producer.
+
+	T is copied in and out, keep it small and trivially copyable.
+*/
+
+template <typename T>
+class MpscQueue {
+public:
+	// capacity is rounded up to a power of two
+	explicit MpscQueue(size_t capacity) {
+		_capacity = (size_t)nextPowerOfTwo((int)jmax((size_t)2, capacity));
+		_mask = _capacity - 1;
+		_cells.reset(new Cell[_capacity]);
+		for (size_t i = 0; i < _capacity; i++)
+			_cells[i].sequence.store(i, std::memory_order_relaxed);
+	}
+
+	size_t getCapacity() const { return _capacity; }
+
+	// any thread, false when the queue is full
+	bool tryPush(const T& value) {
+		size_t pos = _tail.load(std::memory_order_relaxed);
+		Cell* cell;
+		for (;;) {
+			cell = &_cells[pos & _mask];
+			const size_t seq = cell->sequence.load(std::memory_order_acquire);
+			const auto diff = (intptr_t)seq - (intptr_t)pos;
+			if (diff == 0) {
+				if (_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if (diff < 0)
+				return false;
+			else
+				pos = _tail.load(std::memory_order_relaxed);
+		}
+		cell->value = value;
+		cell->sequence.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+
+	// consumer thread only, false when empty
+	bool tryPop(T& value) {
+		Cell& cell = _cells[_head & _mask];
+		const size_t seq = cell.sequence.load(std::memory_order_acquire);
+		if ((intptr_t)seq - (intptr_t)(_head + 1) < 0)
+			return false;
+		value = cell.value;
+		cell.sequence.store(_head + _capacity, std::memory_order_release);
+		_head++;
+		return true;
+	}
+
+private:
+	struct Cell {
+		std::atomic<size_t> sequence{ 0 };
+		T value{};
+	};
+
+	UPtr<Cell[]> _cells;
+	size_t _capacity = 0;
+	size_t _mask = 0;
+
+	alignas(64) std::atomic<size_t> _tail{ 0 };
+	alignas(64) size_t _head = 0;
+
+	JUCE_DECLARE_NON_COPYABLE(MpscQueue)
+};
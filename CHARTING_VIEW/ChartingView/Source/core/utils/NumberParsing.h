@@ -0,0 +1,87 @@
+/*
+  ==============================================================================
+
+    NumberParsing.h
+    Created: 14 Oct 2026 6:02:37pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+
+/*
+	Allocation free parsing of the numbers found in the Binance csv and json,
+	on [p, e) ranges that don't need to be null terminated. Leading quotes and
+	spaces are skipped, parsing stops at the first unexpected character.
+*/
+
+struct NumberParsing {
+	static bool isDigit(char c) { return (unsigned)(c - '0') < 10u; }
+
+	static const char* skipQuoteAndSpace(const char* p, const char* e) {
+		while (p < e && (*p == '"' || *p == ' '))
+			p++;
+		return p;
+	}
+
+	static int64 parseInt(const char* p, const char* e) {
+		p = skipQuoteAndSpace(p, e);
+		bool neg = false;
+		if (p < e && (*p == '-' || *p == '+'))
+			neg = *p++ == '-';
+		uint64 v = 0;
+		while (p < e && isDigit(*p))
+			v = v * 10 + (uint64)(*p++ - '0');
+		// "123.0" style integers are truncated
+		return neg ? -(int64)v : (int64)v;
+	}
+
+	// Binance prices are short fixed point strings : the mantissa is exact in a
+	// double and one division by an exact power of ten gives the correctly rounded value
+	static double parseDouble(const char* p, const char* e) {
+		static constexpr double pow10Table[] = {
+			1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+			1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+		};
+
+		p = skipQuoteAndSpace(p, e);
+		const char* start = p;
+		bool neg = false;
+		if (p < e && (*p == '-' || *p == '+'))
+			neg = *p++ == '-';
+
+		uint64 mantissa = 0;
+		int digits = 0;
+		int exponent = 0;
+		while (p < e && isDigit(*p)) {
+			if (digits < 19) { mantissa = mantissa * 10 + (uint64)(*p - '0'); if (mantissa) digits++; }
+			else exponent++;
+			p++;
+		}
+		if (p < e && *p == '.') {
+			p++;
+			while (p < e && isDigit(*p)) {
+				if (digits < 19) { mantissa = mantissa * 10 + (uint64)(*p - '0'); if (mantissa) digits++; exponent--; }
+				p++;
+			}
+		}
+		if (p < e && (*p == 'e' || *p == 'E'))
+			return parseDoubleSlow(start, e);
+		if (mantissa >= (1ull << 53) || exponent < -22 || exponent > 22)
+			return parseDoubleSlow(start, e);
+
+		const double m = (double)mantissa;
+		const double v = exponent < 0 ? m / pow10Table[-exponent] : m * pow10Table[exponent];
+		return neg ? -v : v;
+	}
+
+	static double parseDoubleSlow(const char* p, const char* e) {
+		char buffer[64];
+		const size_t n = jmin((size_t)(e - p), sizeof(buffer) - 1);
+		std::memcpy(buffer, p, n);
+		buffer[n] = 0;
+		return std::strtod(buffer, nullptr);
+	}
+};
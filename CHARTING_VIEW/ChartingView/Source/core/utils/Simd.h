@@ -0,0 +1,125 @@
+/*
+  ==============================================================================
+
+    Simd.h
+    Created: 14 Oct 2026 11:40:15am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+ #define W_USE_SSE2 1
+ #include <emmintrin.h>
+#else
+ #define W_USE_SSE2 0
+#endif
+
+#if defined(_MSC_VER)
+ #include <intrin.h>
+#endif
+
+struct Simd {
+	static int countTrailingZeros(uint32 v) {
+		jassert(v != 0);
+	   #if defined(_MSC_VER)
+		unsigned long i;
+		_BitScanForward(&i, v);
+		return (int)i;
+	   #else
+		return __builtin_ctz(v);
+	   #endif
+	}
+
+	static int countBits(uint32 v) {
+		return countNumberOfBits(v);
+	}
+
+	// bitmask of the bytes equal to c in the 16 bytes at p
+	static uint32 matchMask16(const char* p, char c) {
+	   #if W_USE_SSE2
+		const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+		return (uint32)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(c)));
+	   #else
+		uint32 m = 0;
+		for (int i = 0; i < 16; i++)
+			m |= (uint32)(p[i] == c) << i;
+		return m;
+	   #endif
+	}
+
+	// bitmask of the bytes equal to a or b in the 16 bytes at p
+	static uint32 matchMask16(const char* p, char a, char b) {
+	   #if W_USE_SSE2
+		const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+		const __m128i m = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(a)), _mm_cmpeq_epi8(v, _mm_set1_epi8(b)));
+		return (uint32)_mm_movemask_epi8(m);
+	   #else
+		uint32 m = 0;
+		for (int i = 0; i < 16; i++)
+			m |= (uint32)(p[i] == a || p[i] == b) << i;
+		return m;
+	   #endif
+	}
+
+	// out[i] = (float)((values[i] - origin) * scale + offset), the int64 difference is
+	// exact and converted to double without cvt instructions (|values[i] - origin| < 2^51)
+	static void mapLinear(const int64* values, size_t n, int64 origin, double scale, double offset, float* out) {
+		size_t i = 0;
+	   #if W_USE_SSE2
+		const __m128i o = _mm_set1_epi64x(origin);
+		const __m128i magicBits = _mm_set1_epi64x(0x4338000000000000LL); // 2^52 + 2^51
+		const __m128d magic = _mm_set1_pd(6755399441055744.0);
+		const __m128d s = _mm_set1_pd(scale);
+		const __m128d b = _mm_set1_pd(offset);
+		auto toDouble = [&](const int64* p) {
+			const __m128i d = _mm_sub_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), o);
+			return _mm_sub_pd(_mm_castsi128_pd(_mm_add_epi64(d, magicBits)), magic);
+		};
+		for (; i + 4 <= n; i += 4) {
+			const __m128 lo = _mm_cvtpd_ps(_mm_add_pd(_mm_mul_pd(toDouble(values + i), s), b));
+			const __m128 hi = _mm_cvtpd_ps(_mm_add_pd(_mm_mul_pd(toDouble(values + i + 2), s), b));
+			_mm_storeu_ps(out + i, _mm_movelh_ps(lo, hi));
+		}
+	   #endif
+		for (; i < n; i++)
+			out[i] = (float)((double)(values[i] - origin) * scale + offset);
+	}
+
+	// out[i] = (float)((values[i] - origin) * scale + offset)
+	static void mapLinear(const double* values, size_t n, double origin, double scale, double offset, float* out) {
+		size_t i = 0;
+	   #if W_USE_SSE2
+		const __m128d o = _mm_set1_pd(origin);
+		const __m128d s = _mm_set1_pd(scale);
+		const __m128d b = _mm_set1_pd(offset);
+		for (; i + 4 <= n; i += 4) {
+			const __m128 lo = _mm_cvtpd_ps(_mm_add_pd(_mm_mul_pd(_mm_sub_pd(_mm_loadu_pd(values + i), o), s), b));
+			const __m128 hi = _mm_cvtpd_ps(_mm_add_pd(_mm_mul_pd(_mm_sub_pd(_mm_loadu_pd(values + i + 2), o), s), b));
+			_mm_storeu_ps(out + i, _mm_movelh_ps(lo, hi));
+		}
+	   #endif
+		for (; i < n; i++)
+			out[i] = (float)((values[i] - origin) * scale + offset);
+	}
+
+	// out[i] += a * x[i] - b * y[i], the rolling update of a row of sums of products
+	static void addProductDifference(double* out, double a, const double* x, double b, const double* y, size_t n) {
+		size_t i = 0;
+	   #if W_USE_SSE2
+		const __m128d va = _mm_set1_pd(a);
+		const __m128d vb = _mm_set1_pd(b);
+		for (; i + 4 <= n; i += 4) {
+			const __m128d lo = _mm_sub_pd(_mm_mul_pd(va, _mm_loadu_pd(x + i)), _mm_mul_pd(vb, _mm_loadu_pd(y + i)));
+			const __m128d hi = _mm_sub_pd(_mm_mul_pd(va, _mm_loadu_pd(x + i + 2)), _mm_mul_pd(vb, _mm_loadu_pd(y + i + 2)));
+			_mm_storeu_pd(out + i, _mm_add_pd(_mm_loadu_pd(out + i), lo));
+			_mm_storeu_pd(out + i + 2, _mm_add_pd(_mm_loadu_pd(out + i + 2), hi));
+		}
+	   #endif
+		for (; i < n; i++)
+			out[i] += a * x[i] - b * y[i];
+	}
+};
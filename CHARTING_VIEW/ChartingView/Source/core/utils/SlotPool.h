@@ -0,0 +1,132 @@
+/*
+  ==============================================================================
+
+    SlotPool.h
+    Created: 15 Oct 2026 6:02:37am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+
+/*
+	Dense pool with stable handles (a slot map), for the primitives a chart
+	holds by the thousands : the values live in one contiguous array iterated
+	as is, a handle goes through a slot table to find its value wherever the
+	removes moved it.
+
+	- add / remove / lookup are O(1), remove moves the last value in the hole
+	- a handle carries the generation of its slot, a removed (or cleared)
+	  handle is detected instead of reading the value now in the slot
+	- clear() drops every value at once and keeps the capacity : reloading
+	  the same amount of data allocates nothing
+
+	Handle : generation << 32 | slot, the generation has 30 bits so the two top
+	bits are free for the owner to tag (e.g. several pools behind one id type).
+	The slot is a small integer, usable as an index by side structures
+	(e.g. SpatialGrid ids).
+*/
+
+template <typename T>
+class SlotPool {
+public:
+	using Handle = uint64;
+	static constexpr Handle invalidHandle = ~(Handle)0;
+
+	static uint32 getSlot(Handle h) { return (uint32)h; }
+	static uint32 getGeneration(Handle h) { return (uint32)(h >> 32) & generationMask; }
+	static constexpr uint32 generationMask = 0x3fffffff;
+
+	void reserve(size_t n) {
+		_values.reserve(n);
+		_owners.reserve(n);
+		_slots.reserve(n);
+	}
+
+	Handle add(T value) {
+		uint32 slot;
+		if (_freeSlots.empty()) {
+			slot = (uint32)_slots.size();
+			_slots.push_back({});
+		}
+		else {
+			slot = _freeSlots.back();
+			_freeSlots.pop_back();
+		}
+		auto& s = _slots[slot];
+		s.dense = (uint32)_values.size();
+		_values.push_back(std::move(value));
+		_owners.push_back(slot);
+		return _makeHandle(slot, s.generation);
+	}
+
+	bool remove(Handle h) {
+		if (!contains(h))
+			return false;
+		const uint32 slot = getSlot(h);
+		const uint32 dense = _slots[slot].dense;
+		const uint32 last = (uint32)_values.size() - 1;
+		if (dense != last) {
+			_values[dense] = std::move(_values[last]);
+			_owners[dense] = _owners[last];
+			_slots[_owners[dense]].dense = dense;
+		}
+		_values.pop_back();
+		_owners.pop_back();
+		_release(slot);
+		return true;
+	}
+
+	void clear() {
+		for (auto slot : _owners)
+			_release(slot);
+		_values.clear();
+		_owners.clear();
+	}
+
+	bool contains(Handle h) const {
+		const uint32 slot = getSlot(h);
+		return slot < _slots.size() && _slots[slot].generation == getGeneration(h) && _slots[slot].dense != freeDense;
+	}
+	T* get(Handle h) { return contains(h) ? &_values[_slots[getSlot(h)].dense] : nullptr; }
+	const T* get(Handle h) const { return contains(h) ? &_values[_slots[getSlot(h)].dense] : nullptr; }
+	// by slot, the slot must be in use
+	T& getBySlot(uint32 slot) { return _values[_slots[slot].dense]; }
+	const T& getBySlot(uint32 slot) const { return _values[_slots[slot].dense]; }
+	Handle getHandleBySlot(uint32 slot) const { return _makeHandle(slot, _slots[slot].generation); }
+
+	// contiguous values, in no particular order after removes
+	size_t size() const { return _values.size(); }
+	bool isEmpty() const { return _values.empty(); }
+	T* begin() { return _values.data(); }
+	T* end() { return _values.data() + _values.size(); }
+	const T* begin() const { return _values.data(); }
+	const T* end() const { return _values.data() + _values.size(); }
+	T& operator[](size_t i) { return _values[i]; }
+	const T& operator[](size_t i) const { return _values[i]; }
+	Handle getHandle(size_t i) const { return _makeHandle(_owners[i], _slots[_owners[i]].generation); }
+
+private:
+	static constexpr uint32 freeDense = ~(uint32)0;
+
+	struct Slot {
+		uint32 dense = freeDense;
+		uint32 generation = 0;
+	};
+
+	static Handle _makeHandle(uint32 slot, uint32 generation) { return ((Handle)generation << 32) | slot; }
+
+	void _release(uint32 slot) {
+		auto& s = _slots[slot];
+		s.dense = freeDense;
+		s.generation = (s.generation + 1) & generationMask;
+		_freeSlots.push_back(slot);
+	}
+
+	std::vector<T> _values;
+	std::vector<uint32> _owners; // slot of each value
+	std::vector<Slot> _slots;
+	std::vector<uint32> _freeSlots;
+};
@@ -0,0 +1,178 @@
+/*
+  ==============================================================================
+
+    TaskPool.cpp
+    Created: 15 Oct 2026 1:47:52am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "TaskPool.h"
+
+// index of the worker running on this thread, -1 off the pool
+static thread_local const TaskPool* currentPool = nullptr;
+static thread_local int currentWorker = -1;
+
+TaskPool::Group::~Group() {
+	cancel();
+	wait();
+	// the last _finish() may still hold the lock
+	const ScopedLock sl(_lock);
+}
+
+void TaskPool::Group::wait() {
+	Entry e;
+	while (_pending.load() > 0) {
+		auto* pool = _pool.load();
+		// runs its own queued tasks, waiting from inside a task never starves the pool
+		if (pool != nullptr && pool->_popGroup(*this, e)) {
+			pool->_run(e);
+			continue;
+		}
+		// the rest is running on the workers
+		_done.wait();
+	}
+}
+
+void TaskPool::Group::_add() {
+	const ScopedLock sl(_lock);
+	if (_pending++ == 0)
+		_done.reset();
+}
+
+void TaskPool::Group::_finish() {
+	const ScopedLock sl(_lock);
+	if (--_pending == 0)
+		_done.signal();
+}
+
+TaskPool::TaskPool(int numThreads) {
+	if (numThreads <= 0)
+		numThreads = jmax(1, SystemStats::getNumCpus() - 1);
+	for (int i = 0; i < numThreads; i++)
+		_workers.push_back(std::make_unique<Worker>());
+	// started once every queue exists, they steal from each other
+	for (int i = 0; i < numThreads; i++) {
+		auto& w = *_workers[(size_t)i];
+		w.thread = std::make_unique<ThreadLambda>("TaskPool " + String(i), [this, i]() { _workerLoop(i); });
+		w.thread->startThread();
+	}
+}
+
+TaskPool::~TaskPool() {
+	_exit = true;
+	for (auto& w : _workers)
+		w->thread->signalThreadShouldExit();
+	for (size_t i = 0; i < _workers.size(); i++)
+		_wake.signal();
+	for (auto& w : _workers)
+		w->thread->stopThread(4000);
+	// never run, the groups waiting for them return
+	Entry e;
+	while (_pop(0, e))
+		if (e.group != nullptr)
+			e.group->_finish();
+}
+
+TaskPool& TaskPool::getInstance() {
+	static TaskPool pool;
+	return pool;
+}
+
+void TaskPool::submit(std::function<void()> task, Priority priority, Group* group) {
+	if (group != nullptr) {
+		group->_pool = this;
+		group->_add();
+	}
+	// a task submits to its own queue (run next, while its data is hot), others spread the work
+	const size_t w = currentPool == this && currentWorker >= 0
+		? (size_t)currentWorker
+		: _nextWorker.fetch_add(1, std::memory_order_relaxed) % _workers.size();
+	{
+		auto& worker = *_workers[w];
+		const ScopedLock sl(worker.lock);
+		worker.queues[(int)priority].push_back({ std::move(task), group });
+	}
+	_numQueued++;
+	_wake.signal();
+}
+
+bool TaskPool::_pop(int worker, Entry& e) {
+	const int n = (int)_workers.size();
+	for (int p = 0; p < numPriorities; p++) {
+		{
+			auto& own = *_workers[(size_t)worker];
+			const ScopedLock sl(own.lock);
+			auto& q = own.queues[p];
+			if (!q.empty()) {
+				e = std::move(q.back());
+				q.pop_back();
+				return true;
+			}
+		}
+		for (int i = 1; i < n; i++) {
+			auto& other = *_workers[(size_t)((worker + i) % n)];
+			const ScopedLock sl(other.lock);
+			auto& q = other.queues[p];
+			if (!q.empty()) {
+				e = std::move(q.front());
+				q.pop_front();
+				_numSteals++;
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+bool TaskPool::_popGroup(const Group& group, Entry& e) {
+	for (int p = 0; p < numPriorities; p++) {
+		for (auto& w : _workers) {
+			const ScopedLock sl(w->lock);
+			auto& q = w->queues[p];
+			auto it = std::find_if(q.rbegin(), q.rend(), [&group](const Entry& x) { return x.group == &group; });
+			if (it != q.rend()) {
+				e = std::move(*it);
+				q.erase(std::next(it).base());
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+void TaskPool::_run(Entry& e) {
+	_numQueued--;
+	if (e.group == nullptr || !e.group->isCancelled())
+		e.task();
+	e.task = nullptr;
+	if (e.group != nullptr)
+		e.group->_finish();
+}
+
+bool TaskPool::runPending() {
+	Entry e;
+	const int worker = currentPool == this && currentWorker >= 0 ? currentWorker : 0;
+	if (!_pop(worker, e))
+		return false;
+	_run(e);
+	return true;
+}
+
+void TaskPool::_workerLoop(int worker) {
+	currentPool = this;
+	currentWorker = worker;
+	Entry e;
+	while (!_exit.load()) {
+		if (_pop(worker, e)) {
+			// one signal wakes one sleeper, pass it on while there is work left
+			if (_numQueued.load() > 1)
+				_wake.signal();
+			_run(e);
+		}
+		else {
+			_wake.wait(20);
+		}
+	}
+}
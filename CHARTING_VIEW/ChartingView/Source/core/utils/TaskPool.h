@@ -0,0 +1,132 @@
+/*
+  ==============================================================================
+
+    TaskPool.h
+    Created: 15 Oct 2026 1:47:52am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+#include "ThreadLambda.h"
+#include <deque>
+
+/*
+	Work-stealing pool shared by the whole app (csv parsing, pyramids,
+	resampling, indicators...), one thread per core but the message thread.
+
+	Each worker has its own queue per priority : it runs the newest task of
+	its queue first (the data it just touched is still in cache) and, when it
+	is empty, steals the oldest task of another worker. Every queue of a
+	priority is drained before a lower priority task starts, visible charts
+	submit with Priority::high.
+
+	Tasks submitted together share a Group to be waited for or cancelled :
+	cancel() skips the tasks not started yet, running ones may poll
+	isCancelled() (a viewport that moved again before its work finished).
+	wait() runs the queued tasks of its group meanwhile, then sleeps until
+	the ones running elsewhere finish, it can be called from a task.
+*/
+
+class TaskPool {
+public:
+	enum class Priority { high, normal, low };
+	static constexpr int numPriorities = 3;
+
+	class Group {
+	public:
+		Group() = default;
+		// cancels and waits for the running tasks
+		~Group();
+
+		void cancel() { _cancelled = true; }
+		bool isCancelled() const { return _cancelled.load(std::memory_order_relaxed); }
+		// new tasks can be submitted after a cancel
+		void reset() { _cancelled = false; }
+		// returns once every task submitted with this group ran or was skipped, runs the
+		// queued ones on the calling thread meanwhile (never a task of another group)
+		void wait();
+		int getNumPending() const { return _pending.load(); }
+
+	private:
+		friend class TaskPool;
+		void _add();
+		void _finish();
+
+		std::atomic<TaskPool*> _pool{ nullptr };
+		std::atomic<int> _pending{ 0 };
+		std::atomic<bool> _cancelled{ false };
+		CriticalSection _lock;       // _pending and _done change together
+		WaitableEvent _done{ true }; // set while nothing is pending
+
+		JUCE_DECLARE_NON_COPYABLE(Group)
+	};
+
+	// numThreads 0 : one per core but one, at least one
+	explicit TaskPool(int numThreads = 0);
+	~TaskPool();
+
+	static TaskPool& getInstance();
+
+	// group, when given, must outlive the task
+	void submit(std::function<void()> task, Priority priority = Priority::normal, Group* group = nullptr);
+
+	// fn(first, last) over [0, n) in ranges of at least grain items, returns when all ran.
+	// The calling thread takes the first range
+	template <typename Fn>
+	void parallelFor(size_t n, size_t grain, Fn&& fn, Priority priority = Priority::normal);
+
+	// runs one queued task on the calling thread, false when there was none
+	bool runPending();
+
+	int getNumThreads() const { return (int)_workers.size(); }
+	int getNumQueued() const { return _numQueued.load(); }
+	// tasks taken from the queue of another worker
+	uint64 getNumSteals() const { return _numSteals.load(); }
+
+private:
+	struct Entry {
+		std::function<void()> task;
+		Group* group = nullptr;
+	};
+	struct Worker {
+		CriticalSection lock;
+		std::deque<Entry> queues[numPriorities];
+		UPtr<ThreadLambda> thread;
+	};
+
+	bool _pop(int worker, Entry& e);
+	// a queued task of group, newest first
+	bool _popGroup(const Group& group, Entry& e);
+	void _run(Entry& e);
+	void _workerLoop(int worker);
+
+	std::vector<UPtr<Worker>> _workers;
+	std::atomic<size_t> _nextWorker{ 0 };
+	std::atomic<int> _numQueued{ 0 };
+	std::atomic<uint64> _numSteals{ 0 };
+	std::atomic<bool> _exit{ false };
+	WaitableEvent _wake;
+
+	JUCE_DECLARE_NON_COPYABLE(TaskPool)
+};
+
+template <typename Fn>
+void TaskPool::parallelFor(size_t n, size_t grain, Fn&& fn, Priority priority) {
+	if (n == 0)
+		return;
+	const size_t maxTasks = (size_t)getNumThreads() + 1;
+	const size_t numTasks = jlimit((size_t)1, maxTasks, n / jmax((size_t)1, grain));
+	if (numTasks == 1) {
+		fn((size_t)0, n);
+		return;
+	}
+	const size_t step = (n + numTasks - 1) / numTasks;
+	Group group;
+	for (size_t first = step; first < n; first += step)
+		submit([&fn, first, last = jmin(n, first + step)]() { fn(first, last); }, priority, &group);
+	fn((size_t)0, step);
+	group.wait();
+}
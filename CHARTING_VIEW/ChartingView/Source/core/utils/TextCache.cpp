@@ -0,0 +1,145 @@
+/*
+  ==============================================================================
+
+    TextCache.cpp
+    Created: 14 Oct 2026 11:20:06pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "TextCache.h"
+#include "MemoryBudget.h"
+
+TextCache::TextCache(size_t capacityPerGeneration) : _capacity(jmax((size_t)1, capacityPerGeneration)) {
+}
+
+TextCache::~TextCache() {
+	clear();
+}
+
+TextCache& TextCache::getInstance() {
+	if (MessageManager::existsAndIsCurrentThread()) {
+		static TextCache cache;
+		return cache;
+	}
+	// offscreen charts painted on a worker (ChartBatchRenderer)
+	thread_local TextCache cache;
+	return cache;
+}
+
+size_t TextCache::KeyHash::operator()(const Key& k) const {
+	size_t h = (size_t)k.text.hashCode64();
+	auto mix = [&h](size_t v) { h ^= v + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2); };
+	mix((size_t)k.typeface.hashCode64());
+	mix(std::hash<float>()(k.height));
+	mix(std::hash<float>()(k.horizontalScale));
+	mix(std::hash<float>()(k.kerning));
+	mix((size_t)k.style);
+	return h;
+}
+
+TextCache::Key TextCache::_makeKey(const Font& font, const String& text) {
+	Key k;
+	k.typeface = font.getTypefaceName();
+	k.text = text;
+	k.height = font.getHeight();
+	k.horizontalScale = font.getHorizontalScale();
+	k.kerning = font.getExtraKerningFactor();
+	k.style = font.getStyleFlags();
+	return k;
+}
+
+size_t TextCache::_getBytes(const Key& key, const Entry& entry) {
+	return sizeof(Key) + sizeof(Entry) + (size_t)key.text.getNumBytesAsUTF8()
+		+ (size_t)entry.glyphs.getNumGlyphs() * sizeof(PositionedGlyph);
+}
+
+const TextCache::Entry& TextCache::get(const Font& font, const String& text) {
+	auto key = _makeKey(font, text);
+	auto it = _current.find(key);
+	if (it != _current.end()) {
+		_hits++;
+		return *it->second;
+	}
+
+	UPtr<Entry> entry;
+	size_t bytes = 0;
+	auto old = _previous.find(key);
+	if (old != _previous.end()) {
+		_hits++;
+		entry = std::move(old->second);
+		_previous.erase(old);
+		bytes = _getBytes(key, *entry);
+		_previousBytes -= bytes;
+	}
+	else {
+		_misses++;
+		entry = std::make_unique<Entry>();
+		entry->glyphs.addLineOfText(font, text, 0.0f, 0.0f);
+		entry->width = font.getStringWidthFloat(text);
+		entry->ascent = font.getAscent();
+		entry->descent = font.getDescent();
+		bytes = _getBytes(key, *entry);
+		MemoryBudget::getInstance().add(MemoryBudget::glyphs, (int64)bytes);
+	}
+
+	if (_current.size() >= _capacity) {
+		MemoryBudget::getInstance().add(MemoryBudget::glyphs, -(int64)_previousBytes);
+		_previous = std::move(_current);
+		_previousBytes = _currentBytes;
+		_current = Map();
+		_currentBytes = 0;
+	}
+	_currentBytes += bytes;
+	return *_current.emplace(std::move(key), std::move(entry)).first->second;
+}
+
+float TextCache::getNumberWidth(const Font& font, const String& text) {
+	auto key = _makeKey(font, {});
+	auto it = _advances.find(key);
+	if (it == _advances.end()) {
+		Advances a;
+		a.fill(-1.0f);
+		float digit = 0.0f;
+		for (char c = '0'; c <= '9'; c++)
+			digit = jmax(digit, font.getStringWidthFloat(String::charToString(c)));
+		for (const char* c = numberChars; *c != 0; c++)
+			a[(size_t)*c] = (*c >= '0' && *c <= '9') ? digit : font.getStringWidthFloat(String::charToString(*c));
+		it = _advances.emplace(std::move(key), a).first;
+	}
+	const auto& a = it->second;
+	float width = 0.0f;
+	for (auto p = text.getCharPointer(); !p.isEmpty();) {
+		const auto c = p.getAndAdvance();
+		if (c >= 128 || a[(size_t)c] < 0.0f)
+			return getWidth(font, text);
+		width += a[(size_t)c];
+	}
+	return width;
+}
+
+void TextCache::draw(Graphics& g, const Font& font, const String& text, Rectangle<float> area, Justification justification) {
+	const auto& e = get(font, text);
+	float x = area.getX();
+	if (justification.testFlags(Justification::horizontallyCentred))
+		x = area.getCentreX() - e.width * 0.5f;
+	else if (justification.testFlags(Justification::right))
+		x = area.getRight() - e.width;
+
+	float baseline = area.getY() + e.ascent;
+	if (justification.testFlags(Justification::verticallyCentred))
+		baseline = area.getCentreY() + (e.ascent - e.descent) * 0.5f;
+	else if (justification.testFlags(Justification::bottom))
+		baseline = area.getBottom() - e.descent;
+
+	e.glyphs.draw(g, AffineTransform::translation(x, baseline));
+}
+
+void TextCache::clear() {
+	MemoryBudget::getInstance().add(MemoryBudget::glyphs, -(int64)(_currentBytes + _previousBytes));
+	_currentBytes = _previousBytes = 0;
+	_current.clear();
+	_previous.clear();
+	_advances.clear();
+}
@@ -0,0 +1,101 @@
+/*
+  ==============================================================================
+
+    TextCache.h
+    Created: 14 Oct 2026 11:20:06pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+
+/*
+	Shaped text shared by every widget (axis labels, price tags...) : the
+	first use of a (font, string) measures it and lays out its glyphs once,
+	the following frames only draw the GlyphArrangement (JUCE keeps the
+	rasterized glyphs in its own cache).
+
+	Two generations of entries : lookups move entries from the previous one
+	to the current one, when the current one is full the previous one is
+	dropped. Labels in use stay, labels of an old zoom level go away without
+	a per entry LRU list.
+
+	Numbers have a fast path for live values (prices, % changes...) : a table
+	of advance widths per font, every digit as wide as the widest one, so a
+	value keeps its width while its digits change and is measured without
+	shaping nor a map entry per value.
+
+	The entries count in MemoryBudget::glyphs (an estimate : the glyph
+	arrangements and their keys).
+
+	Not locked : getInstance() is the message thread's cache there and a
+	cache per thread elsewhere (offscreen charts painted on the TaskPool).
+*/
+
+class TextCache {
+public:
+	struct Entry {
+		GlyphArrangement glyphs; // laid out on a baseline at y = 0, starting at x = 0
+		float width = 0.0f;
+		float ascent = 0.0f;
+		float descent = 0.0f;
+	};
+
+	static constexpr size_t defaultCapacity = 4096;
+
+	explicit TextCache(size_t capacityPerGeneration = defaultCapacity);
+	~TextCache();
+
+	// the cache shared by the widgets of the calling thread
+	static TextCache& getInstance();
+
+	// valid until the next get()
+	const Entry& get(const Font& font, const String& text);
+	float getWidth(const Font& font, const String& text) { return get(font, text).width; }
+	// text made of numberChars only : sum of the advances (without kerning), getWidth() otherwise
+	float getNumberWidth(const Font& font, const String& text);
+	static constexpr const char* numberChars = "0123456789+-.,%: kKMB$";
+
+	// single line inside area, like Graphics::drawText without the shaping
+	void draw(Graphics& g, const Font& font, const String& text, Rectangle<float> area, Justification justification);
+
+	void clear();
+	size_t size() const { return _current.size() + _previous.size(); }
+	uint64 getNumHits() const { return _hits; }
+	uint64 getNumMisses() const { return _misses; }
+
+private:
+	struct Key {
+		String typeface;
+		String text;
+		float height = 0.0f;
+		float horizontalScale = 1.0f;
+		float kerning = 0.0f;
+		int style = 0;
+
+		bool operator==(const Key& o) const {
+			return height == o.height && style == o.style && horizontalScale == o.horizontalScale && kerning == o.kerning
+				&& text == o.text && typeface == o.typeface;
+		}
+	};
+	struct KeyHash {
+		size_t operator()(const Key& k) const;
+	};
+	using Map = std::unordered_map<Key, UPtr<Entry>, KeyHash>;
+	using Advances = std::array<float, 128>; // < 0 : not a number char
+
+	static Key _makeKey(const Font& font, const String& text);
+	static size_t _getBytes(const Key& key, const Entry& entry);
+
+	size_t _capacity;
+	Map _current;
+	Map _previous;
+	size_t _currentBytes = 0, _previousBytes = 0;
+	std::unordered_map<Key, Advances, KeyHash> _advances; // per font, text empty
+	uint64 _hits = 0;
+	uint64 _misses = 0;
+
+	JUCE_DECLARE_NON_COPYABLE(TextCache)
+};
@@ -9,3 +9,35 @@
 */
 
 #pragma once
+#include "JuceHeader.h"
+
+class ThreadLambda : public Thread {
+public:
+
+	std::function<void()> onRun;
+
+	ThreadLambda(const String& name) : Thread(name) {
+
+	}
+
+	ThreadLambda(const String& name, std::function<void()> onRun) : Thread(name), onRun(onRun) {
+
+	}
+
+	~ThreadLambda() override {
+		stopThread(4000);
+	}
+
+	void run() override {
+		if (onRun)
+			onRun();
+	}
+
+	// starts onRun on this thread, waiting for a previous run to finish first
+	void restart(std::function<void()> f) {
+		stopThread(4000);
+		onRun = std::move(f);
+		startThread();
+	}
+
+};
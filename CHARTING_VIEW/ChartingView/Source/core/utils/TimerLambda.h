@@ -9,3 +9,29 @@
 */
 
 #pragma once
+#include "JuceHeader.h"
+
+class TimerLambda : public Timer {
+public:
+
+	std::function<void()> onTimer;
+
+	TimerLambda() {
+
+	}
+
+	TimerLambda(std::function<void()> onTimer) : onTimer(onTimer) {
+
+	}
+
+	~TimerLambda() override {
+		stopTimer();
+	}
+
+
+	void timerCallback() override {
+		if (onTimer)
+			onTimer();
+	}
+
+};
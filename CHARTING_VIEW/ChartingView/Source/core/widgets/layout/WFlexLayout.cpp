@@ -12,32 +12,31 @@
 
 WFlexLayout::WFlexLayout(const Options& opts) : options(opts) {}
 
-void WFlexLayout::setOptions(const Options& opts) { options = opts; }
+void WFlexLayout::setOptions(const Options& opts) {
+	options = opts;
+	invalidate();
+}
 
 const WFlexLayout::Options& WFlexLayout::getOptions() const { return options; }
 
-void WFlexLayout::applyLayout(const Rectangle<int>& bParent, const Array<Component*>& children) {
-	std::vector<BaseComponent*> validChildren;
+void WFlexLayout::applyLayout(const Rectangle<int>& bParent, const std::vector<BaseComponent*>& children) {
+	const auto& validChildren = getValidChildren(children);
 	int totalPreferredMain = 0;
 	int totalFlexible = 0;
 
-	for (auto* c : children) {
-		if (auto* bc = dynamic_cast<BaseComponent*>(c)) {
-			if (!bc->getPreferredSize().getIgnoreLayout()) {
-				validChildren.push_back(bc);
-				if (options.direction == Direction::Row)
-					totalPreferredMain += bc->getPreferredSize().getPreferredWidth();
-				else
-					totalPreferredMain += bc->getPreferredSize().getPreferredHeight();
-
-				totalFlexible += (options.direction == Direction::Row)
-					? bc->getPreferredSize().getFlexibleWidth()
-					: bc->getPreferredSize().getFlexibleHeight();
-			}
-		}
+	for (auto* bc : validChildren) {
+		if (options.direction == Direction::Row)
+			totalPreferredMain += bc->getPreferredSize().getPreferredWidth();
+		else
+			totalPreferredMain += bc->getPreferredSize().getPreferredHeight();
+
+		totalFlexible += (options.direction == Direction::Row)
+			? bc->getPreferredSize().getFlexibleWidth()
+			: bc->getPreferredSize().getFlexibleHeight();
 	}
 
 	if (validChildren.empty()) return;
+	if (_isUnchanged(bParent, validChildren)) return;
 
 	int mainSize = (options.direction == Direction::Row) ? bParent.getWidth() : bParent.getHeight();
 	int crossSize = (options.direction == Direction::Row) ? bParent.getHeight() : bParent.getWidth();
@@ -79,11 +78,13 @@ void WFlexLayout::applyLayout(const Rectangle<int>& bParent, const Array<Compone
 	}
 
 	int currentLineCrossSize = 0;
-	std::vector<BaseComponent*> lineChildren;
+	// the current line is validChildren[lineStart, lineEnd)
+	size_t lineStart = 0, lineEnd = 0;
+	_bounds.clear();
 	auto flushLine = [&](int startMainPos) {
 		int localMainPos = startMainPos;
-		for (auto* bc : lineChildren) {
-			auto& pref = bc->getPreferredSize();
+		for (size_t i = lineStart; i < lineEnd; i++) {
+			auto& pref = validChildren[i]->getPreferredSize();
 
 			int prefMain = (options.direction == Direction::Row)
 				? pref.getPreferredWidth()
@@ -126,9 +127,9 @@ void WFlexLayout::applyLayout(const Rectangle<int>& bParent, const Array<Compone
 				childBounds = Rectangle<int>(crossPos + posCross, localMainPos, sizeCross, sizeMain);
 				localMainPos += sizeMain + options.spacing;
 			}
-			bc->setBounds(childBounds);
+			_bounds.push_back(childBounds);
 		}
-		lineChildren.clear();
+		lineStart = lineEnd;
 	};
 
 	int usedMain = 0;
@@ -137,7 +138,7 @@ void WFlexLayout::applyLayout(const Rectangle<int>& bParent, const Array<Compone
 		int childMainSize = (options.direction == Direction::Row)
 			? pref.getPreferredWidth()
 			: pref.getPreferredHeight();
-		if (options.wrap == FlexWrap::Wrap && usedMain + childMainSize > mainSize && !lineChildren.empty()) {
+		if (options.wrap == FlexWrap::Wrap && usedMain + childMainSize > mainSize && lineEnd > lineStart) {
 			flushLine(mainPos);
 			if (options.direction == Direction::Row)
 				crossPos += currentLineCrossSize + options.spacing;
@@ -147,12 +148,13 @@ void WFlexLayout::applyLayout(const Rectangle<int>& bParent, const Array<Compone
 			usedMain = 0;
 			currentLineCrossSize = 0;
 		}
-		lineChildren.push_back(bc);
+		lineEnd++;
 		int childCrossSize = (options.direction == Direction::Row)
 			? pref.getPreferredHeight()
 			: pref.getPreferredWidth();
 		currentLineCrossSize = jmax(currentLineCrossSize, childCrossSize);
 		usedMain += childMainSize + options.spacing;
 	}
-	if (!lineChildren.empty()) flushLine(mainPos);
+	if (lineEnd > lineStart) flushLine(mainPos);
+	_commit(bParent, validChildren, _bounds);
 }
@@ -80,7 +80,7 @@ public:
 	void setOptions(const Options& opts);
 	const Options& getOptions() const;
 
-	void applyLayout(const Rectangle<int>& bParent, const Array<Component*>& children) override;
+	void applyLayout(const Rectangle<int>& bParent, const std::vector<BaseComponent*>& children) override;
 
 private:
 	Options options;
@@ -11,24 +11,46 @@
 #include "WLayout.h"
 #include "../ui/BaseComponent.h"
 
-void WParentLayout::applyLayout(const Rectangle<int>& bParent, const Array<Component*>& children) {
-	const auto cs = getValidChildren(children);
-	for (auto* c : cs) {
-		const auto b = c->getLayout().LayoutBounds(bParent);
-		c->setBounds(b);
-	}
+void WParentLayout::applyLayout(const Rectangle<int>& bParent, const std::vector<BaseComponent*>& children) {
+	const auto& cs = getValidChildren(children);
+	if (_isUnchanged(bParent, cs))
+		return;
+	_bounds.clear();
+	for (auto* c : cs)
+		_bounds.push_back(c->getLayout().LayoutBounds(bParent));
+	_commit(bParent, cs, _bounds);
 }
 
-std::vector<BaseComponent*> WParentLayout::getValidChildren(const Array<Component*>& children) {
-	std::vector<BaseComponent*> validChildren;
+bool WParentLayout::_isUnchanged(const Rectangle<int>& bParent, const std::vector<BaseComponent*>& children) const {
+	if (bParent != _lastParent || children.size() != _lastChildren.size() || children.empty())
+		return false;
+	for (size_t i = 0; i < children.size(); i++) {
+		const auto* c = children[i];
+		const auto& last = _lastChildren[i];
+		// bounds too : a child moved by someone else, or a new one at a freed address
+		if (c != last.component || c->getLayout().getVersion() != last.layoutVersion
+			|| c->getPreferredSize().getVersion() != last.sizeVersion || c->getBounds() != last.bounds)
+			return false;
+	}
+	return true;
+}
 
-	for (auto* c : children) {
-		if (auto* bc = dynamic_cast<BaseComponent*>(c)) {
-			if (!bc->getPreferredSize().getIgnoreLayout()) {
-				validChildren.push_back(bc);
-			}
-		}
+void WParentLayout::_commit(const Rectangle<int>& bParent, const std::vector<BaseComponent*>& children, const std::vector<Rectangle<int>>& bounds) {
+	jassert(children.size() == bounds.size());
+	_lastParent = bParent;
+	_lastChildren.resize(children.size());
+	for (size_t i = 0; i < children.size(); i++) {
+		auto* c = children[i];
+		_lastChildren[i] = { c, c->getLayout().getVersion(), c->getPreferredSize().getVersion(), bounds[i] };
+		if (c->getBounds() != bounds[i])
+			c->setBounds(bounds[i]);
 	}
+}
 
-	return validChildren;
+const std::vector<BaseComponent*>& WParentLayout::getValidChildren(const std::vector<BaseComponent*>& children) {
+	_validChildren.clear();
+	for (auto* c : children)
+		if (!c->getPreferredSize().getIgnoreLayout())
+			_validChildren.push_back(c);
+	return _validChildren;
 }
@@ -64,49 +64,52 @@ public:
 
 
 	// Pivot
-	WLayout& setPivot(Point<float> p) { _pivot = p; return *this; }
+	WLayout& setPivot(Point<float> p) { _pivot = p; _changed(); return *this; }
 	Point<float> getPivot() const { return _pivot; }
-	WLayout& setPivotX(float x) { _pivot.x = x; return *this; }
+	WLayout& setPivotX(float x) { _pivot.x = x; _changed(); return *this; }
 	float getPivotX() const { return _pivot.x; }
-	WLayout& setPivotY(float y) { _pivot.y = y; return *this; }
+	WLayout& setPivotY(float y) { _pivot.y = y; _changed(); return *this; }
 	float getPivotY() const { return _pivot.y; }
 
 	// Offset
-	WLayout& setOffset(Rectangle<float> o) { _offset = o; return *this; }
+	WLayout& setOffset(Rectangle<float> o) { _offset = o; _changed(); return *this; }
 	Rectangle<float> getOffset() const { return _offset; }
-	WLayout& setX(float v) { _offset.setX(v); return *this; }
+	WLayout& setX(float v) { _offset.setX(v); _changed(); return *this; }
 	float getX() const { return _offset.getX(); }
-	WLayout& setY(float v) { _offset.setY(v); return *this; }
+	WLayout& setY(float v) { _offset.setY(v); _changed(); return *this; }
 	float getY() const { return _offset.getY(); }
-	WLayout& setWidth(float v) { _offset.setWidth(v); return *this; }
+	WLayout& setWidth(float v) { _offset.setWidth(v); _changed(); return *this; }
 	float getWidth() const { return _offset.getWidth(); }
-	WLayout& setHeight(float v) { _offset.setHeight(v); return *this; }
+	WLayout& setHeight(float v) { _offset.setHeight(v); _changed(); return *this; }
 	float getHeight() const { return _offset.getHeight(); }
 
 	// Borders
-	WLayout& setBorders(BorderSize<float> b) { _borders = b; return *this; }
+	WLayout& setBorders(BorderSize<float> b) { _borders = b; _changed(); return *this; }
 	BorderSize<float> getBorders() const { return _borders; }
-	WLayout& setBorderLeft(float v) { _borders.setLeft(v); return *this; }
+	WLayout& setBorderLeft(float v) { _borders.setLeft(v); _changed(); return *this; }
 	float getBorderLeft() const { return _borders.getLeft(); }
-	WLayout& setBorderRight(float v) { _borders.setRight(v); return *this; }
+	WLayout& setBorderRight(float v) { _borders.setRight(v); _changed(); return *this; }
 	float getBorderRight() const { return _borders.getRight(); }
-	WLayout& setBorderTop(float v) { _borders.setTop(v); return *this; }
+	WLayout& setBorderTop(float v) { _borders.setTop(v); _changed(); return *this; }
 	float getBorderTop() const { return _borders.getTop(); }
-	WLayout& setBorderBottom(float v) { _borders.setBottom(v); return *this; }
+	WLayout& setBorderBottom(float v) { _borders.setBottom(v); _changed(); return *this; }
 	float getBorderBottom() const { return _borders.getBottom(); }
 
 	// Anchors
-	WLayout& setAnchors(BorderSize<float> a) { _anchors = a; return *this; }
+	WLayout& setAnchors(BorderSize<float> a) { _anchors = a; _changed(); return *this; }
 	BorderSize<float> getAnchors() const { return _anchors; }
-	WLayout& setAnchorLeft(float v) { _anchors.setLeft(v); return *this; }
+	WLayout& setAnchorLeft(float v) { _anchors.setLeft(v); _changed(); return *this; }
 	float getAnchorLeft() const { return _anchors.getLeft(); }
-	WLayout& setAnchorRight(float v) { _anchors.setRight(v); return *this; }
+	WLayout& setAnchorRight(float v) { _anchors.setRight(v); _changed(); return *this; }
 	float getAnchorRight() const { return _anchors.getRight(); }
-	WLayout& setAnchorTop(float v) { _anchors.setTop(v); return *this; }
+	WLayout& setAnchorTop(float v) { _anchors.setTop(v); _changed(); return *this; }
 	float getAnchorTop() const { return _anchors.getTop(); }
-	WLayout& setAnchorBottom(float v) { _anchors.setBottom(v); return *this; }
+	WLayout& setAnchorBottom(float v) { _anchors.setBottom(v); _changed(); return *this; }
 	float getAnchorBottom() const { return _anchors.getBottom(); }
 
+	// bumped by every setter, layouts compare it to skip unchanged children
+	uint32 getVersion() const { return _version; }
+
 	// void layout_stretch_all(float left, int right, int top, int bot) {
 		// setAnchors({ 0, 0, 1, 1 });
 		// setBorders({ top, left, bot, right });
@@ -119,6 +122,10 @@ public:
 	// }
 
 private:
+	void _changed() { _version = ++_lastVersion; }
+
+	inline static uint32 _lastVersion = 0;
+	uint32 _version = 0;
 	Point<float> _pivot;
 	Rectangle<float> _offset;
 	BorderSize<float> _borders;
@@ -147,6 +154,7 @@ public:
 	bool getIgnoreLayout() const { return ignoreLayout; }
 	WPreferredSize& setIgnoreLayout(bool v, bool notify=true) {
 		ignoreLayout = v;
+		_changed();
 		if (notify) notifyListeners();
 		return *this;
 	}
@@ -155,6 +163,7 @@ public:
 	WPreferredSize& setMinWidth(int v, bool notify = true) {
 		if (minWidth != v) {
 			minWidth = v;
+			_changed();
 			if (notify) notifyListeners();
 		}
 		return *this;
@@ -164,6 +173,7 @@ public:
 	WPreferredSize& setMinHeight(int v, bool notify = true) {
 		if (minHeight != v) {
 			minHeight = v;
+			_changed();
 			if (notify) notifyListeners();
 		}
 		return *this;
@@ -172,6 +182,7 @@ public:
 	Point<int> getMinSize() const { return { minWidth, minHeight }; }
 	WPreferredSize& setMinSize(int w, int h, bool notify = true) {
 		minWidth = w; minHeight = h;
+		_changed();
 		if (notify) notifyListeners();
 		return *this;
 	}
@@ -180,6 +191,7 @@ public:
 	WPreferredSize& setPreferredWidth(int v, bool notify = true) {
 		if (preferredWidth != v) {
 			preferredWidth = v;
+			_changed();
 			if (notify) notifyListeners();
 		}
 		return *this;
@@ -189,6 +201,7 @@ public:
 	WPreferredSize& setPreferredHeight(int v, bool notify = true) {
 		if (preferredHeight != v) {
 			preferredHeight = v;
+			_changed();
 			if (notify) notifyListeners();
 		}
 		return *this;
@@ -197,6 +210,7 @@ public:
 	Point<int> getPreferredSize() const { return { preferredWidth, preferredHeight }; }
 	WPreferredSize& setPreferredSize(int w, int h, bool notify = true) {
 		preferredWidth = w; preferredHeight = h;
+		_changed();
 		if (notify) notifyListeners();
 		return *this;
 	}
@@ -205,6 +219,7 @@ public:
 	WPreferredSize& setFlexibleWidth(int v, bool notify = true) {
 		if (flexibleWidth != v) {
 			flexibleWidth = v;
+			_changed();
 			if (notify) notifyListeners();
 		}
 		return *this;
@@ -214,6 +229,7 @@ public:
 	WPreferredSize& setFlexibleHeight(int v, bool notify = true) {
 		if (flexibleHeight != v) {
 			flexibleHeight = v;
+			_changed();
 			if (notify) notifyListeners();
 		}
 		return *this;
@@ -222,11 +238,15 @@ public:
 	Point<int> getFlexibleSize() const { return { flexibleWidth, flexibleHeight }; }
 	WPreferredSize& setFlexibleSize(int w, int h, bool notify = true) {
 		flexibleWidth = w; flexibleHeight = h;
+		_changed();
 		if (notify) notifyListeners();
 		return *this;
 	}
 
 
+	// bumped by every change, notified or not
+	uint32 getVersion() const { return _version; }
+
 	// -------- LISTENER MANAGEMENT --------
 	WPreferredSize& addListener(Listener* l) {
 		if (l && std::find(_listeners.begin(), _listeners.end(), l) == _listeners.end())
@@ -240,6 +260,10 @@ public:
 	}
 
 private:
+	void _changed() { _version = ++_lastVersion; }
+
+	inline static uint32 _lastVersion = 0;
+	uint32 _version = 0;
 	bool ignoreLayout = false;
 	int minWidth = 0;
 	int minHeight = 0;
@@ -255,10 +279,50 @@ private:
 	}
 };
 
+/*
+	Lays out the children of a BaseComponent, called by its resized().
+
+	The last pass is memoized : parent rect, children with the versions of
+	their WLayout / WPreferredSize, and the rects computed. A pass with the
+	same input whose children still have those rects is skipped, otherwise
+	setBounds() is only issued for the children whose rect differs, so an
+	unchanged subtree doesn't resize again.
+
+	Children come typed from the parent (kept by BaseComponent::childrenChanged),
+	every buffer is a member reused by the next pass : once the sizes settle a
+	pass allocates nothing and does no dynamic_cast.
+*/
+
 class WParentLayout {
 public:
-	virtual void applyLayout(const Rectangle<int>& bParent, const Array<Component*>& children);
+	virtual ~WParentLayout() = default;
+
+	// children : the BaseComponent children of the parent, in z-order
+	virtual void applyLayout(const Rectangle<int>& bParent, const std::vector<BaseComponent*>& children);
+	// the next applyLayout() recomputes everything (options changed)
+	void invalidate() { _lastChildren.clear(); }
+
+	// children not ignoring the layout, valid until the next call
+	const std::vector<BaseComponent*>& getValidChildren(const std::vector<BaseComponent*>& children);
+
+protected:
+	// true when the last pass had this exact input and its rects still hold
+	bool _isUnchanged(const Rectangle<int>& bParent, const std::vector<BaseComponent*>& children) const;
+	// keeps the input and the rects of a pass, sets the bounds that differ
+	void _commit(const Rectangle<int>& bParent, const std::vector<BaseComponent*>& children, const std::vector<Rectangle<int>>& bounds);
+
+	std::vector<Rectangle<int>> _bounds; // scratch of the pass, same order as the valid children
+
+private:
+	struct LastChild {
+		BaseComponent* component = nullptr;
+		uint32 layoutVersion = 0;
+		uint32 sizeVersion = 0;
+		Rectangle<int> bounds;
+	};
 
-	std::vector<BaseComponent*> getValidChildren(const Array<Component*>& children);
+	std::vector<BaseComponent*> _validChildren;
+	Rectangle<int> _lastParent;
+	std::vector<LastChild> _lastChildren;
 };
 
@@ -0,0 +1,79 @@
+/*
+  ==============================================================================
+
+    WLayoutScheduler.cpp
+    Created: 15 Oct 2026 9:02:44am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "WLayoutScheduler.h"
+#include "../ui/BaseComponent.h"
+#include "../../utils/FrameProfiler.h"
+
+WLayoutScheduler::WLayoutScheduler() {
+	_updater.onAsyncUpdate = [this]() { flush(); };
+}
+
+WLayoutScheduler& WLayoutScheduler::getInstance() {
+	static WLayoutScheduler scheduler;
+	return scheduler;
+}
+
+void WLayoutScheduler::markDirty(BaseComponent& c) {
+	if (c._layoutDirty)
+		return;
+	c._layoutDirty = true;
+	_dirty.push_back(&c);
+	if (!_flushing)
+		_updater.triggerAsyncUpdate();
+}
+
+void WLayoutScheduler::remove(BaseComponent& c) {
+	if (!c._layoutDirty && !_flushing)
+		return;
+	// entries are cleared, not erased : a pass may be walking them
+	for (auto& d : _dirty)
+		if (d == &c)
+			d = nullptr;
+	for (auto& a : _arranging)
+		if (a.second == &c)
+			a.second = nullptr;
+	c._layoutDirty = false;
+}
+
+void WLayoutScheduler::flush() {
+	if (_flushing)
+		return;
+	_flushing = true;
+	const FrameProfiler::Scope scope(FrameProfiler::layout);
+	for (int round = 0; round < maxRounds && !_dirty.empty(); round++) {
+		_numPasses++;
+		// measure, the list grows with the parents of the sizes that changed
+		for (size_t i = 0; i < _dirty.size(); i++)
+			if (auto* c = _dirty[i])
+				c->measure();
+
+		// arrange, top-down. Marks from here on go to the next round
+		_arranging.clear();
+		for (auto* c : _dirty) {
+			if (c == nullptr)
+				continue;
+			c->_layoutDirty = false;
+			int depth = 0;
+			for (auto* p = c->getParentComponent(); p != nullptr; p = p->getParentComponent())
+				depth++;
+			_arranging.push_back({ depth, c });
+		}
+		_dirty.clear();
+		std::stable_sort(_arranging.begin(), _arranging.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+		for (const auto& a : _arranging)
+			if (a.second != nullptr)
+				a.second->resized();
+	}
+	_arranging.clear();
+	_flushing = false;
+	if (!_dirty.empty())
+		_updater.triggerAsyncUpdate();
+}
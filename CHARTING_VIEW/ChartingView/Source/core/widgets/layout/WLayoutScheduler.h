@@ -0,0 +1,59 @@
+/*
+  ==============================================================================
+
+    WLayoutScheduler.h
+    Created: 15 Oct 2026 9:02:44am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+#include "../../utils/AsyncUpdaterLambda.h"
+
+class BaseComponent;
+
+/*
+	Deferred layouts of every BaseComponent, run in one pass per message loop
+	instead of an AsyncUpdater per component firing in any order.
+
+	markDirty() only queues the component once, however many setters notified.
+	A pass then runs two phases :
+	- measure : measure() of the dirty components, a preferred size that
+	  changes there marks the parent, which joins the same pass
+	- arrange : resized() of the dirty components, parents before children,
+	  so a child is laid out once in its final bounds (the memoized layouts
+	  skip the children a parent didn't move)
+	Components marked while arranging get another round, the ones still dirty
+	after maxRounds (layouts that never settle) wait for the next message loop.
+
+	Message thread only.
+*/
+
+class WLayoutScheduler {
+public:
+	static constexpr int maxRounds = 4;
+
+	static WLayoutScheduler& getInstance();
+
+	void markDirty(BaseComponent& c);
+	// c is being deleted
+	void remove(BaseComponent& c);
+	// runs the pending pass now (before a snapshot, in tests)
+	void flush();
+
+	bool isPending() const { return !_dirty.empty(); }
+	uint64 getNumPasses() const { return _numPasses; }
+
+private:
+	WLayoutScheduler();
+
+	std::vector<BaseComponent*> _dirty;
+	std::vector<std::pair<int, BaseComponent*>> _arranging; // depth, component
+	AsyncUpdaterLambda _updater;
+	bool _flushing = false;
+	uint64 _numPasses = 0;
+
+	JUCE_DECLARE_NON_COPYABLE(WLayoutScheduler)
+};
@@ -16,8 +16,8 @@ public:
 	
 	WBaseComponentLayout() {}
 
-	void applyLayout(const Rectangle<int>& bParent, const Array<Component*>& children) override {
-		const auto c = getValidChildren(children);
+	void applyLayout(const Rectangle<int>& bParent, const std::vector<BaseComponent*>& children) override {
+		const auto& c = getValidChildren(children);
 		if (c.empty())
 			return;
 		c[0]->setBounds(bParent);
@@ -29,15 +29,19 @@ private:
 
 
 BaseComponent::BaseComponent()
-	: _asyncResizer(this)
-	// , _parentLayout(new WFlexLayout(WFlexLayout::Options::horizontal_group())) //WBaseComponentLayout
-	, _preferredSizeListener([&]() { triggerAsyncResize(); })
+	// : _parentLayout(new WFlexLayout(WFlexLayout::Options::horizontal_group())) //WBaseComponentLayout
+	: _preferredSizeListener([&]() {
+		// the parent's layout reads the preferred size
+		if (auto* parent = dynamic_cast<BaseComponent*>(getParentComponent()))
+			parent->triggerAsyncResize();
+	})
 	{
 
 	getPreferredSize().addListener(&_preferredSizeListener);
 }
 
 BaseComponent::~BaseComponent() {
+	WLayoutScheduler::getInstance().remove(*this);
 	clearOwnedChildren();
 }
 
@@ -45,6 +49,14 @@ void BaseComponent::resized() {
 	applyLayout();
 }
 
+void BaseComponent::childrenChanged() {
+	// the only cast of the layout, once per change of the children
+	_layoutChildren.clear();
+	for (auto* c : getChildren())
+		if (auto* bc = dynamic_cast<BaseComponent*>(c))
+			_layoutChildren.push_back(bc);
+}
+
 WLayout& BaseComponent::getLayout() {
 	return _wlayout;
 }
@@ -78,15 +90,13 @@ void BaseComponent::setBorders(int size) {
 void BaseComponent::applyLayout() {
 	const auto bParent = _borders.subtractedFrom(getLocalBounds());
 	if (_parentLayout) 
-		_parentLayout->applyLayout(bParent, getChildren());
-	else {
-		WParentLayout l;
-		l.applyLayout(bParent, getChildren());
-	}
+		_parentLayout->applyLayout(bParent, _layoutChildren);
+	else
+		_defaultLayout.applyLayout(bParent, _layoutChildren);
 }
 
 void BaseComponent::triggerAsyncResize() {
-	_asyncResizer.triggerAsyncResize();
+	WLayoutScheduler::getInstance().markDirty(*this);
 }
 
 void BaseComponent::setEditor(bool isEditor) {
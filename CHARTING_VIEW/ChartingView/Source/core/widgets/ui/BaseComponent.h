@@ -11,7 +11,7 @@
 #pragma once
 #include "JuceHeader.h"
 #include "../layout/WLayout.h"
-#include "../../utils/AsyncResizer.h"
+#include "../layout/WLayoutScheduler.h"
 
 
 class BaseComponent : public Component {
@@ -21,6 +21,9 @@ public:
 	~BaseComponent();
 
 	void resized() override;
+	void childrenChanged() override;
+	// sets the preferred size from the content, the scheduler calls it before arranging the parent
+	virtual void measure() {}
 
 	WLayout& getLayout();
 	const WLayout& getLayout() const;
@@ -36,6 +39,7 @@ public:
 	void setBorders(int size);
 	void applyLayout();
 
+	// measure() and resized() in the next WLayoutScheduler pass
 	void triggerAsyncResize();
 	void setEditor(bool isEditor);
 
@@ -48,9 +52,13 @@ private:
 	WLayout _wlayout;
 	WPreferredSize _wPreferredSize;
 	std::unique_ptr<WParentLayout> _parentLayout;
+	WParentLayout _defaultLayout; // anchors, when no parent layout is set
+	std::vector<BaseComponent*> _layoutChildren; // BaseComponent children, in z-order
 	BorderSize<int> _borders;
-	AsyncResizer _asyncResizer;
 	WPreferredSize::ListenerLambda _preferredSizeListener;
 	std::vector<UPtr<Component>> _ownedChildren;
+	bool _layoutDirty = false; // queued in the WLayoutScheduler
+
+	friend class WLayoutScheduler;
 };
 
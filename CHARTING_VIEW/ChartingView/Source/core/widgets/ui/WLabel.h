@@ -10,6 +10,7 @@
 
 #pragma once
 #include "BaseComponent.h"
+#include "../../utils/TextCache.h"
 
 class WLabel : public BaseComponent {
 public:
@@ -28,25 +29,41 @@ public:
 		g.drawRect(getLocalBounds());
 	}
 
-	void resized() override {
+	void measure() override {
 		_updatePreferredSize();
+	}
+
+	void resized() override {
 		_l.setBounds(getLocalBounds());
 	}
 
+	// the preferred size only notifies the parent when the width changes
 	void setText(const String& s) {
+		if (s == _l.getText())
+			return;
 		_l.setText(s, dontSendNotification);
 		_updatePreferredSize();
 	}
 
+	// live values (prices, % changes) : every digit measures as the widest one,
+	// a tick with the same number of digits keeps the width
+	void setNumeric(bool isNumeric) {
+		_numeric = isNumeric;
+		_updatePreferredSize();
+	}
+
 private:
 
 	void _updatePreferredSize(bool notify = true) {
-		const int w = _l.getFont().getStringWidth(_l.getText());
+		auto& text = TextCache::getInstance();
+		const auto& font = _l.getFont();
+		const float w = _numeric ? text.getNumberWidth(font, _l.getText()) : text.getWidth(font, _l.getText());
 		getPreferredSize()
-			.setPreferredWidth(w, notify)
-			.setPreferredHeight(_l.getFont().getHeight(), notify);
+			.setPreferredWidth(roundToInt(w), notify)
+			.setPreferredHeight(roundToInt(font.getHeight()), notify);
 	}
 
 	Label _l;
+	bool _numeric = false;
 };
 
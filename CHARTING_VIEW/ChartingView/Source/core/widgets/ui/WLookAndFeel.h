@@ -20,6 +20,12 @@ public:
 
 	inline static float widgetCorner = 6;
 
+	inline static Colour candleUpColour = Colour(0xff26a69a);
+	inline static Colour candleDownColour = Colour(0xffef5350);
+
+	inline static Colour gridColour = Colours::white.withAlpha(0.06f);
+	inline static Colour axisTextColour = Colours::white.withAlpha(0.6f);
+
 	WLookAndFeel() {
 		setColour(juce::ResizableWindow::backgroundColourId, bgColour);
 	}
@@ -0,0 +1,72 @@
+/*
+  ==============================================================================
+
+    WProfilerOverlay.cpp
+    Created: 15 Oct 2026 2:41:07pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "WProfilerOverlay.h"
+#include "WLookAndFeel.h"
+#include "../../utils/FrameProfiler.h"
+#include "../../utils/MemoryBudget.h"
+#include "../../utils/TextCache.h"
+
+static constexpr int numLines = 6 + FrameProfiler::numSections - 1 + MemoryBudget::numSubsystems;
+static constexpr int margin = 6;
+
+WProfilerOverlay::WProfilerOverlay() {
+	setInterceptsMouseClicks(false, false);
+	setWantsKeyboardFocus(false);
+	_refresh.onTimer = [this]() { repaint(); };
+}
+
+int WProfilerOverlay::getPreferredHeight() const {
+	return numLines * roundToInt(_font.getHeight() + 2.0f) + margin * 2;
+}
+
+void WProfilerOverlay::visibilityChanged() {
+	if (isVisible())
+		_refresh.startTimerHz(4);
+	else
+		_refresh.stopTimer();
+}
+
+static String formatCount(double n) {
+	if (n >= 1e6)
+		return String(n / 1e6, 2) + "M";
+	if (n >= 1e4)
+		return String(n / 1e3, 1) + "k";
+	return String(roundToInt(n));
+}
+
+static String formatBytes(int64 bytes) {
+	return String((double)bytes / (double)(1 << 20), 1) + " MB";
+}
+
+void WProfilerOverlay::paint(Graphics& g) {
+	const auto stats = FrameProfiler::getInstance().getStats();
+	StringArray lines;
+	lines.add(String(roundToInt(stats.fps)) + " fps, " + String(stats.numFrames) + " frames");
+	lines.add("p50 " + String(stats.p50, 2) + "  p90 " + String(stats.p90, 2) + "  p99 " + String(stats.p99, 2) + " ms");
+	lines.add("max " + String(stats.maxMs, 2) + " ms");
+	for (int s = FrameProfiler::layout; s < FrameProfiler::numSections; s++)
+		lines.add(String(FrameProfiler::getSectionName((FrameProfiler::Section)s)) + " " + String(stats.sectionMs[s], 3) + " ms");
+	lines.add("points " + formatCount(stats.pointsDrawn) + " / " + formatCount(stats.pointsInRange));
+	lines.add("layer cache " + String(roundToInt(stats.cacheHitRate * 100.0)) + "% hits");
+	const auto& budget = MemoryBudget::getInstance();
+	lines.add("memory " + formatBytes(budget.getTotalUsage()) + " / " + formatBytes(budget.getLimit()));
+	for (int s = 0; s < MemoryBudget::numSubsystems; s++)
+		lines.add("  " + String(MemoryBudget::getSubsystemName((MemoryBudget::Subsystem)s)) + " " + formatBytes(budget.getUsage((MemoryBudget::Subsystem)s)));
+
+	g.setColour(WLookAndFeel::bgColour.withAlpha(0.85f));
+	g.fillRoundedRectangle(getLocalBounds().toFloat(), 4.0f);
+	g.setColour(WLookAndFeel::axisTextColour);
+	auto& text = TextCache::getInstance();
+	auto area = getLocalBounds().reduced(margin).toFloat();
+	const float lineHeight = (float)roundToInt(_font.getHeight() + 2.0f);
+	for (const auto& line : lines)
+		text.draw(g, _font, line, area.removeFromTop(lineHeight), Justification::centredLeft);
+}
@@ -0,0 +1,40 @@
+/*
+  ==============================================================================
+
+    WProfilerOverlay.h
+    Created: 15 Oct 2026 2:41:07pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "BaseComponent.h"
+#include "../../utils/TimerLambda.h"
+
+/*
+	FrameProfiler statistics drawn over the view : FPS, frame time percentiles,
+	mean ms per section, points in range vs drawn and layer cache hit rate,
+	then the MemoryBudget usage per subsystem against its limit.
+	Refreshed 4 times per second while visible, clicks go through.
+*/
+
+class WProfilerOverlay : public BaseComponent {
+public:
+	static constexpr int preferredWidth = 220;
+
+	WProfilerOverlay();
+
+	void paint(Graphics& g) override;
+
+	// fits the lines
+	int getPreferredHeight() const;
+
+private:
+	void visibilityChanged() override;
+
+	Font _font{ 12.0f };
+	TimerLambda _refresh;
+
+	JUCE_DECLARE_NON_COPYABLE(WProfilerOverlay)
+};
@@ -13,17 +13,63 @@
 #include "../WLookAndFeel.h"
 #include "WChartAxis.h"
 #include "WChartViewport.h"
+#include "../../../io/KlineFile.h"
+#include "../../../io/OrdersCsvLoader.h"
+#include "../../../io/DerivedCache.h"
+#include "../../../Workspace.h"
 
 WChart::WChart()
-	: _xAxis(new WChartAxis(_scaleT))
-	, _yAxis(new WChartAxis(_scaleT))
+	: _xAxis(new WChartAxis(_scaleT, WChartAxis::Orientation::horizontal))
+	, _yAxis(new WChartAxis(_scaleT, WChartAxis::Orientation::vertical))
 	, _viewport(new WChartViewport(_scaleT))
 {
 	addAndMakeVisible(&*_xAxis);
 	addAndMakeVisible(&*_yAxis);
 	addAndMakeVisible(&*_viewport);
+	_viewport->setInterceptsMouseClicks(false, false);
 
-	_scaleT.xUnit
+	_loader.onProgress = [this](float) { repaint(); };
+	_loader.onPartial = [this](KlineStore::Ptr store) {
+		// the latest rows first, filling the view, then the history before them
+		if (_showsPartial)
+			_extendHistory(std::move(store));
+		else
+			setStore(std::move(store));
+		_showsPartial = true;
+		repaint();
+	};
+	_loader.onLoaded = [this](KlineStore::Ptr store, const String& error) {
+		// the partial stores are not cached, the complete one is
+		_sourceFile = _loadingFile;
+		const bool loaded = store != nullptr;
+		if (store && _showsPartial)
+			_extendHistory(std::move(store));
+		else if (store)
+			setStore(std::move(store));
+		else
+			DBG("WChart: " << error);
+		// other windows opening the file adopt it
+		if (loaded && _sourceFile != File())
+			Workspace::getInstance().addSeries(_sourceFile, _resampler);
+		_showsPartial = false;
+		repaint();
+	};
+
+	_sharedPoll.onTimer = [this]() {
+		if (!_shared || !_shared->refresh())
+			return;
+		// the drawn rows before the last one are final, new rows only extend the pyramid
+		const auto& drawn = _viewport->getStore();
+		const size_t fromRow = drawn && drawn->size() > 0 ? drawn->size() - 1 : 0;
+		const bool grown = _setSource(SharedSeries::toKlineStore(_shared));
+		// the timeframes grow in place, the one on screen may be read by the workers
+		_viewport->writeStore([this]() { _resampler->sync(); });
+		_viewport->updateStore(_resampler->get(_timeframe), grown ? fromRow : 0);
+	};
+
+	setWantsKeyboardFocus(true);
+
+	_scaleT.getX().xUnit
 		.setWorldStart(0)
 		.setWorldEnd(100);
 	_scaleT.yUnit
@@ -39,38 +85,549 @@ WChart::WChart()
 }
 
 WChart::~WChart() {
-	
+	// a shared transition outlives the pane, it must not call it back
+	_cancelZoom();
 }
 
 void WChart::paint(Graphics& g) {
-	g.setColour(WLookAndFeel::bgWidgetColour);
-	g.fillRoundedRectangle(getLocalBounds().toFloat(), WLookAndFeel::widgetCorner);
+	_viewport->updateVisibleRange();
+	if (_autoScale) {
+		// before the children paint, they all see the fitted y
+		const auto values = _viewport->getVisibleValueRange();
+		if (values.getLength() > 0.0)
+			_scaleT.yUnit
+				.setWorldStart(values.getStart())
+				.setWorldEnd(values.getEnd());
+	}
+	_xAxis->setTimeOrigin(_viewport->getOriginTime());
+	// static layer, only depends on the bounds
+	WChartLayerCache::Key key;
+	key.width = getWidth();
+	key.height = getHeight();
+	_background.draw(g, key, [this](Graphics& lg) {
+		lg.setColour(WLookAndFeel::bgWidgetColour);
+		lg.fillRoundedRectangle(getLocalBounds().toFloat(), WLookAndFeel::widgetCorner);
+		lg.setColour(WLookAndFeel::bgWidgetColour.brighter());
+		lg.drawRoundedRectangle(getLocalBounds().reduced(1).toFloat(), WLookAndFeel::widgetCorner, 1.0f);
+	});
+}
+
+void WChart::paintOverChildren(Graphics& g) {
+	if (_crosshairVisible) {
+		const auto area = _viewport->getBounds();
+		const auto p = _crosshair + area.getPosition().toFloat();
+		g.setColour(WLookAndFeel::axisTextColour.withMultipliedAlpha(0.5f));
+		g.drawVerticalLine(roundToInt(p.x), (float)area.getY(), (float)area.getBottom());
+		g.drawHorizontalLine(roundToInt(p.y), (float)area.getX(), (float)area.getRight());
+		if (_hoveredShape != WChartShapes::invalidId)
+			g.drawEllipse(Rectangle<float>(10.0f, 10.0f).withCentre(p), 1.0f);
+	}
+	if (!_loader.isLoading())
+		return;
+	auto bar = getLocalBounds().reduced((int)WLookAndFeel::widgetCorner, 0).removeFromTop(3).toFloat();
 	g.setColour(WLookAndFeel::bgWidgetColour.brighter());
-	g.drawRoundedRectangle(getLocalBounds().reduced(1).toFloat(), WLookAndFeel::widgetCorner, 1.0f);
+	g.fillRect(bar);
+	g.setColour(WLookAndFeel::candleUpColour);
+	g.fillRect(bar.withWidth(bar.getWidth() * _loader.getProgress()));
 }
 
 void WChart::resized() {
-	_scaleT.xWorld
+	// BaseComponent::resized();
+	auto bounds = getLocalBounds();
+	const int xAxisHeight = _xAxis->isVisible() ? 100 : 0;
+	auto bRight = bounds.removeFromRight(_yAxis->isVisible() ? 100 : 0);
+	bRight.removeFromBottom(xAxisHeight);
+	auto bBot = bounds.removeFromBottom(xAxisHeight);
+	auto bContent = bounds;
+
+	// the axis world is the pixel space of the viewport
+	_scaleT.getX().xWorld
 		.setWorldStart(0)
-		.setWorldEnd(getWidth())
+		.setWorldEnd(bContent.getWidth())
 		.setViewportStart(0)
-		.setViewportEnd(getWidth());
+		.setViewportEnd(bContent.getWidth());
 	_scaleT.yWorld
 		.setWorldStart(0)
-		.setWorldEnd(getHeight())
+		.setWorldEnd(bContent.getHeight())
 		.setViewportStart(0)
-		.setViewportEnd(getHeight());
-
-	// BaseComponent::resized();
-	auto bounds = getLocalBounds();
-	auto bRight = bounds.removeFromRight(100);
-	bRight.removeFromBottom(100);
-	auto bBot = bounds.removeFromBottom(100);
-	auto bContent = bounds;
+		.setViewportEnd(bContent.getHeight());
 
 	_viewport->setBounds(bContent);
 	_xAxis->setBounds(bBot);
 	_yAxis->setBounds(bRight);
 }
 
+void WChart::setStore(KlineStore::Ptr store) {
+	_cancelZoom();
+	_setSource(std::move(store));
+	store = DerivedCache::getTimeframe(*_resampler, _timeframe, _sourceFile);
+	if (store && !store->isEmpty()) {
+		const auto n = store->size();
+		const auto* t = store->getOpenTime();
+		const auto candle = n > 1 ? t[1] - t[0] : 1;
+		const auto prices = store->computePriceRange(0, n);
+		_scaleT.getX().xUnit
+			.setWorldStart(0)
+			.setWorldEnd((double)(t[n - 1] - t[0] + candle));
+		_scaleT.yUnit
+			.setWorldStart(prices.getStart())
+			.setWorldEnd(prices.getEnd());
+	}
+	_viewport->setCacheSource(_sourceFile);
+	_viewport->setStore(std::move(store));
+}
+
+void WChart::_extendHistory(KlineStore::Ptr store) {
+	_cancelZoom();
+	const auto before = _viewport->getStore();
+	_setSource(std::move(store));
+	auto next = DerivedCache::getTimeframe(*_resampler, _timeframe, _sourceFile);
+	if (before && next && !before->isEmpty() && !next->isEmpty()) {
+		// x units are relative to the first open_time of the drawn store
+		const double shift = (double)(before->getFirstOpenTime() - next->getFirstOpenTime());
+		_scaleT.getX().xUnit
+			.setWorldStart(_scaleT.getX().xUnit.getWorldStart() + shift)
+			.setWorldEnd(_scaleT.getX().xUnit.getWorldEnd() + shift);
+	}
+	// rows moved : the pyramid is rebuilt, the last frame stays as a placeholder
+	_viewport->setCacheSource(_sourceFile);
+	_viewport->updateStore(std::move(next), 0);
+	_getXRepaintTarget().repaint();
+}
+
+bool WChart::_setSource(KlineStore::Ptr store) {
+	// a resampler shared with other windows only ever has its file as source
+	if (_resampler.use_count() > 1 && store != _resampler->getSource())
+		_resampler = std::make_shared<KlineResampler>();
+	return _resampler->setSource(std::move(store));
+}
+
+const KlineStore::Ptr& WChart::getStore() const {
+	return _resampler->getSource();
+}
+
+const KlineStore::Ptr& WChart::getDisplayedStore() const {
+	return _viewport->getStore();
+}
+
+void WChart::setTimeframe(int64 period) {
+	if (period == _timeframe)
+		return;
+	_timeframe = period;
+	_cancelZoom();
+	const auto before = _viewport->getStore();
+	auto next = DerivedCache::getTimeframe(*_resampler, period, _sourceFile);
+	if (before && next && !before->isEmpty() && !next->isEmpty()) {
+		// x units are relative to the first open_time of the drawn store, keep the same times in view
+		const double shift = (double)(before->getFirstOpenTime() - next->getFirstOpenTime());
+		_scaleT.getX().xUnit
+			.setWorldStart(_scaleT.getX().xUnit.getWorldStart() + shift)
+			.setWorldEnd(_scaleT.getX().xUnit.getWorldEnd() + shift);
+	}
+	if (next != before)
+		_viewport->setStore(std::move(next));
+	_getXRepaintTarget().repaint();
+}
+
+int64 WChart::getTimeframe() const {
+	return _timeframe;
+}
+
+void WChart::setValueRange(Range<double> range) {
+	_scaleT.yUnit
+		.setWorldStart(range.getStart())
+		.setWorldEnd(range.getEnd());
+	repaint();
+}
+
+void WChart::showTimeRange(int64 start, int64 end) {
+	const auto& store = _viewport->getStore();
+	if (!store || store->isEmpty() || end <= start)
+		return;
+	_cancelZoom();
+	const auto origin = store->getFirstOpenTime();
+	_scaleT.getX().xUnit
+		.setWorldStart((double)(start - origin))
+		.setWorldEnd((double)(end - origin));
+	const auto* t = store->getOpenTime();
+	const auto first = (size_t)(std::lower_bound(t, t + store->size(), start) - t);
+	const auto last = (size_t)(std::lower_bound(t, t + store->size(), end) - t);
+	if (first < last) {
+		const auto prices = store->computePriceRange(first, last);
+		_scaleT.yUnit
+			.setWorldStart(prices.getStart())
+			.setWorldEnd(prices.getEnd());
+	}
+	_getXRepaintTarget().repaint();
+}
+
+void WChart::setSharedX(SharedX* x) {
+	_cancelZoom();
+	_sharedX = x;
+	_scaleT.setSharedX(x ? &x->transform : nullptr);
+	resized();
+	_getXRepaintTarget().repaint();
+}
+
+void WChart::setXAxisVisible(bool shouldBeVisible) {
+	_xAxis->setVisible(shouldBeVisible);
+	resized();
+}
+
+void WChart::setYAxisVisible(bool shouldBeVisible) {
+	_yAxis->setVisible(shouldBeVisible);
+	resized();
+}
+
+void WChart::setBackgroundRenderingEnabled(bool shouldBeEnabled) {
+	_viewport->setBackgroundRenderingEnabled(shouldBeEnabled);
+}
+
+void WChart::setTileCacheEnabled(bool shouldBeEnabled) {
+	_viewport->setTileCacheEnabled(shouldBeEnabled);
+}
+
+bool WChart::isTileCacheEnabled() const {
+	return _viewport->isTileCacheEnabled();
+}
+
+WChart::ZoomTransition& WChart::_getZoom() {
+	return _sharedX ? _sharedX->zoom : _ownZoom;
+}
+
+void WChart::_cancelZoom() {
+	// a chart that never animated doesn't touch the Animator : an offscreen one may be drawn
+	// off the message thread (ChartBatchRenderer)
+	if (_getZoom().animation != 0)
+		Animator::getInstance().cancel(_getZoom().animation);
+}
+
+Component& WChart::_getXRepaintTarget() {
+	return _sharedX && _sharedX->stack ? *_sharedX->stack : *this;
+}
+
+void WChart::setLogScale(bool shouldBeLog) {
+	_scaleT.yScale = shouldBeLog ? AxisScale::logarithmic : AxisScale::linear;
+	repaint();
+}
+
+bool WChart::isLogScale() const {
+	return _scaleT.yScale == AxisScale::logarithmic;
+}
+
+void WChart::setAutoScale(bool shouldAutoScale) {
+	_autoScale = shouldAutoScale;
+	repaint();
+}
+
+void WChart::setOpenGLEnabled(bool shouldBeEnabled) {
+	_viewport->setOpenGLEnabled(shouldBeEnabled);
+}
+
+bool WChart::isOpenGLEnabled() const {
+	return _viewport->isOpenGLEnabled();
+}
+
+bool WChart::keyPressed(const KeyPress& key) {
+	if (key.getTextCharacter() == 'l' || key.getTextCharacter() == 'L') {
+		setLogScale(!isLogScale());
+		return true;
+	}
+	if (key.getTextCharacter() == 'g' || key.getTextCharacter() == 'G') {
+		setOpenGLEnabled(!isOpenGLEnabled());
+		return true;
+	}
+	if (key.getTextCharacter() == 't' || key.getTextCharacter() == 'T') {
+		setTileCacheEnabled(!isTileCacheEnabled());
+		return true;
+	}
+	if (key.getTextCharacter() == 'a' || key.getTextCharacter() == 'A') {
+		setAutoScale(!isAutoScale());
+		return true;
+	}
+	if (key.getTextCharacter() == 'v' || key.getTextCharacter() == 'V') {
+		setVolumeProfileVisible(!isVolumeProfileVisible());
+		return true;
+	}
+	const int preset = key.getKeyCode() - '1';
+	if (!isPositiveAndBelow(preset, (int)std::size(KlineResampler::presets)))
+		return false;
+	setTimeframe(KlineResampler::presets[preset].period);
+	return true;
+}
+
+void WChart::mouseDown(const MouseEvent&) {
+	// the pixel offset of a long pan goes back into the unit world before float pixels lose precision
+	auto& xWorld = _scaleT.getX().xWorld;
+	if (std::abs(xWorld.getViewportStart() - xWorld.getWorldStart()) > (float)(1 << 20))
+		_scaleT.rebaseX();
+	_dragViewportStart = _scaleT.getX().xWorld.getViewportStart();
+	if (_hoveredShape != WChartShapes::invalidId && onShapeClicked)
+		onShapeClicked(_hoveredShape);
+}
+
+void WChart::mouseDrag(const MouseEvent& e) {
+	// whole pixels, the viewport reuses its previous frame and renders the exposed strip only
+	const float dx = (float)e.getDistanceFromDragStartX() * (_scaleT.getX().xDir == WChartScaleTransform::AxisDirection::right_to_left ? -1.0f : 1.0f);
+	const float size = _scaleT.getX().xWorld.getViewportSize();
+	const float start = _dragViewportStart - dx;
+	if (start == _scaleT.getX().xWorld.getViewportStart())
+		return;
+	_scaleT.getX().xWorld
+		.setViewportStart(start)
+		.setViewportEnd(start + size);
+	_getXRepaintTarget().repaint();
+}
+
+void WChart::mouseWheelMove(const MouseEvent& e, const MouseWheelDetails& wheel) {
+	if (wheel.deltaY == 0.0f)
+		return;
+	auto& animator = Animator::getInstance();
+	const Range<double> current(_scaleT.getX().xUnit.getWorldStart(), _scaleT.getX().xUnit.getWorldEnd());
+	// from the end of the running transition, fast wheel moves keep stepping through the presets
+	auto& zoom = _getZoom();
+	const auto from = animator.isRunning(zoom.animation) ? zoom.target : current;
+	const float pivot = e.getEventRelativeTo(_viewport.get()).position.x;
+	const auto to = _scaleT.getZoomedX(from, wheel.deltaY > 0.0f ? 0.8 : 1.25, pivot, (float)_viewport->getWidth());
+	if (to == from)
+		return;
+	// start and end move linearly, the time under the pivot stays in place
+	zoom.target = to;
+	animator.cancel(zoom.animation);
+	zoom.animation = animator.start(_getXRepaintTarget(), zoomDuration, AnimationCurve::easeOut(), [this, current, to](float v) {
+		_scaleT.getX().xUnit
+			.setWorldStart(current.getStart() + (to.getStart() - current.getStart()) * v)
+			.setWorldEnd(current.getEnd() + (to.getEnd() - current.getEnd()) * v);
+	});
+}
+
+void WChart::mouseMove(const MouseEvent& e) {
+	const auto p = e.getEventRelativeTo(_viewport.get()).position;
+	if (!_viewport->getLocalBounds().toFloat().contains(p)) {
+		_setCrosshair(false, {});
+		return;
+	}
+	WChartShapes::Hit hit;
+	const bool onShape = _viewport->getShapes().hitTest(p, shapeHitDistance, _scaleT, _viewport->getOriginTime(), (float)_viewport->getWidth(), (float)_viewport->getHeight(), hit);
+	if (hit.id != _hoveredShape) {
+		_hoveredShape = hit.id;
+		if (onShapeHovered)
+			onShapeHovered(_hoveredShape);
+	}
+	FillClusters::Cluster fills;
+	const bool onFills = !onShape && _viewport->getFills().hitTest(p, shapeHitDistance, fills);
+	if (onFills || _fillsHovered) {
+		_fillsHovered = onFills;
+		if (onFillsHovered)
+			onFillsHovered(onFills ? &fills : nullptr);
+	}
+	_setCrosshair(true, onShape ? hit.anchor : Point<float>(_viewport->snapToCandle(p.x), p.y));
+}
+
+void WChart::mouseExit(const MouseEvent&) {
+	if (_hoveredShape != WChartShapes::invalidId) {
+		_hoveredShape = WChartShapes::invalidId;
+		if (onShapeHovered)
+			onShapeHovered(_hoveredShape);
+	}
+	if (_fillsHovered) {
+		_fillsHovered = false;
+		if (onFillsHovered)
+			onFillsHovered(nullptr);
+	}
+	_setCrosshair(false, {});
+}
+
+void WChart::_setCrosshair(bool visible, Point<float> position) {
+	if (visible == _crosshairVisible && (!visible || position == _crosshair))
+		return;
+	// only the strips under the lines, the viewport blits its cached layers there
+	if (_crosshairVisible)
+		_repaintCrosshair();
+	_crosshairVisible = visible;
+	_crosshair = position;
+	if (_crosshairVisible)
+		_repaintCrosshair();
+}
+
+void WChart::_repaintCrosshair() {
+	const auto area = _viewport->getBounds();
+	const auto p = _crosshair.roundToInt() + area.getPosition();
+	const int r = 6; // the hover ring
+	repaint(p.x - r, area.getY(), 2 * r + 1, area.getHeight());
+	repaint(area.getX(), p.y - r, area.getWidth(), 2 * r + 1);
+}
+
+const SeriesRange& WChart::getVisibleRange() const {
+	return _viewport->getVisibleRange();
+}
+
+WChartCurve* WChart::addCurve(KlineStore::Ptr times, SPtr<const std::vector<double>> values, const WChartCurve::Options& options) {
+	return _viewport->addCurve(std::move(times), std::move(values), options);
+}
+
+WChartCurve* WChart::addCurve(FunctionSeries::Ptr function, const WChartCurve::Options& options) {
+	return _viewport->addCurve(std::move(function), options);
+}
+
+void WChart::removeCurve(WChartCurve* curve) {
+	_viewport->removeCurve(curve);
+}
+
+void WChart::clearCurves() {
+	_viewport->clearCurves();
+}
+
+WChartHistogram* WChart::addHistogram(const WChartHistogram::Options& options) {
+	return _viewport->addHistogram(options);
+}
+
+void WChart::removeHistogram(WChartHistogram* histogram) {
+	_viewport->removeHistogram(histogram);
+}
+
+void WChart::clearHistograms() {
+	_viewport->clearHistograms();
+}
+
+void WChart::setVolumeProfileVisible(bool shouldBeVisible, const WChartHistogram::Options& options) {
+	_viewport->setVolumeProfileVisible(shouldBeVisible, options);
+}
+
+bool WChart::isVolumeProfileVisible() const {
+	return _viewport->isVolumeProfileVisible();
+}
+
+void WChart::setFills(FillClusters::Ptr fills) {
+	_viewport->getFills().setFills(std::move(fills));
+}
+
+WChartFills& WChart::getFills() {
+	return _viewport->getFills();
+}
+
+WChartShapes& WChart::getShapes() {
+	return _viewport->getShapes();
+}
+
+void WChart::setLiveSeries(KlineRingSeries::Ptr series) {
+	if (series) {
+		const auto snap = series->getSnapshot();
+		if (snap.size() > 1) {
+			Range<double> prices;
+			for (uint64 i = snap.begin; i < snap.end; i++) {
+				const auto k = snap.getRow(i);
+				prices = i == snap.begin ? Range<double>(k.low, k.high) : prices.getUnionWith(Range<double>(k.low, k.high));
+			}
+			const auto candle = snap.getOpenTime(snap.begin + 1) - snap.getOpenTime(snap.begin);
+			_scaleT.getX().xUnit
+				.setWorldStart((double)(snap.getOpenTime(snap.begin) - snap.originTime))
+				.setWorldEnd((double)(snap.getOpenTime(snap.end - 1) - snap.originTime + candle));
+			_scaleT.yUnit
+				.setWorldStart(prices.getStart())
+				.setWorldEnd(prices.getEnd());
+		}
+	}
+	_viewport->setLiveSeries(std::move(series));
+	_updateLiveMarker();
+}
+
+void WChart::updateLiveSeries() {
+	const auto changed = _viewport->updateLiveSeries();
+	if (_autoScale && !changed.isEmpty()) {
+		// a tick that moves the fitted y redraws everything, not only its candles with the new scale
+		const auto values = _viewport->getLiveValueRange();
+		if (values.getLength() > 0.0 && (values.getStart() != _scaleT.yUnit.getWorldStart() || values.getEnd() != _scaleT.yUnit.getWorldEnd()))
+			repaint();
+	}
+	_updateLiveMarker();
+}
+
+void WChart::_updateLiveMarker() {
+	KlineRingSeries::Kline k;
+	if (_viewport->getLastLiveKline(k))
+		_yAxis->setMarker(k.close, k.close >= k.open ? WLookAndFeel::candleUpColour : WLookAndFeel::candleDownColour);
+	else
+		_yAxis->clearMarker();
+}
+
+const KlineRingSeries::Ptr& WChart::getLiveSeries() const {
+	return _viewport->getLiveSeries();
+}
+
+void WChart::loadFile(const File& file) {
+	if (file.getFileName().startsWith("binance_transactions_")) {
+		// OrdersGetter export : the fills of the displayed symbol over the current series
+		const auto& store = getDisplayedStore();
+		String error;
+		auto fills = OrdersCsvLoader::parseFile(file, store ? store->getSymbol() : String(), &error);
+		if (error.isNotEmpty())
+			DBG("WChart: " << error);
+		setFills(std::make_shared<FillClusters>(std::move(fills)));
+		return;
+	}
+	// a csv still loading would replace the new series once parsed
+	_loader.cancel();
+	_sharedPoll.stopTimer();
+	_shared = nullptr;
+	_showsPartial = false;
+	// derived data is cached next to the file once all its rows are loaded
+	_sourceFile = File();
+	_loadingFile = File();
+	// shapes belong to the previous series
+	_viewport->getShapes().clear();
+	_hoveredShape = WChartShapes::invalidId;
+	if (auto series = Workspace::getInstance().findSeries(file)) {
+		// open in another window : its rows, timeframes and pyramids are reused
+		_resampler = std::move(series);
+		_sourceFile = file;
+		setStore(_resampler->getSource());
+		return;
+	}
+	// the previous one may be shared
+	_resampler = std::make_shared<KlineResampler>();
+	if (file.hasFileExtension(KlineFile::fileExtension)) {
+		// mapped, nothing to parse
+		String error;
+		_sourceFile = file;
+		if (auto store = KlineFile::open(file, &error)) {
+			setStore(std::move(store));
+			Workspace::getInstance().addSeries(file, _resampler);
+		}
+		else
+			DBG("WChart: " << error);
+		return;
+	}
+	if (file.hasFileExtension(SharedSeries::fileExtension)) {
+		openSharedSeries(file);
+		return;
+	}
+	_loadingFile = file;
+	_loader.loadAsync(file);
+	repaint();
+}
+
+void WChart::openSharedSeries(const File& file) {
+	// rewritten in place, nothing to key a cache on
+	_sourceFile = File();
+	String error;
+	_shared = SharedSeries::open(file, &error);
+	if (!_shared) {
+		DBG("WChart: " << error);
+		_sharedPoll.stopTimer();
+		return;
+	}
+	setStore(SharedSeries::toKlineStore(_shared));
+	_sharedPoll.startTimerHz(30);
+}
+
+bool WChart::isInterestedInFileDrag(const StringArray& files) {
+	return files.size() == 1 && File(files[0]).hasFileExtension(String("csv;") + KlineFile::fileExtension + ";" + SharedSeries::fileExtension);
+}
+
+void WChart::filesDropped(const StringArray& files, int, int) {
+	if (isInterestedInFileDrag(files))
+		loadFile(File(files[0]));
+}
+
 
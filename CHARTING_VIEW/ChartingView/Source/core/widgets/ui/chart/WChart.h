@@ -11,24 +11,164 @@
 #pragma once
 #include "../BaseComponent.h"
 #include "WChartTransform.h"
+#include "WChartLayerCache.h"
+#include "WChartCurve.h"
+#include "WChartShapes.h"
+#include "WChartHistogram.h"
+#include "WChartFills.h"
+#include "../../../data/KlineStore.h"
+#include "../../../data/KlineRingSeries.h"
+#include "../../../data/KlineResampler.h"
+#include "../../../io/KlineCsvLoader.h"
+#include "../../../io/SharedSeries.h"
+#include "../../../utils/TimerLambda.h"
+#include "../../../utils/Animator.h"
 
 class WChartAxis;
 class WChartViewport;
 
-class WChart : public BaseComponent {
+class WChart : public BaseComponent, public FileDragAndDropTarget {
 public:
+	static constexpr double zoomDuration = 150.0; // ms
+
+	struct ZoomTransition {
+		Animator::Id animation = 0;
+		Range<double> target;
+	};
+
+	// x axis shared by the panes of a WChartManager : every pane reads and writes the x
+	// members of transform, one zoom transition runs for all and stack is repainted
+	// (once for every pane) when x moves
+	struct SharedX {
+		WChartScaleTransform transform;
+		ZoomTransition zoom;
+		Component* stack = nullptr;
+	};
+	// px from a shape under which the crosshair snaps to it
+	static constexpr float shapeHitDistance = 6.0f;
+
 	WChart();
 	~WChart();
 
 	void paint(Graphics& g) override;
+	void paintOverChildren(Graphics& g) override;
 	void resized() override;
+	// 1 .. 6 : timeframe presets, L : log / linear prices, G : OpenGL / software candles,
+	// V : volume profile, A : y autoscale
+	bool keyPressed(const KeyPress& key) override;
+	// drag : horizontal pan (the viewport shifts its previous frame)
+	void mouseDown(const MouseEvent& e) override;
+	void mouseDrag(const MouseEvent& e) override;
+	// wheel : time zoom around the mouse, snapped on the zoom presets and eased over zoomDuration ms
+	void mouseWheelMove(const MouseEvent& e, const MouseWheelDetails& wheel) override;
+	// crosshair : snapped to the shape within shapeHitDistance, to the nearest candle otherwise
+	void mouseMove(const MouseEvent& e) override;
+	void mouseExit(const MouseEvent& e) override;
+
+	void setStore(KlineStore::Ptr store);
+	const KlineStore::Ptr& getStore() const;
+	// the candles drawn : the store aggregated to the timeframe
+	const KlineStore::Ptr& getDisplayedStore() const;
+	// candles drawn from the store aggregated to period ms (KlineResampler), 0 for the store rows
+	void setTimeframe(int64 period);
+	int64 getTimeframe() const;
+	// y range of a pane without candles (RSI 0 .. 100...), setStore() sets it from the prices
+	void setValueRange(Range<double> range);
+	// open_time range [start, end) in view, the prices fitted to the candles inside it
+	void showTimeRange(int64 start, int64 end);
+	// null for the chart's own x axis, x outlives the chart
+	void setSharedX(SharedX* x);
+	// stacked panes only show the time axis under the last one
+	void setXAxisVisible(bool shouldBeVisible);
+	void setYAxisVisible(bool shouldBeVisible);
+	// see WChartViewport, mini charts draw on the message thread
+	void setBackgroundRenderingEnabled(bool shouldBeEnabled);
+	// tiles per zoom preset, see WChartViewport. T toggles it
+	void setTileCacheEnabled(bool shouldBeEnabled);
+	bool isTileCacheEnabled() const;
+	void setLogScale(bool shouldBeLog);
+	bool isLogScale() const;
+	// y fitted every frame to the candles and curves in view (WChartViewport::getVisibleValueRange),
+	// panning and zooming keep them filling the height. Off by default
+	void setAutoScale(bool shouldAutoScale);
+	bool isAutoScale() const { return _autoScale; }
+	void setOpenGLEnabled(bool shouldBeEnabled);
+	bool isOpenGLEnabled() const;
+	// line series over the candles (indicators...), values[i] at times->getOpenTime()[i].
+	// Owned by the chart, the pointer stays valid until removeCurve() / clearCurves()
+	WChartCurve* addCurve(KlineStore::Ptr times, SPtr<const std::vector<double>> values, const WChartCurve::Options& options = {});
+	// a curve evaluated over the visible range only, see FunctionSeries
+	WChartCurve* addCurve(FunctionSeries::Ptr function, const WChartCurve::Options& options = {});
+	void removeCurve(WChartCurve* curve);
+	void clearCurves();
+	// bars over the candles, see WChartHistogram. Owned by the chart like the curves
+	WChartHistogram* addHistogram(const WChartHistogram::Options& options = {});
+	void removeHistogram(WChartHistogram* histogram);
+	void clearHistograms();
+	// volume by price of the visible candles, at the right by default
+	void setVolumeProfileVisible(bool shouldBeVisible, const WChartHistogram::Options& options = {});
+	bool isVolumeProfileVisible() const;
+	// markers (fills, signals...), rects and paths in open_time x price
+	WChartShapes& getShapes();
+	// shape under the crosshair, invalidId when none
+	WChartShapes::Id getHoveredShape() const { return _hoveredShape; }
+	// order history fills (OrdersCsvLoader), clustered per zoom. Kept when another series loads
+	void setFills(FillClusters::Ptr fills);
+	WChartFills& getFills();
+	void setLiveSeries(KlineRingSeries::Ptr series);
+	const KlineRingSeries::Ptr& getLiveSeries() const;
+	// call when the live series changed (BinanceKlineFeed::onUpdated) : repaints the
+	// touched candles and the last price tag only
+	void updateLiveSeries();
+	// rows in view for the current frame, shared by every layer
+	const SeriesRange& getVisibleRange() const;
+
+	// DownloaderTool klines csv (parsed in the background), .klines file or shared series
+	void loadFile(const File& file);
+	// maps a channel written by SharedSeries.py and follows its updates
+	void openSharedSeries(const File& file);
+
+	bool isInterestedInFileDrag(const StringArray& files) override;
+	void filesDropped(const StringArray& files, int x, int y) override;
+
+	std::function<void(WChartShapes::Id)> onShapeHovered; // invalidId when the mouse leaves it
+	std::function<void(WChartShapes::Id)> onShapeClicked;
+	// fills under the crosshair (one or a cluster), nullptr when the mouse leaves them
+	std::function<void(const FillClusters::Cluster*)> onFillsHovered;
 
 private:
+	void _updateLiveMarker();
+	ZoomTransition& _getZoom();
+	void _cancelZoom();
+	Component& _getXRepaintTarget();
+	void _setCrosshair(bool visible, Point<float> position);
+	void _repaintCrosshair();
+	// the same series with more history before it, the times in view stay
+	void _extendHistory(KlineStore::Ptr store);
+	// _resampler->setSource(), leaving a shared resampler to the other windows
+	bool _setSource(KlineStore::Ptr store);
 
 	WChartScaleTransform _scaleT;
+	WChartLayerCache _background;
 	UPtr<WChartAxis> _xAxis;
 	UPtr<WChartAxis> _yAxis;
 	UPtr<WChartViewport> _viewport;
+	SPtr<KlineResampler> _resampler = std::make_shared<KlineResampler>(); // shared by the windows showing a file (Workspace)
+	int64 _timeframe = 0;
+	float _dragViewportStart = 0.0f;
+	ZoomTransition _ownZoom;
+	SharedX* _sharedX = nullptr;
+	bool _crosshairVisible = false;
+	Point<float> _crosshair; // viewport pixels
+	WChartShapes::Id _hoveredShape = WChartShapes::invalidId;
+	bool _fillsHovered = false;
+	bool _autoScale = false;
+	KlineCsvLoader _loader;
+	bool _showsPartial = false; // rows of the file being loaded are on screen
+	SharedSeries::Ptr _shared;
+	File _sourceFile; // derived data cached next to it (DerivedCache), none for partial or shared series
+	File _loadingFile;
+	TimerLambda _sharedPoll;
 };
 
 
@@ -10,11 +10,106 @@
 
 #include "WChartAxis.h"
 #include "WChartTransform.h"
+#include "../WLookAndFeel.h"
+#include "../../../utils/TextCache.h"
 
-WChartAxis::WChartAxis(WChartScaleTransform& scaleData) : _scaleData(scaleData) {
+WChartAxis::WChartAxis(WChartScaleTransform& scaleData, Orientation orientation)
+	: _scaleData(scaleData)
+	, _orientation(orientation)
+{
+	setInterceptsMouseClicks(false, false);
+}
 
+void WChartAxis::setTimeOrigin(int64 origin) {
+	if (origin == _timeOrigin)
+		return;
+	_timeOrigin = origin;
+	repaint();
 }
 
 void WChartAxis::paint(Graphics& g) {
-	g.fillAll(Colours::green);
+	WChartLayerCache::Key key;
+	key.width = getWidth();
+	key.height = getHeight();
+	if (_orientation == Orientation::horizontal) {
+		key.x = _scaleData.getXMapping(_timeOrigin, (float)getWidth());
+		_labels.draw(g, key, [this, &key](Graphics& lg) { _paintTimeLabels(lg, key.x); });
+	}
+	else {
+		key.y = _scaleData.withYMapper((float)getHeight(), [](const auto& m) { return m.mapping; });
+		key.yScale = _scaleData.yScale;
+		_labels.draw(g, key, [this](Graphics& lg) { _paintPriceLabels(lg); });
+		_paintMarker(g);
+	}
+}
+
+void WChartAxis::_paintTimeLabels(Graphics& g, const AxisMapping& xMap) {
+	const float w = (float)getWidth();
+	auto& text = TextCache::getInstance();
+	g.setColour(WLookAndFeel::axisTextColour);
+	for (const auto& tick : _ticks.getTimeTicks(xMap, w, minTickSpacing)) {
+		const float x = xMap.toPixel(tick.time);
+		if (x < -(float)minTickSpacing || x > w + (float)minTickSpacing)
+			continue;
+		g.drawVerticalLine(roundToInt(x), 0.0f, 4.0f);
+		text.draw(g, _font, tick.label, Rectangle<float>(x - minTickSpacing * 0.5f, 6.0f, (float)minTickSpacing, 16.0f), Justification::centredTop);
+	}
+}
+
+void WChartAxis::_paintPriceLabels(Graphics& g) {
+	const float h = (float)getHeight();
+	auto& text = TextCache::getInstance();
+	g.setColour(WLookAndFeel::axisTextColour);
+	_scaleData.withYMapper(h, [&](const auto& yMap) {
+		for (const auto& tick : _ticks.getPriceTicks(yMap, h, minPriceTickSpacing)) {
+			const float y = yMap.toPixel(tick.value);
+			if (y < -16.0f || y > h + 16.0f)
+				continue;
+			g.drawHorizontalLine(roundToInt(y), 0.0f, 4.0f);
+			text.draw(g, _font, tick.label, Rectangle<float>(6.0f, y - 8.0f, (float)getWidth() - 6.0f, 16.0f), Justification::centredLeft);
+		}
+	});
+}
+
+int WChartAxis::_getPriceDecimals() {
+	const float h = (float)getHeight();
+	_scaleData.withYMapper(h, [&](const auto& yMap) { _ticks.getPriceTicks(yMap, h, minPriceTickSpacing); });
+	return _ticks.getPriceDecimals();
+}
+
+void WChartAxis::setMarker(double value, Colour colour) {
+	if (_hasMarker && value == _markerValue && colour == _markerColour)
+		return;
+	if (_hasMarker)
+		repaint(_getMarkerBounds());
+	_hasMarker = true;
+	_markerValue = value;
+	_markerColour = colour;
+	repaint(_getMarkerBounds());
+}
+
+void WChartAxis::clearMarker() {
+	if (!_hasMarker)
+		return;
+	repaint(_getMarkerBounds());
+	_hasMarker = false;
+}
+
+Rectangle<int> WChartAxis::_getMarkerBounds() const {
+	const float y = _scaleData.withYMapper((float)getHeight(), [this](const auto& yMap) { return yMap.toPixel(_markerValue); });
+	return Rectangle<float>(0.0f, y - 9.0f, (float)getWidth(), 18.0f)
+		.getIntersection(getLocalBounds().toFloat())
+		.getSmallestIntegerContainer();
+}
+
+void WChartAxis::_paintMarker(Graphics& g) {
+	if (!_hasMarker)
+		return;
+	const auto bounds = _getMarkerBounds();
+	if (bounds.isEmpty())
+		return;
+	g.setColour(_markerColour);
+	g.fillRect(bounds);
+	g.setColour(Colours::white);
+	TextCache::getInstance().draw(g, _font, String(_markerValue, _getPriceDecimals()), bounds.withTrimmedLeft(6).toFloat(), Justification::centredLeft);
 }
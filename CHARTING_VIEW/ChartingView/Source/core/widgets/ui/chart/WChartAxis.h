@@ -10,17 +10,50 @@
 
 #pragma once
 #include "../BaseComponent.h"
+#include "WChartLayerCache.h"
+#include "WChartTicks.h"
 
 class WChartScaleTransform;
 
+// Tick labels of the time (horizontal) or price (vertical) axis, along the
+// viewport edge. Ticks come from a WChartTicks (regenerated on zoom only), the
+// labels are cached in an image until the axis mapping changes.
 class WChartAxis : public BaseComponent {
 public:
-	WChartAxis(WChartScaleTransform& scaleData);
+	enum class Orientation { horizontal, vertical };
+
+	WChartAxis(WChartScaleTransform& scaleData, Orientation orientation);
 
 	void paint(Graphics& g) override;
 
+	// open_time x units are relative to (first open_time of the drawn series)
+	void setTimeOrigin(int64 origin);
+	int64 getTimeOrigin() const { return _timeOrigin; }
+	Orientation getOrientation() const { return _orientation; }
+
+	// value tag over the labels of a vertical axis (last price of the live series),
+	// drawn every paint, only its old and new areas are repainted when it moves
+	void setMarker(double value, Colour colour);
+	void clearMarker();
+
+	static constexpr int minTickSpacing = 80;      // px between time ticks
+	static constexpr int minPriceTickSpacing = 40; // px between price ticks
+
 private:
+	void _paintTimeLabels(Graphics& g, const AxisMapping& xMap);
+	void _paintPriceLabels(Graphics& g);
+	void _paintMarker(Graphics& g);
+	Rectangle<int> _getMarkerBounds() const;
+	int _getPriceDecimals();
+
 	WChartScaleTransform& _scaleData;
+	Orientation _orientation;
+	int64 _timeOrigin = 0;
+	WChartLayerCache _labels;
+	WChartTicks _ticks;
+	Font _font{ 12.0f };
+	bool _hasMarker = false;
+	double _markerValue = 0.0;
+	Colour _markerColour;
 };
 
-
@@ -0,0 +1,380 @@
+/*
+  ==============================================================================
+
+    WChartCurve.cpp
+    Created: 14 Oct 2026 10:41:55pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "WChartCurve.h"
+
+static constexpr float breakX = std::numeric_limits<float>::quiet_NaN();
+
+static bool isBreak(const Point<float>& p) {
+	return std::isnan(p.x);
+}
+
+// position inside the pattern for x, anchored on the pixel of the series origin
+static float getPhase(float x, float originX, float period) {
+	const float p = std::fmod(x - originX, period);
+	return p < 0.0f ? p + period : p;
+}
+
+static Point<float> interpolate(const Point<float>& a, const Point<float>& b, float x) {
+	if (b.x == a.x)
+		return b;
+	return { x, a.y + (b.y - a.y) * (x - a.x) / (b.x - a.x) };
+}
+
+void WChartCurve::Scratch::Column::resize(size_t n) {
+	time.resize(n);
+	a.resize(n);
+	b.resize(n);
+	x.resize(n);
+	ya.resize(n);
+	yb.resize(n);
+}
+
+WChartCurve::WChartCurve(KlineStore::Ptr times, SPtr<const std::vector<double>> values, const Options& options)
+	: _options(options)
+{
+	setValues(std::move(times), std::move(values));
+}
+
+WChartCurve::WChartCurve(FunctionSeries::Ptr function, const Options& options)
+	: _options(options)
+{
+	setFunction(std::move(function));
+}
+
+void WChartCurve::_wrap(KlineStore::Ptr times, SPtr<const std::vector<double>> values) {
+	if (!times || !values) {
+		_store = nullptr;
+		return;
+	}
+	const size_t n = jmin(times->size(), values->size());
+	const void* columns[KlineStore::numColumns] = {};
+	columns[KlineStore::openTime] = times->getOpenTime();
+	for (auto c : { KlineStore::open, KlineStore::high, KlineStore::low, KlineStore::close })
+		columns[c] = values->data();
+	auto owner = std::make_shared<std::pair<KlineStore::Ptr, SPtr<const std::vector<double>>>>(std::move(times), std::move(values));
+	_store = KlineStore::wrapExternal(owner, columns, n);
+}
+
+Range<double> WChartCurve::getValueRange(int64 start, int64 end, double msPerSample) const {
+	if (_function != nullptr) {
+		if (end <= start)
+			return {};
+		// the samples of the frames at this scale, at most a few screens of them
+		const int64 step = FunctionSeries::getStep(jmax(msPerSample, (double)(end - start) / 16384.0));
+		const int64 first = (int64)std::floor((double)start / (double)step);
+		const int64 last = (int64)std::ceil((double)end / (double)step) + 1;
+		std::vector<double> values((size_t)(last - first));
+		_function->getSamples(step, first, last, values.data());
+		double low = std::numeric_limits<double>::max(), high = std::numeric_limits<double>::lowest();
+		for (double v : values) {
+			if (std::isnan(v))
+				continue;
+			low = jmin(low, v);
+			high = jmax(high, v);
+		}
+		return low <= high ? Range<double>(low, high) : Range<double>();
+	}
+	if (!_store)
+		return {};
+	return _lod.computePriceRange(_store->lowerBound(start), _store->lowerBound(end));
+}
+
+void WChartCurve::setValues(KlineStore::Ptr times, SPtr<const std::vector<double>> values, size_t fromRow) {
+	if (onChanging)
+		onChanging();
+	_function = nullptr;
+	_wrap(std::move(times), std::move(values));
+	if (_store)
+		_lod.update(*_store, fromRow);
+	else
+		_lod.clear();
+	if (onChanged)
+		onChanged();
+}
+
+void WChartCurve::setFunction(FunctionSeries::Ptr function) {
+	if (onChanging)
+		onChanging();
+	_function = std::move(function);
+	_store = nullptr;
+	_lod.clear();
+	if (onChanged)
+		onChanged();
+}
+
+void WChartCurve::setOptions(const Options& options) {
+	if (onChanging)
+		onChanging();
+	_options = options;
+	if (onChanged)
+		onChanged();
+}
+
+void WChartCurve::setLogPricesEnabled(bool shouldBeEnabled) {
+	if (shouldBeEnabled == _lod.isLogPricesEnabled())
+		return;
+	if (onChanging)
+		onChanging();
+	_lod.setLogPricesEnabled(shouldBeEnabled);
+}
+
+void WChartCurve::paint(Graphics& g, Scratch& s, const WChartScaleTransform& scaleT, int64 seriesOrigin, float width, float height, float x0, float x1) const {
+	if (!_hasData())
+		return;
+	_buildPolyline(s, scaleT, seriesOrigin, width, height, x0, x1);
+	if (s.points.empty())
+		return;
+
+	const float originX = scaleT.getXMapping(seriesOrigin, width).toPixel(seriesOrigin);
+	const auto& o = _options;
+	s.path.clear();
+	s.path.preallocateSpace((int)s.points.size() * 3 + 16);
+
+	if (o.style == Style::area || o.style == Style::fill) {
+		_addAreas(s, getFillBase(scaleT, height));
+		g.setColour(o.colour.withAlpha(o.fillAlpha));
+		g.fillPath(s.path);
+		s.path.clear();
+	}
+
+	if (o.style == Style::dot) {
+		_addDots(s, originX);
+		g.setColour(o.colour);
+		g.fillPath(s.path);
+		return;
+	}
+	if (o.style == Style::dashed)
+		_addDashes(s, originX);
+	else
+		_addLine(s);
+	g.setColour(o.colour);
+	g.strokePath(s.path, PathStrokeType(o.thickness));
+}
+
+const std::vector<Point<float>>& WChartCurve::getPolyline(Scratch& s, const WChartScaleTransform& scaleT, int64 seriesOrigin, float width, float height, float x0, float x1) const {
+	s.points.clear();
+	if (_hasData())
+		_buildPolyline(s, scaleT, seriesOrigin, width, height, x0, x1);
+	return s.points;
+}
+
+float WChartCurve::getFillBase(const WChartScaleTransform& scaleT, float height) const {
+	if (_options.style != Style::fill)
+		return scaleT.yDir == WChartScaleTransform::AxisDirection::top_to_bot ? 0.0f : height;
+	return scaleT.withYMapper(height, [&](const auto& yMap) { return yMap.toPixel(_options.baseline); });
+}
+
+void WChartCurve::_buildPolyline(Scratch& s, const WChartScaleTransform& scaleT, int64 seriesOrigin, float width, float height, float x0, float x1) const {
+	s.points.clear();
+	if (_function) {
+		_buildFunctionPolyline(s, scaleT, seriesOrigin, width, height, x0, x1);
+		return;
+	}
+	const auto xMap = scaleT.getXMapping(seriesOrigin, width);
+	const auto* times = _store->getOpenTime();
+	const size_t numRows = _store->size();
+	const int64 unit = numRows > 1 ? times[1] - times[0] : 1;
+
+	// one row past each side, the line enters and leaves the range
+	const double t0 = jmin(xMap.toValue(x0), xMap.toValue(x1));
+	const double t1 = jmax(xMap.toValue(x0), xMap.toValue(x1));
+	auto rows = _store->findRange((int64)std::floor(t0) - unit, (int64)std::ceil(t1));
+	rows.first = rows.first > 0 ? rows.first - 1 : 0;
+	rows.last = jmin((uint64)numRows, rows.last + 1);
+	if (rows.isEmpty())
+		return;
+
+	const auto visibleRows = (double)(xMap.toValue(width) - xMap.toValue(0.0f)) / (double)unit;
+	const int levelIndex = _lod.chooseLevel(scaleT.sampling.getMaxRowsPerBucket(std::abs(visibleRows), (double)width));
+	// on a log axis the stored levels give their log values, mapped linearly
+	const auto logLevel = scaleT.yScale == AxisScale::logarithmic ? _lod.getLogLevel(levelIndex) : LodPyramid::Level();
+	const bool logBuckets = logLevel.size > 0;
+	const auto level = logBuckets ? logLevel : _lod.getLevel(levelIndex);
+	const int shift = level.shift;
+	const uint64 firstBucket = rows.first >> shift;
+	const uint64 lastBucket = ((rows.last - 1) >> shift) + 1;
+	const size_t n = (size_t)(lastBucket - firstBucket);
+	const int64 bucketUnit = unit << shift;
+
+	// a bucket is a vertical from its extreme farthest from the last value to the nearest one
+	auto& c = s.column;
+	c.resize(n);
+	for (size_t i = 0; i < n; i++) {
+		const size_t b = (size_t)(firstBucket + i);
+		const auto k = level.getBucket(b);
+		c.time[i] = times[b << shift] + bucketUnit / 2;
+		const bool endsLow = k.close - k.low < k.high - k.close;
+		c.a[i] = endsLow ? k.high : k.low;
+		c.b[i] = endsLow ? k.low : k.high;
+	}
+	const auto frameX = xMap.withOrigin(c.time[0]);
+	frameX.toPixels(c.time.data(), c.x.data(), n);
+	scaleT.withYMapper(height, [&](const auto& yMap) {
+		if (logBuckets) {
+			yMap.forwardToPixels(c.a.data(), c.ya.data(), n);
+			yMap.forwardToPixels(c.b.data(), c.yb.data(), n);
+			return;
+		}
+		yMap.toPixels(c.a.data(), c.ya.data(), n);
+		yMap.toPixels(c.b.data(), c.yb.data(), n);
+	});
+
+	_addRuns(s, n);
+}
+
+void WChartCurve::_buildFunctionPolyline(Scratch& s, const WChartScaleTransform& scaleT, int64 seriesOrigin, float width, float height, float x0, float x1) const {
+	const auto xMap = scaleT.getXMapping(seriesOrigin, width);
+	const double t0 = jmin(xMap.toValue(x0), xMap.toValue(x1));
+	const double t1 = jmax(xMap.toValue(x0), xMap.toValue(x1));
+	// a function has no rows to show all of : None samples like Auto
+	const auto& sampling = scaleT.sampling;
+	const double numSamples = sampling.mode == SamplingMode::FixedDensity ? (double)sampling.maxPointsPerViewport
+		: (double)width * (double)sampling.maxPointsPerPixel;
+	const double msPerPixel = std::abs(xMap.toValue(1.0f) - xMap.toValue(0.0f));
+	const int64 step = FunctionSeries::getStep(msPerPixel * (double)width / jmax(1.0, numSamples));
+
+	// one sample past each side, the line enters and leaves the range
+	const int64 first = (int64)std::floor(t0 / (double)step) - 1;
+	const int64 last = (int64)std::ceil(t1 / (double)step) + 2;
+	if (last <= first)
+		return;
+	const size_t n = (size_t)(last - first);
+
+	// one point per sample : a and b are the same value
+	auto& c = s.column;
+	c.resize(n);
+	_function->getSamples(step, first, last, c.a.data());
+	for (size_t i = 0; i < n; i++)
+		c.time[i] = (first + (int64)i) * step;
+	const auto frameX = xMap.withOrigin(c.time[0]);
+	frameX.toPixels(c.time.data(), c.x.data(), n);
+	scaleT.withYMapper(height, [&](const auto& yMap) { yMap.toPixels(c.a.data(), c.ya.data(), n); });
+	std::copy(c.ya.begin(), c.ya.begin() + (std::ptrdiff_t)n, c.yb.begin());
+	_addRuns(s, n);
+}
+
+void WChartCurve::_addRuns(Scratch& s, size_t n) {
+	const auto& c = s.column;
+	auto& points = s.points;
+	points.reserve(n * 2 + 1);
+	bool broken = true;
+	for (size_t i = 0; i < n; i++) {
+		if (std::isnan(c.ya[i]) || std::isnan(c.yb[i])) {
+			if (!broken)
+				points.push_back({ breakX, 0.0f });
+			broken = true;
+			continue;
+		}
+		broken = false;
+		points.push_back({ c.x[i], c.ya[i] });
+		if (c.yb[i] != c.ya[i])
+			points.push_back({ c.x[i], c.yb[i] });
+	}
+	// points are in increasing x, a right to left axis is walked backwards
+	if (!points.empty() && points.front().x > points.back().x)
+		std::reverse(points.begin(), points.end());
+}
+
+void WChartCurve::_addLine(Scratch& s) {
+	bool start = true;
+	for (const auto& p : s.points) {
+		if (isBreak(p)) {
+			start = true;
+			continue;
+		}
+		if (start)
+			s.path.startNewSubPath(p);
+		else
+			s.path.lineTo(p);
+		start = false;
+	}
+}
+
+void WChartCurve::_addDashes(Scratch& s, float originX) const {
+	const auto& points = s.points;
+	auto& path = s.path;
+	const float dash = jmax(0.5f, _options.dash);
+	const float period = dash + jmax(0.5f, _options.gap);
+	bool drawing = false;
+	for (size_t i = 1; i < points.size(); i++) {
+		const auto a = points[i - 1];
+		const auto b = points[i];
+		if (isBreak(a) || isBreak(b)) {
+			drawing = false;
+			continue;
+		}
+		if (b.x == a.x) {
+			// vertical of a bucket, on or off as a whole
+			if (getPhase(a.x, originX, period) < dash) {
+				if (!drawing)
+					path.startNewSubPath(a);
+				path.lineTo(b);
+				drawing = true;
+			}
+			else {
+				drawing = false;
+			}
+			continue;
+		}
+		for (float x = a.x; x < b.x;) {
+			const float phase = getPhase(x, originX, period);
+			const bool on = phase < dash;
+			const float x1 = jmin(b.x, x + (on ? dash - phase : period - phase));
+			if (on) {
+				if (!drawing)
+					path.startNewSubPath(interpolate(a, b, x));
+				path.lineTo(interpolate(a, b, x1));
+			}
+			drawing = on && x1 < x + (dash - phase);
+			if (x1 <= x)
+				break;
+			x = x1;
+		}
+	}
+}
+
+void WChartCurve::_addDots(Scratch& s, float originX) const {
+	const auto& points = s.points;
+	auto& path = s.path;
+	const float period = jmax(1.0f, _options.gap + _options.thickness);
+	const float size = jmax(1.0f, _options.thickness * 1.5f);
+	for (size_t i = 1; i < points.size(); i++) {
+		const auto a = points[i - 1];
+		const auto b = points[i];
+		if (isBreak(a) || isBreak(b) || b.x == a.x)
+			continue;
+		// dots on the multiples of the period inside [a.x, b.x)
+		const float phase = getPhase(a.x, originX, period);
+		for (float x = phase == 0.0f ? a.x : a.x + period - phase; x < b.x; x += period) {
+			const auto p = interpolate(a, b, x);
+			path.addRectangle(p.x - size * 0.5f, p.y - size * 0.5f, size, size);
+		}
+	}
+}
+
+void WChartCurve::_addAreas(Scratch& s, float baseY) {
+	const auto& points = s.points;
+	auto& path = s.path;
+	// one closed polygon per run, down to baseY
+	size_t first = 0;
+	for (size_t i = 0; i <= points.size(); i++) {
+		if (i < points.size() && !isBreak(points[i]))
+			continue;
+		if (i > first) {
+			path.startNewSubPath(points[first].x, baseY);
+			for (size_t j = first; j < i; j++)
+				path.lineTo(points[j]);
+			path.lineTo(points[i - 1].x, baseY);
+			path.closeSubPath();
+		}
+		first = i + 1;
+	}
+}
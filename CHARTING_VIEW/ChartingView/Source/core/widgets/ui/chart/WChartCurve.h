@@ -0,0 +1,123 @@
+/*
+  ==============================================================================
+
+    WChartCurve.h
+    Created: 14 Oct 2026 10:41:55pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+#include "WChartTransform.h"
+#include "../../../data/KlineStore.h"
+#include "../../../data/LodPyramid.h"
+#include "../../../data/FunctionSeries.h"
+
+/*
+	A line series drawn over the candles (indicators...) : values[i] is at
+	the open_time of row i of a kline store.
+
+	The values are wrapped as a price only store (open = high = low = close)
+	so the candles' LodPyramid decimates them : a curve of 1M points costs a
+	couple of vertices per visible pixel column (the min / max envelope of
+	each bucket, ordered toward the last value).
+
+	Each frame builds one polyline in pixel space into a Scratch kept between
+	frames by the caller, dashes and dots are cut from it directly. A curve is
+	painted by the message thread, the render thread and the tile worker at the
+	same time, each with its own Scratch (the curve itself is only read). They follow x (not the
+	length along the curve), so strips rendered separately while panning join.
+	NaN values (indicator warm-up) break the line.
+
+	A curve can be given by a FunctionSeries instead : it has no rows, each
+	frame samples the function at about one point per pixel column over the
+	visible range only (FunctionSeries::getStep(msPerPixel)), from its cache.
+*/
+
+class WChartCurve {
+public:
+	enum class Style {
+		line,
+		dashed,
+		dot,
+		area,   // filled down to the bottom of the viewport
+		fill    // filled down to Options::baseline
+	};
+
+	// per frame storage of one painting thread, kept between its frames
+	struct Scratch {
+		struct Column {
+			std::vector<int64> time;
+			std::vector<double> a, b;
+			std::vector<float> x, ya, yb;
+
+			void resize(size_t n);
+		};
+		Column column;
+		std::vector<Point<float>> points; // NaN x starts a new run
+		Path path;
+	};
+
+	struct Options {
+		Style style = Style::line;
+		Colour colour = Colours::orange;
+		float thickness = 1.5f;
+		float dash = 6.0f;       // px, dashed only
+		float gap = 4.0f;        // px between dashes / dots
+		float fillAlpha = 0.2f;  // area / fill
+		double baseline = 0.0;   // fill
+	};
+
+	// times keeps the open_time column alive, values[i] is at times->getOpenTime()[i]
+	WChartCurve(KlineStore::Ptr times, SPtr<const std::vector<double>> values, const Options& options = {});
+	WChartCurve(FunctionSeries::Ptr function, const Options& options = {});
+
+	// new rows (or a rewritten tail), the pyramid is updated from fromRow on
+	void setValues(KlineStore::Ptr times, SPtr<const std::vector<double>> values, size_t fromRow = 0);
+	// replaces the values by a function (or the function by another one, or the same one invalidated)
+	void setFunction(FunctionSeries::Ptr function);
+	const FunctionSeries::Ptr& getFunction() const { return _function; }
+	const Options& getOptions() const { return _options; }
+	void setOptions(const Options& options);
+	size_t size() const { return _store ? _store->size() : 0; }
+	// keeps the log of the decimated values for a log price axis (LodPyramid::setLogPricesEnabled)
+	void setLogPricesEnabled(bool shouldBeEnabled);
+	bool isLogPricesEnabled() const { return _lod.isLogPricesEnabled(); }
+
+	// draws the part of the curve inside the x range [x0, x1] (pixels) of a viewport of that size
+	void paint(Graphics& g, Scratch& scratch, const WChartScaleTransform& scaleT, int64 seriesOrigin, float width, float height, float x0, float x1) const;
+	// the polyline paint() would draw, in pixels and increasing x, NaN x points break it.
+	// In scratch until its next use, for another renderer (WChartGLRenderer)
+	const std::vector<Point<float>>& getPolyline(Scratch& scratch, const WChartScaleTransform& scaleT, int64 seriesOrigin, float width, float height, float x0, float x1) const;
+	// y (pixels) an area / fill goes down to
+	float getFillBase(const WChartScaleTransform& scaleT, float height) const;
+	// lowest and highest value at open_times [start, end) from the pyramid, O(log n). A
+	// function is sampled every msPerSample like a frame (mostly read from its cache).
+	// Empty for NaN values only
+	Range<double> getValueRange(int64 start, int64 end, double msPerSample) const;
+
+	// called before / after the values or the options change (only before for the log prices,
+	// the drawing stays the same)
+	std::function<void()> onChanging;
+	std::function<void()> onChanged;
+
+private:
+	void _wrap(KlineStore::Ptr times, SPtr<const std::vector<double>> values);
+	bool _hasData() const { return _function != nullptr || (_store && _store->size() > 0); }
+	void _buildPolyline(Scratch& s, const WChartScaleTransform& scaleT, int64 seriesOrigin, float width, float height, float x0, float x1) const;
+	void _buildFunctionPolyline(Scratch& s, const WChartScaleTransform& scaleT, int64 seriesOrigin, float width, float height, float x0, float x1) const;
+	static void _addRuns(Scratch& s, size_t n);
+	static void _addLine(Scratch& s);
+	void _addDashes(Scratch& s, float originX) const;
+	void _addDots(Scratch& s, float originX) const;
+	static void _addAreas(Scratch& s, float baseY);
+
+	Options _options;
+	KlineStore::Ptr _store;
+	LodPyramid _lod;
+	FunctionSeries::Ptr _function;
+
+	JUCE_DECLARE_NON_COPYABLE(WChartCurve)
+};
@@ -0,0 +1,96 @@
+/*
+  ==============================================================================
+
+    WChartFills.cpp
+    Created: 16 Oct 2026 5:10:44pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "WChartFills.h"
+#include "../../../utils/TextCache.h"
+
+WChartFills::WChartFills(const Options& options) : _options(options) {
+}
+
+void WChartFills::setFills(FillClusters::Ptr fills) {
+	_fills = std::move(fills);
+	_visible.clear();
+	_centers.clear();
+	if (onChanged)
+		onChanged();
+}
+
+void WChartFills::setOptions(const Options& options) {
+	_options = options;
+	if (onChanged)
+		onChanged();
+}
+
+float WChartFills::_getSize(const FillClusters::Cluster& c) const {
+	if (c.isSingle())
+		return _options.markerSize;
+	// area proportional to the count
+	return jmin(_options.maxClusterSize, _options.markerSize * std::sqrt((float)c.count));
+}
+
+void WChartFills::paint(Graphics& g, const WChartScaleTransform& scaleT, int64 seriesOrigin, float width, float height) {
+	_visible.clear();
+	_centers.clear();
+	if (!_fills || _fills->size() == 0)
+		return;
+	const auto xMap = scaleT.getXMapping(seriesOrigin, width);
+	const double ta = xMap.toValue(0.0f);
+	const double tb = xMap.toValue(width);
+	// half a cluster past each side, the markers cut by the edges are drawn
+	const double margin = std::abs(tb - ta) / jmax(1.0, (double)width) * (double)_options.maxClusterSize * 0.5;
+	const double bucketMs = std::abs(tb - ta) / jmax(1.0, (double)width) * (double)_options.clusterWidth;
+	_fills->query((int64)std::floor(jmin(ta, tb) - margin), (int64)std::ceil(jmax(ta, tb) + margin), bucketMs, _visible);
+	if (_visible.empty())
+		return;
+
+	_centers.resize(_visible.size());
+	scaleT.withYMapper(height, [&](const auto& yMap) {
+		for (size_t i = 0; i < _visible.size(); i++)
+			_centers[i] = { xMap.toPixel(_visible[i].time), yMap.toPixel(_visible[i].price) };
+	});
+
+	const auto font = Font(10.0f);
+	auto& text = TextCache::getInstance();
+	for (size_t i = 0; i < _visible.size(); i++) {
+		const auto& c = _visible[i];
+		const auto p = _centers[i];
+		const float size = _getSize(c);
+		const float half = size * 0.5f;
+		const auto colour = (c.netQty >= 0.0 ? _options.buyColour : _options.sellColour).withMultipliedAlpha(_options.alpha);
+		g.setColour(colour);
+		if (c.isSingle()) {
+			const float dir = c.netQty >= 0.0 ? 1.0f : -1.0f;
+			_path.clear();
+			_path.addTriangle(p.x, p.y - half * dir, p.x + half, p.y + half * dir, p.x - half, p.y + half * dir);
+			g.fillPath(_path);
+			continue;
+		}
+		const auto bounds = Rectangle<float>(size, size).withCentre(p);
+		g.fillEllipse(bounds);
+		g.setColour(colour.brighter(0.5f).withAlpha(1.0f));
+		g.drawEllipse(bounds, 1.0f);
+		const String count(c.count);
+		if (text.getNumberWidth(font, count) <= size - 2.0f)
+			text.draw(g, font, count, bounds, Justification::centred);
+	}
+}
+
+bool WChartFills::hitTest(Point<float> p, float maxDistance, FillClusters::Cluster& hit) const {
+	float best = std::numeric_limits<float>::max();
+	for (size_t i = 0; i < _visible.size(); i++) {
+		// 0 inside the marker
+		const float d = jmax(0.0f, _centers[i].getDistanceFrom(p) - _getSize(_visible[i]) * 0.5f);
+		if (d <= maxDistance && d < best) {
+			best = d;
+			hit = _visible[i];
+		}
+	}
+	return best <= maxDistance;
+}
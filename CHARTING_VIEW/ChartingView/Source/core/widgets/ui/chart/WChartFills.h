@@ -0,0 +1,70 @@
+/*
+  ==============================================================================
+
+    WChartFills.h
+    Created: 16 Oct 2026 5:10:44pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+#include "WChartTransform.h"
+#include "../../../data/FillClusters.h"
+
+/*
+	The fills of an order history over the candles. Each frame takes the
+	visible clusters of a FillClusters about one per clusterWidth pixels :
+	zoomed out, the fills of a bucket are one circle at their average price,
+	its area growing with the count, green when the bucket bought more than
+	it sold, its count written inside when it fits. Zoomed in, a bucket with
+	a single fill is its own triangle in the direction of the fill.
+
+	Not part of the data layer (the clusters change with the zoom), painted
+	over it every frame like the histograms : a few hundred markers at most,
+	the query costs a binary search.
+
+		chart.setFills(std::make_shared<FillClusters>(OrdersCsvLoader::parseFile(file, "BTCUSDT")));
+
+	hitTest() gives the cluster under the mouse (count, net quantity, PnL)
+	for a tooltip. Message thread.
+*/
+
+class WChartFills {
+public:
+	struct Options {
+		Colour buyColour = Colour(0xff26a69a);
+		Colour sellColour = Colour(0xffef5350);
+		float clusterWidth = 16.0f;  // px per bucket
+		float markerSize = 9.0f;     // px, a single fill
+		float maxClusterSize = 28.0f;
+		float alpha = 0.75f;
+	};
+
+	explicit WChartFills(const Options& options = {});
+
+	void setFills(FillClusters::Ptr fills);
+	const FillClusters::Ptr& getFills() const { return _fills; }
+	const Options& getOptions() const { return _options; }
+	void setOptions(const Options& options);
+
+	void paint(Graphics& g, const WChartScaleTransform& scaleT, int64 seriesOrigin, float width, float height);
+	// cluster of the last paint within maxDistance px of p
+	bool hitTest(Point<float> p, float maxDistance, FillClusters::Cluster& hit) const;
+
+	// called after the fills or the options change
+	std::function<void()> onChanged;
+
+private:
+	float _getSize(const FillClusters::Cluster& c) const;
+
+	Options _options;
+	FillClusters::Ptr _fills;
+	// last paint
+	std::vector<FillClusters::Cluster> _visible;
+	std::vector<Point<float>> _centers;
+	Path _path;
+
+	JUCE_DECLARE_NON_COPYABLE(WChartFills)
+};
@@ -0,0 +1,770 @@
+/*
+  ==============================================================================
+
+    WChartGLRenderer.cpp
+    Created: 14 Oct 2026 8:10:33pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "WChartGLRenderer.h"
+#include "../WLookAndFeel.h"
+#include "../../../Workspace.h"
+
+using namespace juce::gl;
+
+// one candle = a wick quad (part 0) and a body quad (part 1) : corner x in [-0.5, 0.5], y in [0, 1]
+static const float candleMesh[] = {
+	-0.5f, 0.0f, 0.0f,   0.5f, 0.0f, 0.0f,   0.5f, 1.0f, 0.0f,
+	-0.5f, 0.0f, 0.0f,   0.5f, 1.0f, 0.0f,  -0.5f, 1.0f, 0.0f,
+	-0.5f, 0.0f, 1.0f,   0.5f, 0.0f, 1.0f,   0.5f, 1.0f, 1.0f,
+	-0.5f, 0.0f, 1.0f,   0.5f, 1.0f, 1.0f,  -0.5f, 1.0f, 1.0f,
+};
+static constexpr int verticesPerCandle = 12;
+
+static const char* vertexShader = R"(
+	attribute vec3 corner;
+	attribute float time;
+	attribute vec4 ohlc;
+
+	uniform vec2 xMap;
+	uniform float xOrigin;
+	uniform vec2 yMap;
+	uniform float logScale;
+	uniform vec2 viewportSize;
+	uniform vec2 widths;
+	uniform vec4 upColour;
+	uniform vec4 downColour;
+
+	varying vec4 colour;
+
+	float toY(float price) {
+		float v = logScale > 0.5 ? log(max(price, 1e-30)) : price;
+		return v * yMap.x + yMap.y;
+	}
+
+	void main() {
+		float x = (time - xOrigin + 0.5) * xMap.x + xMap.y;
+		float top;
+		float bottom;
+		float width;
+		if (corner.z < 0.5) {
+			top = toY(ohlc.y);
+			bottom = toY(ohlc.z);
+			width = widths.y;
+		}
+		else {
+			top = toY(ohlc.x);
+			bottom = toY(ohlc.w);
+			width = widths.x;
+			if (abs(bottom - top) < 1.0)
+				bottom = top + 1.0;
+		}
+		vec2 p = vec2(x + corner.x * width, mix(top, bottom, corner.y));
+		gl_Position = vec4(p.x / viewportSize.x * 2.0 - 1.0, 1.0 - p.y / viewportSize.y * 2.0, 0.0, 1.0);
+		colour = ohlc.w >= ohlc.x ? upColour : downColour;
+	}
+)";
+
+static const char* fragmentShader = R"(
+	varying vec4 colour;
+
+	void main() {
+		gl_FragColor = colour;
+	}
+)";
+
+// viewport quad of the histograms, pixel is in component pixels from the top left
+static const float quadMesh[] = { -1.0f, -1.0f,   1.0f, -1.0f,   -1.0f, 1.0f,   1.0f, 1.0f };
+
+static const char* barsVertexShader = R"(
+	attribute vec2 position;
+
+	uniform vec2 viewportSize;
+
+	varying vec2 pixel;
+
+	void main() {
+		pixel = vec2(position.x * 0.5 + 0.5, 0.5 - position.y * 0.5) * viewportSize;
+		gl_Position = vec4(position, 0.0, 1.0);
+	}
+)";
+
+// params : along x, anchored right, extent, number of texels
+static const char* barsFragmentShader = R"(
+	varying vec2 pixel;
+
+	uniform vec2 viewportSize;
+	uniform vec4 params;
+	uniform vec4 colour;
+	uniform vec4 secondColour;
+	uniform sampler2D bars;
+
+	void main() {
+		bool alongX = params.x > 0.5;
+		float along = alongX ? pixel.x : pixel.y;
+		float across = alongX ? viewportSize.y - pixel.y : (params.y > 0.5 ? viewportSize.x - pixel.x : pixel.x);
+		float size = (alongX ? viewportSize.y : viewportSize.x) * params.z;
+		vec2 v = texture2D(bars, vec2((floor(along) + 0.5) / params.w, 0.5)).rg * size;
+		if (across < v.x)
+			gl_FragColor = colour;
+		else if (across < v.x + v.y)
+			gl_FragColor = secondColour;
+		else
+			discard;
+	}
+)";
+
+// one segment : corner x along it in [0, 1], y across in [-1, 1]
+static const float lineMesh[] = {
+	0.0f, -1.0f,   1.0f, -1.0f,   1.0f, 1.0f,
+	0.0f, -1.0f,   1.0f, 1.0f,    0.0f, 1.0f,
+};
+// one rect or marker : corner in [-1, 1]^2
+static const float shapeMesh[] = {
+	-1.0f, -1.0f,   1.0f, -1.0f,   1.0f, 1.0f,
+	-1.0f, -1.0f,   1.0f, 1.0f,   -1.0f, 1.0f,
+};
+static constexpr int verticesPerQuad = 6;
+
+// the quad of a segment covers its capsule of halfWidth plus a pixel of antialiasing
+static const char* lineVertexShader = R"(
+	attribute vec2 corner;
+	attribute vec4 segment;
+	attribute float arc;
+
+	uniform vec2 viewportSize;
+	uniform float halfWidth;
+
+	varying vec2 local;
+	varying float segmentLength;
+	varying float arcStart;
+
+	void main() {
+		vec2 d = segment.zw - segment.xy;
+		float l = length(d);
+		vec2 dir = l > 0.0 ? d / l : vec2(1.0, 0.0);
+		vec2 normal = vec2(-dir.y, dir.x);
+		float e = halfWidth + 1.0;
+		local = vec2(mix(-e, l + e, corner.x), corner.y * e);
+		segmentLength = l;
+		arcStart = arc;
+		vec2 p = segment.xy + dir * local.x + normal * local.y;
+		gl_Position = vec4(p.x / viewportSize.x * 2.0 - 1.0, 1.0 - p.y / viewportSize.y * 2.0, 0.0, 1.0);
+	}
+)";
+
+// pattern : solid / dashed / dotted, half width of the line, dash, period
+static const char* lineFragmentShader = R"(
+	varying vec2 local;
+	varying float segmentLength;
+	varying float arcStart;
+
+	uniform vec4 pattern;
+	uniform vec4 colour;
+
+	void main() {
+		float along = clamp(local.x, 0.0, segmentLength);
+		float coverage;
+		if (pattern.x > 1.5) {
+			// round dots of the pattern width centred on the multiples of the period
+			float a = arcStart + local.x;
+			float k = a - pattern.w * floor(a / pattern.w + 0.5);
+			coverage = clamp(pattern.y + 0.5 - length(vec2(k, local.y)), 0.0, 1.0);
+		}
+		else {
+			coverage = clamp(pattern.y + 0.5 - length(vec2(local.x - along, local.y)), 0.0, 1.0);
+			if (pattern.x > 0.5) {
+				float phase = mod(arcStart + along, pattern.w);
+				coverage *= clamp(min(phase, pattern.z - phase) + 0.5, 0.0, 1.0);
+			}
+		}
+		if (coverage <= 0.0)
+			discard;
+		gl_FragColor = vec4(colour.rgb, colour.a * coverage);
+	}
+)";
+
+static const char* fillVertexShader = R"(
+	attribute vec2 position;
+
+	uniform vec2 viewportSize;
+
+	void main() {
+		gl_Position = vec4(position.x / viewportSize.x * 2.0 - 1.0, 1.0 - position.y / viewportSize.y * 2.0, 0.0, 1.0);
+	}
+)";
+
+static const char* fillFragmentShader = R"(
+	uniform vec4 colour;
+
+	void main() {
+		gl_FragColor = colour;
+	}
+)";
+
+// bounds : center, half size. style : type (circle, triangle up, down, rect), thickness (0 filled)
+static const char* shapeVertexShader = R"(
+	attribute vec2 corner;
+	attribute vec4 bounds;
+	attribute vec2 style;
+	attribute vec4 shapeColour;
+
+	uniform vec2 viewportSize;
+
+	varying vec2 local;
+	varying vec2 halfSize;
+	varying vec2 params;
+	varying vec4 colour;
+
+	void main() {
+		vec2 e = bounds.zw + style.y + 1.0;
+		local = corner * e;
+		halfSize = bounds.zw;
+		params = style;
+		colour = shapeColour;
+		vec2 p = bounds.xy + local;
+		gl_Position = vec4(p.x / viewportSize.x * 2.0 - 1.0, 1.0 - p.y / viewportSize.y * 2.0, 0.0, 1.0);
+	}
+)";
+
+static const char* shapeFragmentShader = R"(
+	varying vec2 local;
+	varying vec2 halfSize;
+	varying vec2 params;
+	varying vec4 colour;
+
+	float boxDistance(vec2 p, vec2 b) {
+		vec2 q = abs(p) - b;
+		return length(max(q, 0.0)) + min(max(q.x, q.y), 0.0);
+	}
+
+	// signed distance to a triangle, negative inside
+	float triangleDistance(vec2 p, vec2 p0, vec2 p1, vec2 p2) {
+		vec2 e0 = p1 - p0;
+		vec2 e1 = p2 - p1;
+		vec2 e2 = p0 - p2;
+		vec2 v0 = p - p0;
+		vec2 v1 = p - p1;
+		vec2 v2 = p - p2;
+		vec2 q0 = v0 - e0 * clamp(dot(v0, e0) / dot(e0, e0), 0.0, 1.0);
+		vec2 q1 = v1 - e1 * clamp(dot(v1, e1) / dot(e1, e1), 0.0, 1.0);
+		vec2 q2 = v2 - e2 * clamp(dot(v2, e2) / dot(e2, e2), 0.0, 1.0);
+		float s = sign(e0.x * e2.y - e0.y * e2.x);
+		vec2 d = min(min(vec2(dot(q0, q0), s * (v0.x * e0.y - v0.y * e0.x)),
+		                 vec2(dot(q1, q1), s * (v1.x * e1.y - v1.y * e1.x))),
+		                 vec2(dot(q2, q2), s * (v2.x * e2.y - v2.y * e2.x)));
+		return -sqrt(d.x) * sign(d.y);
+	}
+
+	void main() {
+		float type = params.x;
+		float thickness = params.y;
+		float d;
+		if (type < 0.5) {
+			d = length(local) - halfSize.x;
+		}
+		else if (type < 2.5) {
+			// y down : an up triangle has its apex at -h
+			float h = halfSize.x * (type < 1.5 ? 1.0 : -1.0);
+			d = triangleDistance(local, vec2(0.0, -h), vec2(halfSize.x, h), vec2(-halfSize.x, h));
+		}
+		else {
+			d = boxDistance(local, halfSize);
+		}
+		// stroked : rects inside their bounds like Graphics::drawRect, markers centred on the outline
+		if (thickness > 0.0)
+			d = type > 2.5 ? abs(d + thickness * 0.5) - thickness * 0.5 : abs(d) - thickness * 0.5;
+		float coverage = clamp(0.5 - d, 0.0, 1.0);
+		if (coverage <= 0.0)
+			discard;
+		gl_FragColor = vec4(colour.rgb, colour.a * coverage);
+	}
+)";
+
+void WChartGLRenderer::Frame::addLine(const Point<float>* points, size_t n, const LineStyle& lineStyle, float originX) {
+	Batch batch;
+	batch.kind = Batch::Kind::lines;
+	batch.first = segments.size() / floatsPerSegment;
+	batch.style = lineStyle;
+	float arc = 0.0f;
+	bool start = true;
+	for (size_t i = 1; i < n; i++) {
+		const auto a = points[i - 1];
+		const auto b = points[i];
+		if (std::isnan(a.x) || std::isnan(b.x)) {
+			start = true;
+			continue;
+		}
+		// a run starts at its x from the origin, the length is added from there
+		if (start)
+			arc = a.x - originX;
+		start = false;
+		for (float v : { a.x, a.y, b.x, b.y, arc })
+			segments.push_back(v);
+		arc += a.getDistanceFrom(b);
+	}
+	batch.count = segments.size() / floatsPerSegment - batch.first;
+	if (batch.count > 0)
+		batches.push_back(batch);
+}
+
+void WChartGLRenderer::Frame::addFill(const Point<float>* points, size_t n, float baseY, Colour colour) {
+	size_t first = 0;
+	for (size_t i = 0; i <= n; i++) {
+		if (i < n && !std::isnan(points[i].x))
+			continue;
+		if (i > first + 1) {
+			Batch batch;
+			batch.kind = Batch::Kind::fill;
+			batch.first = strips.size() / 2;
+			batch.count = (i - first) * 2;
+			batch.style.colour = colour;
+			for (size_t j = first; j < i; j++)
+				for (float v : { points[j].x, points[j].y, points[j].x, baseY })
+					strips.push_back(v);
+			batches.push_back(batch);
+		}
+		first = i + 1;
+	}
+}
+
+void WChartGLRenderer::Frame::addShape(Shape type, Rectangle<float> bounds, float thickness, Colour colour) {
+	// consecutive shapes share one instanced call
+	if (batches.empty() || batches.back().kind != Batch::Kind::shapes) {
+		Batch batch;
+		batch.kind = Batch::Kind::shapes;
+		batch.first = shapes.size() / floatsPerShape;
+		batches.push_back(batch);
+	}
+	const auto c = bounds.getCentre();
+	for (float v : { c.x, c.y, bounds.getWidth() * 0.5f, bounds.getHeight() * 0.5f, (float)type, thickness,
+		colour.getFloatRed(), colour.getFloatGreen(), colour.getFloatBlue(), colour.getFloatAlpha() })
+		shapes.push_back(v);
+	batches.back().count++;
+}
+
+WChartGLRenderer::WChartGLRenderer(Component& target) {
+	_context.setOpenGLVersionRequired(OpenGLContext::openGL3_2);
+	_context.setRenderer(this);
+	_context.setComponentPaintingEnabled(true);
+	_context.setContinuousRepainting(false);
+	// in the share group of the other windows' contexts
+	if (auto* shared = Workspace::getInstance().getNativeSharedContext())
+		_context.setNativeSharedContext(shared);
+	_context.attachTo(target);
+}
+
+WChartGLRenderer::~WChartGLRenderer() {
+	_context.detach();
+}
+
+void WChartGLRenderer::setFrame(Frame frame) {
+	{
+		const ScopedLock l(_lock);
+		_frame = std::move(frame);
+	}
+	_context.triggerRepaint();
+}
+
+void WChartGLRenderer::clearFrame() {
+	setFrame({});
+}
+
+void WChartGLRenderer::writeStore(const std::function<void()>& write) {
+	const ScopedLock l(_storeLock);
+	write();
+}
+
+void WChartGLRenderer::newOpenGLContextCreated() {
+	Workspace::getInstance().addGLContext(&_context);
+	auto shader = std::make_unique<OpenGLShaderProgram>(_context);
+	if (!shader->addVertexShader(OpenGLHelpers::translateVertexShaderToV3(vertexShader))
+		|| !shader->addFragmentShader(OpenGLHelpers::translateFragmentShaderToV3(fragmentShader))
+		|| !shader->link()) {
+		DBG("WChartGLRenderer: " << shader->getLastError());
+		return;
+	}
+	_shader = std::move(shader);
+	auto uniform = [this](const char* name) { return std::make_unique<OpenGLShaderProgram::Uniform>(*_shader, name); };
+	_xMap = uniform("xMap");
+	_xOrigin = uniform("xOrigin");
+	_yMap = uniform("yMap");
+	_logScale = uniform("logScale");
+	_viewportSize = uniform("viewportSize");
+	_widths = uniform("widths");
+	_upColour = uniform("upColour");
+	_downColour = uniform("downColour");
+	_cornerAttrib = glGetAttribLocation(_shader->getProgramID(), "corner");
+	_timeAttrib = glGetAttribLocation(_shader->getProgramID(), "time");
+	_ohlcAttrib = glGetAttribLocation(_shader->getProgramID(), "ohlc");
+
+	glGenVertexArrays(1, &_vao);
+	glBindVertexArray(_vao);
+
+	glGenBuffers(1, &_meshBuffer);
+	glBindBuffer(GL_ARRAY_BUFFER, _meshBuffer);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(candleMesh), candleMesh, GL_STATIC_DRAW);
+	glEnableVertexAttribArray((GLuint)_cornerAttrib);
+	glVertexAttribPointer((GLuint)_cornerAttrib, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), nullptr);
+
+	// per candle attributes, the pointers are set per frame from the first visible row
+	glGenBuffers(1, &_instanceBuffer);
+	glBindBuffer(GL_ARRAY_BUFFER, _instanceBuffer);
+	glEnableVertexAttribArray((GLuint)_timeAttrib);
+	glVertexAttribDivisor((GLuint)_timeAttrib, 1);
+	glEnableVertexAttribArray((GLuint)_ohlcAttrib);
+	glVertexAttribDivisor((GLuint)_ohlcAttrib, 1);
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	_createHistogramShader();
+	_createOverlayShaders();
+}
+
+static UPtr<OpenGLShaderProgram> createProgram(OpenGLContext& context, const char* vertex, const char* fragment) {
+	auto shader = std::make_unique<OpenGLShaderProgram>(context);
+	if (!shader->addVertexShader(OpenGLHelpers::translateVertexShaderToV3(vertex))
+		|| !shader->addFragmentShader(OpenGLHelpers::translateFragmentShaderToV3(fragment))
+		|| !shader->link()) {
+		DBG("WChartGLRenderer: " << shader->getLastError());
+		return nullptr;
+	}
+	return shader;
+}
+
+// a static mesh on attrib and per instance attributes, their pointers set per batch
+static void createInstancedVao(unsigned int& vao, unsigned int& meshBuffer, unsigned int& instanceBuffer, const float* mesh, size_t meshBytes,
+	GLint cornerAttrib, std::initializer_list<GLint> instanceAttribs) {
+	glGenVertexArrays(1, &vao);
+	glBindVertexArray(vao);
+	glGenBuffers(1, &meshBuffer);
+	glBindBuffer(GL_ARRAY_BUFFER, meshBuffer);
+	glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)meshBytes, mesh, GL_STATIC_DRAW);
+	glEnableVertexAttribArray((GLuint)cornerAttrib);
+	glVertexAttribPointer((GLuint)cornerAttrib, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), nullptr);
+	glGenBuffers(1, &instanceBuffer);
+	glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+	for (auto a : instanceAttribs) {
+		glEnableVertexAttribArray((GLuint)a);
+		glVertexAttribDivisor((GLuint)a, 1);
+	}
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+bool WChartGLRenderer::_createOverlayShaders() {
+	_lineShader = createProgram(_context, lineVertexShader, lineFragmentShader);
+	_fillShader = createProgram(_context, fillVertexShader, fillFragmentShader);
+	_shapeShader = createProgram(_context, shapeVertexShader, shapeFragmentShader);
+	if (_lineShader == nullptr || _fillShader == nullptr || _shapeShader == nullptr) {
+		for (auto* shader : { &_lineShader, &_fillShader, &_shapeShader })
+			shader->reset();
+		return false;
+	}
+	auto uniform = [](OpenGLShaderProgram& shader, const char* name) { return std::make_unique<OpenGLShaderProgram::Uniform>(shader, name); };
+	_lineViewportSize = uniform(*_lineShader, "viewportSize");
+	_lineHalfWidth = uniform(*_lineShader, "halfWidth");
+	_linePattern = uniform(*_lineShader, "pattern");
+	_lineColour = uniform(*_lineShader, "colour");
+	_fillViewportSize = uniform(*_fillShader, "viewportSize");
+	_fillColour = uniform(*_fillShader, "colour");
+	_shapeViewportSize = uniform(*_shapeShader, "viewportSize");
+
+	const auto line = _lineShader->getProgramID();
+	_segmentAttrib = glGetAttribLocation(line, "segment");
+	_arcAttrib = glGetAttribLocation(line, "arc");
+	createInstancedVao(_lineVao, _lineMeshBuffer, _segmentBuffer, lineMesh, sizeof(lineMesh),
+		glGetAttribLocation(line, "corner"), { _segmentAttrib, _arcAttrib });
+
+	const auto shape = _shapeShader->getProgramID();
+	_boundsAttrib = glGetAttribLocation(shape, "bounds");
+	_shapeStyleAttrib = glGetAttribLocation(shape, "style");
+	_shapeColourAttrib = glGetAttribLocation(shape, "shapeColour");
+	createInstancedVao(_shapeVao, _shapeMeshBuffer, _shapeBuffer, shapeMesh, sizeof(shapeMesh),
+		glGetAttribLocation(shape, "corner"), { _boundsAttrib, _shapeStyleAttrib, _shapeColourAttrib });
+
+	const GLint positionAttrib = glGetAttribLocation(_fillShader->getProgramID(), "position");
+	glGenVertexArrays(1, &_fillVao);
+	glBindVertexArray(_fillVao);
+	glGenBuffers(1, &_stripBuffer);
+	glBindBuffer(GL_ARRAY_BUFFER, _stripBuffer);
+	glEnableVertexAttribArray((GLuint)positionAttrib);
+	glVertexAttribPointer((GLuint)positionAttrib, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), nullptr);
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	return true;
+}
+
+bool WChartGLRenderer::_createHistogramShader() {
+	auto shader = std::make_unique<OpenGLShaderProgram>(_context);
+	if (!shader->addVertexShader(OpenGLHelpers::translateVertexShaderToV3(barsVertexShader))
+		|| !shader->addFragmentShader(OpenGLHelpers::translateFragmentShaderToV3(barsFragmentShader))
+		|| !shader->link()) {
+		DBG("WChartGLRenderer: " << shader->getLastError());
+		return false;
+	}
+	_barsShader = std::move(shader);
+	auto uniform = [this](const char* name) { return std::make_unique<OpenGLShaderProgram::Uniform>(*_barsShader, name); };
+	_barsViewportSize = uniform("viewportSize");
+	_barsParams = uniform("params");
+	_barsColour = uniform("colour");
+	_barsSecondColour = uniform("secondColour");
+	_barsTexture = uniform("bars");
+	const GLint positionAttrib = glGetAttribLocation(_barsShader->getProgramID(), "position");
+
+	glGenVertexArrays(1, &_quadVao);
+	glBindVertexArray(_quadVao);
+	glGenBuffers(1, &_quadBuffer);
+	glBindBuffer(GL_ARRAY_BUFFER, _quadBuffer);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(quadMesh), quadMesh, GL_STATIC_DRAW);
+	glEnableVertexAttribArray((GLuint)positionAttrib);
+	glVertexAttribPointer((GLuint)positionAttrib, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), nullptr);
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	// nearest texel, one per pixel row / column
+	glGenTextures(1, &_barsTextureId);
+	glBindTexture(GL_TEXTURE_2D, _barsTextureId);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	return true;
+}
+
+void WChartGLRenderer::openGLContextClosing() {
+	Workspace::getInstance().removeGLContext(&_context);
+	if (_instanceBuffer != 0) glDeleteBuffers(1, &_instanceBuffer);
+	if (_meshBuffer != 0) glDeleteBuffers(1, &_meshBuffer);
+	if (_vao != 0) glDeleteVertexArrays(1, &_vao);
+	_instanceBuffer = _meshBuffer = _vao = 0;
+	for (auto* u : { &_xMap, &_xOrigin, &_yMap, &_logScale, &_viewportSize, &_widths, &_upColour, &_downColour })
+		u->reset();
+	_shader = nullptr;
+	if (_barsTextureId != 0) glDeleteTextures(1, &_barsTextureId);
+	if (_quadBuffer != 0) glDeleteBuffers(1, &_quadBuffer);
+	if (_quadVao != 0) glDeleteVertexArrays(1, &_quadVao);
+	_barsTextureId = _quadBuffer = _quadVao = 0;
+	for (auto* u : { &_barsViewportSize, &_barsParams, &_barsColour, &_barsSecondColour, &_barsTexture })
+		u->reset();
+	_barsShader = nullptr;
+	for (auto* b : { &_lineMeshBuffer, &_shapeMeshBuffer, &_segmentBuffer, &_stripBuffer, &_shapeBuffer })
+		if (*b != 0) glDeleteBuffers(1, b);
+	for (auto* v : { &_lineVao, &_fillVao, &_shapeVao })
+		if (*v != 0) glDeleteVertexArrays(1, v);
+	_lineMeshBuffer = _shapeMeshBuffer = _segmentBuffer = _stripBuffer = _shapeBuffer = 0;
+	_lineVao = _fillVao = _shapeVao = 0;
+	for (auto* u : { &_lineViewportSize, &_lineHalfWidth, &_linePattern, &_lineColour, &_fillViewportSize, &_fillColour, &_shapeViewportSize })
+		u->reset();
+	for (auto* shader : { &_lineShader, &_fillShader, &_shapeShader })
+		shader->reset();
+	_uploaded = nullptr;
+	_uploadedRows = 0;
+	_instanceCapacity = 0;
+	MemoryBudget::getInstance().add(MemoryBudget::gpuBuffers, -(int64)_instanceBytes);
+	_instanceBytes = 0;
+}
+
+void WChartGLRenderer::_upload(const KlineStore::Ptr& store) {
+	const size_t n = store->size();
+	const int64 origin = store->getFirstOpenTime();
+	// the same columns : a shared series is wrapped in a new store at every refresh (SharedSeries::toKlineStore)
+	const bool sameStore = _uploaded != nullptr && origin == _uploadedOrigin && n >= _uploadedRows
+		&& store->getColumnData(KlineStore::openTime) == _uploaded->getColumnData(KlineStore::openTime)
+		&& store->getColumnData(KlineStore::close) == _uploaded->getColumnData(KlineStore::close);
+	// the last uploaded row may have been rewritten (forming candle)
+	size_t from = sameStore && _uploadedRows > 0 ? _uploadedRows - 1 : 0;
+
+	const size_t stride = floatsPerInstance * sizeof(float);
+	glBindBuffer(GL_ARRAY_BUFFER, _instanceBuffer);
+	if (n > _instanceCapacity || !sameStore) {
+		_instanceCapacity = jmax(n, store->getCapacity()) + n / 4 + 1024;
+		glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(_instanceCapacity * stride), nullptr, GL_DYNAMIC_DRAW);
+		MemoryBudget::getInstance().add(MemoryBudget::gpuBuffers, (int64)(_instanceCapacity * stride) - (int64)_instanceBytes);
+		_instanceBytes = _instanceCapacity * stride;
+		from = 0;
+	}
+
+	const size_t count = n - from;
+	if (_stagingSize < count * floatsPerInstance) {
+		_stagingSize = count * floatsPerInstance;
+		_staging.malloc(_stagingSize);
+	}
+	const int64* t = store->getOpenTime();
+	const double* o = store->getOpen();
+	const double* h = store->getHigh();
+	const double* l = store->getLow();
+	const double* c = store->getClose();
+	float* dst = _staging.get();
+	for (size_t r = from; r < n; r++) {
+		// whole numbers of candles below 2^24 : exact in a float
+		*dst++ = (float)((double)(t[r] - origin) / (double)_uploadedUnit);
+		*dst++ = (float)o[r];
+		*dst++ = (float)h[r];
+		*dst++ = (float)l[r];
+		*dst++ = (float)c[r];
+	}
+	glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)(from * stride), (GLsizeiptr)(count * stride), _staging.get());
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	_uploaded = store;
+	_uploadedOrigin = origin;
+	_uploadedRows = n;
+}
+
+void WChartGLRenderer::renderOpenGL() {
+	Frame f;
+	{
+		const ScopedLock l(_lock);
+		f = _frame;
+	}
+	OpenGLHelpers::clear(WLookAndFeel::bgWidgetColour);
+	if (_shader == nullptr || f.store == nullptr || f.range.isEmpty())
+		return;
+
+	if (f.candleUnit != _uploadedUnit) {
+		_uploadedUnit = jmax((int64)1, f.candleUnit);
+		_uploaded = nullptr;
+	}
+	const uint64 first = f.range.first;
+	uint64 last = 0;
+	int64 u0 = 0;
+	{
+		// the message thread may be writing the rows (writeStore)
+		const ScopedLock sl(_storeLock);
+		if (f.store->isEmpty())
+			return;
+		if (f.store != _uploaded || f.store->size() != _uploadedRows)
+			_upload(f.store); // only the new rows of the same columns
+		last = jmin(f.range.last, (uint64)_uploadedRows);
+		if (first >= last)
+			return;
+		// x in candle units from the first drawn candle, exact in float : pixel = (u - u0) * s + b
+		u0 = (int64)std::llround((double)(f.store->getOpenTime()[first] - _uploadedOrigin) / (double)_uploadedUnit);
+	}
+	const double s = f.x.scale * (double)_uploadedUnit;
+	const double b = (double)(_uploadedOrigin + u0 * _uploadedUnit - f.x.origin) * f.x.scale + f.x.offset;
+
+	const float renderingScale = (float)_context.getRenderingScale();
+	glViewport(0, 0, roundToInt(f.width * renderingScale), roundToInt(f.height * renderingScale));
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	_shader->use();
+	_xMap->set((GLfloat)s, (GLfloat)b);
+	_xOrigin->set((GLfloat)u0);
+	_yMap->set((GLfloat)f.y.scale, (GLfloat)(f.y.offset - (double)f.y.origin * f.y.scale));
+	_logScale->set(f.logScale ? 1.0f : 0.0f);
+	_viewportSize->set((GLfloat)f.width, (GLfloat)f.height);
+	_widths->set((GLfloat)f.bodyWidth, 1.0f);
+	const auto up = WLookAndFeel::candleUpColour;
+	const auto down = WLookAndFeel::candleDownColour;
+	_upColour->set(up.getFloatRed(), up.getFloatGreen(), up.getFloatBlue(), up.getFloatAlpha());
+	_downColour->set(down.getFloatRed(), down.getFloatGreen(), down.getFloatBlue(), down.getFloatAlpha());
+
+	glBindVertexArray(_vao);
+	glBindBuffer(GL_ARRAY_BUFFER, _instanceBuffer);
+	const GLsizei stride = floatsPerInstance * sizeof(float);
+	const size_t offset = (size_t)first * (size_t)stride;
+	glVertexAttribPointer((GLuint)_timeAttrib, 1, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const void*>(offset));
+	glVertexAttribPointer((GLuint)_ohlcAttrib, 4, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const void*>(offset + sizeof(float)));
+	glDrawArraysInstanced(GL_TRIANGLES, 0, verticesPerCandle, (GLsizei)(last - first));
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	_drawOverlay(f);
+	_drawHistograms(f);
+}
+
+static void setColour(const OpenGLShaderProgram::Uniform& u, Colour c) {
+	u.set(c.getFloatRed(), c.getFloatGreen(), c.getFloatBlue(), c.getFloatAlpha());
+}
+
+void WChartGLRenderer::_drawOverlay(const Frame& f) {
+	if (_lineShader == nullptr || f.batches.empty())
+		return;
+	// a few thousand vertices rebuilt every frame, streamed whole
+	auto stream = [](unsigned int buffer, const std::vector<float>& data) {
+		if (data.empty())
+			return;
+		glBindBuffer(GL_ARRAY_BUFFER, buffer);
+		glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(data.size() * sizeof(float)), data.data(), GL_STREAM_DRAW);
+	};
+	stream(_segmentBuffer, f.segments);
+	stream(_stripBuffer, f.strips);
+	stream(_shapeBuffer, f.shapes);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	for (const auto& batch : f.batches) {
+		const auto& style = batch.style;
+		if (batch.kind == Batch::Kind::fill) {
+			_fillShader->use();
+			_fillViewportSize->set(f.width, f.height);
+			setColour(*_fillColour, style.colour);
+			glBindVertexArray(_fillVao);
+			glDrawArrays(GL_TRIANGLE_STRIP, (GLint)batch.first, (GLsizei)batch.count);
+		}
+		else if (batch.kind == Batch::Kind::lines) {
+			const bool dotted = style.pattern == LinePattern::dotted;
+			// a dot is 1.5 times the line, the pattern period starts at a dot
+			const float halfWidth = jmax(0.5f, style.thickness * (dotted ? 0.75f : 0.5f));
+			const float dash = jmax(0.5f, style.dash);
+			const float period = dotted ? jmax(1.0f, style.gap + style.thickness) : dash + jmax(0.5f, style.gap);
+			_lineShader->use();
+			_lineViewportSize->set(f.width, f.height);
+			_lineHalfWidth->set(halfWidth);
+			_linePattern->set((GLfloat)(int)style.pattern, halfWidth, dash, period);
+			setColour(*_lineColour, style.colour);
+			glBindVertexArray(_lineVao);
+			glBindBuffer(GL_ARRAY_BUFFER, _segmentBuffer);
+			const GLsizei stride = floatsPerSegment * sizeof(float);
+			const size_t offset = batch.first * (size_t)stride;
+			glVertexAttribPointer((GLuint)_segmentAttrib, 4, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const void*>(offset));
+			glVertexAttribPointer((GLuint)_arcAttrib, 1, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const void*>(offset + 4 * sizeof(float)));
+			glDrawArraysInstanced(GL_TRIANGLES, 0, verticesPerQuad, (GLsizei)batch.count);
+		}
+		else {
+			_shapeShader->use();
+			_shapeViewportSize->set(f.width, f.height);
+			glBindVertexArray(_shapeVao);
+			glBindBuffer(GL_ARRAY_BUFFER, _shapeBuffer);
+			const GLsizei stride = floatsPerShape * sizeof(float);
+			const size_t offset = batch.first * (size_t)stride;
+			glVertexAttribPointer((GLuint)_boundsAttrib, 4, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const void*>(offset));
+			glVertexAttribPointer((GLuint)_shapeStyleAttrib, 2, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const void*>(offset + 4 * sizeof(float)));
+			glVertexAttribPointer((GLuint)_shapeColourAttrib, 4, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const void*>(offset + 6 * sizeof(float)));
+			glDrawArraysInstanced(GL_TRIANGLES, 0, verticesPerQuad, (GLsizei)batch.count);
+		}
+	}
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void WChartGLRenderer::_drawHistograms(const Frame& f) {
+	if (_barsShader == nullptr || f.histograms.empty())
+		return;
+	_barsShader->use();
+	_barsViewportSize->set((GLfloat)f.width, (GLfloat)f.height);
+	_barsTexture->set(0);
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, _barsTextureId);
+	glBindVertexArray(_quadVao);
+	for (const auto& bars : f.histograms) {
+		const GLsizei n = (GLsizei)(bars.lengths.size() / 2);
+		if (n == 0)
+			continue;
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RG32F, n, 1, 0, GL_RG, GL_FLOAT, bars.lengths.data());
+		_barsParams->set(bars.alongX ? 1.0f : 0.0f, bars.anchorRight ? 1.0f : 0.0f, (GLfloat)bars.extent, (GLfloat)n);
+		const auto& a = bars.colour;
+		const auto& b = bars.secondColour;
+		_barsColour->set(a.getFloatRed(), a.getFloatGreen(), a.getFloatBlue(), a.getFloatAlpha());
+		_barsSecondColour->set(b.getFloatRed(), b.getFloatGreen(), b.getFloatBlue(), b.getFloatAlpha());
+		glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	}
+	glBindVertexArray(0);
+	glBindTexture(GL_TEXTURE_2D, 0);
+}
@@ -0,0 +1,167 @@
+/*
+  ==============================================================================
+
+    WChartGLRenderer.h
+    Created: 14 Oct 2026 8:10:33pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+#include "WChartTransform.h"
+#include "../../../data/KlineStore.h"
+
+/*
+	GPU path of WChartViewport : the candles of a KlineStore are uploaded once
+	as instance data (time in candle units since the series origin + ohlc as
+	floats, 20 bytes per row) and drawn with one instanced call, 2 quads per
+	candle built in the vertex shader. Panning and zooming only change uniforms.
+
+	Times are sent relative to the first visible candle in candle units, so the
+	float subtraction stays exact whatever the epoch. A grown store only has
+	its new rows (and the rewritten last one) uploaded, a new store re-uploads.
+
+	Filled histograms come as per pixel row (column) bar lengths, uploaded each
+	frame as a 1 texel high RG32F texture and drawn over the candles by a
+	viewport quad whose fragments look their bar up.
+
+	Curves and shapes come as pixel geometry built by the viewport each frame,
+	drawn over the candles in the order they were added :
+		lines    one instanced quad per segment, widened across it in the vertex
+		         shader; the fragment shader takes its distance to the segment
+		         (round joins and caps, analytic antialiasing) and cuts dashes
+		         and dots from the arc length at the segment start
+		fills    triangle strips down to a base line
+		shapes   one instanced quad per rect or marker, the fragment shader
+		         evaluates the distance to its box, circle or triangle (filled or
+		         stroked)
+
+	The context keeps component painting on : the viewport still paints the
+	live series and the other histograms over it.
+
+	The contexts of every window are in one share group (Workspace), the
+	first live context is the one the next ones share with.
+
+	The candle instance buffer counts in MemoryBudget::gpuBuffers.
+*/
+
+class WChartGLRenderer : public OpenGLRenderer {
+public:
+	struct Bars {
+		std::vector<float> lengths;  // (first, second) per pixel, fractions of extent
+		bool alongX = false;         // columns up from the bottom, else rows from a side
+		bool anchorRight = true;
+		float extent = 0.25f;        // of the width (rows) / height (columns)
+		Colour colour, secondColour;
+	};
+
+	enum class LinePattern { solid, dashed, dotted };
+	enum class Shape { circle, triangleUp, triangleDown, rect };
+
+	struct LineStyle {
+		Colour colour;
+		float thickness = 1.0f;
+		LinePattern pattern = LinePattern::solid;
+		float dash = 6.0f;   // px, dashed
+		float gap = 4.0f;    // px between dashes / dots
+	};
+
+	// consecutive geometry drawn with one call
+	struct Batch {
+		enum class Kind { lines, fill, shapes };
+		Kind kind = Kind::lines;
+		size_t first = 0, count = 0; // segments, strip vertices or shape instances
+		LineStyle style;             // lines, the colour of a fill
+	};
+
+	struct Frame {
+		KlineStore::Ptr store;
+		SeriesRange range;           // rows to draw
+		int64 candleUnit = 1;        // ms between two rows
+		AxisMapping x;               // times
+		AxisMapping y;               // forward(prices)
+		bool logScale = false;
+		float width = 0, height = 0;
+		float bodyWidth = 1;
+		std::vector<Bars> histograms;
+
+		// curves and shapes in pixels, see addLine() / addFill() / addShape()
+		std::vector<float> segments;  // per segment : a, b, arc length at a
+		std::vector<float> strips;    // per vertex : x, y
+		std::vector<float> shapes;    // per instance : center, half size, type, thickness, rgba
+		std::vector<Batch> batches;
+
+		// a polyline, NaN x points break it. The dash pattern is anchored on originX
+		// (pixel of the series origin) so it stays in place while panning along flat parts
+		void addLine(const Point<float>* points, size_t n, const LineStyle& style, float originX);
+		// the area between a polyline and the horizontal baseY, a strip per run
+		void addFill(const Point<float>* points, size_t n, float baseY, Colour colour);
+		// a rect filling bounds or a marker inscribed in it, stroked when thickness > 0
+		void addShape(Shape type, Rectangle<float> bounds, float thickness, Colour colour);
+	};
+
+	explicit WChartGLRenderer(Component& target);
+	~WChartGLRenderer() override;
+
+	// message thread, draws on the next GL frame
+	void setFrame(Frame frame);
+	// clears the candles (nothing to draw on the GPU)
+	void clearFrame();
+	// message thread, runs write (changing the store of the frame in place) between two
+	// GL frames reading it
+	void writeStore(const std::function<void()>& write);
+
+	void newOpenGLContextCreated() override;
+	void renderOpenGL() override;
+	void openGLContextClosing() override;
+
+private:
+	static constexpr int floatsPerInstance = 5;
+	static constexpr int floatsPerSegment = 5;
+	static constexpr int floatsPerShape = 10;
+
+	void _upload(const KlineStore::Ptr& store);
+	bool _createHistogramShader();
+	void _drawHistograms(const Frame& f);
+	bool _createOverlayShaders();
+	void _drawOverlay(const Frame& f);
+
+	OpenGLContext _context;
+	CriticalSection _lock;
+	CriticalSection _storeLock; // around the reads of the store rows on the GL thread
+	Frame _frame;
+
+	// GL thread only
+	UPtr<OpenGLShaderProgram> _shader;
+	UPtr<OpenGLShaderProgram::Uniform> _xMap, _xOrigin, _yMap, _logScale, _viewportSize, _widths, _upColour, _downColour;
+	// GLuint / GLint
+	unsigned int _vao = 0;
+	unsigned int _meshBuffer = 0;
+	unsigned int _instanceBuffer = 0;
+	int _cornerAttrib = -1, _timeAttrib = -1, _ohlcAttrib = -1;
+	UPtr<OpenGLShaderProgram> _barsShader;
+	UPtr<OpenGLShaderProgram::Uniform> _barsViewportSize, _barsParams, _barsColour, _barsSecondColour, _barsTexture;
+	unsigned int _quadVao = 0;
+	unsigned int _quadBuffer = 0;
+	unsigned int _barsTextureId = 0;
+	UPtr<OpenGLShaderProgram> _lineShader, _fillShader, _shapeShader;
+	UPtr<OpenGLShaderProgram::Uniform> _lineViewportSize, _lineHalfWidth, _linePattern, _lineColour;
+	UPtr<OpenGLShaderProgram::Uniform> _fillViewportSize, _fillColour, _shapeViewportSize;
+	unsigned int _lineVao = 0, _fillVao = 0, _shapeVao = 0;
+	unsigned int _lineMeshBuffer = 0, _shapeMeshBuffer = 0;
+	unsigned int _segmentBuffer = 0, _stripBuffer = 0, _shapeBuffer = 0;
+	int _segmentAttrib = -1, _arcAttrib = -1;
+	int _boundsAttrib = -1, _shapeStyleAttrib = -1, _shapeColourAttrib = -1;
+	KlineStore::Ptr _uploaded; // kept alive : its columns can't be reused by another store
+	int64 _uploadedOrigin = 0;
+	int64 _uploadedUnit = 1;
+	size_t _uploadedRows = 0;
+	size_t _instanceCapacity = 0;
+	size_t _instanceBytes = 0; // accounted in the budget
+	HeapBlock<float> _staging;
+	size_t _stagingSize = 0;
+
+	JUCE_DECLARE_NON_COPYABLE(WChartGLRenderer)
+};
@@ -0,0 +1,296 @@
+/*
+  ==============================================================================
+
+    WChartGrid.cpp
+    Created: 15 Oct 2026 8:05:13am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "WChartGrid.h"
+#include "../WLookAndFeel.h"
+#include "../../../utils/TextCache.h"
+
+WChartGrid::WChartGrid() {
+	_readyUpdater.onAsyncUpdate = [this]() { _takeOverviews(); };
+}
+
+WChartGrid::~WChartGrid() {
+	_tasks.cancel();
+	_tasks.wait();
+	_readyUpdater.cancelPendingUpdate();
+}
+
+void WChartGrid::setOptions(const Options& options) {
+	_options = options;
+	resized();
+	repaint();
+}
+
+KlineStore::Ptr WChartGrid::makeOverview(const KlineStore& store, size_t maxRows) {
+	const size_t n = store.size();
+	if (n == 0)
+		return nullptr;
+	// the LodPyramid level of at most maxRows buckets, without building the levels under it
+	int shift = 0;
+	while ((n >> shift) > jmax((size_t)1, maxRows))
+		shift++;
+	const size_t bucket = (size_t)1 << shift;
+	const size_t numBuckets = (n + bucket - 1) / bucket;
+
+	auto out = KlineStore::allocate(numBuckets);
+	out->setSymbol(store.getSymbol());
+	out->setInterval(store.getInterval());
+	for (int c = 0; c < KlineStore::numColumns; c++)
+		std::memset(out->getWritableColumnData((KlineStore::Column)c), 0, numBuckets * KlineStore::elementSize);
+
+	const auto* time = store.getOpenTime();
+	const auto* open = store.getOpen();
+	const auto* high = store.getHigh();
+	const auto* low = store.getLow();
+	const auto* close = store.getClose();
+	const auto* volume = store.getVolume();
+	auto* oTime = out->getWritableIntColumn(KlineStore::openTime);
+	auto* oOpen = out->getWritableDoubleColumn(KlineStore::open);
+	auto* oHigh = out->getWritableDoubleColumn(KlineStore::high);
+	auto* oLow = out->getWritableDoubleColumn(KlineStore::low);
+	auto* oClose = out->getWritableDoubleColumn(KlineStore::close);
+	auto* oVolume = out->getWritableDoubleColumn(KlineStore::volume);
+	for (size_t b = 0; b < numBuckets; b++) {
+		const size_t first = b << shift;
+		const size_t last = jmin(n, first + bucket);
+		double hi = high[first], lo = low[first], v = 0.0;
+		for (size_t i = first; i < last; i++) {
+			hi = jmax(hi, high[i]);
+			lo = jmin(lo, low[i]);
+			v += volume[i];
+		}
+		oTime[b] = time[first];
+		oOpen[b] = open[first];
+		oHigh[b] = hi;
+		oLow[b] = lo;
+		oClose[b] = close[last - 1];
+		oVolume[b] = v;
+	}
+	return out;
+}
+
+int WChartGrid::addSymbol(const String& name, KlineStore::Ptr store) {
+	Symbol s;
+	s.name = name;
+	s.store = std::move(store);
+	_symbols.push_back(std::move(s));
+	_updateCells();
+	repaint();
+	return (int)_symbols.size() - 1;
+}
+
+void WChartGrid::clearSymbols() {
+	_tasks.cancel();
+	_tasks.wait();
+	_tasks.reset();
+	_generation++;
+	_symbols.clear();
+	_scroll = 0;
+	_hovered = -1;
+	_updateCells();
+	repaint();
+}
+
+int WChartGrid::_getNumColumns() const {
+	return jmax(1, (getWidth() - _options.spacing) / jmax(1, _options.cellWidth + _options.spacing));
+}
+
+int WChartGrid::_getContentHeight() const {
+	const int columns = _getNumColumns();
+	const int rows = ((int)_symbols.size() + columns - 1) / columns;
+	return _options.spacing + rows * (_options.cellHeight + _options.spacing);
+}
+
+Rectangle<int> WChartGrid::_getCellBounds(int index) const {
+	const int columns = _getNumColumns();
+	const int col = index % columns;
+	const int row = index / columns;
+	return { _options.spacing + col * (_options.cellWidth + _options.spacing),
+		_options.spacing + row * (_options.cellHeight + _options.spacing) - _scroll,
+		_options.cellWidth, _options.cellHeight };
+}
+
+int WChartGrid::_getIndexAt(Point<int> p) const {
+	const int columns = _getNumColumns();
+	const int col = (p.x - _options.spacing) / (_options.cellWidth + _options.spacing);
+	const int row = (p.y + _scroll - _options.spacing) / (_options.cellHeight + _options.spacing);
+	if (p.x < _options.spacing || p.y + _scroll < _options.spacing || col >= columns)
+		return -1;
+	const int index = row * columns + col;
+	return isPositiveAndBelow(index, (int)_symbols.size()) && _getCellBounds(index).contains(p) ? index : -1;
+}
+
+void WChartGrid::_setScroll(int y) {
+	y = jlimit(0, jmax(0, _getContentHeight() - getHeight()), y);
+	if (y == _scroll)
+		return;
+	// smoothed over the wheel events, a pause starts again from the last step
+	const double now = Time::getMillisecondCounterHiRes();
+	const double dt = jmax(1.0, now - _lastScrollMs) / 1000.0;
+	const float symbols = (float)(y - _scroll) / (float)(_options.cellHeight + _options.spacing) * (float)_getNumColumns();
+	const float velocity = (float)(symbols / dt);
+	_scrollVelocity = dt > 0.25 ? velocity : _scrollVelocity * 0.6f + velocity * 0.4f;
+	_lastScrollMs = now;
+	_scroll = y;
+	_updateCells();
+	repaint();
+}
+
+void WChartGrid::_updateCells() {
+	// symbols with a row in view
+	const int columns = _getNumColumns();
+	const int rowHeight = _options.cellHeight + _options.spacing;
+	const int firstRow = jmax(0, (_scroll - _options.spacing) / rowHeight);
+	const int lastRow = (_scroll + getHeight()) / rowHeight + 1;
+	const int first = jmin((int)_symbols.size(), firstRow * columns);
+	const int last = jmin((int)_symbols.size(), lastRow * columns);
+
+	// cells scrolled out are free, kept to be recycled first
+	std::vector<bool> covered((size_t)jmax(0, last - first), false);
+	std::vector<Cell*> free;
+	for (auto& cell : _cells) {
+		if (cell.symbol >= first && cell.symbol < last)
+			covered[(size_t)(cell.symbol - first)] = true;
+		else
+			free.push_back(&cell);
+	}
+	std::vector<Cell> created;
+	for (int i = first; i < last; i++) {
+		if (covered[(size_t)(i - first)])
+			continue;
+		Cell* cell = nullptr;
+		if (!free.empty()) {
+			cell = free.back();
+			free.pop_back();
+		}
+		else {
+			created.push_back({});
+			cell = &created.back();
+			auto chart = std::make_unique<WChart>();
+			chart->setXAxisVisible(false);
+			chart->setYAxisVisible(false);
+			chart->setBackgroundRenderingEnabled(false);
+			chart->setInterceptsMouseClicks(false, false);
+			chart->setWantsKeyboardFocus(false);
+			addChildComponent(chart.get());
+			cell->chart = std::move(chart);
+		}
+		cell->symbol = i;
+		auto& s = _symbols[(size_t)i];
+		cell->chart->setStore(s.overview);
+		if (!s.overview)
+			_requestOverview(i);
+	}
+	// more cells than the view needs (the grid shrank)
+	for (auto* cell : free)
+		cell->symbol = -1;
+	_cells.erase(std::remove_if(_cells.begin(), _cells.end(), [](const Cell& c) { return c.symbol < 0; }), _cells.end());
+	for (auto& c : created)
+		_cells.push_back(std::move(c));
+
+	for (auto& cell : _cells) {
+		cell.chart->setBounds(_getCellBounds(cell.symbol));
+		cell.chart->setVisible(true);
+	}
+	_visible = { first, last };
+	if (onVisibleSymbolsChanged)
+		onVisibleSymbolsChanged(_visible, _scrollVelocity);
+}
+
+void WChartGrid::_requestOverview(int index) {
+	auto& s = _symbols[(size_t)index];
+	if (s.requested || !s.store)
+		return;
+	s.requested = true;
+	TaskPool::getInstance().submit([this, store = s.store, rows = _options.overviewRows, generation = _generation, index]() {
+		auto overview = makeOverview(*store, rows);
+		{
+			const ScopedLock sl(_readyLock);
+			_ready.push_back({ generation, index, std::move(overview) });
+		}
+		_readyUpdater.triggerAsyncUpdate();
+	}, TaskPool::Priority::high, &_tasks);
+}
+
+void WChartGrid::_takeOverviews() {
+	std::vector<Ready> ready;
+	{
+		const ScopedLock sl(_readyLock);
+		ready.swap(_ready);
+	}
+	for (auto& r : ready) {
+		if (r.generation != _generation || !isPositiveAndBelow(r.symbol, (int)_symbols.size()))
+			continue;
+		_symbols[(size_t)r.symbol].overview = r.overview;
+		for (auto& cell : _cells)
+			if (cell.symbol == r.symbol)
+				cell.chart->setStore(r.overview);
+	}
+}
+
+void WChartGrid::paint(Graphics& g) {
+	g.fillAll(WLookAndFeel::bgColour);
+}
+
+void WChartGrid::paintOverChildren(Graphics& g) {
+	const Font font(12.0f);
+	for (const auto& cell : _cells) {
+		const auto bounds = _getCellBounds(cell.symbol);
+		g.setColour(WLookAndFeel::axisTextColour);
+		TextCache::getInstance().draw(g, font, _symbols[(size_t)cell.symbol].name, bounds.reduced(8, 4).toFloat(), Justification::topLeft);
+		if (cell.symbol == _hovered) {
+			g.setColour(WLookAndFeel::axisTextColour.withMultipliedAlpha(0.5f));
+			g.drawRoundedRectangle(bounds.toFloat().reduced(0.5f), WLookAndFeel::widgetCorner, 1.0f);
+		}
+	}
+	// scroll position
+	const int content = _getContentHeight();
+	if (content > getHeight()) {
+		const float h = (float)getHeight();
+		const float thumb = jmax(20.0f, h * h / (float)content);
+		const float y = (h - thumb) * (float)_scroll / (float)(content - getHeight());
+		g.setColour(WLookAndFeel::gridColour.withAlpha(0.3f));
+		g.fillRoundedRectangle((float)getWidth() - 5.0f, y, 3.0f, thumb, 1.5f);
+	}
+}
+
+void WChartGrid::resized() {
+	_setScroll(_scroll);
+	_updateCells();
+}
+
+void WChartGrid::mouseWheelMove(const MouseEvent&, const MouseWheelDetails& wheel) {
+	_setScroll(_scroll - roundToInt(wheel.deltaY * 4.0f * (float)(_options.cellHeight + _options.spacing)));
+}
+
+void WChartGrid::mouseMove(const MouseEvent& e) {
+	const int index = _getIndexAt(e.getPosition());
+	if (index == _hovered)
+		return;
+	if (_hovered >= 0)
+		repaint(_getCellBounds(_hovered));
+	_hovered = index;
+	if (_hovered >= 0)
+		repaint(_getCellBounds(_hovered));
+}
+
+void WChartGrid::mouseExit(const MouseEvent&) {
+	if (_hovered >= 0)
+		repaint(_getCellBounds(_hovered));
+	_hovered = -1;
+}
+
+void WChartGrid::mouseUp(const MouseEvent& e) {
+	if (e.mouseWasDraggedSinceMouseDown())
+		return;
+	const int index = _getIndexAt(e.getPosition());
+	if (index >= 0 && onSymbolClicked)
+		onSymbolClicked(index);
+}
@@ -0,0 +1,114 @@
+/*
+  ==============================================================================
+
+    WChartGrid.h
+    Created: 15 Oct 2026 8:05:13am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "../BaseComponent.h"
+#include "WChart.h"
+#include "../../../utils/TaskPool.h"
+#include "../../../utils/AsyncUpdaterLambda.h"
+
+/*
+	Watchlist grid of mini charts (hundreds of symbols), scrolled with the wheel.
+
+	Only the cells in view are live WCharts : cells scrolled out are hidden
+	and handed to the symbols scrolled in, the number of components follows
+	the size of the grid, not the number of symbols.
+	A cell draws an overview of its symbol : its LodPyramid level of at most
+	Options::overviewRows buckets, aggregated once on the TaskPool when the
+	symbol is first shown, a few KB whatever the length of the series.
+	Names and the hover frame are painted by the grid itself.
+*/
+
+class WChartGrid : public BaseComponent {
+public:
+	struct Options {
+		int cellWidth = 240;
+		int cellHeight = 140;
+		int spacing = 6;
+		size_t overviewRows = 512;
+	};
+
+	WChartGrid();
+	~WChartGrid();
+
+	void setOptions(const Options& options);
+	const Options& getOptions() const { return _options; }
+
+	// the store is referenced, rows per overview bucket are a power of two
+	int addSymbol(const String& name, KlineStore::Ptr store);
+	void clearSymbols();
+	int getNumSymbols() const { return (int)_symbols.size(); }
+	const String& getSymbolName(int index) const { return _symbols[(size_t)index].name; }
+	// live WCharts, about the visible cells
+	int getNumCells() const { return (int)_cells.size(); }
+
+	void paint(Graphics& g) override;
+	void paintOverChildren(Graphics& g) override;
+	void resized() override;
+	void mouseWheelMove(const MouseEvent& e, const MouseWheelDetails& wheel) override;
+	void mouseMove(const MouseEvent& e) override;
+	void mouseExit(const MouseEvent& e) override;
+	void mouseUp(const MouseEvent& e) override;
+
+	// index of the symbol under the mouse
+	std::function<void(int)> onSymbolClicked;
+	// symbols with a row in view, and the scroll speed in symbols per second (positive
+	// toward the end of the list), e.g. for a KlinePrefetcher
+	std::function<void(Range<int>, float)> onVisibleSymbolsChanged;
+	Range<int> getVisibleSymbols() const { return _visible; }
+	float getScrollVelocity() const { return _scrollVelocity; }
+
+	// bucketed copy of the store, first row of each bucket for the times
+	static KlineStore::Ptr makeOverview(const KlineStore& store, size_t maxRows);
+
+private:
+	struct Symbol {
+		String name;
+		KlineStore::Ptr store;
+		KlineStore::Ptr overview;
+		bool requested = false;
+	};
+	struct Cell {
+		UPtr<WChart> chart;
+		int symbol = -1;
+	};
+
+	int _getNumColumns() const;
+	int _getContentHeight() const;
+	Rectangle<int> _getCellBounds(int index) const;
+	int _getIndexAt(Point<int> p) const;
+	void _setScroll(int y);
+	void _updateCells();
+	void _requestOverview(int index);
+	void _takeOverviews();
+
+	Options _options;
+	std::vector<Symbol> _symbols;
+	std::vector<Cell> _cells;
+	int _scroll = 0;
+	int _hovered = -1;
+	Range<int> _visible;
+	float _scrollVelocity = 0.0f;
+	double _lastScrollMs = 0.0;
+
+	// overviews computed on the pool, picked up on the message thread
+	struct Ready {
+		uint32 generation = 0;
+		int symbol = -1;
+		KlineStore::Ptr overview;
+	};
+	TaskPool::Group _tasks;
+	CriticalSection _readyLock;
+	std::vector<Ready> _ready;
+	uint32 _generation = 0; // bumped by clearSymbols()
+	AsyncUpdaterLambda _readyUpdater;
+
+	JUCE_DECLARE_NON_COPYABLE(WChartGrid)
+};
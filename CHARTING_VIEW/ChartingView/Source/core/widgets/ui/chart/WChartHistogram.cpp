@@ -0,0 +1,181 @@
+/*
+  ==============================================================================
+
+    WChartHistogram.cpp
+    Created: 15 Oct 2026 6:41:17pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "WChartHistogram.h"
+
+// adds value to the pixels [a, b) pro rata of the overlap
+static void spread(float* pixels, int numPixels, float a, float b, float value) {
+	if (a > b)
+		std::swap(a, b);
+	if (!(b > 0.0f && a < (float)numPixels) || !(value > 0.0f))
+		return;
+	if (b - a < 1e-4f) {
+		pixels[jlimit(0, numPixels - 1, (int)a)] += value;
+		return;
+	}
+	const float density = value / (b - a);
+	const int p0 = jmax(0, (int)std::floor(a));
+	const int p1 = jmin(numPixels, (int)std::ceil(b));
+	for (int p = p0; p < p1; p++)
+		pixels[p] += density * (jmin(b, (float)p + 1.0f) - jmax(a, (float)p));
+}
+
+WChartHistogram::WChartHistogram(const Options& options)
+	: _options(options)
+{
+}
+
+void WChartHistogram::setBins(std::vector<double> edges, std::vector<double> values, std::vector<double> second) {
+	jassert(values.empty() || edges.size() == values.size() + 1);
+	jassert(second.empty() || second.size() == values.size());
+	if (onChanging)
+		onChanging();
+	_edges = std::move(edges);
+	_values = std::move(values);
+	_second = std::move(second);
+	if (_edges.size() != _values.size() + 1)
+		_values.clear();
+	if (_second.size() != _values.size())
+		_second.clear();
+	if (onChanged)
+		onChanged();
+}
+
+void WChartHistogram::setOptions(const Options& options) {
+	if (onChanging)
+		onChanging();
+	_options = options;
+	if (onChanged)
+		onChanged();
+}
+
+void WChartHistogram::computeBars(const WChartScaleTransform& scaleT, int64 seriesOrigin, float width, float height,
+								  std::vector<float>& first, std::vector<float>& second) {
+	const bool price = _options.axis == Axis::price;
+	const int numPixels = jmax(0, (int)std::ceil(price ? height : width));
+	first.assign((size_t)numPixels, 0.0f);
+	second.assign(_second.empty() ? 0 : (size_t)numPixels, 0.0f);
+	if (_values.empty() || numPixels == 0)
+		return;
+
+	// only the bins inside the viewport (edges increase, the axis may not)
+	const size_t n = _values.size();
+	size_t b0 = 0, b1 = n;
+	auto clip = [&](double v0, double v1) {
+		const double lo = jmin(v0, v1), hi = jmax(v0, v1);
+		b0 = (size_t)(std::upper_bound(_edges.begin(), _edges.end(), lo) - _edges.begin());
+		b0 = b0 > 0 ? b0 - 1 : 0;
+		b1 = jmin(n, (size_t)(std::lower_bound(_edges.begin(), _edges.end(), hi) - _edges.begin()));
+	};
+	_edgePixels.resize(n + 1);
+	if (price) {
+		scaleT.withYMapper(height, [&](const auto& yMap) {
+			clip(yMap.toValue(0.0f), yMap.toValue(height));
+			if (b0 < b1)
+				yMap.toPixels(_edges.data() + b0, _edgePixels.data(), b1 - b0 + 1);
+		});
+	}
+	else {
+		const auto xMap = scaleT.getXMapping(seriesOrigin, width);
+		clip(xMap.toValue(0.0f), xMap.toValue(width));
+		if (b0 < b1)
+			for (size_t b = b0; b <= b1; b++)
+				_edgePixels[b - b0] = xMap.toPixel(_edges[b]);
+	}
+
+	for (size_t b = b0; b < b1; b++) {
+		const float a = _edgePixels[b - b0], e = _edgePixels[b - b0 + 1];
+		spread(first.data(), numPixels, a, e, (float)_values[b]);
+		if (!second.empty())
+			spread(second.data(), numPixels, a, e, (float)_second[b]);
+	}
+
+	float largest = 0.0f;
+	for (int p = 0; p < numPixels; p++)
+		largest = jmax(largest, first[(size_t)p] + (second.empty() ? 0.0f : second[(size_t)p]));
+	if (largest <= 0.0f)
+		return;
+	const float k = 1.0f / largest;
+	for (auto& v : first)
+		v *= k;
+	for (auto& v : second)
+		v *= k;
+}
+
+void WChartHistogram::_addOutline(const std::vector<float>& bars, const std::vector<float>* base, float width, float height) {
+	const bool price = _options.axis == Axis::price;
+	const float scale = _options.extent * (price ? width : height);
+	auto tip = [&](int p) {
+		return scale * (bars[(size_t)p] + (base ? (*base)[(size_t)p] : 0.0f));
+	};
+	auto point = [&](float along, float length) {
+		if (!price)
+			return Point<float>(along, height - length);
+		return Point<float>(_options.anchorRight ? width - length : length, along);
+	};
+	const int n = (int)bars.size();
+	_path.startNewSubPath(point(0.0f, 0.0f));
+	for (int p = 0; p < n; p++) {
+		const float length = tip(p);
+		_path.lineTo(point((float)p, length));
+		_path.lineTo(point((float)p + 1.0f, length));
+	}
+	_path.lineTo(point((float)n, 0.0f));
+}
+
+void WChartHistogram::paint(Graphics& g, const WChartScaleTransform& scaleT, int64 seriesOrigin, float width, float height, float x0, float x1) {
+	computeBars(scaleT, seriesOrigin, width, height, _first, _secondBars);
+	if (_first.empty())
+		return;
+	const bool price = _options.axis == Axis::price;
+	const float scale = _options.extent * (price ? width : height);
+	const auto& o = _options;
+
+	if (o.style == Style::hollow) {
+		_path.clear();
+		_addOutline(_first, nullptr, width, height);
+		g.setColour(o.colour.withMultipliedAlpha(jmin(1.0f, o.alpha * 2.0f)));
+		g.strokePath(_path, PathStrokeType(1.0f));
+		if (!_secondBars.empty()) {
+			_path.clear();
+			_addOutline(_secondBars, &_first, width, height);
+			g.setColour(o.secondColour.withMultipliedAlpha(jmin(1.0f, o.alpha * 2.0f)));
+			g.strokePath(_path, PathStrokeType(1.0f));
+		}
+		return;
+	}
+
+	// one rectangle per pixel row / column, the time axis only inside [x0, x1]
+	const int p0 = price ? 0 : jmax(0, (int)std::floor(jmin(x0, x1)));
+	const int p1 = price ? (int)_first.size() : jmin((int)_first.size(), (int)std::ceil(jmax(x0, x1)));
+	RectangleList<float> firstRects, secondRects;
+	firstRects.ensureStorageAllocated(p1 - p0);
+	for (int p = p0; p < p1; p++) {
+		const float a = _first[(size_t)p] * scale;
+		const float b = _secondBars.empty() ? 0.0f : _secondBars[(size_t)p] * scale;
+		if (a + b <= 0.0f)
+			continue;
+		if (price) {
+			const float x = o.anchorRight ? width - a : 0.0f;
+			firstRects.addWithoutMerging({ x, (float)p, a, 1.0f });
+			if (b > 0.0f)
+				secondRects.addWithoutMerging({ o.anchorRight ? x - b : a, (float)p, b, 1.0f });
+		}
+		else {
+			firstRects.addWithoutMerging({ (float)p, height - a, 1.0f, a });
+			if (b > 0.0f)
+				secondRects.addWithoutMerging({ (float)p, height - a - b, 1.0f, b });
+		}
+	}
+	g.setColour(o.colour.withMultipliedAlpha(o.alpha));
+	g.fillRectList(firstRects);
+	g.setColour(o.secondColour.withMultipliedAlpha(o.alpha));
+	g.fillRectList(secondRects);
+}
@@ -0,0 +1,81 @@
+/*
+  ==============================================================================
+
+    WChartHistogram.h
+    Created: 15 Oct 2026 6:41:17pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+#include "WChartTransform.h"
+
+/*
+	Bars over the chart : bin i covers [edges[i], edges[i + 1]) of the price
+	axis (drawn from a side of the viewport, volume profile) or of the time
+	axis (open_times, drawn up from the bottom), with an optional second value
+	stacked after the first (buy / sell).
+
+		WChartHistogram::Options o;
+		o.axis = WChartHistogram::Axis::price;
+		o.extent = 0.25f;
+		viewport.addHistogram(std::make_shared<WChartHistogram>(o))
+			->setBins(edges, buyVolumes, sellVolumes);
+
+	Every frame the bins are spread over the pixel rows (columns) they cover,
+	pro rata of the overlap, so a bar is the value per pixel whatever the zoom,
+	and the bars are scaled so that the largest visible one is extent of the
+	viewport. Without second values, the second colour is not used.
+*/
+
+class WChartHistogram {
+public:
+	enum class Axis { price, time };
+	enum class Style { hollow, fill };
+
+	struct Options {
+		Axis axis = Axis::price;
+		Style style = Style::fill;
+		Colour colour = Colour(0xff26a69a);       // values
+		Colour secondColour = Colour(0xffef5350); // second values
+		float alpha = 0.35f;
+		float extent = 0.25f;      // of the width (price) / height (time) for the largest bar
+		bool anchorRight = true;   // price axis, bars grow from the right side
+	};
+
+	explicit WChartHistogram(const Options& options = {});
+
+	// edges.size() == values.size() + 1, increasing; second empty or values.size()
+	void setBins(std::vector<double> edges, std::vector<double> values, std::vector<double> second = {});
+	const std::vector<double>& getEdges() const { return _edges; }
+	const Options& getOptions() const { return _options; }
+	void setOptions(const Options& options);
+	size_t size() const { return _values.size(); }
+	bool hasSecondValues() const { return !_second.empty(); }
+
+	// per pixel row (price) / column (time) of a viewport of that size, the lengths of the
+	// first and second bars as fractions of the largest ([0, 1], first + second <= 1)
+	void computeBars(const WChartScaleTransform& scaleT, int64 seriesOrigin, float width, float height,
+					 std::vector<float>& first, std::vector<float>& second);
+
+	void paint(Graphics& g, const WChartScaleTransform& scaleT, int64 seriesOrigin, float width, float height, float x0, float x1);
+
+	// called before / after the bins or the options change
+	std::function<void()> onChanging;
+	std::function<void()> onChanged;
+
+private:
+	// step outline of the tips of base + bars (base may be null)
+	void _addOutline(const std::vector<float>& bars, const std::vector<float>* base, float width, float height);
+
+	Options _options;
+	std::vector<double> _edges, _values, _second;
+
+	// per frame storage, kept between frames
+	std::vector<float> _edgePixels, _first, _secondBars;
+	Path _path;
+
+	JUCE_DECLARE_NON_COPYABLE(WChartHistogram)
+};
@@ -0,0 +1,40 @@
+/*
+  ==============================================================================
+
+    WChartLayerCache.cpp
+    Created: 14 Oct 2026 9:12:37pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "WChartLayerCache.h"
+
+void WChartLayerCache::invalidate() {
+	_valid = false;
+}
+
+void WChartLayerCache::clear() {
+	_image = {};
+	_valid = false;
+}
+
+Image& WChartLayerCache::_prepare(const Key& key) {
+	const int w = roundToInt((float)key.width * key.pixelScale);
+	const int h = roundToInt((float)key.height * key.pixelScale);
+	// same size : cleared in place, no allocation while only the scale changes
+	if (_image.isValid() && _image.getWidth() == w && _image.getHeight() == h)
+		_image.clear(_image.getBounds());
+	else
+		_image = Image(Image::ARGB, w, h, true);
+	_key = key;
+	_valid = true;
+	return _image;
+}
+
+void WChartLayerCache::_blit(Graphics& g) const {
+	if (_key.pixelScale == 1.0f)
+		g.drawImageAt(_image, 0, 0);
+	else
+		g.drawImageTransformed(_image, AffineTransform::scale(1.0f / _key.pixelScale));
+}
@@ -0,0 +1,71 @@
+/*
+  ==============================================================================
+
+    WChartLayerCache.h
+    Created: 14 Oct 2026 9:12:37pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+#include "WChartTransform.h"
+#include "../../../utils/FrameProfiler.h"
+
+/*
+	A chart layer that only changes with the bounds or the scale (background,
+	grid, axis labels), rendered once to an image at the display pixel scale
+	and blitted on the following frames.
+
+	The key holds what the content depends on, the layer is rendered again
+	when it differs from the one of the cached image. Callers leave the fields
+	they don't use to their defaults.
+*/
+
+class WChartLayerCache {
+public:
+	struct Key {
+		int width = 0, height = 0;
+		float pixelScale = 1.0f; // set by draw()
+		AxisMapping x, y;
+		AxisScale yScale = AxisScale::linear;
+		int64 tag = 0;           // anything else the layer depends on
+
+		bool operator==(const Key&) const = default;
+	};
+
+	// render(Graphics&) paints the layer in component coordinates, only called on a miss
+	template <typename Fn>
+	void draw(Graphics& g, Key key, Fn&& render) {
+		key.pixelScale = g.getInternalContext().getPhysicalPixelScaleFactor();
+		if (key.width <= 0 || key.height <= 0)
+			return;
+		auto& profiler = FrameProfiler::getInstance();
+		if (!_valid || !(key == _key)) {
+			profiler.count(FrameProfiler::cacheMisses);
+			Graphics ig(_prepare(key));
+			ig.addTransform(AffineTransform::scale(key.pixelScale));
+			render(ig);
+		}
+		else {
+			profiler.count(FrameProfiler::cacheHits);
+		}
+		const FrameProfiler::Scope scope(FrameProfiler::compositing);
+		_blit(g);
+	}
+
+	// forces a render on the next draw (colours changed...)
+	void invalidate();
+	// drops the image
+	void clear();
+	bool isValid() const { return _valid; }
+
+private:
+	Image& _prepare(const Key& key);
+	void _blit(Graphics& g) const;
+
+	Image _image;
+	Key _key;
+	bool _valid = false;
+};
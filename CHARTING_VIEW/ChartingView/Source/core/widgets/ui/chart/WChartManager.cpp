@@ -0,0 +1,73 @@
+/*
+  ==============================================================================
+
+    WChartManager.cpp
+    Created: 15 Oct 2026 7:20:48am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "WChartManager.h"
+
+WChartManager::WChartManager() {
+	_x.stack = this;
+	addPane(1.0f);
+}
+
+WChartManager::~WChartManager() {
+	// the panes reference _x
+	_panes.clear();
+}
+
+WChart* WChartManager::addPane(float weight) {
+	Pane p;
+	p.chart = std::make_unique<WChart>();
+	p.weight = jmax(0.01f, weight);
+	auto* chart = p.chart.get();
+	chart->setSharedX(&_x);
+	_panes.push_back(std::move(p));
+	addAndMakeVisible(chart);
+	_updateAxes();
+	resized();
+	return chart;
+}
+
+void WChartManager::removePane(WChart* pane) {
+	auto it = std::find_if(_panes.begin() + 1, _panes.end(), [pane](const Pane& p) { return p.chart.get() == pane; });
+	if (it == _panes.end())
+		return;
+	_panes.erase(it);
+	_updateAxes();
+	resized();
+}
+
+void WChartManager::_updateAxes() {
+	for (size_t i = 0; i < _panes.size(); i++)
+		_panes[i].chart->setXAxisVisible(i + 1 == _panes.size());
+}
+
+void WChartManager::resized() {
+	float total = 0.0f;
+	for (const auto& p : _panes)
+		total += p.weight;
+	auto bounds = getLocalBounds();
+	const int height = bounds.getHeight();
+	// same width for every pane, the shared x world is the viewport width
+	for (size_t i = 0; i < _panes.size(); i++) {
+		const bool last = i + 1 == _panes.size();
+		_panes[i].chart->setBounds(last ? bounds : bounds.removeFromTop(roundToInt((float)height * _panes[i].weight / total)));
+	}
+}
+
+void WChartManager::setStore(KlineStore::Ptr store) {
+	getPricePane().setStore(std::move(store));
+}
+
+const KlineStore::Ptr& WChartManager::getStore() const {
+	return getPricePane().getStore();
+}
+
+void WChartManager::loadFile(const File& file) {
+	getPricePane().loadFile(file);
+}
@@ -0,0 +1,60 @@
+/*
+  ==============================================================================
+
+    WChartManager.h
+    Created: 15 Oct 2026 7:20:48am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "../BaseComponent.h"
+#include "WChart.h"
+
+/*
+	Stacked charts (price, volume, RSI... panes) over one time axis and one
+	data store.
+
+	Every pane's transform reads and writes the x members of the manager's
+	(WChartScaleTransform::setSharedX) : a pan or a zoom from any pane moves
+	them all with nothing to sync, and repaints the manager, so the whole
+	stack paints in one batch. The time axis is only shown under the last pane.
+
+	The price pane draws the candles of the store, the other panes draw
+	curves over the same rows (addCurve(getStore(), values)) : they keep a
+	reference to the store, its columns exist once.
+*/
+
+class WChartManager : public BaseComponent {
+public:
+	WChartManager();
+	~WChartManager();
+
+	void resized() override;
+
+	// new pane under the others, weight is its share of the height (the price pane has 1)
+	WChart* addPane(float weight = 0.3f);
+	// any pane but the price pane
+	void removePane(WChart* pane);
+	int getNumPanes() const { return (int)_panes.size(); }
+	WChart* getPane(int index) const { return _panes[(size_t)index].chart.get(); }
+	WChart& getPricePane() const { return *_panes.front().chart; }
+
+	void setStore(KlineStore::Ptr store);
+	const KlineStore::Ptr& getStore() const;
+	void loadFile(const File& file);
+
+private:
+	struct Pane {
+		UPtr<WChart> chart;
+		float weight = 1.0f;
+	};
+
+	void _updateAxes();
+
+	WChart::SharedX _x;
+	std::vector<Pane> _panes;
+
+	JUCE_DECLARE_NON_COPYABLE(WChartManager)
+};
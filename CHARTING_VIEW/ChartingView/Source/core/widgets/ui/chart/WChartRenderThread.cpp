@@ -0,0 +1,142 @@
+/*
+  ==============================================================================
+
+    WChartRenderThread.cpp
+    Created: 15 Oct 2026 1:02:15am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "WChartRenderThread.h"
+#include "../../../utils/FrameProfiler.h"
+
+static bool isSameKey(const WChartScrollLayer::Key& a, const WChartScrollLayer::Key& b) {
+	return a.isSameFrameAs(b) && a.x.offset == b.x.offset;
+}
+
+WChartRenderThread::WChartRenderThread() {
+	_ready.onAsyncUpdate = [this]() {
+		if (onFrameReady)
+			onFrameReady();
+	};
+	_thread.onRun = [this]() { _run(); };
+	_thread.startThread();
+}
+
+WChartRenderThread::~WChartRenderThread() {
+	_thread.signalThreadShouldExit();
+	_wake.signal();
+	_thread.stopThread(4000);
+	_ready.cancelPendingUpdate();
+}
+
+bool WChartRenderThread::draw(Graphics& g, Key& key) {
+	key.pixelScale = g.getInternalContext().getPhysicalPixelScaleFactor();
+	const ScopedLock sl(_lock);
+	if (!_front.valid)
+		return false;
+	const FrameProfiler::Scope scope(FrameProfiler::compositing);
+	const auto toComponent = AffineTransform::scale(1.0f / _front.key.pixelScale);
+	const bool exact = isSameKey(_front.key, key) && !_front.stale;
+	FrameProfiler::getInstance().count(exact ? FrameProfiler::cacheHits : FrameProfiler::cacheMisses);
+	if (exact && _front.key.pixelScale == 1.0f)
+		g.drawImageAt(_front.image, 0, 0);
+	else
+		g.drawImageTransformed(_front.image, toComponent.followedBy(exact ? AffineTransform() : _getFrameTransform(_front.key, key)));
+	return exact;
+}
+
+AffineTransform WChartRenderThread::_getFrameTransform(const Key& from, const Key& to) {
+	// both mappings are linear (in Scale::forward space for y), a pixel of one is an affine function of the other
+	const auto x = from.x.withOrigin(to.x.origin);
+	const double sx = to.x.scale / x.scale;
+	const double tx = to.x.offset - x.offset * sx;
+	double sy = 1.0, ty = 0.0;
+	if (from.yScale == to.yScale && from.y.origin == to.y.origin) {
+		sy = to.y.scale / from.y.scale;
+		ty = to.y.offset - from.y.offset * sy;
+	}
+	return AffineTransform((float)sx, 0.0f, (float)tx, 0.0f, (float)sy, (float)ty);
+}
+
+void WChartRenderThread::request(const Key& key, Render render) {
+	if (_hasRequested && isSameKey(_requested, key))
+		return;
+	{
+		const ScopedLock sl(_lock);
+		if (_pending.valid)
+			_numDropped++;
+		_pending.key = key;
+		_pending.render = std::move(render);
+		_pending.valid = true;
+	}
+	_requested = key;
+	_hasRequested = true;
+	_wake.signal();
+}
+
+void WChartRenderThread::cancel() {
+	{
+		const ScopedLock sl(_lock);
+		_pending = {};
+	}
+	_hasRequested = false;
+	// the frame in flight reads the data the caller is about to change
+	const ScopedLock rl(_renderLock);
+}
+
+void WChartRenderThread::invalidate() {
+	cancel();
+	const ScopedLock sl(_lock);
+	_front.stale = true;
+}
+
+void WChartRenderThread::clear() {
+	cancel();
+	const ScopedLock sl(_lock);
+	_front.valid = false;
+}
+
+void WChartRenderThread::_run() {
+	while (!_thread.threadShouldExit()) {
+		_wake.wait(-1);
+		for (;;) {
+			// taken under the render lock, cancel() either drops it first or waits for the frame
+			const ScopedLock rl(_renderLock);
+			Request r;
+			{
+				const ScopedLock sl(_lock);
+				if (!_pending.valid)
+					break;
+				r = std::move(_pending);
+				_pending = {};
+			}
+			if (_thread.threadShouldExit())
+				return;
+
+			const int w = roundToInt((float)r.key.width * r.key.pixelScale);
+			const int h = roundToInt((float)r.key.height * r.key.pixelScale);
+			if (w <= 0 || h <= 0)
+				continue;
+			if (_back.image.getWidth() != w || _back.image.getHeight() != h)
+				_back.image = Image(Image::ARGB, w, h, true, SoftwareImageType());
+			else
+				_back.image.clear(_back.image.getBounds());
+			{
+				Graphics ig(_back.image);
+				ig.addTransform(AffineTransform::scale(r.key.pixelScale));
+				r.render(ig);
+			}
+			_back.key = r.key;
+			_back.valid = true;
+			_back.stale = false;
+			{
+				const ScopedLock sl(_lock);
+				std::swap(_front, _back);
+			}
+			_numRendered++;
+			_ready.triggerAsyncUpdate();
+		}
+	}
+}
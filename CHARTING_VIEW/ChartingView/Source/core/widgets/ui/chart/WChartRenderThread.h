@@ -0,0 +1,90 @@
+/*
+  ==============================================================================
+
+    WChartRenderThread.h
+    Created: 15 Oct 2026 1:02:15am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+#include "WChartScrollLayer.h"
+#include "../../../utils/ThreadLambda.h"
+#include "../../../utils/AsyncUpdaterLambda.h"
+
+/*
+	Data layer of a chart rasterized on a worker thread, double buffered :
+	the worker renders the last requested frame into the back image and
+	swaps it with the front one, the message thread only draws the front.
+
+	While the worker is behind, draw() shows the last finished frame moved
+	and scaled to the current mappings, pans and zooms follow the mouse and
+	the exact frame replaces it when done. A request the worker did not start
+	yet is replaced by the next one, stale frames are never rendered.
+
+	The render function runs on the worker : it only reads what it captured
+	and data the owner does not change without calling cancel() first.
+*/
+
+class WChartRenderThread {
+public:
+	using Key = WChartScrollLayer::Key;
+	// paints the frame in component coordinates, on a transparent background
+	using Render = std::function<void(Graphics&)>;
+
+	WChartRenderThread();
+	~WChartRenderThread();
+
+	// draws the last finished frame mapped to key (key.pixelScale is set from g),
+	// true when it is the frame of key
+	bool draw(Graphics& g, Key& key);
+	// renders the frame of key in the background, nothing when it is already the requested one
+	void request(const Key& key, Render render);
+	// drops the pending request and waits for the frame being rendered, call before
+	// changing data the render functions read
+	void cancel();
+	// cancel(), the last frame is still drawn in the meantime but rendered again
+	void invalidate();
+	// cancel() and forgets the frames
+	void clear();
+
+	// message thread, a new frame can be drawn
+	std::function<void()> onFrameReady;
+
+	int getNumRendered() const { return _numRendered.load(); }
+	// requests replaced before the worker started them
+	int getNumDropped() const { return _numDropped.load(); }
+
+private:
+	struct Frame {
+		Key key;
+		Image image;
+		bool valid = false;
+		bool stale = false;
+	};
+	struct Request {
+		Key key;
+		Render render;
+		bool valid = false;
+	};
+
+	void _run();
+	static AffineTransform _getFrameTransform(const Key& from, const Key& to);
+
+	CriticalSection _lock;        // _pending, _front and the swap
+	CriticalSection _renderLock;  // held by the worker for a whole frame
+	WaitableEvent _wake;
+	Request _pending;
+	Frame _front;
+	Frame _back;                  // worker only
+	Key _requested;
+	bool _hasRequested = false;
+	std::atomic<int> _numRendered{ 0 };
+	std::atomic<int> _numDropped{ 0 };
+	AsyncUpdaterLambda _ready;
+	ThreadLambda _thread{ "WChartRenderThread" };
+
+	JUCE_DECLARE_NON_COPYABLE(WChartRenderThread)
+};
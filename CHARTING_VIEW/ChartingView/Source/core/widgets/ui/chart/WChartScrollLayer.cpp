@@ -0,0 +1,84 @@
+/*
+  ==============================================================================
+
+    WChartScrollLayer.cpp
+    Created: 14 Oct 2026 10:04:18pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "WChartScrollLayer.h"
+
+void WChartScrollLayer::invalidate(Rectangle<int> area) {
+	_dirty = _dirty.isEmpty() ? area : _dirty.getUnion(area);
+}
+
+void WChartScrollLayer::invalidate() {
+	_valid = false;
+}
+
+void WChartScrollLayer::clear() {
+	_image = {};
+	_valid = false;
+	_dirty = {};
+}
+
+Rectangle<int> WChartScrollLayer::_prepare(const Key& key) {
+	const Rectangle<int> bounds(key.width, key.height);
+	const int w = roundToInt((float)key.width * key.pixelScale);
+	const int h = roundToInt((float)key.height * key.pixelScale);
+
+	int shift = 0;
+	bool full = !_valid || !key.isSameFrameAs(_key) || _image.getWidth() != w || _image.getHeight() != h;
+	if (!full) {
+		const double dx = (key.x.offset - _contentOffset) * (double)key.pixelScale;
+		shift = (int)std::lround(dx);
+		full = std::abs(dx - (double)shift) > maxShiftError || std::abs(shift) >= w;
+	}
+
+	_key = key;
+	if (full) {
+		if (_image.getWidth() != w || _image.getHeight() != h)
+			_image = Image(Image::ARGB, w, h, true);
+		else
+			_image.clear(_image.getBounds());
+		_contentOffset = key.x.offset;
+		_valid = true;
+		_dirty = {};
+		_numShifts = 0;
+		return bounds;
+	}
+
+	auto area = _dirty.getIntersection(bounds);
+	_dirty = {};
+	if (shift != 0) {
+		// content moves by shift physical pixels, the strip it uncovers is rendered
+		const int n = std::abs(shift);
+		if (shift > 0)
+			_image.moveImageSection(shift, 0, 0, 0, w - n, h);
+		else
+			_image.moveImageSection(0, 0, n, 0, w - n, h);
+		const Rectangle<int> strip(shift > 0 ? 0 : w - n, 0, n, h);
+		_image.clear(strip);
+		_contentOffset += (double)shift / (double)key.pixelScale;
+		_numShifts++;
+
+		// back to component coordinates, rounded outwards
+		const auto s = strip.toFloat() / key.pixelScale;
+		const auto exposed = s.getSmallestIntegerContainer().getIntersection(bounds);
+		area = area.isEmpty() ? exposed : area.getUnion(exposed);
+	}
+	if (!area.isEmpty()) {
+		const auto physical = (area.toFloat() * key.pixelScale).getSmallestIntegerContainer().getIntersection(_image.getBounds());
+		_image.clear(physical);
+	}
+	return area;
+}
+
+void WChartScrollLayer::_blit(Graphics& g) const {
+	if (_key.pixelScale == 1.0f)
+		g.drawImageAt(_image, 0, 0);
+	else
+		g.drawImageTransformed(_image, AffineTransform::scale(1.0f / _key.pixelScale));
+}
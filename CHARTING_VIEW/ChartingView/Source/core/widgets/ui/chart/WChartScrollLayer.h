@@ -0,0 +1,87 @@
+/*
+  ==============================================================================
+
+    WChartScrollLayer.h
+    Created: 14 Oct 2026 10:04:18pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+#include "WChartTransform.h"
+#include "../../../utils/FrameProfiler.h"
+
+/*
+	Offscreen data layer that follows horizontal pans : when only the x offset
+	of the mapping moved (by a whole number of physical pixels), the previous
+	image is shifted and only the exposed column strip is rendered. Any other
+	change of the key (size, zoom, y range, scale...) renders the whole layer.
+
+	The x offset the image content was rendered at is tracked separately from
+	the key, the rounding of the shifts never accumulates over a long pan.
+	Areas whose data changed (live ticks) are invalidated and rendered again
+	on the next draw, the rest of the image is kept.
+*/
+
+class WChartScrollLayer {
+public:
+	struct Key {
+		int width = 0, height = 0;
+		float pixelScale = 1.0f; // set by draw()
+		AxisMapping x;           // x.offset may differ, the image is shifted
+		AxisMapping y;
+		AxisScale yScale = AxisScale::linear;
+		int64 tag = 0;           // anything else the content depends on
+
+		bool isSameFrameAs(const Key& other) const {
+			return width == other.width && height == other.height && pixelScale == other.pixelScale
+				&& x.origin == other.x.origin && x.scale == other.x.scale
+				&& y == other.y && yScale == other.yScale && tag == other.tag;
+		}
+	};
+
+	// largest error between the shifted content and its exact place, in physical pixels
+	static constexpr double maxShiftError = 0.05;
+
+	// render(Graphics&, Rectangle<int> area) paints the content of area, in component
+	// coordinates, on a transparent background. Only called for the areas that changed
+	template <typename Fn>
+	void draw(Graphics& g, Key key, Fn&& render) {
+		key.pixelScale = g.getInternalContext().getPhysicalPixelScaleFactor();
+		if (key.width <= 0 || key.height <= 0)
+			return;
+		const auto area = _prepare(key);
+		// a strip uncovered by a pan counts as a miss
+		FrameProfiler::getInstance().count(area.isEmpty() ? FrameProfiler::cacheHits : FrameProfiler::cacheMisses);
+		if (!area.isEmpty()) {
+			Graphics ig(_image);
+			ig.addTransform(AffineTransform::scale(key.pixelScale));
+			ig.reduceClipRegion(area);
+			render(ig, area);
+		}
+		const FrameProfiler::Scope scope(FrameProfiler::compositing);
+		_blit(g);
+	}
+
+	// the content of area (component coordinates) changed, rendered again on the next draw
+	void invalidate(Rectangle<int> area);
+	// everything is rendered again on the next draw
+	void invalidate();
+	void clear();
+
+	// strips rendered since the last full render, for the stats
+	int getNumShifts() const { return _numShifts; }
+
+private:
+	Rectangle<int> _prepare(const Key& key);
+	void _blit(Graphics& g) const;
+
+	Image _image;
+	Key _key;
+	double _contentOffset = 0.0; // x.offset the content of the image is at
+	bool _valid = false;
+	Rectangle<int> _dirty;
+	int _numShifts = 0;
+};
@@ -0,0 +1,302 @@
+/*
+  ==============================================================================
+
+    WChartShapes.cpp
+    Created: 15 Oct 2026 4:40:02am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "WChartShapes.h"
+
+static Point<float> getNearestOnSegment(Point<float> p, Point<float> a, Point<float> b) {
+	const auto ab = b - a;
+	const float length2 = ab.x * ab.x + ab.y * ab.y;
+	const float t = length2 > 0.0f ? jlimit(0.0f, 1.0f, ((p - a).x * ab.x + (p - a).y * ab.y) / length2) : 0.0f;
+	return a + ab * t;
+}
+
+void WChartShapes::_changing() {
+	if (onChanging)
+		onChanging();
+}
+
+void WChartShapes::_changed() {
+	if (onChanged)
+		onChanged();
+}
+
+WChartShapes::Id WChartShapes::_index(Group group, uint64 handle, const SpatialGrid::Box& bounds, double price) {
+	auto& grid = _grids[group];
+	if (grid.size() == 0) {
+		// 1 s x 1 bp of the first price for the finest cells, 4^11 times that for the coarsest
+		grid.clear();
+		grid.setCellSize(1000.0, jmax(1e-9, std::abs(price) * 1e-4));
+	}
+	grid.insert(SlotPool<Marker>::getSlot(handle), bounds);
+	return _makeId(group, handle);
+}
+
+WChartShapes::Id WChartShapes::addMarker(Type type, int64 time, double price, const Options& options) {
+	jassert(_isMarker(type));
+	_changing();
+	_maxMarkerSize = jmax(_maxMarkerSize, options.size);
+	// world box of a marker is its center, its pixel size is added to the queries
+	const auto id = _index(markers, _markers.add({ type, time, price, options }), { (double)time, price, (double)time, price }, price);
+	_changed();
+	return id;
+}
+
+WChartShapes::Id WChartShapes::addRect(int64 startTime, double low, int64 endTime, double high, const Options& options) {
+	_changing();
+	RectShape r{ { jmin(startTime, endTime), jmin(low, high) }, { jmax(startTime, endTime), jmax(low, high) }, options };
+	const SpatialGrid::Box bounds{ (double)r.start.time, r.start.price, (double)r.end.time, r.end.price };
+	const auto id = _index(rects, _rects.add(r), bounds, r.start.price);
+	_changed();
+	return id;
+}
+
+WChartShapes::Id WChartShapes::addPath(std::vector<WorldPoint> points, const Options& options) {
+	if (points.empty())
+		return invalidId;
+	_changing();
+	SpatialGrid::Box bounds{ (double)points[0].time, points[0].price, (double)points[0].time, points[0].price };
+	for (const auto& p : points)
+		bounds = bounds.getUnion({ (double)p.time, p.price, (double)p.time, p.price });
+	PathShape path{ (uint32)_pathPoints.size(), (uint32)points.size(), options };
+	_pathPoints.insert(_pathPoints.end(), points.begin(), points.end());
+	_numUsedPathPoints += points.size();
+	const auto id = _index(paths, _paths.add(path), bounds, points[0].price);
+	_changed();
+	return id;
+}
+
+bool WChartShapes::contains(Id id) const {
+	if (id == invalidId)
+		return false;
+	const auto h = _getHandle(id);
+	switch (_getGroup(id)) {
+	case markers: return _markers.contains(h);
+	case rects: return _rects.contains(h);
+	case paths: return _paths.contains(h);
+	default: return false;
+	}
+}
+
+WChartShapes::Type WChartShapes::getType(Id id) const {
+	jassert(contains(id));
+	switch (_getGroup(id)) {
+	case markers: return _markers.get(_getHandle(id))->type;
+	case rects: return Type::rect;
+	default: return Type::path;
+	}
+}
+
+WChartShapes::WorldPoint WChartShapes::getPosition(Id id) const {
+	jassert(contains(id));
+	const auto h = _getHandle(id);
+	switch (_getGroup(id)) {
+	case markers: return { _markers.get(h)->time, _markers.get(h)->price };
+	case rects: return _rects.get(h)->start;
+	default: return _pathPoints[_paths.get(h)->first];
+	}
+}
+
+void WChartShapes::remove(Id id) {
+	if (!contains(id))
+		return;
+	_changing();
+	const auto h = _getHandle(id);
+	const auto group = _getGroup(id);
+	_grids[group].remove(SlotPool<Marker>::getSlot(h));
+	if (group == markers) {
+		_markers.remove(h);
+	}
+	else if (group == rects) {
+		_rects.remove(h);
+	}
+	else {
+		_numUsedPathPoints -= _paths.get(h)->count;
+		_paths.remove(h);
+		if (_numUsedPathPoints < _pathPoints.size() / 2)
+			_compactPathPoints();
+	}
+	_changed();
+}
+
+void WChartShapes::_compactPathPoints() {
+	std::vector<WorldPoint> packed;
+	packed.reserve(_numUsedPathPoints);
+	for (auto& path : _paths) {
+		const uint32 first = (uint32)packed.size();
+		packed.insert(packed.end(), _pathPoints.begin() + path.first, _pathPoints.begin() + path.first + path.count);
+		path.first = first;
+	}
+	_pathPoints.swap(packed);
+}
+
+void WChartShapes::clear() {
+	_changing();
+	_markers.clear();
+	_rects.clear();
+	_paths.clear();
+	_pathPoints.clear();
+	_numUsedPathPoints = 0;
+	for (auto& grid : _grids)
+		grid.clear();
+	_maxMarkerSize = 0.0f;
+	_changed();
+}
+
+SpatialGrid::Box WChartShapes::_getPixelQuery(const WChartScaleTransform& scaleT, int64 seriesOrigin, float width, float height, float px0, float py0, float px1, float py1) const {
+	const auto xMap = scaleT.getXMapping(seriesOrigin, width);
+	const double t0 = xMap.toValue(px0), t1 = xMap.toValue(px1);
+	return scaleT.withYMapper(height, [&](const auto& yMap) {
+		const double p0 = yMap.toValue(py0), p1 = yMap.toValue(py1);
+		return SpatialGrid::Box{ jmin(t0, t1), jmin(p0, p1), jmax(t0, t1), jmax(p0, p1) };
+	});
+}
+
+bool WChartShapes::hitTest(Point<float> p, float maxDistance, const WChartScaleTransform& scaleT, int64 seriesOrigin, float width, float height, Hit& hit) const {
+	if (size() == 0)
+		return false;
+	const auto xMap = scaleT.getXMapping(seriesOrigin, width);
+	return scaleT.withYMapper(height, [&](const auto& yMap) {
+		auto toPixel = [&](const WorldPoint& w) { return Point<float>(xMap.toPixel(w.time), yMap.toPixel(w.price)); };
+		hit = {};
+		hit.distance = maxDistance;
+		auto consider = [&](Id id, float d, Point<float> anchor) {
+			// ties go to the group drawn on top
+			if (d <= hit.distance) {
+				hit.id = id;
+				hit.distance = d;
+				hit.anchor = anchor;
+			}
+		};
+		auto query = [&](Group group, float r) -> const std::vector<uint32>& {
+			_hitIds.clear();
+			_grids[group].query(_getPixelQuery(scaleT, seriesOrigin, width, height, p.x - r, p.y - r, p.x + r, p.y + r), _hitIds);
+			return _hitIds;
+		};
+
+		for (auto slot : query(rects, maxDistance)) {
+			const auto& s = _rects.getBySlot(slot);
+			const Rectangle<float> rect(toPixel(s.start), toPixel(s.end));
+			const auto anchor = rect.getConstrainedPoint(p);
+			float d = p.getDistanceFrom(anchor);
+			if (!s.options.filled) {
+				// hollow : distance to the border from inside too
+				if (d == 0.0f)
+					d = jmin(p.x - rect.getX(), rect.getRight() - p.x, p.y - rect.getY(), rect.getBottom() - p.y);
+				d = jmax(0.0f, d - s.options.thickness * 0.5f);
+			}
+			consider(_makeId(rects, _rects.getHandleBySlot(slot)), d, anchor);
+		}
+		for (auto slot : query(paths, maxDistance)) {
+			const auto& s = _paths.getBySlot(slot);
+			const auto* points = _pathPoints.data() + s.first;
+			auto a = toPixel(points[0]);
+			float d = p.getDistanceFrom(a);
+			auto anchor = a;
+			for (uint32 i = 1; i < s.count; i++) {
+				const auto b = toPixel(points[i]);
+				const auto nearest = getNearestOnSegment(p, a, b);
+				if (p.getDistanceFrom(nearest) < d) {
+					d = p.getDistanceFrom(nearest);
+					anchor = nearest;
+				}
+				a = b;
+			}
+			consider(_makeId(paths, _paths.getHandleBySlot(slot)), jmax(0.0f, d - s.options.thickness * 0.5f), anchor);
+		}
+		// any marker whose center is within its radius + maxDistance
+		for (auto slot : query(markers, maxDistance + _maxMarkerSize * 0.5f)) {
+			const auto& s = _markers.getBySlot(slot);
+			const auto anchor = toPixel({ s.time, s.price });
+			consider(_makeId(markers, _markers.getHandleBySlot(slot)), jmax(0.0f, p.getDistanceFrom(anchor) - s.options.size * 0.5f), anchor);
+		}
+		return hit.id != invalidId;
+	});
+}
+
+void WChartShapes::getVisible(const WChartScaleTransform& scaleT, int64 seriesOrigin, float width, float height, float x0, float x1,
+	std::vector<Visible>& shapes, std::vector<Point<float>>& points) {
+	shapes.clear();
+	points.clear();
+	if (size() == 0)
+		return;
+	const auto xMap = scaleT.getXMapping(seriesOrigin, width);
+	scaleT.withYMapper(height, [&](const auto& yMap) {
+		auto toPixel = [&](const WorldPoint& w) { return Point<float>(xMap.toPixel(w.time), yMap.toPixel(w.price)); };
+		auto query = [&](Group group, float r) -> const std::vector<uint32>& {
+			_paintIds.clear();
+			_grids[group].query(_getPixelQuery(scaleT, seriesOrigin, width, height, x0 - r, -r, x1 + r, height + r), _paintIds);
+			return _paintIds;
+		};
+
+		for (auto slot : query(rects, 1.0f)) {
+			const auto& s = _rects.getBySlot(slot);
+			shapes.push_back({ Type::rect, Rectangle<float>(toPixel(s.start), toPixel(s.end)), s.options });
+		}
+		for (auto slot : query(paths, 1.0f)) {
+			const auto& s = _paths.getBySlot(slot);
+			const auto* world = _pathPoints.data() + s.first;
+			Visible v{ Type::path, {}, s.options, (uint32)points.size(), s.count };
+			for (uint32 i = 0; i < s.count; i++)
+				points.push_back(toPixel(world[i]));
+			shapes.push_back(v);
+		}
+		for (auto slot : query(markers, _maxMarkerSize * 0.5f + 1.0f)) {
+			const auto& s = _markers.getBySlot(slot);
+			const auto c = toPixel({ s.time, s.price });
+			const float half = s.options.size * 0.5f;
+			shapes.push_back({ s.type, { c.x - half, c.y - half, s.options.size, s.options.size }, s.options });
+		}
+	});
+}
+
+void WChartShapes::paint(Graphics& g, const WChartScaleTransform& scaleT, int64 seriesOrigin, float width, float height, float x0, float x1) {
+	getVisible(scaleT, seriesOrigin, width, height, x0, x1, _visible, _visiblePoints);
+	for (const auto& v : _visible) {
+		const auto& o = v.options;
+		const auto& r = v.bounds;
+		g.setColour(o.colour);
+		switch (v.type) {
+		case Type::rect:
+			if (o.filled)
+				g.fillRect(r);
+			else
+				g.drawRect(r, o.thickness);
+			break;
+		case Type::path:
+			_path.clear();
+			_path.startNewSubPath(_visiblePoints[v.first]);
+			for (uint32 i = 1; i < v.count; i++)
+				_path.lineTo(_visiblePoints[v.first + i]);
+			g.strokePath(_path, PathStrokeType(o.thickness));
+			break;
+		case Type::dot:
+			g.fillEllipse(r);
+			break;
+		case Type::circle:
+			if (o.filled)
+				g.fillEllipse(r);
+			else
+				g.drawEllipse(r, o.thickness);
+			break;
+		default: {
+			const auto c = r.getCentre();
+			const float half = r.getWidth() * 0.5f;
+			const float dir = v.type == Type::triangleUp ? 1.0f : -1.0f;
+			_path.clear();
+			_path.addTriangle(c.x, c.y - half * dir, c.x + half, c.y + half * dir, c.x - half, c.y + half * dir);
+			if (o.filled)
+				g.fillPath(_path);
+			else
+				g.strokePath(_path, PathStrokeType(o.thickness));
+			break;
+		}
+		}
+	}
+}
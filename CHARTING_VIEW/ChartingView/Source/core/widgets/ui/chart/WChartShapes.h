@@ -0,0 +1,148 @@
+/*
+  ==============================================================================
+
+    WChartShapes.h
+    Created: 15 Oct 2026 4:40:02am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+#include "WChartTransform.h"
+#include "../../../data/SpatialGrid.h"
+#include "../../../utils/SlotPool.h"
+
+/*
+	Pool of shapes drawn over the candles (fills, signals, zones...), placed in
+	world units : open_time ms x price.
+
+	Markers (dot, circle, triangles) keep their size in pixels, rects and
+	paths are in world units. Every shape is indexed in a SpatialGrid as it is
+	added : painting reads the visible ones only and hitTest() answers a mouse
+	move in a few cells, with tens of thousands of markers.
+
+	Storage is one SlotPool (contiguous values, stable handles) and one grid
+	per group : markers, rects, paths, the path points share one array. Ids are
+	the pool handles tagged with their group, a removed id is detected.
+	clear() keeps every capacity, painting allocates nothing once the sizes
+	settle. Rects are drawn first, then paths, then markers.
+*/
+
+class WChartShapes {
+public:
+	using Id = uint64;
+	static constexpr Id invalidId = ~(Id)0;
+
+	enum class Type {
+		dot,          // always filled, size is the diameter
+		circle,
+		triangleUp,
+		triangleDown,
+		rect,
+		path
+	};
+
+	struct Options {
+		Colour colour = Colours::white;
+		bool filled = true;      // circle, triangles, rect (paths are only stroked)
+		float size = 8.0f;       // px, markers
+		float thickness = 1.0f;  // px, hollow shapes and paths
+	};
+
+	struct WorldPoint {
+		int64 time = 0;
+		double price = 0.0;
+	};
+
+	// a shape as drawn, in pixels : a marker is inscribed in bounds, a rect fills it, a path
+	// goes through points [first, first + count) of the points given with it
+	struct Visible {
+		Type type = Type::dot;
+		Rectangle<float> bounds;
+		Options options;
+		uint32 first = 0, count = 0;
+	};
+
+	struct Hit {
+		Id id = invalidId;
+		float distance = 0.0f;   // px, 0 inside a filled shape
+		Point<float> anchor;     // px, marker center or nearest point otherwise
+	};
+
+	WChartShapes() = default;
+
+	Id addMarker(Type type, int64 time, double price, const Options& options = {});
+	Id addRect(int64 startTime, double low, int64 endTime, double high, const Options& options = {});
+	Id addPath(std::vector<WorldPoint> points, const Options& options = {});
+	void remove(Id id);
+	// every shape at once (another series loaded), the storage is kept
+	void clear();
+	// expected number of markers, before adding them in bulk
+	void reserveMarkers(size_t n) { _markers.reserve(n); }
+	size_t size() const { return _markers.size() + _rects.size() + _paths.size(); }
+	bool contains(Id id) const;
+	// valid ids only
+	Type getType(Id id) const;
+	WorldPoint getPosition(Id id) const;
+
+	// nearest shape within maxDistance px of p, in a viewport of that size
+	bool hitTest(Point<float> p, float maxDistance, const WChartScaleTransform& scaleT, int64 seriesOrigin, float width, float height, Hit& hit) const;
+
+	// draws the shapes inside the x range [x0, x1] (pixels) of a viewport of that size
+	void paint(Graphics& g, const WChartScaleTransform& scaleT, int64 seriesOrigin, float width, float height, float x0, float x1);
+	// the shapes paint() would draw, in its order, for another renderer (WChartGLRenderer).
+	// Same thread as paint()
+	void getVisible(const WChartScaleTransform& scaleT, int64 seriesOrigin, float width, float height, float x0, float x1,
+		std::vector<Visible>& shapes, std::vector<Point<float>>& points);
+
+	// called before / after shapes are added or removed
+	std::function<void()> onChanging;
+	std::function<void()> onChanged;
+
+private:
+	enum Group { markers = 0, rects, paths, numGroups };
+
+	struct Marker {
+		Type type = Type::dot;
+		int64 time = 0;
+		double price = 0.0;
+		Options options;
+	};
+	struct RectShape {
+		WorldPoint start, end;   // start low, end high
+		Options options;
+	};
+	struct PathShape {
+		uint32 first = 0;        // in _pathPoints
+		uint32 count = 0;
+		Options options;
+	};
+
+	static Id _makeId(Group group, SlotPool<Marker>::Handle h) { return h | ((Id)group << 62); }
+	static Group _getGroup(Id id) { return (Group)(id >> 62); }
+	static uint64 _getHandle(Id id) { return id & ~((Id)3 << 62); }
+	static bool _isMarker(Type t) { return t <= Type::triangleDown; }
+
+	void _changing();
+	void _changed();
+	Id _index(Group group, uint64 handle, const SpatialGrid::Box& bounds, double price);
+	void _compactPathPoints();
+	SpatialGrid::Box _getPixelQuery(const WChartScaleTransform& scaleT, int64 seriesOrigin, float width, float height, float px0, float py0, float px1, float py1) const;
+
+	SlotPool<Marker> _markers;
+	SlotPool<RectShape> _rects;
+	SlotPool<PathShape> _paths;
+	std::vector<WorldPoint> _pathPoints;
+	size_t _numUsedPathPoints = 0;
+	SpatialGrid _grids[numGroups]; // ids are the pool slots
+	float _maxMarkerSize = 0.0f;
+	std::vector<uint32> _paintIds;       // painting thread
+	std::vector<Visible> _visible;
+	std::vector<Point<float>> _visiblePoints;
+	mutable std::vector<uint32> _hitIds; // message thread
+	Path _path;
+
+	JUCE_DECLARE_NON_COPYABLE(WChartShapes)
+};
@@ -0,0 +1,72 @@
+/*
+  ==============================================================================
+
+    WChartSignals.cpp
+    Created: 15 Oct 2026 5:02:51pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "WChartSignals.h"
+#include "WChart.h"
+#include "../WLookAndFeel.h"
+
+WChartSignals::WChartSignals(WChart& chart) : _chart(chart) {
+}
+
+WChartSignals::~WChartSignals() {
+	_removeMarkers();
+}
+
+bool WChartSignals::setRules(const String& longEntry, const String& shortEntry, String* error) {
+	if (!_engine.setRules(longEntry, shortEntry, error))
+		return false;
+	update();
+	return true;
+}
+
+void WChartSignals::setParameter(const String& name, double value) {
+	_engine.setParameter(name, value);
+	update();
+}
+
+void WChartSignals::setBacktest(const SignalEngine::Backtest& backtest) {
+	_backtest = backtest;
+	update();
+}
+
+void WChartSignals::update() {
+	_removeMarkers();
+	const auto& store = _chart.getDisplayedStore();
+	if (!store || store->isEmpty()) {
+		_result = {};
+		return;
+	}
+	_result = _engine.evaluate(*store, _backtest);
+
+	auto& shapes = _chart.getShapes();
+	shapes.reserveMarkers(shapes.size() + _result.trades.size() * 2);
+	_markers.reserve(_result.trades.size() * 2);
+	WChartShapes::Options entry, exit;
+	exit.size = 5.0f;
+	for (const auto& t : _result.trades) {
+		entry.colour = t.isLong ? WLookAndFeel::candleUpColour : WLookAndFeel::candleDownColour;
+		exit.colour = t.returnPct > 0.0 ? WLookAndFeel::candleUpColour : WLookAndFeel::candleDownColour;
+		_markers.push_back(shapes.addMarker(t.isLong ? WChartShapes::Type::triangleUp : WChartShapes::Type::triangleDown, t.entryTime, t.entryPrice, entry));
+		_markers.push_back(shapes.addMarker(WChartShapes::Type::dot, t.exitTime, t.exitPrice, exit));
+	}
+}
+
+void WChartSignals::clear() {
+	_removeMarkers();
+	_result = {};
+}
+
+void WChartSignals::_removeMarkers() {
+	// the chart may have cleared its shapes meanwhile (new file), removed ids are skipped
+	auto& shapes = _chart.getShapes();
+	for (auto id : _markers)
+		shapes.remove(id);
+	_markers.clear();
+}
@@ -0,0 +1,59 @@
+/*
+  ==============================================================================
+
+    WChartSignals.h
+    Created: 15 Oct 2026 5:02:51pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+#include "WChartShapes.h"
+#include "../../../data/SignalEngine.h"
+
+class WChart;
+
+/*
+	SignalEngine rules evaluated over the candles of a WChart, the trades shown
+	as markers : entries are triangles in the direction of the trade, exits
+	are dots, green for a winning trade and red otherwise.
+
+		WChartSignals signals(chart);
+		signals.setRules("crossover(ema(close, 1), ema(close, $slow))", "");
+		signals.setParameter("slow", 30); // from a slider, re-evaluates
+
+	Only its own markers are replaced on an update, the other shapes of the
+	chart stay. Message thread.
+*/
+
+class WChartSignals {
+public:
+	explicit WChartSignals(WChart& chart);
+	// removes its markers
+	~WChartSignals();
+
+	bool setRules(const String& longEntry, const String& shortEntry, String* error = nullptr);
+	void setParameter(const String& name, double value);
+	void setBacktest(const SignalEngine::Backtest& backtest);
+	const SignalEngine::Backtest& getBacktest() const { return _backtest; }
+
+	// evaluates again, after the chart shows another store or timeframe
+	void update();
+	void clear();
+
+	const SignalEngine::Result& getResult() const { return _result; }
+	SignalEngine& getEngine() { return _engine; }
+
+private:
+	void _removeMarkers();
+
+	WChart& _chart;
+	SignalEngine _engine;
+	SignalEngine::Backtest _backtest;
+	SignalEngine::Result _result;
+	std::vector<WChartShapes::Id> _markers;
+
+	JUCE_DECLARE_NON_COPYABLE(WChartSignals)
+};
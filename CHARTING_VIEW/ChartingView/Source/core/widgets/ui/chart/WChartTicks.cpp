@@ -0,0 +1,201 @@
+/*
+  ==============================================================================
+
+    WChartTicks.cpp
+    Created: 14 Oct 2026 11:48:30pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "WChartTicks.h"
+
+static constexpr int64 second = 1000, minute = 60 * second, hour = 60 * minute, day = 24 * hour;
+
+using TimeUnit = WChartTicks::TimeUnit;
+using TimeStep = WChartTicks::TimeStep;
+
+static const TimeStep timeSteps[] = {
+	{ TimeUnit::millisecond, second }, { TimeUnit::millisecond, 2 * second }, { TimeUnit::millisecond, 5 * second },
+	{ TimeUnit::millisecond, 10 * second }, { TimeUnit::millisecond, 15 * second }, { TimeUnit::millisecond, 30 * second },
+	{ TimeUnit::millisecond, minute }, { TimeUnit::millisecond, 2 * minute }, { TimeUnit::millisecond, 5 * minute },
+	{ TimeUnit::millisecond, 10 * minute }, { TimeUnit::millisecond, 15 * minute }, { TimeUnit::millisecond, 30 * minute },
+	{ TimeUnit::hour, 1 }, { TimeUnit::hour, 2 }, { TimeUnit::hour, 3 }, { TimeUnit::hour, 4 }, { TimeUnit::hour, 6 }, { TimeUnit::hour, 12 },
+	{ TimeUnit::day, 1 }, { TimeUnit::day, 2 }, { TimeUnit::day, 7 },
+	{ TimeUnit::month, 1 }, { TimeUnit::month, 3 }, { TimeUnit::month, 6 },
+	{ TimeUnit::year, 1 }
+};
+
+static bool isLeapYear(int y) {
+	return (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+}
+
+static int getDaysInMonth(int y, int m) {
+	static constexpr int days[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+	return m == 1 && isLeapYear(y) ? 29 : days[m];
+}
+
+// local calendar time, months are 0 based like juce::Time
+static int64 localTime(int y, int m, int d, int h = 0) {
+	return Time(y, m, d, h, 0, 0, 0, true).toMilliseconds();
+}
+
+static String formatTick(int64 t, const TimeStep& step) {
+	const Time time(t);
+	switch (step.unit) {
+	case TimeUnit::year:
+		return time.formatted("%Y");
+	case TimeUnit::month:
+		return time.getMonth() == 0 ? time.formatted("%Y") : time.formatted("%b");
+	case TimeUnit::day:
+		if (time.getDayOfMonth() == 1)
+			return time.getMonth() == 0 ? time.formatted("%Y") : time.formatted("%b");
+		return String(time.getDayOfMonth());
+	default:
+		break;
+	}
+	if (time.getHours() == 0 && time.getMinutes() == 0 && time.getSeconds() == 0)
+		return time.formatted("%d %b");
+	return time.formatted(step.unit == TimeUnit::millisecond && step.count < minute ? "%H:%M:%S" : "%H:%M");
+}
+
+double WChartTicks::getNiceStep(double span, int maxTicks) {
+	if (!(span > 0.0) || maxTicks < 1)
+		return 0.0;
+	const double raw = span / maxTicks;
+	const double magnitude = std::pow(10.0, std::floor(std::log10(raw)));
+	for (double m : { 1.0, 2.0, 5.0 })
+		if (m * magnitude >= raw)
+			return m * magnitude;
+	return 10.0 * magnitude;
+}
+
+double WChartTicks::getApproxDuration(const TimeStep& step) {
+	switch (step.unit) {
+	case TimeUnit::hour: return (double)(step.count * hour);
+	case TimeUnit::day: return (double)(step.count * day);
+	case TimeUnit::month: return (double)step.count * 30.44 * (double)day;
+	case TimeUnit::year: return (double)step.count * 365.25 * (double)day;
+	default: return (double)step.count;
+	}
+}
+
+WChartTicks::TimeStep WChartTicks::getTimeStep(double span, int maxTicks) {
+	for (const auto& s : timeSteps)
+		if (span / getApproxDuration(s) <= (double)maxTicks)
+			return s;
+	// years, 1 / 2 / 5 x 10^n
+	const double years = span / getApproxDuration({ TimeUnit::year, 1 });
+	return { TimeUnit::year, jmax((int64)1, (int64)getNiceStep(years, jmax(1, maxTicks))) };
+}
+
+void WChartTicks::generateTimeTicks(const TimeStep& step, int64 from, int64 to, std::vector<Tick>& ticks) {
+	auto add = [&](int64 t) {
+		// a DST gap can map two local times to the same instant
+		if (t < from || t > to || (!ticks.empty() && ticks.back().time >= t))
+			return;
+		ticks.push_back({ t, 0.0, formatTick(t, step) });
+	};
+	if (step.count <= 0)
+		return;
+
+	if (step.unit == TimeUnit::millisecond) {
+		// below the hour, epoch multiples (local time is whole hours away from UTC almost everywhere)
+		const int64 first = (from >= 0 ? (from + step.count - 1) / step.count : from / step.count) * step.count;
+		for (int64 t = first; t <= to; t += step.count)
+			add(t);
+		return;
+	}
+
+	const Time start(from);
+	int y = start.getYear();
+	int m = start.getMonth();
+	int d = start.getDayOfMonth();
+
+	if (step.unit == TimeUnit::year) {
+		for (int year = y - (int)(((y % step.count) + step.count) % step.count); localTime(year, 0, 1) <= to; year += (int)step.count)
+			add(localTime(year, 0, 1));
+		return;
+	}
+	if (step.unit == TimeUnit::month) {
+		for (int month = m - (m % (int)step.count);; month += (int)step.count) {
+			while (month >= 12) {
+				month -= 12;
+				y++;
+			}
+			const int64 t = localTime(y, month, 1);
+			if (t > to)
+				break;
+			add(t);
+		}
+		return;
+	}
+
+	// hours and days, walking the local calendar days
+	for (;;) {
+		const int64 midnight = localTime(y, m, d);
+		if (midnight > to)
+			break;
+		if (step.unit == TimeUnit::day) {
+			// days of the month 1, 1 + count...
+			if ((d - 1) % step.count == 0)
+				add(midnight);
+		}
+		else {
+			for (int h = 0; h < 24; h += (int)step.count)
+				add(localTime(y, m, d, h));
+		}
+		if (++d > getDaysInMonth(y, m)) {
+			d = 1;
+			if (++m == 12) {
+				m = 0;
+				y++;
+			}
+		}
+	}
+}
+
+const std::vector<WChartTicks::Tick>& WChartTicks::getTimeTicks(const AxisMapping& xMap, float width, int minSpacing) {
+	const double a = xMap.toValue(0.0f);
+	const double b = xMap.toValue(width);
+	const double t0 = jmin(a, b);
+	const double t1 = jmax(a, b);
+	const auto step = getTimeStep(t1 - t0, jmax(1, (int)width / jmax(1, minSpacing)));
+	if (step == _time.step && t0 >= (double)_time.from && t1 <= (double)_time.to)
+		return _time.ticks;
+
+	// a visible span on each side, the next pans reuse them
+	const double span = t1 - t0;
+	_time.step = step;
+	_time.from = (int64)std::floor(t0 - span);
+	_time.to = (int64)std::ceil(t1 + span);
+	_time.ticks.clear();
+	generateTimeTicks(step, _time.from, _time.to, _time.ticks);
+	_numGenerations++;
+	return _time.ticks;
+}
+
+const std::vector<WChartTicks::Tick>& WChartTicks::_getPriceTicks(double low, double high, int maxTicks) {
+	const double step = getNiceStep(high - low, maxTicks);
+	if (step == _price.step && low >= _price.from && high <= _price.to)
+		return _price.ticks;
+
+	const double span = high - low;
+	_price.step = step;
+	_price.from = low - span;
+	_price.to = high + span;
+	_price.decimals = step > 0.0 ? jmax(0, -(int)std::floor(std::log10(step))) : 0;
+	_price.ticks.clear();
+	if (step > 0.0) {
+		// from an index, adding the step would drift
+		for (double i = std::ceil(_price.from / step); i * step <= _price.to; i++)
+			_price.ticks.push_back({ 0, i * step, String(i * step, _price.decimals) });
+	}
+	_numGenerations++;
+	return _price.ticks;
+}
+
+void WChartTicks::clear() {
+	_time = {};
+	_price = {};
+}
@@ -0,0 +1,86 @@
+/*
+  ==============================================================================
+
+    WChartTicks.h
+    Created: 14 Oct 2026 11:48:30pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+#include "WChartTransform.h"
+
+/*
+	Tick positions and labels of an axis, generated once per step and reused
+	while the axis only pans.
+
+	The step follows the scale (time : calendar steps from 1s to years, local
+	time so days and months start at midnight whatever the DST ; prices :
+	1 / 2 / 5 x 10^n). The ticks are generated for three times the visible
+	span, a pan inside that window returns the same ticks and the caller only
+	maps them to pixels. Zoom levels giving the same step (the snapped zoom
+	presets of WChartScaleTransform) hit the cache as well.
+*/
+
+class WChartTicks {
+public:
+	struct Tick {
+		int64 time = 0;     // time axis, ms
+		double value = 0.0; // price axis
+		String label;
+	};
+
+	// ticks of a width px time axis, at least minSpacing px apart (maybe outside the axis)
+	const std::vector<Tick>& getTimeTicks(const AxisMapping& xMap, float width, int minSpacing);
+	// ticks of a height px price axis, at least minSpacing px apart (maybe outside the axis)
+	template <typename Mapper>
+	const std::vector<Tick>& getPriceTicks(const Mapper& yMap, float height, int minSpacing) {
+		const double a = yMap.toValue(0.0f);
+		const double b = yMap.toValue(height);
+		return _getPriceTicks(jmin(a, b), jmax(a, b), jmax(1, (int)height / minSpacing));
+	}
+
+	// decimals of the price labels for the last getPriceTicks()
+	int getPriceDecimals() const { return _price.decimals; }
+	// generations so far, a pan inside the window does not count
+	int getNumGenerations() const { return _numGenerations; }
+	void clear();
+
+	// 1 / 2 / 5 x 10^n step giving at most maxTicks ticks over span
+	static double getNiceStep(double span, int maxTicks);
+
+	// calendar steps of the time axis
+	enum class TimeUnit { millisecond, hour, day, month, year };
+	struct TimeStep {
+		TimeUnit unit = TimeUnit::millisecond;
+		int64 count = 0;   // of the unit
+		bool operator==(const TimeStep&) const = default;
+	};
+	// smallest step giving at most maxTicks ticks over span ms
+	static TimeStep getTimeStep(double span, int maxTicks);
+	static double getApproxDuration(const TimeStep& step);
+
+	// appends the ticks of step in [from, to] to ticks, with their label
+	static void generateTimeTicks(const TimeStep& step, int64 from, int64 to, std::vector<Tick>& ticks);
+
+private:
+	const std::vector<Tick>& _getPriceTicks(double low, double high, int maxTicks);
+
+	struct TimeCache {
+		TimeStep step;
+		int64 from = 0, to = -1;
+		std::vector<Tick> ticks;
+	};
+	struct PriceCache {
+		double step = 0.0;
+		double from = 0.0, to = -1.0;
+		int decimals = 0;
+		std::vector<Tick> ticks;
+	};
+
+	TimeCache _time;
+	PriceCache _price;
+	int _numGenerations = 0;
+};
@@ -0,0 +1,180 @@
+/*
+  ==============================================================================
+
+    WChartTileCache.cpp
+    Created: 15 Oct 2026 11:48:22pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "WChartTileCache.h"
+#include "../../../utils/FrameProfiler.h"
+
+WChartTileCache::WChartTileCache(size_t maxBytes) : _maxBytes(maxBytes) {
+	_ready.onAsyncUpdate = [this]() {
+		if (onTileReady)
+			onTileReady();
+	};
+	_thread.onRun = [this]() { _run(); };
+	_thread.startThread();
+	MemoryBudget::getInstance().addClient(MemoryBudget::tiles, this);
+}
+
+WChartTileCache::~WChartTileCache() {
+	MemoryBudget::getInstance().removeClient(this);
+	_thread.signalThreadShouldExit();
+	_wake.signal();
+	_thread.stopThread(4000);
+	_ready.cancelPendingUpdate();
+	MemoryBudget::getInstance().add(MemoryBudget::tiles, -(int64)_numBytes);
+}
+
+bool WChartTileCache::draw(Graphics& g, Key key, double viewStart, int width, Render render) {
+	key.pixelScale = g.getInternalContext().getPhysicalPixelScaleFactor();
+	if (key.msPerPixel <= 0.0 || width <= 0 || key.height <= 0)
+		return true;
+	const FrameProfiler::Scope scope(FrameProfiler::compositing);
+	const int64 first = key.getTileIndex(viewStart);
+	const int64 last = key.getTileIndex(viewStart + (double)width * key.msPerPixel);
+	const double center = 0.5 * (double)(first + last);
+	// on the physical pixel grid, the tiles from the first one on : no seam, the pixels are not resampled
+	const int tilePixels = roundToInt((float)tileWidth * key.pixelScale);
+	const float firstX = (float)std::round(((double)key.getTileStart(first) - viewStart) / key.msPerPixel * (double)key.pixelScale);
+	std::vector<Request> missing;
+	{
+		const ScopedLock sl(_lock);
+		_drawStart = _useCounter;
+		for (int64 i = first; i <= last; i++) {
+			const auto* tile = _find(key, i);
+			FrameProfiler::getInstance().count(tile ? FrameProfiler::cacheHits : FrameProfiler::cacheMisses);
+			if (tile == nullptr) {
+				missing.push_back({ key, i });
+				continue;
+			}
+			const float px = firstX + (float)((i - first) * tilePixels);
+			if (key.pixelScale == 1.0f)
+				g.drawImageAt(tile->image, (int)px, 0);
+			else
+				g.drawImageTransformed(tile->image, AffineTransform::translation(px, 0.0f).scaled(1.0f / key.pixelScale, 1.0f / key.pixelScale));
+		}
+		// the view moved on : only its own tiles are still wanted, nearest to the center first
+		std::sort(missing.begin(), missing.end(), [center](const Request& a, const Request& b) {
+			return std::abs((double)a.index - center) < std::abs((double)b.index - center);
+		});
+		_pending = missing;
+		_render = std::move(render);
+	}
+	if (!missing.empty())
+		_wake.signal();
+	return missing.empty();
+}
+
+void WChartTileCache::cancel() {
+	{
+		const ScopedLock sl(_lock);
+		_pending.clear();
+		_render = nullptr;
+	}
+	// the tile in flight reads the data the caller is about to change
+	const ScopedLock rl(_renderLock);
+}
+
+void WChartTileCache::clear() {
+	cancel();
+	const ScopedLock sl(_lock);
+	MemoryBudget::getInstance().add(MemoryBudget::tiles, -(int64)_numBytes);
+	_tiles.clear();
+	_numBytes = 0;
+}
+
+void WChartTileCache::setMaxBytes(size_t maxBytes) {
+	const ScopedLock sl(_lock);
+	_maxBytes = maxBytes;
+	_evict(_maxBytes, _useCounter);
+}
+
+size_t WChartTileCache::getNumBytes() const {
+	const ScopedLock sl(_lock);
+	return _numBytes;
+}
+
+int WChartTileCache::getNumTiles() const {
+	const ScopedLock sl(_lock);
+	return (int)_tiles.size();
+}
+
+const WChartTileCache::Tile* WChartTileCache::_find(const Key& key, int64 index) {
+	for (auto& t : _tiles) {
+		if (t.index == index && t.key == key) {
+			t.lastUsed = ++_useCounter;
+			return &t;
+		}
+	}
+	return nullptr;
+}
+
+size_t WChartTileCache::_evict(size_t maxBytes, uint64 keepFrom) {
+	size_t freed = 0;
+	while (_numBytes > maxBytes && _tiles.size() > 1) {
+		auto oldest = _tiles.begin();
+		for (auto it = _tiles.begin(); it != _tiles.end(); ++it)
+			if (it->lastUsed < oldest->lastUsed)
+				oldest = it;
+		if (oldest->lastUsed > keepFrom)
+			break;
+		freed += _getBytes(oldest->image);
+		_numBytes -= _getBytes(oldest->image);
+		_tiles.erase(oldest);
+	}
+	MemoryBudget::getInstance().add(MemoryBudget::tiles, -(int64)freed);
+	return freed;
+}
+
+size_t WChartTileCache::releaseMemory(size_t bytes) {
+	const ScopedLock sl(_lock);
+	return _evict(_numBytes - jmin(bytes, _numBytes), _drawStart);
+}
+
+void WChartTileCache::_run() {
+	while (!_thread.threadShouldExit()) {
+		_wake.wait(-1);
+		for (;;) {
+			// taken under the render lock, cancel() either drops it first or waits for the tile
+			const ScopedLock rl(_renderLock);
+			Request r;
+			Render render;
+			{
+				const ScopedLock sl(_lock);
+				if (_pending.empty() || !_render)
+					break;
+				r = _pending.front();
+				_pending.erase(_pending.begin());
+				if (_find(r.key, r.index) != nullptr)
+					continue;
+				render = _render;
+			}
+			if (_thread.threadShouldExit())
+				return;
+
+			const int w = roundToInt((float)tileWidth * r.key.pixelScale);
+			const int h = roundToInt((float)r.key.height * r.key.pixelScale);
+			Tile tile{ r.key, r.index, Image(Image::ARGB, w, h, true, SoftwareImageType()), 0 };
+			{
+				Graphics ig(tile.image);
+				ig.addTransform(AffineTransform::scale(r.key.pixelScale));
+				ig.reduceClipRegion({ 0, 0, tileWidth, r.key.height });
+				render(ig, r.key.getTileStart(r.index));
+			}
+			{
+				const ScopedLock sl(_lock);
+				tile.lastUsed = ++_useCounter;
+				_numBytes += _getBytes(tile.image);
+				MemoryBudget::getInstance().add(MemoryBudget::tiles, (int64)_getBytes(tile.image));
+				_tiles.push_back(std::move(tile));
+				_evict(_maxBytes, _useCounter);
+			}
+			_ready.triggerAsyncUpdate();
+		}
+	}
+}
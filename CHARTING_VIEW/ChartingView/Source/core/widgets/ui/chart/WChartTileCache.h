@@ -0,0 +1,118 @@
+/*
+  ==============================================================================
+
+    WChartTileCache.h
+    Created: 15 Oct 2026 11:48:22pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "JuceHeader.h"
+#include "WChartTransform.h"
+#include "../../../utils/ThreadLambda.h"
+#include "../../../utils/AsyncUpdaterLambda.h"
+#include "../../../utils/MemoryBudget.h"
+
+/*
+	Data layer of a chart cut in fixed tiles, map style, for the zoom presets :
+	at msPerPixel the time axis is cut from the epoch in tiles of tileWidth
+	pixels, tile i covers the times [i, i + 1) * tileWidth * msPerPixel.
+
+	Tiles are rasterized on a worker thread into an LRU of images (maxBytes),
+	panning only composites the tiles in view, and a view coming back to a
+	preset (or to an earlier place of the same series) finds its tiles again.
+	A missing tile is requested to the worker, nearest to the center of the
+	view first, and stays empty until it is done (onTileReady).
+
+	A tile depends on everything but its place (Key) : the series drawn, the
+	preset, the y mapping, the LOD level... Its candles are placed from the
+	exact int64 start of the tile and the buckets crossing its edges are drawn
+	clipped by both tiles, so the edges join whatever the pan. Tiles are drawn
+	at the rounded physical pixel, the view is at most half a pixel off.
+
+	The render function runs on the worker like WChartRenderThread's : it reads
+	what it captured and data the owner does not change without cancel().
+
+	The tiles count in MemoryBudget::tiles, the first evicted by a trim : the
+	least recently used go, the ones of the last draw() stay.
+*/
+
+class WChartTileCache : private MemoryBudget::Client {
+public:
+	static constexpr int tileWidth = 256;
+
+	struct Key {
+		int64 series = 0;        // the data drawn (store, curves, shapes...)
+		double msPerPixel = 0.0; // a zoom preset
+		int height = 0;
+		float pixelScale = 1.0f; // set by draw()
+		AxisMapping y;
+		AxisScale yScale = AxisScale::linear;
+		int64 tag = 0;           // anything else the tiles depend on (level...)
+
+		bool operator==(const Key&) const = default;
+		double getTileSpan() const { return (double)tileWidth * msPerPixel; }
+		int64 getTileStart(int64 index) const { return (int64)std::floor((double)index * getTileSpan()); }
+		int64 getTileIndex(double time) const { return (int64)std::floor(time / getTileSpan()); }
+	};
+
+	// paints the tile starting at tileStart (ms), x 0 at tileStart, tileWidth x key.height
+	// px in component units, on a transparent background
+	using Render = std::function<void(Graphics&, int64 tileStart)>;
+
+	explicit WChartTileCache(size_t maxBytes = (size_t)128 << 20);
+	~WChartTileCache() override;
+
+	// composites the tiles of a view of width px whose x 0 is at time viewStart, the
+	// missing ones are rendered by render on the worker. True when none was missing
+	bool draw(Graphics& g, Key key, double viewStart, int width, Render render);
+	// drops the tiles not started and waits for the one being rendered, call before
+	// changing data the render functions read. The tiles done are kept
+	void cancel();
+	// cancel() and drops every tile
+	void clear();
+
+	void setMaxBytes(size_t maxBytes);
+	size_t getNumBytes() const;
+	int getNumTiles() const;
+
+	// message thread, a tile was added
+	std::function<void()> onTileReady;
+
+private:
+	struct Tile {
+		Key key;
+		int64 index = 0;
+		Image image;
+		uint64 lastUsed = 0;
+	};
+	struct Request {
+		Key key;
+		int64 index = 0;
+	};
+
+	void _run();
+	const Tile* _find(const Key& key, int64 index);
+	// least recently used first down to maxBytes, the tiles used after keepFrom stay.
+	// Returns the bytes freed
+	size_t _evict(size_t maxBytes, uint64 keepFrom);
+	size_t releaseMemory(size_t bytes) override;
+	static size_t _getBytes(const Image& image) { return (size_t)image.getWidth() * (size_t)image.getHeight() * 4; }
+
+	mutable CriticalSection _lock;  // the tiles, the requests
+	CriticalSection _renderLock;    // held by the worker for a whole tile
+	WaitableEvent _wake;
+	std::vector<Tile> _tiles;
+	size_t _numBytes = 0;
+	size_t _maxBytes;
+	uint64 _useCounter = 0;
+	uint64 _drawStart = 0;          // _useCounter when the last draw() began
+	std::vector<Request> _pending;  // next first
+	Render _render;                 // of the pending tiles
+	AsyncUpdaterLambda _ready;
+	ThreadLambda _thread{ "WChartTileCache" };
+
+	JUCE_DECLARE_NON_COPYABLE(WChartTileCache)
+};
@@ -10,6 +10,7 @@
 
 #pragma once
 #include "JuceHeader.h"
+#include "../../../utils/Simd.h"
 
 /*
 	un viewport rect et son pivot en pixel
@@ -26,24 +27,125 @@
 
 */
 
-/*
-	enum class SamplingMode
-	{
-		None,        // tous les points
-		Auto,        // adapte en fonction des pixels
-		FixedDensity // max n points par viewport
-	};
-	struct SamplingConfig
-	{
-		SamplingMode mode = SamplingMode::Auto;
-		float maxPointsPerPixel = 1.0f;  // densit max (Auto/Fixed)
-		int   minPointsPerSegment = 1;     // scurit
-
-		// ventuellement : type de dcimation
-		// enum class Strategy { MinMax, FirstLast, OHLCCompress, ... };
-		// Strategy strategy = Strategy::MinMax;
+enum class SamplingMode
+{
+	None,        // tous les points
+	Auto,        // adapte en fonction des pixels
+	FixedDensity // max n points par viewport
+};
+struct SamplingConfig
+{
+	// type de dcimation, appliqu sur les buckets de LodPyramid
+	enum class Strategy {
+		MinMax,      // une barre low -> high par bucket
+		FirstLast,   // une ligne qui relie les close
+		OHLCCompress // une bougie fusionne par bucket
 	};
-*/
+
+	SamplingMode mode = SamplingMode::Auto;
+	float maxPointsPerPixel = 1.0f;  // densit max (Auto)
+	int   maxPointsPerViewport = 2000; // densit max (FixedDensity)
+	int   minPointsPerSegment = 1;     // scurit
+	Strategy strategy = Strategy::OHLCCompress;
+
+	// nombre de samples max par bucket pour afficher visibleRows sur widthPx pixels
+	double getMaxRowsPerBucket(double visibleRows, double widthPx) const {
+		double points = visibleRows;
+		if (mode == SamplingMode::Auto)
+			points = widthPx * maxPointsPerPixel;
+		else if (mode == SamplingMode::FixedDensity)
+			points = maxPointsPerViewport;
+		return jmax((double)minPointsPerSegment, visibleRows / jmax(1.0, points));
+	}
+};
+
+// Non-virtual snapshot of an axis for one frame : pixel = (value - origin) * scale + offset.
+// The origin is an int64 near the visible values (epoch ms don't fit in a float),
+// the differences are exact and the arithmetic is done in double, only pixels are floats.
+struct AxisMapping
+{
+	int64 origin = 0;
+	double scale = 1.0;
+	double offset = 0.0;
+
+	float toPixel(int64 value) const { return (float)((double)(value - origin) * scale + offset); }
+	float toPixel(double value) const { return (float)((value - (double)origin) * scale + offset); }
+	double toValue(float pixel) const { return ((double)pixel - offset) / scale + (double)origin; }
+
+	bool operator==(const AxisMapping&) const = default;
+
+	// same mapping expressed from another origin
+	AxisMapping withOrigin(int64 newOrigin) const {
+		return { newOrigin, scale, offset + (double)(newOrigin - origin) * scale };
+	}
+
+	// whole slices in one call (SSE2)
+	void toPixels(const int64* values, float* out, size_t n) const { Simd::mapLinear(values, n, origin, scale, offset, out); }
+	void toPixels(const double* values, float* out, size_t n) const { Simd::mapLinear(values, n, (double)origin, scale, offset, out); }
+};
+
+// Area of the chart in series units : open_times [startTime, endTime) and prices [low, high]
+struct WorldRect
+{
+	int64 startTime = 0, endTime = 0;
+	double low = 0.0, high = 0.0;
+
+	bool isEmpty() const { return endTime <= startTime; }
+	WorldRect getUnion(const WorldRect& other) const {
+		if (isEmpty()) return other;
+		if (other.isEmpty()) return *this;
+		return { jmin(startTime, other.startTime), jmax(endTime, other.endTime), jmin(low, other.low), jmax(high, other.high) };
+	}
+};
+
+// Axis scale policies : what is linear on screen. AxisMapping applies to forward(value)
+enum class AxisScale { linear, logarithmic };
+
+struct LinearScale {
+	static constexpr AxisScale type = AxisScale::linear;
+	static double forward(double v) { return v; }
+	static double inverse(double v) { return v; }
+};
+
+struct LogScale {
+	static constexpr AxisScale type = AxisScale::logarithmic;
+	static constexpr double minValue = 1e-300; // prices <= 0 are drawn at the bottom
+	static double forward(double v) { return std::log(jmax(v, minValue)); }
+	static double inverse(double v) { return std::exp(v); }
+};
+
+// An axis for one frame with its scale known at compile time, so the per point
+// loops are inlined and vectorized. The direction is already folded into the
+// mapping (negative scale), it costs nothing per point.
+template <typename Scale>
+struct AxisMapper
+{
+	AxisMapping mapping;
+
+	float toPixel(double value) const { return mapping.toPixel(Scale::forward(value)); }
+	double toValue(float pixel) const { return Scale::inverse(mapping.toValue(pixel)); }
+
+	void toPixels(const double* values, float* out, size_t n) const {
+		if constexpr (Scale::type == AxisScale::linear) {
+			mapping.toPixels(values, out, n);
+		}
+		else {
+			const double s = mapping.scale;
+			const double b = mapping.offset - (double)mapping.origin * s;
+			for (size_t i = 0; i < n; i++)
+				out[i] = (float)(Scale::forward(values[i]) * s + b);
+		}
+	}
+	// values already through Scale::forward (LodPyramid::getLogLevel() for a log axis) : linear whatever the scale
+	void forwardToPixels(const double* forwardValues, float* out, size_t n) const {
+		mapping.toPixels(forwardValues, out, n);
+	}
+	// times only make sense on a linear axis
+	void toPixels(const int64* values, float* out, size_t n) const {
+		static_assert(Scale::type == AxisScale::linear, "int64 values are times, map them on a linear axis");
+		mapping.toPixels(values, out, n);
+	}
+};
 
 
 class WChartScaleTransform {
@@ -65,18 +167,18 @@ public:
 			: worldStart(wStart), worldEnd(wEnd), viewportStart(vStart), viewportEnd(vEnd) {}
 		AxisTransform() : AxisTransform(0, 1, 0, 1) {}
 
-		virtual float getWorldStart() const { return worldStart; }
-		virtual float getWorldEnd() const { return worldEnd; }
+		float getWorldStart() const { return worldStart; }
+		float getWorldEnd() const { return worldEnd; }
 		float getWorldSize() const { return worldEnd - worldStart; }
-		virtual float getViewportStart() const { return viewportStart; }
-		virtual float getViewportEnd() const { return viewportEnd; }
+		float getViewportStart() const { return viewportStart; }
+		float getViewportEnd() const { return viewportEnd; }
 		float getViewportSize() const { return viewportEnd - viewportStart; }
 		float getZoomLevel() const { return getViewportSize() / getWorldSize(); }
 
-		virtual AxisTransform& setWorldStart(float value) { worldStart = value; return *this; }
-		virtual AxisTransform& setWorldEnd(float value) { worldEnd = value; return *this; }
-		virtual AxisTransform& setViewportStart(float value) { viewportStart = value; return *this; }
-		virtual AxisTransform& setViewportEnd(float value) { viewportEnd = value; return *this; }
+		AxisTransform& setWorldStart(float value) { worldStart = value; return *this; }
+		AxisTransform& setWorldEnd(float value) { worldEnd = value; return *this; }
+		AxisTransform& setViewportStart(float value) { viewportStart = value; return *this; }
+		AxisTransform& setViewportEnd(float value) { viewportEnd = value; return *this; }
 		void setZoomLevel(float newZoom, float pivot = 0.5f)
 		{
 			float worldSize = getWorldSize();
@@ -105,50 +207,52 @@ public:
 		}
 	};
 
+	// the unit world is in double : x units are ms from the series origin, 1.6e11 after
+	// 5 years where a float step is 16 s. The axis side stays in float pixels
 	class UnitTransform {
 		AxisTransform& axisT;
-		float worldStart, worldEnd;
+		double worldStart = 0.0, worldEnd = 1.0;
 	public:
 		UnitTransform(AxisTransform& axisT) : axisT(axisT) {}
 
-		virtual float getWorldStart() const { return worldStart; }
-		virtual float getWorldEnd() const { return worldEnd; }
-		float getWorldSize() const { return worldEnd - worldStart; }
-		virtual float getViewportStart() const { return axisWorldToUnitWorld(axisT.getViewportStart()); }
-		virtual float getViewportEnd() const { return axisWorldToUnitWorld(axisT.getViewportEnd()); }
-		float getViewportSize() const { return getViewportEnd() - getViewportStart(); }
-		float getZoomLevel() const { return getViewportSize() / getWorldSize(); }
+		double getWorldStart() const { return worldStart; }
+		double getWorldEnd() const { return worldEnd; }
+		double getWorldSize() const { return worldEnd - worldStart; }
+		double getViewportStart() const { return axisWorldToUnitWorld(axisT.getViewportStart()); }
+		double getViewportEnd() const { return axisWorldToUnitWorld(axisT.getViewportEnd()); }
+		double getViewportSize() const { return getViewportEnd() - getViewportStart(); }
+		double getZoomLevel() const { return getViewportSize() / getWorldSize(); }
 
-		virtual UnitTransform& setWorldStart(float value) { worldStart = value; return *this; }
-		virtual UnitTransform& setWorldEnd(float value) { worldEnd = value; return *this; }
-		virtual UnitTransform& setViewportStart(float value) { axisT.setViewportStart(unitWorldToAxisWorld(value)); return *this; }
-		virtual UnitTransform& setViewportEnd(float value) { axisT.setViewportEnd(unitWorldToAxisWorld(value)); return *this; }
-		virtual UnitTransform& setZoomLevel(float newZoom, float pivot = 0.5f) { axisT.setZoomLevel(newZoom, pivot); return *this; }
-		virtual void zoomIn(float zoomStep = 0.1f, float pivot = 0.5f) { axisT.zoomIn(zoomStep, pivot); }
-		virtual void zoomOut(float zoomStep = 0.1f, float pivot = 0.5f) { axisT.zoomOut(zoomStep, pivot); }
+		UnitTransform& setWorldStart(double value) { worldStart = value; return *this; }
+		UnitTransform& setWorldEnd(double value) { worldEnd = value; return *this; }
+		UnitTransform& setViewportStart(double value) { axisT.setViewportStart((float)unitWorldToAxisWorld(value)); return *this; }
+		UnitTransform& setViewportEnd(double value) { axisT.setViewportEnd((float)unitWorldToAxisWorld(value)); return *this; }
+		UnitTransform& setZoomLevel(float newZoom, float pivot = 0.5f) { axisT.setZoomLevel(newZoom, pivot); return *this; }
+		void zoomIn(float zoomStep = 0.1f, float pivot = 0.5f) { axisT.zoomIn(zoomStep, pivot); }
+		void zoomOut(float zoomStep = 0.1f, float pivot = 0.5f) { axisT.zoomOut(zoomStep, pivot); }
 
-		virtual float axisWorldToUnitWorld(float k) const {
-			return mapValue(k, axisT.getWorldStart(), axisT.getWorldEnd(), worldStart, worldEnd);
+		double axisWorldToUnitWorld(double k) const {
+			return mapValue(k, (double)axisT.getWorldStart(), (double)axisT.getWorldEnd(), worldStart, worldEnd);
 		}
-		virtual float unitWorldToAxisWorld(float k) const {
-			return mapValue(k, worldStart, worldEnd, axisT.getWorldStart(), axisT.getWorldEnd());
+		double unitWorldToAxisWorld(double k) const {
+			return mapValue(k, worldStart, worldEnd, (double)axisT.getWorldStart(), (double)axisT.getWorldEnd());
 		}
-		virtual float axisViewportToUnitViewport(float k) {
+		double axisViewportToUnitViewport(double k) {
 			return mapValue(
 				k,
-				axisT.getViewportStart(),
-				axisT.getViewportEnd(),
+				(double)axisT.getViewportStart(),
+				(double)axisT.getViewportEnd(),
 				worldStart,
 				worldEnd
 			);
 		}
-		virtual float unitViewportToAxisViewport(float k) {
+		double unitViewportToAxisViewport(double k) {
 			return mapValue(
 				k,
 				worldStart,
 				worldEnd,
-				axisT.getViewportStart(),
-				axisT.getViewportEnd()
+				(double)axisT.getViewportStart(),
+				(double)axisT.getViewportEnd()
 			);
 		}
 
@@ -165,13 +269,163 @@ public:
 		
 	}
 
+	// the unit transforms of a copy are bound to its own axes (snapshots for the render thread)
+	WChartScaleTransform(const WChartScaleTransform& other) : WChartScaleTransform() {
+		*this = other;
+	}
+	// a shared x is resolved : the copy owns the x axis the source had at that time
+	WChartScaleTransform& operator=(const WChartScaleTransform& other) {
+		const auto& x = other.getX();
+		xWorld = x.xWorld;
+		xUnit.setWorldStart(x.xUnit.getWorldStart()).setWorldEnd(x.xUnit.getWorldEnd());
+		xDir = x.xDir;
+		zoomPresets = x.zoomPresets;
+		snapZoom = x.snapZoom;
+		_sharedX = nullptr;
+		yWorld = other.yWorld;
+		yUnit.setWorldStart(other.yUnit.getWorldStart()).setWorldEnd(other.yUnit.getWorldEnd());
+		yDir = other.yDir;
+		yScale = other.yScale;
+		sampling = other.sampling;
+		return *this;
+	}
+
+
+	// x axis (xWorld, xUnit, xDir, the zoom presets) read from and written to source instead
+	// of this transform, the panes of a WChartManager all reference the same one. Null for
+	// this transform's own. Readers of the x members go through getX()
+	void setSharedX(WChartScaleTransform* source) { _sharedX = source != this ? source : nullptr; }
+	bool hasSharedX() const { return _sharedX != nullptr; }
+	WChartScaleTransform& getX() { return _sharedX ? *_sharedX : *this; }
+	const WChartScaleTransform& getX() const { return _sharedX ? *_sharedX : *this; }
+
+	// 1 / 2 / 5 x 10^n ms per pixel in [minMsPerPixel, maxMsPerPixel]. 10 ms/px is a 10 s span
+	// over 1000 px, exact in the double unit world (a float world steps by 16 s at 5 years)
+	static std::vector<double> makeZoomPresets(double minMsPerPixel = 10.0, double maxMsPerPixel = 1.0e8) {
+		std::vector<double> presets;
+		for (double magnitude = 1.0; magnitude <= maxMsPerPixel; magnitude *= 10.0)
+			for (double m : { 1.0, 2.0, 5.0 })
+				if (m * magnitude >= minMsPerPixel && m * magnitude <= maxMsPerPixel)
+					presets.push_back(m * magnitude);
+		return presets;
+	}
+
+	double getMsPerPixel() const {
+		const auto& x = getX();
+		return x.xUnit.getWorldSize() / (double)x.xWorld.getWorldSize();
+	}
+
+	// x zoom : ms per pixel times factor (< 1 zooms in), keeping the time under the
+	// pivot pixel of a width px viewport. With snapZoom the scale moves to the next
+	// preset instead, the axis ticks of a preset are generated once (WChartTicks).
+	void zoomX(double factor, float pivot, float width) {
+		auto& x = getX();
+		const auto next = getZoomedX({ x.xUnit.getWorldStart(), x.xUnit.getWorldEnd() }, factor, pivot, width);
+		x.xUnit
+			.setWorldStart(next.getStart())
+			.setWorldEnd(next.getEnd());
+	}
+
+	// moves the pixel offset of the x viewport (pans) into the unit world, the mapping is
+	// the same. Float pixels are exact to 1/8 px up to 2^20, a long pan is folded back
+	void rebaseX() {
+		auto& x = getX();
+		const double offset = (double)x.xWorld.getViewportStart() - (double)x.xWorld.getWorldStart();
+		if (offset == 0.0)
+			return;
+		const double shift = offset * x.xUnit.getWorldSize() / (double)x.xWorld.getWorldSize();
+		x.xUnit
+			.setWorldStart(x.xUnit.getWorldStart() + shift)
+			.setWorldEnd(x.xUnit.getWorldEnd() + shift);
+		const float size = x.xWorld.getViewportSize();
+		x.xWorld
+			.setViewportStart(x.xWorld.getWorldStart())
+			.setViewportEnd(x.xWorld.getWorldStart() + size);
+	}
+
+	// x unit world zoomX() would give from the unit world units (for a transition)
+	Range<double> getZoomedX(Range<double> units, double factor, float pivot, float width) const {
+		if (_sharedX)
+			return _sharedX->getZoomedX(units, factor, pivot, width);
+		const double m = units.getLength() / (double)xWorld.getWorldSize();
+		if (!(m > 0.0) || !(factor > 0.0) || factor == 1.0)
+			return units;
+		double next = m * factor;
+		if (!zoomPresets.empty()) {
+			if (snapZoom) {
+				auto it = std::upper_bound(zoomPresets.begin(), zoomPresets.end(), m * (factor > 1.0 ? 1.001 : 0.999));
+				if (factor > 1.0)
+					next = it != zoomPresets.end() ? *it : zoomPresets.back();
+				else
+					next = it != zoomPresets.begin() ? *std::prev(it) : zoomPresets.front();
+			}
+			next = jlimit(zoomPresets.front(), zoomPresets.back(), next);
+		}
+		if (next == m)
+			return units;
+
+		const float p = xDir == AxisDirection::right_to_left ? width - pivot : pivot;
+		const double axisPixel = (double)p - (double)xWorld.getWorldStart() + (double)xWorld.getViewportStart();
+		const double time = units.getStart() + m * axisPixel;
+		const double start = time - next * axisPixel;
+		return { start, start + next * (double)xWorld.getWorldSize() };
+	}
+
+	// x values are times, the unit world being milliseconds since seriesOrigin
+	AxisMapping getXMapping(int64 seriesOrigin, float width) const {
+		const auto& x = getX();
+		return makeMapping<LinearScale>(x.xUnit, x.xWorld, seriesOrigin, x.xDir == AxisDirection::right_to_left, width);
+	}
+
+	// calls fn(AxisMapper<Scale>) with the y scale resolved once for the frame
+	template <typename Fn>
+	decltype(auto) withYMapper(float height, Fn&& fn) const {
+		const bool inverted = yDir == AxisDirection::bot_to_top;
+		if (yScale == AxisScale::logarithmic)
+			return fn(AxisMapper<LogScale>{ makeMapping<LogScale>(yUnit, yWorld, 0, inverted, height) });
+		return fn(AxisMapper<LinearScale>{ makeMapping<LinearScale>(yUnit, yWorld, 0, inverted, height) });
+	}
+
+	// pixel bounds of a world area of the series starting at seriesOrigin
+	Rectangle<float> toPixels(const WorldRect& r, int64 seriesOrigin, float width, float height) const {
+		const auto xMap = getXMapping(seriesOrigin, width);
+		return withYMapper(height, [&](const auto& yMap) {
+			return Rectangle<float>::leftTopRightBottom(
+				jmin(xMap.toPixel(r.startTime), xMap.toPixel(r.endTime)), jmin(yMap.toPixel(r.low), yMap.toPixel(r.high)),
+				jmax(xMap.toPixel(r.startTime), xMap.toPixel(r.endTime)), jmax(yMap.toPixel(r.low), yMap.toPixel(r.high)));
+		});
+	}
+
+	// chains unitWorldToAxisWorld() and worldToViewport() on Scale::forward(unit values),
+	// flipped inside size when inverted. Unit values are value - origin
+	template <typename Scale>
+	static AxisMapping makeMapping(const UnitTransform& unit, const AxisTransform& axis, int64 origin, bool inverted, float size) {
+		const double unitStart = Scale::forward(unit.getWorldStart());
+		const double unitEnd = Scale::forward(unit.getWorldEnd());
+		AxisMapping m;
+		m.origin = origin;
+		m.scale = (double)axis.getWorldSize() / (unitEnd - unitStart);
+		m.offset = (double)axis.getWorldStart() - (double)axis.getViewportStart() - unitStart * m.scale;
+		if (inverted) {
+			m.scale = -m.scale;
+			m.offset = (double)size - m.offset;
+		}
+		return m;
+	}
 
 	AxisTransform xWorld;
 	UnitTransform xUnit;
 	AxisDirection xDir = AxisDirection::left_to_right;
+	std::vector<double> zoomPresets = makeZoomPresets();
+	bool snapZoom = true;
 	AxisTransform yWorld;
 	UnitTransform yUnit;
 	AxisDirection yDir = AxisDirection::bot_to_top;
+	AxisScale yScale = AxisScale::linear;
+	SamplingConfig sampling;
+
+private:
+	WChartScaleTransform* _sharedX = nullptr;
 };
 
 
@@ -10,14 +10,927 @@
 
 #include "WChartViewport.h"
 #include "WChartTransform.h"
+#include "WChartGLRenderer.h"
+#include "WChartAxis.h"
+#include "../WLookAndFeel.h"
+#include "../../../utils/FrameProfiler.h"
+#include "../../../Workspace.h"
 
 
 WChartViewport::WChartViewport(WChartScaleTransform& scaleT) : _scaleT(scaleT) {
-	
+	_shapes.onChanging = [this] { _invalidateBackgroundFrame(); };
+	_shapes.onChanged = [this] {
+		_dataLayer.invalidate();
+		repaint();
+	};
+	_fills.onChanged = [this] { repaint(); };
+	setBackgroundRenderingEnabled(true);
+	MemoryBudget::getInstance().addClient(MemoryBudget::lodLevels, this);
 }
 
+WChartViewport::~WChartViewport() {
+	MemoryBudget::getInstance().removeClient(this);
+	_renderThread = nullptr;
+	_tileCache = nullptr;
+	_gl = nullptr;
+}
+
+// same row / bucket access over a KlineStore (with its pyramid) and a live snapshot
+struct WChartViewport::StoreSource {
+	const KlineStore& store;
+	const LodPyramid& lod;
+	LodPyramid::Level level;
+
+	int64 getOriginTime() const { return store.getFirstOpenTime(); }
+	uint64 getBegin() const { return 0; }
+	uint64 getEnd() const { return store.size(); }
+	int64 getOpenTime(uint64 row) const { return store.getOpenTime()[row]; }
+	SeriesRange findRange(int64 start, int64 end) const { return store.findRange(start, end); }
+	LodPyramid::Level logLevel;
+
+	int selectLevel(double maxRowsPerBucket) {
+		const int l = lod.chooseLevel(maxRowsPerBucket);
+		level = lod.getLevel(l);
+		logLevel = lod.getLogLevel(l);
+		return level.shift;
+	}
+	LodPyramid::Bucket getBucket(uint64 b) const { return level.getBucket((size_t)b); }
+	// the log of the prices of the selected level, when the pyramid keeps them
+	bool hasLogBuckets() const { return logLevel.size > 0; }
+	LodPyramid::Bucket getLogBucket(uint64 b) const { return logLevel.getBucket((size_t)b); }
+};
+
+struct WChartViewport::LiveSource {
+	const KlineRingSeries::Snapshot& snap;
+	int level = 0;
+
+	int64 getOriginTime() const { return snap.originTime; }
+	uint64 getBegin() const { return snap.begin; }
+	uint64 getEnd() const { return snap.end; }
+	int64 getOpenTime(uint64 row) const { return snap.getOpenTime(row); }
+	SeriesRange findRange(int64 start, int64 end) const { return snap.findRange(start, end); }
+	int selectLevel(double maxRowsPerBucket) { level = snap.chooseLevel(maxRowsPerBucket); return level; }
+	LodPyramid::Bucket getBucket(uint64 b) const { return snap.getBucket(level, b); }
+	// a few thousand rows, mapped with the log
+	bool hasLogBuckets() const { return false; }
+	LodPyramid::Bucket getLogBucket(uint64 b) const { return getBucket(b); }
+};
+
 void WChartViewport::paint(Graphics& g) {
 	// g.fillAll(Colours::blue);
+	// the slice of the frame was resolved by WChart::paint (the viewport is not opaque, its
+	// parent paints before it), the y autoscale was fitted on the same one
+	_paintGrid(g);
+	if (_visibleRange.isEmpty())
+		return;
+	// the shapes are painted by one worker at a time, the other one is waited for
+	const double preset = !_live && !_gl && _tileCache ? _getTilePreset() : 0.0;
+	if ((preset > 0.0) != _paintedTiles) {
+		_paintedTiles = preset > 0.0;
+		if (_paintedTiles && _renderThread)
+			_renderThread->cancel();
+		else if (!_paintedTiles && _tileCache)
+			_tileCache->cancel();
+	}
+	if (_live) {
+		LiveSource src{ _liveFrame };
+		_paintData(g, src);
+	}
+	else if (_gl) {
+		// candles, curves and shapes are all on the GPU
+	}
+	else if (preset > 0.0) {
+		_paintStoreTiles(g, preset);
+	}
+	else if (_renderThread) {
+		_paintStoreInBackground(g);
+	}
+	else {
+		StoreSource src{ *_store, *_lod };
+		_paintData(g, src);
+	}
+	_paintHistograms(g);
+	_fills.paint(g, _scaleT, getOriginTime(), (float)getWidth(), (float)getHeight());
+}
+
+void WChartViewport::updateVisibleRange() {
+	const FrameProfiler::Scope scope(FrameProfiler::rangeQuery);
+	if (_lod->hasReleasedLevels())
+		_lod->restoreFineLevels();
+	if (_live) {
+		_liveFrame = _live->getSnapshot();
+		_visibleRange = _resolveRange(LiveSource{ _liveFrame });
+	}
+	else if (_store && !_store->isEmpty()) {
+		_visibleRange = _resolveRange(StoreSource{ *_store, *_lod });
+	}
+	else {
+		_visibleRange = {};
+	}
+	FrameProfiler::getInstance().count(FrameProfiler::pointsInRange, (int64)_visibleRange.size());
+	_updateLogPrices();
+	_updateVolumeProfile();
+	if (_gl)
+		_updateGLFrame();
+}
+
+size_t WChartViewport::releaseMemory(size_t) {
+	// a pyramid shared with other windows may be on screen there. A chart without a parent
+	// is an offscreen one, possibly painted on a worker right now (ChartBatchRenderer)
+	if (isShowing() || _lod->hasReleasedLevels() || _sharedLod || getParentComponent() == nullptr)
+		return 0;
+	// a worker frame or tile may be reading the levels
+	if (_renderThread)
+		_renderThread->cancel();
+	if (_tileCache)
+		_tileCache->cancel();
+	return _lod->releaseFineLevels();
+}
+
+int64 WChartViewport::getOriginTime() const {
+	if (_live)
+		return _liveFrame.originTime;
+	return _store && !_store->isEmpty() ? _store->getFirstOpenTime() : 0;
+}
+
+void WChartViewport::_paintGrid(Graphics& g) {
+	// only redrawn when the bounds or the scale change, live ticks just blit it
+	WChartLayerCache::Key key;
+	key.width = getWidth();
+	key.height = getHeight();
+	key.x = _scaleT.getXMapping(getOriginTime(), (float)getWidth());
+	key.y = _scaleT.withYMapper((float)getHeight(), [](const auto& m) { return m.mapping; });
+	key.yScale = _scaleT.yScale;
+	_gridLayer.draw(g, key, [this, &key](Graphics& lg) {
+		const float w = (float)getWidth();
+		const float h = (float)getHeight();
+		lg.setColour(WLookAndFeel::gridColour);
+		for (const auto& tick : _gridTicks.getTimeTicks(key.x, w, WChartAxis::minTickSpacing)) {
+			const float x = key.x.toPixel(tick.time);
+			if (x >= 0.0f && x <= w)
+				lg.drawVerticalLine(roundToInt(x), 0.0f, h);
+		}
+		_scaleT.withYMapper(h, [&](const auto& yMap) {
+			for (const auto& tick : _gridTicks.getPriceTicks(yMap, h, WChartAxis::minPriceTickSpacing)) {
+				const float y = yMap.toPixel(tick.value);
+				if (y >= 0.0f && y <= h)
+					lg.drawHorizontalLine(roundToInt(y), 0.0f, w);
+			}
+		});
+	});
+}
+
+void WChartViewport::_paintCurves(Graphics& g, int64 origin, float x0, float x1) {
+	const FrameProfiler::Scope scope(FrameProfiler::rasterization);
+	for (auto& c : _curves)
+		c->paint(g, _curveScratch, _scaleT, origin, (float)getWidth(), (float)getHeight(), x0, x1);
+	_shapes.paint(g, _scaleT, origin, (float)getWidth(), (float)getHeight(), x0, x1);
+}
+
+float WChartViewport::snapToCandle(float x) const {
+	auto snap = [&](const auto& src) {
+		if (src.getEnd() == src.getBegin())
+			return x;
+		const int64 unit = _getCandleUnit(src);
+		const auto xMap = _scaleT.getXMapping(src.getOriginTime(), (float)getWidth());
+		// candles are drawn at the middle of their period, the one under x or its neighbours
+		const int64 t = (int64)std::floor(xMap.toValue(x)) - unit / 2;
+		const auto rows = src.findRange(t - unit, t + unit);
+		float best = x;
+		float bestDistance = std::numeric_limits<float>::max();
+		for (uint64 r = rows.first; r < rows.last; r++) {
+			const float cx = xMap.toPixel(src.getOpenTime(r) + unit / 2);
+			if (std::abs(cx - x) < bestDistance) {
+				bestDistance = std::abs(cx - x);
+				best = cx;
+			}
+		}
+		return best;
+	};
+	if (_live)
+		return snap(LiveSource{ _liveFrame });
+	if (_store && !_store->isEmpty())
+		return snap(StoreSource{ *_store, *_lod });
+	return x;
+}
+
+void WChartViewport::_updateLogPrices() {
+	// the pyramids keep log prices while the axis is log (a worker frame may be reading them)
+	const bool log = _scaleT.yScale == AxisScale::logarithmic;
+	// a shared pyramid keeps them for the windows with a log axis
+	if (_lod->isLogPricesEnabled() != log && (log || !_sharedLod)) {
+		_invalidateBackgroundFrame();
+		_lod->setLogPricesEnabled(log);
+	}
+	for (auto& c : _curves)
+		c->setLogPricesEnabled(log);
+}
+
+WChartCurve* WChartViewport::addCurve(KlineStore::Ptr times, SPtr<const std::vector<double>> values, const WChartCurve::Options& options) {
+	return _addCurve(new WChartCurve(std::move(times), std::move(values), options));
+}
+
+WChartCurve* WChartViewport::addCurve(FunctionSeries::Ptr function, const WChartCurve::Options& options) {
+	return _addCurve(new WChartCurve(std::move(function), options));
+}
+
+WChartCurve* WChartViewport::_addCurve(WChartCurve* c) {
+	c->onChanging = [this] { _invalidateBackgroundFrame(); };
+	c->onChanged = [this] {
+		_dataLayer.invalidate();
+		repaint();
+	};
+	_curves.emplace_back(c);
+	c->onChanged();
+	return c;
+}
+
+void WChartViewport::removeCurve(WChartCurve* curve) {
+	auto it = std::find_if(_curves.begin(), _curves.end(), [curve](const UPtr<WChartCurve>& c) { return c.get() == curve; });
+	if (it == _curves.end())
+		return;
+	_invalidateBackgroundFrame();
+	_curves.erase(it);
+	_dataLayer.invalidate();
+	repaint();
+}
+
+void WChartViewport::clearCurves() {
+	_invalidateBackgroundFrame();
+	_curves.clear();
+	_dataLayer.invalidate();
+	repaint();
+}
+
+WChartHistogram* WChartViewport::addHistogram(const WChartHistogram::Options& options) {
+	auto* h = new WChartHistogram(options);
+	h->onChanged = [this] { repaint(); };
+	_histograms.emplace_back(h);
+	repaint();
+	return h;
+}
+
+void WChartViewport::removeHistogram(WChartHistogram* histogram) {
+	auto it = std::find_if(_histograms.begin(), _histograms.end(), [histogram](const UPtr<WChartHistogram>& h) { return h.get() == histogram; });
+	if (it == _histograms.end())
+		return;
+	_histograms.erase(it);
+	repaint();
+}
+
+void WChartViewport::clearHistograms() {
+	_histograms.clear();
+	repaint();
+}
+
+void WChartViewport::setVolumeProfileVisible(bool shouldBeVisible, const WChartHistogram::Options& options) {
+	if (!shouldBeVisible) {
+		_profileHistogram = nullptr;
+		_profile.clear();
+		repaint();
+		return;
+	}
+	auto o = options;
+	o.axis = WChartHistogram::Axis::price;
+	if (_profileHistogram == nullptr) {
+		// set from updateVisibleRange(), inside paint : no onChanged
+		_profileHistogram = std::make_unique<WChartHistogram>(o);
+		if (_store)
+			_profile.build(*_store);
+	}
+	else {
+		_profileHistogram->setOptions(o);
+	}
+	_profileStale = true;
+	repaint();
+}
+
+template <typename Fn>
+void WChartViewport::_forEachHistogram(Fn&& fn) {
+	for (auto& h : _histograms)
+		fn(*h);
+	if (_profileHistogram)
+		fn(*_profileHistogram);
+}
+
+void WChartViewport::_updateVolumeProfile() {
+	if (_profileHistogram == nullptr)
+		return;
+	if (_live || _profile.isEmpty() || _visibleRange.isEmpty()) {
+		if (_profileHistogram->size() > 0)
+			_profileHistogram->setBins({}, {});
+		_profileStale = true;
+		return;
+	}
+	const size_t first = (size_t)_visibleRange.first;
+	const size_t last = (size_t)_visibleRange.last;
+	if (!_profileStale && first == _profile.getFirstRow() && last == _profile.getLastRow())
+		return;
+	_profile.setRange(first, last);
+	const int n = _profile.getNumBuckets();
+	std::vector<double> edges((size_t)n + 1);
+	for (int b = 0; b <= n; b++)
+		edges[(size_t)b] = _profile.getBucketPrice(b);
+	_profileHistogram->setBins(std::move(edges), _profile.getBuyVolumes(), _profile.getSellVolumes());
+	_profileStale = false;
+}
+
+void WChartViewport::_paintHistograms(Graphics& g) {
+	const FrameProfiler::Scope scope(FrameProfiler::rasterization);
+	// the GL frame has the filled ones of a store
+	const bool glFills = _gl != nullptr && !_live;
+	const float w = (float)getWidth();
+	const float h = (float)getHeight();
+	_forEachHistogram([&](WChartHistogram& histogram) {
+		if (!(glFills && histogram.getOptions().style == WChartHistogram::Style::fill))
+			histogram.paint(g, _scaleT, getOriginTime(), w, h, 0.0f, w);
+	});
+}
+
+void WChartViewport::_updateGLFrame() {
+	if (_live || !_store || _visibleRange.isEmpty()) {
+		_gl->clearFrame();
+		return;
+	}
+	WChartGLRenderer::Frame f;
+	f.store = _store;
+	f.range = _visibleRange;
+	f.candleUnit = _getCandleUnit(StoreSource{ *_store, *_lod });
+	f.x = _scaleT.getXMapping(_store->getFirstOpenTime(), (float)getWidth());
+	f.y = _scaleT.withYMapper((float)getHeight(), [](const auto& m) { return m.mapping; });
+	f.logScale = _scaleT.yScale == AxisScale::logarithmic;
+	f.width = (float)getWidth();
+	f.height = (float)getHeight();
+	f.bodyWidth = jmax(1.0f, (float)((double)f.candleUnit * std::abs(f.x.scale)) * 0.8f);
+	std::vector<float> first, second;
+	_forEachHistogram([&](WChartHistogram& histogram) {
+		const auto& o = histogram.getOptions();
+		if (o.style != WChartHistogram::Style::fill || histogram.size() == 0)
+			return;
+		histogram.computeBars(_scaleT, _store->getFirstOpenTime(), f.width, f.height, first, second);
+		WChartGLRenderer::Bars bars;
+		bars.alongX = o.axis == WChartHistogram::Axis::time;
+		bars.anchorRight = o.anchorRight;
+		bars.extent = o.extent;
+		bars.colour = o.colour.withMultipliedAlpha(o.alpha);
+		bars.secondColour = o.secondColour.withMultipliedAlpha(o.alpha);
+		bars.lengths.resize(first.size() * 2);
+		for (size_t i = 0; i < first.size(); i++) {
+			bars.lengths[i * 2] = first[i];
+			bars.lengths[i * 2 + 1] = second.empty() ? 0.0f : second[i];
+		}
+		f.histograms.push_back(std::move(bars));
+	});
+	_addGLOverlay(f);
+	_gl->setFrame(std::move(f));
+}
+
+void WChartViewport::_addGLOverlay(WChartGLRenderer::Frame& f) {
+	using GL = WChartGLRenderer;
+	const int64 origin = _store->getFirstOpenTime();
+	const float originX = f.x.toPixel(origin);
+	for (auto& c : _curves) {
+		const auto& o = c->getOptions();
+		const auto& points = c->getPolyline(_curveScratch, _scaleT, origin, f.width, f.height, 0.0f, f.width);
+		if (points.empty())
+			continue;
+		if (o.style == WChartCurve::Style::area || o.style == WChartCurve::Style::fill)
+			f.addFill(points.data(), points.size(), c->getFillBase(_scaleT, f.height), o.colour.withAlpha(o.fillAlpha));
+		GL::LineStyle style;
+		style.colour = o.colour;
+		style.thickness = o.thickness;
+		style.pattern = o.style == WChartCurve::Style::dashed ? GL::LinePattern::dashed
+			: o.style == WChartCurve::Style::dot ? GL::LinePattern::dotted : GL::LinePattern::solid;
+		style.dash = o.dash;
+		style.gap = o.gap;
+		f.addLine(points.data(), points.size(), style, originX);
+	}
+
+	_shapes.getVisible(_scaleT, origin, f.width, f.height, 0.0f, f.width, _glShapes, _glShapePoints);
+	for (const auto& v : _glShapes) {
+		const auto& o = v.options;
+		const float thickness = o.filled || v.type == WChartShapes::Type::dot ? 0.0f : o.thickness;
+		switch (v.type) {
+		case WChartShapes::Type::path: {
+			GL::LineStyle style;
+			style.colour = o.colour;
+			style.thickness = o.thickness;
+			f.addLine(_glShapePoints.data() + v.first, v.count, style, originX);
+			break;
+		}
+		case WChartShapes::Type::rect:
+			f.addShape(GL::Shape::rect, v.bounds, thickness, o.colour);
+			break;
+		case WChartShapes::Type::triangleUp:
+			f.addShape(GL::Shape::triangleUp, v.bounds, thickness, o.colour);
+			break;
+		case WChartShapes::Type::triangleDown:
+			f.addShape(GL::Shape::triangleDown, v.bounds, thickness, o.colour);
+			break;
+		default:
+			f.addShape(GL::Shape::circle, v.bounds, thickness, o.colour);
+			break;
+		}
+	}
+}
+
+void WChartViewport::setOpenGLEnabled(bool shouldBeEnabled) {
+	if (shouldBeEnabled == isOpenGLEnabled())
+		return;
+	// the curves are painted on the message thread from now on
+	_invalidateBackgroundFrame();
+	_gl = shouldBeEnabled ? std::make_unique<WChartGLRenderer>(*this) : nullptr;
+	_dataLayer.clear();
+	updateVisibleRange();
+	repaint();
+}
+
+bool WChartViewport::isOpenGLEnabled() const {
+	return _gl != nullptr;
+}
+
+void WChartViewport::setBackgroundRenderingEnabled(bool shouldBeEnabled) {
+	if (shouldBeEnabled == isBackgroundRenderingEnabled())
+		return;
+	if (shouldBeEnabled) {
+		_renderThread = std::make_unique<WChartRenderThread>();
+		_renderThread->onFrameReady = [this]() { repaint(); };
+	}
+	else {
+		_renderThread = nullptr;
+	}
+	_dataLayer.clear();
+	repaint();
 }
 
+bool WChartViewport::isBackgroundRenderingEnabled() const {
+	return _renderThread != nullptr;
+}
+
+void WChartViewport::setTileCacheEnabled(bool shouldBeEnabled) {
+	if (shouldBeEnabled == isTileCacheEnabled())
+		return;
+	if (shouldBeEnabled) {
+		_tileCache = std::make_unique<WChartTileCache>();
+		_tileCache->onTileReady = [this]() { repaint(); };
+	}
+	else {
+		_tileCache = nullptr;
+	}
+	_paintedTiles = false;
+	repaint();
+}
+
+bool WChartViewport::isTileCacheEnabled() const {
+	return _tileCache != nullptr;
+}
+
+void WChartViewport::_invalidateBackgroundFrame() {
+	if (_renderThread)
+		_renderThread->invalidate();
+	// the tiles done stay in the cache under their old version, until evicted
+	if (_tileCache)
+		_tileCache->cancel();
+	_tileVersion++;
+}
 
+void WChartViewport::_paintStoreInBackground(Graphics& g) {
+	StoreSource src{ *_store, *_lod };
+	auto frame = _getDataFrame(src);
+	if (_renderThread->draw(g, frame.key))
+		return;
+	// everything the worker reads is captured, but the store rows, the pyramid, the curves
+	// and the shapes, which are not changed without _invalidateBackgroundFrame()
+	std::vector<WChartCurve*> curves;
+	for (auto& c : _curves)
+		curves.push_back(c.get());
+	_renderThread->request(frame.key, [this, frame, curves = std::move(curves), scaleT = _scaleT, store = _store, lod = _lod, rows = _visibleRange](Graphics& lg) {
+		StoreSource src{ *store, *lod };
+		src.selectLevel(frame.rowsPerBucket);
+		const float w = (float)frame.key.width;
+		const float h = (float)frame.key.height;
+		_paintCandles(lg, src, rows, frame.shift, frame.strategy, scaleT, src.getOriginTime(), w, h, _renderBatch);
+		for (auto* c : curves)
+			c->paint(lg, _renderCurveScratch, scaleT, src.getOriginTime(), w, h, 0.0f, w);
+		_shapes.paint(lg, scaleT, src.getOriginTime(), w, h, 0.0f, w);
+	});
+}
+
+double WChartViewport::_getTilePreset() const {
+	const auto& x = _scaleT.getX();
+	if (x.xDir != WChartScaleTransform::AxisDirection::left_to_right)
+		return 0.0;
+	// the unit world is in double, a preset is reached to a few ulps at any distance from the origin
+	const double m = _scaleT.getMsPerPixel();
+	for (double p : x.zoomPresets)
+		if (std::abs(m - p) <= p * 1.0e-9)
+			return p;
+	return 0.0;
+}
+
+static int64 combineHash(int64 h, int64 value) {
+	return (int64)(((uint64)h ^ (uint64)value) * 1099511628211ull);
+}
+
+void WChartViewport::_paintStoreTiles(Graphics& g, double msPerPixel) {
+	StoreSource src{ *_store, *_lod };
+	const int width = getWidth();
+	// the level follows the preset and not the rows in view : every tile of a preset has the same
+	// one, and the same one as the untiled path over a full viewport
+	const double rows = (double)width * msPerPixel / (double)jmax((int64)1, _getCandleUnit(src));
+	const double rowsPerBucket = _scaleT.sampling.getMaxRowsPerBucket(rows, (double)width);
+	const int shift = src.selectLevel(rowsPerBucket);
+	const auto strategy = shift == 0 ? SamplingConfig::Strategy::OHLCCompress : _scaleT.sampling.strategy;
+
+	WChartTileCache::Key key;
+	int64 series = _store->getSymbol().hashCode64();
+	for (int64 v : { _store->getInterval().hashCode64(), (int64)_store->size(), _store->getFirstOpenTime(), _store->getLastOpenTime(), _tileVersion })
+		series = combineHash(series, v);
+	key.series = series;
+	key.msPerPixel = msPerPixel;
+	key.height = getHeight();
+	key.y = _scaleT.withYMapper((float)getHeight(), [](const auto& m) { return m.mapping; });
+	key.yScale = _scaleT.yScale;
+	// the curves pick their level from the viewport width when the density is fixed
+	key.tag = (int64)shift | ((int64)strategy << 8) | ((_scaleT.sampling.mode == SamplingMode::FixedDensity ? (int64)width : 0) << 16);
+	const double viewStart = _scaleT.getXMapping(src.getOriginTime(), (float)width).toValue(0.0f);
+
+	// a tile is drawn as the left of a viewport as wide as this one starting at its first time
+	auto tileT = _scaleT;
+	tileT.xWorld = { 0.0f, (float)width, 0.0f, (float)width };
+	tileT.xUnit.setWorldStart(0.0).setWorldEnd((double)width * msPerPixel);
+	std::vector<WChartCurve*> curves;
+	for (auto& c : _curves)
+		curves.push_back(c.get());
+	// same captures as _paintStoreInBackground(), the shared data waits for _tileCache->cancel()
+	_tileCache->draw(g, key, viewStart, width, [this, key, rowsPerBucket, shift, strategy, width, curves = std::move(curves), tileT, store = _store, lod = _lod](Graphics& lg, int64 tileStart) {
+		StoreSource src{ *store, *lod };
+		src.selectLevel(rowsPerBucket);
+		const float w = (float)width;
+		const float h = (float)key.height;
+		const float tw = (float)WChartTileCache::tileWidth;
+		// the candles crossing the tile edges are drawn by both tiles
+		const int64 unit = _getCandleUnit(src) << shift;
+		const auto rows = src.findRange(tileStart - 2 * unit, tileStart + (int64)std::ceil(key.getTileSpan()) + unit);
+		if (!rows.isEmpty())
+			_paintCandles(lg, src, rows, shift, strategy, tileT, tileStart, w, h, _tileBatch);
+		for (auto* c : curves)
+			c->paint(lg, _tileCurveScratch, tileT, tileStart, w, h, 0.0f, tw);
+		_shapes.paint(lg, tileT, tileStart, w, h, 0.0f, tw);
+	});
+}
+
+void WChartViewport::CandleBatch::resize(size_t n) {
+	for (auto* v : { &open, &high, &low, &close })
+		v->resize(n);
+	for (auto* v : { &x, &yOpen, &yHigh, &yLow, &yClose })
+		v->resize(n);
+	time.resize(n);
+}
+
+template <typename Source>
+int64 WChartViewport::_getCandleUnit(const Source& src) {
+	const uint64 begin = src.getBegin();
+	return src.getEnd() - begin > 1 ? src.getOpenTime(begin + 1) - src.getOpenTime(begin) : 1;
+}
+
+template <typename Source>
+SeriesRange WChartViewport::_resolveRange(const Source& src) const {
+	if (src.getEnd() == src.getBegin())
+		return {};
+	// a candle that started one candle before the viewport is still partly visible
+	const auto xMap = _scaleT.getXMapping(src.getOriginTime(), (float)getWidth());
+	const double t0 = xMap.toValue(0.0f);
+	const double t1 = xMap.toValue((float)getWidth());
+	return src.findRange((int64)std::floor(jmin(t0, t1)) - _getCandleUnit(src), (int64)std::ceil(jmax(t0, t1)));
+}
+
+template <typename Source>
+WChartViewport::DataFrame WChartViewport::_getDataFrame(Source& src) const {
+	// the level follows the whole visible range, the strips rendered while panning use the same one
+	DataFrame f;
+	f.rowsPerBucket = _scaleT.sampling.getMaxRowsPerBucket((double)_visibleRange.size(), (double)getWidth());
+	f.shift = src.selectLevel(f.rowsPerBucket);
+	f.strategy = f.shift == 0 ? SamplingConfig::Strategy::OHLCCompress : _scaleT.sampling.strategy;
+
+	auto& key = f.key;
+	key.width = getWidth();
+	key.height = getHeight();
+	key.x = _scaleT.getXMapping(src.getOriginTime(), (float)getWidth());
+	key.y = _scaleT.withYMapper((float)getHeight(), [](const auto& m) { return m.mapping; });
+	key.yScale = _scaleT.yScale;
+	key.tag = (int64)f.shift | ((int64)f.strategy << 8);
+	return f;
+}
+
+template <typename Source>
+void WChartViewport::_paintData(Graphics& g, Source& src) {
+	const auto frame = _getDataFrame(src);
+	const auto& key = frame.key;
+	const int shift = frame.shift;
+	const auto strategy = frame.strategy;
+
+	// live rows that changed since the image was rendered (it may repaint without updateLiveSeries())
+	if constexpr (std::is_same_v<Source, LiveSource>) {
+		if (!_livePainted.isEmpty() && _paintedShift == shift)
+			_dataLayer.invalidate(_getChangedBounds(_liveFrame, _livePainted, shift));
+		_livePainted = _liveFrame;
+	}
+	_paintedShift = shift;
+
+	_dataLayer.draw(g, key, [&](Graphics& lg, Rectangle<int> area) {
+		// rows under the area, plus the candles (and the close line) crossing its edges
+		const int64 unit = _getCandleUnit(src) << shift;
+		const double t0 = key.x.toValue((float)area.getX());
+		const double t1 = key.x.toValue((float)area.getRight());
+		const auto range = src.findRange((int64)std::floor(jmin(t0, t1)) - 2 * unit, (int64)std::ceil(jmax(t0, t1)) + unit);
+		if (!range.isEmpty())
+			_paintCandles(lg, src, range, shift, strategy, _scaleT, src.getOriginTime(), (float)getWidth(), (float)getHeight(), _batch);
+		_paintCurves(lg, src.getOriginTime(), (float)area.getX(), (float)area.getRight());
+	});
+}
+
+template <typename Source>
+void WChartViewport::_paintCandles(Graphics& g, Source& src, const SeriesRange& rows, int shift, SamplingConfig::Strategy strategy,
+	const WChartScaleTransform& scaleT, int64 origin, float width, float height, CandleBatch& c) {
+	const uint64 begin = src.getBegin();
+	const uint64 first = rows.first;
+	const uint64 last = rows.last;
+
+	const uint64 firstBucket = first >> shift;
+	const uint64 lastBucket = ((last - 1) >> shift) + 1;
+	const size_t n = (size_t)(lastBucket - firstBucket);
+	const int64 bucketUnit = _getCandleUnit(src) << shift;
+	FrameProfiler::getInstance().count(FrameProfiler::pointsDrawn, (int64)n);
+
+	// buckets of the level gathered and mapped, then the primitives built and filled.
+	// On a log axis the stored levels give their log prices, mapped linearly
+	FrameProfiler::Scope gathering(FrameProfiler::decimation);
+	const bool logBuckets = scaleT.yScale == AxisScale::logarithmic && src.hasLogBuckets();
+	c.resize(n);
+	for (size_t i = 0; i < n; i++) {
+		const uint64 b = firstBucket + i;
+		const auto k = logBuckets ? src.getLogBucket(b) : src.getBucket(b);
+		// the first bucket may start before the oldest row of a ring, draw it from its first valid row
+		c.time[i] = src.getOpenTime(jmax(begin, b << shift)) + bucketUnit / 2;
+		c.open[i] = k.open;
+		c.high[i] = k.high;
+		c.low[i] = k.low;
+		c.close[i] = k.close;
+	}
+
+	// x from an origin inside the frame, the times stay exact whatever the epoch
+	const auto xMap = scaleT.getXMapping(origin, width).withOrigin(c.time[0]);
+	xMap.toPixels(c.time.data(), c.x.data(), n);
+	// linear or log, picked here once for the whole batch
+	scaleT.withYMapper(height, [&](const auto& yMap) {
+		if (logBuckets) {
+			yMap.forwardToPixels(c.open.data(), c.yOpen.data(), n);
+			yMap.forwardToPixels(c.high.data(), c.yHigh.data(), n);
+			yMap.forwardToPixels(c.low.data(), c.yLow.data(), n);
+			yMap.forwardToPixels(c.close.data(), c.yClose.data(), n);
+			return;
+		}
+		yMap.toPixels(c.open.data(), c.yOpen.data(), n);
+		yMap.toPixels(c.high.data(), c.yHigh.data(), n);
+		yMap.toPixels(c.low.data(), c.yLow.data(), n);
+		yMap.toPixels(c.close.data(), c.yClose.data(), n);
+	});
+
+	const float bodyWidth = jmax(1.0f, (float)((double)bucketUnit * std::abs(xMap.scale)) * 0.8f);
+	gathering.stop();
+	const FrameProfiler::Scope filling(FrameProfiler::rasterization);
+
+	if (strategy == SamplingConfig::Strategy::FirstLast) {
+		auto& p = c.line;
+		p.clear();
+		p.preallocateSpace((int)n * 3 + 3);
+		p.startNewSubPath(c.x[0], c.yClose[0]);
+		for (size_t i = 1; i < n; i++)
+			p.lineTo(c.x[i], c.yClose[i]);
+		g.setColour(WLookAndFeel::candleUpColour);
+		g.strokePath(p, PathStrokeType(1.0f));
+		return;
+	}
+
+	// wicks and bodies gathered per colour, two fills for the whole batch
+	auto& up = c.up;
+	auto& down = c.down;
+	up.clear();
+	down.clear();
+	up.ensureStorageAllocated((int)n * 2);
+	down.ensureStorageAllocated((int)n * 2);
+
+	if ((double)bucketUnit * std::abs(xMap.scale) < minCandleSpacing) {
+		// sub-pixel candles : one low -> high column per pixel column, coloured from its first open to its last close
+		for (size_t i = 0; i < n;) {
+			const float column = std::floor(c.x[i]);
+			float top = jmin(c.yHigh[i], c.yLow[i]);
+			float bottom = jmax(c.yHigh[i], c.yLow[i]);
+			size_t j = i + 1;
+			for (; j < n && std::floor(c.x[j]) == column; j++) {
+				top = jmin(top, jmin(c.yHigh[j], c.yLow[j]));
+				bottom = jmax(bottom, jmax(c.yHigh[j], c.yLow[j]));
+			}
+			(c.close[j - 1] >= c.open[i] ? up : down).addWithoutMerging({ column, top, 1.0f, jmax(1.0f, bottom - top) });
+			i = j;
+		}
+	}
+	else {
+		for (size_t i = 0; i < n; i++) {
+			auto& list = c.close[i] >= c.open[i] ? up : down;
+			const float px = c.x[i];
+			const float top = jmin(c.yHigh[i], c.yLow[i]);
+			list.addWithoutMerging({ px - 0.5f, top, 1.0f, jmax(1.0f, jmax(c.yHigh[i], c.yLow[i]) - top) });
+			if (strategy == SamplingConfig::Strategy::OHLCCompress) {
+				const float yOpen = c.yOpen[i];
+				const float yClose = c.yClose[i];
+				list.addWithoutMerging({ px - bodyWidth * 0.5f, jmin(yOpen, yClose), bodyWidth, jmax(1.0f, std::abs(yClose - yOpen)) });
+			}
+		}
+	}
+	g.setColour(WLookAndFeel::candleUpColour);
+	g.fillRectList(up);
+	g.setColour(WLookAndFeel::candleDownColour);
+	g.fillRectList(down);
+}
+
+void WChartViewport::setStore(KlineStore::Ptr store) {
+	// another series, the last frame is not even a placeholder
+	if (_renderThread)
+		_renderThread->clear();
+	// the tiles of the previous series stay cached, coming back to it finds them
+	if (_tileCache)
+		_tileCache->cancel();
+	_store = std::move(store);
+	_updatePyramid(0);
+	if (_store && _profileHistogram)
+		_profile.build(*_store);
+	else
+		_profile.clear();
+	_profileStale = true;
+	_dataLayer.invalidate();
+	repaint();
+}
+
+void WChartViewport::updateStore(KlineStore::Ptr store, size_t fromRow) {
+	_invalidateBackgroundFrame();
+	_store = std::move(store);
+	_updatePyramid(fromRow);
+	if (_store && _profileHistogram)
+		_profile.update(*_store, fromRow);
+	else
+		_profile.clear();
+	_profileStale = true;
+	_dataLayer.invalidate();
+	repaint();
+}
+
+void WChartViewport::writeStore(const std::function<void()>& write) {
+	// no new frame or tile starts before the next paint
+	if (_renderThread)
+		_renderThread->cancel();
+	if (_tileCache)
+		_tileCache->cancel();
+	if (_gl)
+		_gl->writeStore(write);
+	else
+		write();
+}
+
+void WChartViewport::_updatePyramid(size_t fromRow) {
+	if (_store && fromRow == 0 && _cacheSource.existsAsFile()) {
+		// a file series doesn't change once loaded, the windows drawing it share its pyramid
+		_lod = Workspace::getInstance().getPyramid(_store, _cacheSource);
+		_sharedLod = true;
+		return;
+	}
+	if (_sharedLod) {
+		// the shared one is left to the other windows
+		_lod = std::make_shared<LodPyramid>();
+		_sharedLod = false;
+		fromRow = 0;
+	}
+	if (_store)
+		_lod->update(*_store, fromRow);
+	else
+		_lod->clear();
+}
+
+const KlineStore::Ptr& WChartViewport::getStore() const {
+	return _store;
+}
+
+const SeriesRange& WChartViewport::getVisibleRange() const {
+	return _visibleRange;
+}
+
+Range<double> WChartViewport::getVisibleValueRange() const {
+	return _getValueRange(_visibleRange, _liveFrame);
+}
+
+Range<double> WChartViewport::getLiveValueRange() const {
+	if (!_live)
+		return {};
+	return _getValueRange(_resolveRange(LiveSource{ _liveReported }), _liveReported);
+}
+
+Range<double> WChartViewport::_getValueRange(const SeriesRange& rows, const KlineRingSeries::Snapshot& snap) const {
+	if (rows.isEmpty())
+		return {};
+	// Range() is "no value", like KlineStore::computePriceRange
+	Range<double> r;
+	bool any = false;
+	auto add = [&](Range<double> v) {
+		if (v == Range<double>())
+			return;
+		r = any ? r.getUnionWith(v) : v;
+		any = true;
+	};
+	int64 start = 0, end = 0;
+	if (_live) {
+		add(snap.computePriceRange(rows.first, rows.last));
+		start = snap.getOpenTime(rows.first);
+		end = snap.getOpenTime(rows.last - 1) + 1;
+	}
+	else if (_store) {
+		add(_lod->computePriceRange((size_t)rows.first, (size_t)rows.last));
+		start = _store->getOpenTime()[rows.first];
+		end = _store->getOpenTime()[rows.last - 1] + 1;
+	}
+	// Bollinger bands, functions and the other overlays stay in view
+	const double msPerPixel = _scaleT.getMsPerPixel();
+	for (const auto& c : _curves)
+		add(c->getValueRange(start, end, msPerPixel));
+	return r;
+}
+
+void WChartViewport::setLiveSeries(KlineRingSeries::Ptr series) {
+	// the curves are painted on the message thread with a live series
+	_invalidateBackgroundFrame();
+	_live = std::move(series);
+	_liveReported = _live ? _live->getSnapshot() : KlineRingSeries::Snapshot();
+	_livePainted = {};
+	_dataLayer.invalidate();
+	repaint();
+}
+
+const KlineRingSeries::Ptr& WChartViewport::getLiveSeries() const {
+	return _live;
+}
+
+
+
+Rectangle<int> WChartViewport::updateLiveSeries() {
+	if (!_live)
+		return {};
+	const auto previous = _liveReported;
+	_liveReported = _live->getSnapshot();
+	const auto bounds = _getChangedBounds(_liveReported, previous, _paintedShift);
+	if (!bounds.isEmpty())
+		repaint(bounds);
+	return bounds;
+}
+
+Rectangle<int> WChartViewport::_getChangedBounds(const KlineRingSeries::Snapshot& snap, const KlineRingSeries::Snapshot& previous, int shift) const {
+	const uint64 from = snap.getFirstChangedRow(previous);
+	if (from == snap.end)
+		return {};
+	// another series, wrapped ring under the view : everything moved
+	if (from == snap.begin || snap.begin > _visibleRange.first)
+		return getLocalBounds();
+
+	// the old pixels of the forming candle are erased too
+	auto area = _getLiveArea(snap, from, shift);
+	if (previous.end > from)
+		area = area.getUnion(_getLiveArea(previous, from, shift));
+	return _scaleT.toPixels(area, snap.originTime, (float)getWidth(), (float)getHeight())
+		.expanded(2.0f)
+		.getIntersection(getLocalBounds().toFloat())
+		.getSmallestIntegerContainer();
+}
+
+WorldRect WChartViewport::_getLiveArea(const KlineRingSeries::Snapshot& snap, uint64 fromRow, int shift) const {
+	// whole buckets as drawn, from the one before the change (the line of FirstLast joins it) to the last one
+	const int64 unit = _getCandleUnit(LiveSource{ snap }) << shift;
+	const uint64 firstBucket = jmax(snap.begin >> shift, (fromRow >> shift) - ((fromRow >> shift) > 0 ? 1 : 0));
+	const uint64 lastBucket = (snap.end - 1) >> shift;
+	WorldRect r;
+	r.startTime = snap.getOpenTime(jmax(snap.begin, firstBucket << shift));
+	r.endTime = snap.getOpenTime(jmax(snap.begin, lastBucket << shift)) + unit;
+	r.low = std::numeric_limits<double>::max();
+	r.high = std::numeric_limits<double>::lowest();
+	for (uint64 b = firstBucket; b <= lastBucket; b++) {
+		const auto k = snap.getBucket(shift, b);
+		r.low = jmin(r.low, k.low);
+		r.high = jmax(r.high, k.high);
+	}
+	return r;
+}
+
+bool WChartViewport::getLastLiveKline(KlineRingSeries::Kline& k) const {
+	if (!_live || _liveReported.isEmpty())
+		return false;
+	k = _liveReported.getRow(_liveReported.end - 1);
+	return true;
+}
@@ -10,8 +10,22 @@
 
 #pragma once
 #include "../BaseComponent.h"
-
-class WChartScaleTransform;
+#include "../../../data/KlineStore.h"
+#include "../../../data/LodPyramid.h"
+#include "../../../data/KlineRingSeries.h"
+#include "../../../data/VolumeProfile.h"
+#include "WChartLayerCache.h"
+#include "WChartScrollLayer.h"
+#include "WChartRenderThread.h"
+#include "WChartTileCache.h"
+#include "WChartTicks.h"
+#include "WChartCurve.h"
+#include "WChartShapes.h"
+#include "WChartHistogram.h"
+#include "WChartFills.h"
+#include "WChartTransform.h"
+#include "WChartGLRenderer.h"
+#include "../../../utils/MemoryBudget.h"
 
 
 /*
@@ -37,13 +51,198 @@ Il faudrait surement un concept de layouts d
 
 */
 
-class WChartViewport : public BaseComponent {
+class WChartViewport : public BaseComponent, private MemoryBudget::Client {
 public:
 	WChartViewport(WChartScaleTransform& scaleT);
+	~WChartViewport() override;
 
 	void paint(Graphics& g) override;
 
+	void setStore(KlineStore::Ptr store);
+	// same series grown or with a rewritten tail, only the pyramid from fromRow on is rebuilt
+	void updateStore(KlineStore::Ptr store, size_t fromRow);
+	// runs write, which changes the drawn store in place (KlineResampler::sync), while no worker
+	// reads it : the frame and tile in flight are cancelled, the GL thread waits. Then updateStore()
+	void writeStore(const std::function<void()>& write);
+	const KlineStore::Ptr& getStore() const;
+	// file the stores come from : their pyramid is cached next to it (DerivedCache) and shared
+	// with the other viewports drawing them (Workspace). None by default
+	void setCacheSource(const File& file) { _cacheSource = file; }
+
+	// a live series is drawn instead of the store while set
+	void setLiveSeries(KlineRingSeries::Ptr series);
+	const KlineRingSeries::Ptr& getLiveSeries() const;
+	// picks up the changes of the live series since the last call and repaints only the
+	// pixels of the candles they touch, returned (empty when nothing visible changed)
+	Rectangle<int> updateLiveSeries();
+	// forming candle as of the last updateLiveSeries()
+	bool getLastLiveKline(KlineRingSeries::Kline& k) const;
+
+	// resolves the rows of the drawn series inside the x viewport (O(log n)),
+	// WChart calls it once per frame before its layers paint so they all share the
+	// same slice (and the same live snapshot), paint() doesn't call it again.
+	// Rebuilds the fine levels of the pyramid released while off screen
+	void updateVisibleRange();
+	const SeriesRange& getVisibleRange() const;
+	// low / high of the candles and the curves in the visible range, for the y autoscale.
+	// O(log n) from the pyramids, of the store or of the live series
+	Range<double> getVisibleValueRange() const;
+	// the same with the live snapshot of the last updateLiveSeries(), before a frame resolves it
+	Range<double> getLiveValueRange() const;
+	// open_time the x units of the drawn series are relative to
+	int64 getOriginTime() const;
+
+	// line series over the candles, rendered with them in the data layer
+	WChartCurve* addCurve(KlineStore::Ptr times, SPtr<const std::vector<double>> values, const WChartCurve::Options& options = {});
+	// sampled over the visible range only, see FunctionSeries
+	WChartCurve* addCurve(FunctionSeries::Ptr function, const WChartCurve::Options& options = {});
+	void removeCurve(WChartCurve* curve);
+	void clearCurves();
+	int getNumCurves() const { return (int)_curves.size(); }
+	WChartCurve* getCurve(int index) const { return _curves[(size_t)index].get(); }
+	// markers, rects and paths over the curves, indexed for hit-testing
+	WChartShapes& getShapes() { return _shapes; }
+	const WChartShapes& getShapes() const { return _shapes; }
+	// bars over the curves, scaled on the visible bins every frame so not part of the data
+	// layer. With OpenGL the filled ones are textures drawn by WChartGLRenderer, under the curves
+	WChartHistogram* addHistogram(const WChartHistogram::Options& options = {});
+	void removeHistogram(WChartHistogram* histogram);
+	void clearHistograms();
+	int getNumHistograms() const { return (int)_histograms.size(); }
+	WChartHistogram* getHistogram(int index) const { return _histograms[(size_t)index].get(); }
+
+	// volume by price of the visible rows of the store (not of a live series), built on
+	// the first show and updated incrementally as the range moves
+	void setVolumeProfileVisible(bool shouldBeVisible, const WChartHistogram::Options& options = {});
+	bool isVolumeProfileVisible() const { return _profileHistogram != nullptr; }
+	const VolumeProfile& getVolumeProfile() const { return _profile; }
+
+	// order history fills over everything, clustered per zoom (see WChartFills)
+	WChartFills& getFills() { return _fills; }
+	const WChartFills& getFills() const { return _fills; }
+
+	// x (pixels) of the center of the drawn candle nearest to x, x when there is none
+	float snapToCandle(float x) const;
+
+	// store candles drawn by WChartGLRenderer (instanced, uploaded once) with the curves and shapes
+	// over them (GPU lines and markers), live series stay in software
+	void setOpenGLEnabled(bool shouldBeEnabled);
+	bool isOpenGLEnabled() const;
+	// store candles and curves rasterized on a worker thread (WChartRenderThread), the
+	// message thread only draws the last finished frame. On by default, not used with OpenGL
+	void setBackgroundRenderingEnabled(bool shouldBeEnabled);
+	bool isBackgroundRenderingEnabled() const;
+	// at a zoom preset the store candles and curves are drawn from tiles rendered once per
+	// preset (WChartTileCache), panning and coming back to a preset only composite them.
+	// Off by default, not used with OpenGL nor for a live series
+	void setTileCacheEnabled(bool shouldBeEnabled);
+	bool isTileCacheEnabled() const;
+
 private:
+	// MemoryBudget::lodLevels, off screen only : the fine levels of the candles' pyramid
+	size_t releaseMemory(size_t bytes) override;
+
+	// visible buckets of the frame, gathered as columns then mapped to pixels in batches.
+	// Kept between frames, nothing is allocated once the sizes settle
+	struct CandleBatch {
+		std::vector<int64> time;
+		std::vector<double> open, high, low, close;
+		std::vector<float> x, yOpen, yHigh, yLow, yClose;
+		RectangleList<float> up, down; // wicks and bodies per colour
+		Path line;                     // FirstLast
+
+		void resize(size_t n);
+	};
+
+	// px between candles under which they collapse to min / max columns
+	static constexpr double minCandleSpacing = 2.0;
+
+	// level and layer key of the data frame
+	struct DataFrame {
+		WChartScrollLayer::Key key;
+		double rowsPerBucket = 1.0;
+		int shift = 0;
+		SamplingConfig::Strategy strategy = SamplingConfig::Strategy::OHLCCompress;
+	};
+
+	struct StoreSource;
+	struct LiveSource;
+	template <typename Source>
+	static int64 _getCandleUnit(const Source& src);
+	template <typename Source>
+	SeriesRange _resolveRange(const Source& src) const;
+	// snap is only read with a live series
+	Range<double> _getValueRange(const SeriesRange& rows, const KlineRingSeries::Snapshot& snap) const;
+	template <typename Source>
+	DataFrame _getDataFrame(Source& src) const;
+	template <typename Source>
+	void _paintData(Graphics& g, Source& src);
+	// reads scaleT and c only, also called on the render thread
+	template <typename Source>
+	static void _paintCandles(Graphics& g, Source& src, const SeriesRange& rows, int shift, SamplingConfig::Strategy strategy,
+		const WChartScaleTransform& scaleT, int64 origin, float width, float height, CandleBatch& c);
+	void _paintStoreInBackground(Graphics& g);
+	// the preset of the current x scale, 0 when it is not at one
+	double _getTilePreset() const;
+	void _paintStoreTiles(Graphics& g, double msPerPixel);
+	// waits for the frame of the render thread and renders it again, before the store, the
+	// pyramid or the curves change
+	void _invalidateBackgroundFrame();
+	void _updateGLFrame();
+	// curves then shapes as GL geometry
+	void _addGLOverlay(WChartGLRenderer::Frame& f);
+	void _paintGrid(Graphics& g);
+	// curves then shapes
+	void _paintCurves(Graphics& g, int64 origin, float x0, float x1);
+	// added ones then the volume profile
+	template <typename Fn>
+	void _forEachHistogram(Fn&& fn);
+	// log prices of the pyramids following the y scale
+	void _updateLogPrices();
+	// the pyramid of _store, from fromRow on
+	void _updatePyramid(size_t fromRow);
+	WChartCurve* _addCurve(WChartCurve* c);
+	void _updateVolumeProfile();
+	void _paintHistograms(Graphics& g);
+	Rectangle<int> _getChangedBounds(const KlineRingSeries::Snapshot& snap, const KlineRingSeries::Snapshot& previous, int shift) const;
+	WorldRect _getLiveArea(const KlineRingSeries::Snapshot& snap, uint64 fromRow, int shift) const;
+
 	WChartScaleTransform& _scaleT;
+	KlineStore::Ptr _store;
+	SPtr<LodPyramid> _lod = std::make_shared<LodPyramid>(); // shared by the windows drawing a file series (Workspace)
+	bool _sharedLod = false;
+	File _cacheSource;
+	KlineRingSeries::Ptr _live;
+	KlineRingSeries::Snapshot _liveFrame;
+	KlineRingSeries::Snapshot _liveReported;
+	KlineRingSeries::Snapshot _livePainted;
+	int _paintedShift = 0;
+	SeriesRange _visibleRange;
+	CandleBatch _batch;
+	WChartCurve::Scratch _curveScratch;
+	WChartLayerCache _gridLayer;
+	WChartTicks _gridTicks;
+	WChartScrollLayer _dataLayer;
+	std::vector<UPtr<WChartCurve>> _curves;
+	WChartShapes _shapes;
+	std::vector<UPtr<WChartHistogram>> _histograms;
+	VolumeProfile _profile;
+	UPtr<WChartHistogram> _profileHistogram;
+	bool _profileStale = true; // bins to set again, even for the same range
+	WChartFills _fills;
+	UPtr<WChartGLRenderer> _gl;
+	std::vector<WChartShapes::Visible> _glShapes;
+	std::vector<Point<float>> _glShapePoints;
+	CandleBatch _renderBatch; // render thread only
+	CandleBatch _tileBatch;   // tile worker only
+	WChartCurve::Scratch _renderCurveScratch;
+	WChartCurve::Scratch _tileCurveScratch;
+	// what the tiles were rendered from, bumped with _invalidateBackgroundFrame()
+	int64 _tileVersion = 0;
+	// which worker the last frame used, the other one is waited for (the shapes are not shared)
+	bool _paintedTiles = false;
+	// last, stopped before the data they read goes away
+	UPtr<WChartTileCache> _tileCache;
+	UPtr<WChartRenderThread> _renderThread;
 };
 
@@ -0,0 +1,248 @@
+/*
+  ==============================================================================
+
+    WCorrelationView.cpp
+    Created: 16 Oct 2026 10:48:03pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "WCorrelationView.h"
+#include "../WLookAndFeel.h"
+#include "../../../utils/TextCache.h"
+
+static constexpr float statusHeight = 18.0f;
+static constexpr float labelWidth = 64.0f;
+
+WCorrelationView::WCorrelationView(const Options& options) : _options(options) {
+	_options.window = jmax(2, _options.window);
+	// -1 red, 0 background, +1 green
+	for (int i = 0; i < 256; i++) {
+		const float t = (float)i / 255.0f * 2.0f - 1.0f;
+		_palette[i] = t < 0.0f
+			? WLookAndFeel::bgWidgetColour.interpolatedWith(WLookAndFeel::candleDownColour, -t)
+			: WLookAndFeel::bgWidgetColour.interpolatedWith(WLookAndFeel::candleUpColour, t);
+	}
+}
+
+WCorrelationView::~WCorrelationView() {
+	_vblank = nullptr;
+	_tasks.cancel();
+	_tasks.wait();
+}
+
+void WCorrelationView::setSeries(const StringArray& symbols, std::vector<KlineRingSeries::Ptr> series, int64 period) {
+	jassert((int)series.size() == symbols.size());
+	// the task reads all of it
+	_tasks.cancel();
+	_tasks.wait();
+	_tasks.reset();
+	_symbols = symbols;
+	_series = std::move(series);
+	_period = jmax((int64)1, period);
+	const int n = jmin(_symbols.size(), (int)_series.size());
+	_matrix = std::make_unique<CorrelationMatrix>(n, _options.window);
+	_lastClose.assign((size_t)n, std::numeric_limits<double>::quiet_NaN());
+	_returns.assign((size_t)n, 0.0);
+	_nextBar = 0;
+	_numPushed = 0;
+	{
+		const ScopedLock l(_lock);
+		_ready = nullptr;
+	}
+	_shown = {};
+	_hoverA = _hoverB = -1;
+	repaint();
+}
+
+void WCorrelationView::visibilityChanged() {
+	if (isVisible())
+		_vblank = std::make_unique<VBlankAttachment>(this, [this]() { _onVBlank(); });
+	else
+		_vblank = nullptr;
+}
+
+void WCorrelationView::_onVBlank() {
+	if (_matrix == nullptr)
+		return;
+	UPtr<Result> ready;
+	{
+		const ScopedLock l(_lock);
+		ready = std::move(_ready);
+	}
+	if (ready) {
+		_shown = std::move(*ready);
+		repaint();
+	}
+	if (_tasks.getNumPending() > 0)
+		return;
+	// a new row in any series may close a bar
+	uint64 pushed = 0;
+	for (const auto& s : _series)
+		pushed += s ? s->getNumPushed() : 0;
+	if (pushed == _numPushed)
+		return;
+	_numPushed = pushed;
+	TaskPool::getInstance().submit([this]() { _update(); }, TaskPool::Priority::low, &_tasks);
+}
+
+void WCorrelationView::_update() {
+	const int n = _matrix->getNumSymbols();
+	const int64 period = _period;
+	auto floorToPeriod = [period](int64 t) { return t - ((t % period) + period) % period; };
+
+	std::vector<KlineRingSeries::Snapshot> snaps((size_t)n);
+	int64 closedEnd = std::numeric_limits<int64>::max();
+	for (int i = 0; i < n; i++) {
+		if (_series[(size_t)i] == nullptr)
+			continue;
+		snaps[(size_t)i] = _series[(size_t)i]->getSnapshot();
+		// the bar of the forming row isn't closed
+		if (!snaps[(size_t)i].isEmpty())
+			closedEnd = jmin(closedEnd, floorToPeriod(snaps[(size_t)i].getOpenTime(snaps[(size_t)i].end - 1)));
+	}
+	if (closedEnd == std::numeric_limits<int64>::max())
+		return;
+
+	// close of the last row in [t, t + period), NaN without one
+	auto closeAt = [&](const KlineRingSeries::Snapshot& s, int64 t) {
+		if (s.isEmpty())
+			return std::numeric_limits<double>::quiet_NaN();
+		const uint64 row = s.lowerBound(t + period);
+		if (row == s.begin || s.getOpenTime(row - 1) < t)
+			return std::numeric_limits<double>::quiet_NaN();
+		return s.getRow(row - 1).close;
+	};
+	// first update or a long gap : the last window only (one more bar for its first returns)
+	_nextBar = jmax(_nextBar, closedEnd - (int64)(_options.window + 1) * period);
+	for (; _nextBar + period <= closedEnd; _nextBar += period) {
+		if (_tasks.isCancelled())
+			return;
+		bool any = false;
+		for (int i = 0; i < n; i++) {
+			const double close = closeAt(snaps[(size_t)i], _nextBar);
+			double& last = _lastClose[(size_t)i];
+			_returns[(size_t)i] = close > 0.0 && last > 0.0 ? std::log(close / last) : std::numeric_limits<double>::quiet_NaN();
+			any = any || !std::isnan(_returns[(size_t)i]);
+			if (close > 0.0)
+				last = close;
+		}
+		if (any)
+			_matrix->push(_returns.data());
+	}
+
+	auto result = std::make_unique<Result>();
+	_matrix->getMatrix(result->matrix);
+	result->numBars = _matrix->getNumBars();
+	result->pairBars.resize((size_t)n * (size_t)n);
+	for (int a = 0; a < n; a++)
+		for (int b = 0; b < n; b++)
+			result->pairBars[(size_t)a * (size_t)n + (size_t)b] = _matrix->getNumBars(a, b);
+	result->returns.resize((size_t)n);
+	for (int i = 0; i < n; i++)
+		result->returns[(size_t)i] = (float)_matrix->getWindowReturn(i);
+	// off the message thread, a software image
+	result->heatmap = Image(Image::ARGB, jmax(1, n), jmax(1, n), true, SoftwareImageType());
+	if (n > 0) {
+		Image::BitmapData pixels(result->heatmap, Image::BitmapData::writeOnly);
+		for (int a = 0; a < n; a++) {
+			for (int b = 0; b < n; b++) {
+				const float c = result->matrix[(size_t)a * (size_t)n + (size_t)b];
+				const int index = std::isnan(c) ? 128 : jlimit(0, 255, roundToInt((c + 1.0f) * 127.5f));
+				pixels.setPixelColour(b, a, _palette[index]);
+			}
+		}
+	}
+	const ScopedLock l(_lock);
+	_ready = std::move(result);
+}
+
+Rectangle<float> WCorrelationView::_getMatrixArea() const {
+	auto area = getLocalBounds().toFloat().reduced(4.0f);
+	area.removeFromBottom(statusHeight);
+	area.removeFromRight(_options.returnsWidth);
+	const int n = jmax(1, getNumSymbols());
+	// the symbols on the left when their rows are tall enough to be read
+	if (jmin(area.getWidth(), area.getHeight()) / (float)n >= _options.minLabelHeight)
+		area.removeFromLeft(labelWidth);
+	const float side = jmax(0.0f, jmin(area.getWidth(), area.getHeight()));
+	return area.withSize(side, side);
+}
+
+bool WCorrelationView::_getCell(Point<float> p, int& a, int& b) const {
+	const auto area = _getMatrixArea();
+	const int n = _shown.heatmap.isValid() ? _shown.heatmap.getWidth() : 0;
+	if (n == 0 || !area.contains(p))
+		return false;
+	const float cell = area.getWidth() / (float)n;
+	a = jlimit(0, n - 1, (int)((p.y - area.getY()) / cell));
+	b = jlimit(0, n - 1, (int)((p.x - area.getX()) / cell));
+	return true;
+}
+
+void WCorrelationView::paint(Graphics& g) {
+	g.fillAll(WLookAndFeel::bgWidgetColour);
+	auto& text = TextCache::getInstance();
+	const auto font = Font(11.0f);
+	const int n = _shown.heatmap.isValid() ? jmin(_shown.heatmap.getWidth(), getNumSymbols()) : 0;
+	if (n == 0 || _shown.numBars < 2) {
+		g.setColour(WLookAndFeel::axisTextColour);
+		text.draw(g, font, "waiting for bars", getLocalBounds().toFloat(), Justification::centred);
+		return;
+	}
+	const auto area = _getMatrixArea();
+	const float cell = area.getWidth() / (float)n;
+	g.setImageResamplingQuality(Graphics::lowResamplingQuality);
+	g.drawImage(_shown.heatmap, area);
+
+	// symbols and returns, row by row
+	const bool labels = cell >= _options.minLabelHeight;
+	float maxReturn = 1e-9f;
+	for (float r : _shown.returns)
+		maxReturn = jmax(maxReturn, std::abs(r));
+	const auto column = Rectangle<float>(area.getRight() + 4.0f, area.getY(), _options.returnsWidth - 4.0f, area.getHeight());
+	for (int i = 0; i < n; i++) {
+		const auto row = Rectangle<float>(column.getX(), area.getY() + cell * (float)i, column.getWidth(), cell);
+		const float r = _shown.returns[(size_t)i];
+		const float half = row.getWidth() * 0.5f;
+		const float length = half * std::abs(r) / maxReturn;
+		g.setColour((r >= 0.0f ? WLookAndFeel::candleUpColour : WLookAndFeel::candleDownColour).withAlpha(0.6f));
+		g.fillRect(r >= 0.0f ? row.withX(row.getCentreX()).withWidth(length) : row.withX(row.getCentreX() - length).withWidth(length));
+		if (!labels)
+			continue;
+		g.setColour(WLookAndFeel::axisTextColour);
+		text.draw(g, font, String(r * 100.0f, 1) + "%", row, Justification::centredRight);
+		text.draw(g, font, _symbols[i], row.withX(area.getX() - labelWidth).withWidth(labelWidth - 4.0f), Justification::centredRight);
+	}
+
+	auto status = getLocalBounds().toFloat().reduced(4.0f).removeFromBottom(statusHeight);
+	g.setColour(WLookAndFeel::axisTextColour);
+	String line = String(n) + " symbols, " + String(_shown.numBars) + " bars";
+	if (_hoverA >= 0 && _hoverA < n && _hoverB < n) {
+		const size_t pair = (size_t)_hoverA * (size_t)n + (size_t)_hoverB;
+		const float c = _shown.matrix[pair];
+		line = _symbols[_hoverA] + " / " + _symbols[_hoverB] + "  " + (std::isnan(c) ? String("-") : String(c, 2))
+			+ " over " + String(_shown.pairBars[pair]) + " bars   " + line;
+		g.setColour(Colours::white);
+		g.drawRect(Rectangle<float>(area.getX() + cell * (float)_hoverB, area.getY() + cell * (float)_hoverA, cell, cell).expanded(1.0f), 1.0f);
+		g.setColour(WLookAndFeel::axisTextColour);
+	}
+	text.draw(g, font, line, status, Justification::centredLeft);
+}
+
+void WCorrelationView::mouseMove(const MouseEvent& e) {
+	int a = -1, b = -1;
+	if (!_getCell(e.position, a, b))
+		a = b = -1;
+	if (a == _hoverA && b == _hoverB)
+		return;
+	_hoverA = a;
+	_hoverB = b;
+	repaint();
+}
+
+void WCorrelationView::mouseExit(const MouseEvent&) {
+	_hoverA = _hoverB = -1;
+	repaint();
+}
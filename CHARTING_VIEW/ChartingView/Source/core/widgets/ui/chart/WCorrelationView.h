@@ -0,0 +1,96 @@
+/*
+  ==============================================================================
+
+    WCorrelationView.h
+    Created: 16 Oct 2026 10:48:03pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "../BaseComponent.h"
+#include "../../../data/CorrelationMatrix.h"
+#include "../../../data/KlineRingSeries.h"
+#include "../../../utils/TaskPool.h"
+
+/*
+	Rolling correlation of the returns of many symbols (100 .. 300, the
+	series of a BinanceKlineFeed) as a heatmap, the return of each symbol
+	over the window in a column at the right, the pair under the mouse below.
+
+		feed.start(symbols, "1m");
+		view.setSeries(symbols, series, chart.getTimeframe());
+
+	Bars are the chart's timeframe (period ms, the series rows aggregated to
+	it by their last close), a bar is closed once every symbol has a row past
+	it. Each closed bar is one CorrelationMatrix::push (log returns, O(N^2)).
+	A symbol without a row in a bar has no return there, each pair is
+	correlated over the bars both have (shown with the pair under the mouse).
+
+	Nothing of it runs in the frames of the charts : on each display refresh
+	(VBlankAttachment) the view only compares the rows pushed to the series
+	with the last update. When a row came, a low priority TaskPool task folds
+	the closed bars into the matrix and bakes the heatmap into an image of one
+	pixel per pair, the next refresh swaps it in and repaints. One task at a
+	time, a refresh while it runs skips.
+*/
+
+class WCorrelationView : public BaseComponent {
+public:
+	struct Options {
+		int window = 100;            // bars of the rolling correlation
+		float returnsWidth = 56.0f;  // px of the window returns column
+		float minLabelHeight = 9.0f; // px per row under which the symbols are not written
+	};
+
+	explicit WCorrelationView(const Options& options = {});
+	~WCorrelationView() override;
+
+	// series[i] of symbols[i], bars of period ms (a multiple of the series interval)
+	void setSeries(const StringArray& symbols, std::vector<KlineRingSeries::Ptr> series, int64 period);
+	int getNumSymbols() const { return _symbols.size(); }
+
+	void paint(Graphics& g) override;
+	void mouseMove(const MouseEvent& e) override;
+	void mouseExit(const MouseEvent& e) override;
+
+private:
+	struct Result {
+		Image heatmap;               // N x N, one pixel per pair
+		std::vector<float> returns;  // per symbol over the window
+		std::vector<float> matrix;
+		std::vector<int> pairBars;   // N x N, bars both symbols have
+		int numBars = 0;
+	};
+
+	void visibilityChanged() override;
+	void _onVBlank();
+	// on the pool : the bars closed since the last update into the matrix, then a Result
+	void _update();
+	Rectangle<float> _getMatrixArea() const;
+	bool _getCell(Point<float> p, int& a, int& b) const;
+
+	Options _options;
+	StringArray _symbols;
+	std::vector<KlineRingSeries::Ptr> _series;
+	int64 _period = 0;
+	uint64 _numPushed = 0; // rows of all the series at the last update
+	UPtr<VBlankAttachment> _vblank;
+	Colour _palette[256];
+
+	// the task's
+	UPtr<CorrelationMatrix> _matrix;
+	std::vector<double> _lastClose;
+	std::vector<double> _returns;
+	int64 _nextBar = 0; // start of the next bar to push, 0 before the first update
+
+	CriticalSection _lock;
+	UPtr<Result> _ready; // under _lock, taken by _onVBlank
+	Result _shown;
+	int _hoverA = -1, _hoverB = -1;
+
+	TaskPool::Group _tasks; // last, the task is done before the rest goes
+
+	JUCE_DECLARE_NON_COPYABLE(WCorrelationView)
+};
@@ -0,0 +1,230 @@
+/*
+  ==============================================================================
+
+    WDepthView.cpp
+    Created: 15 Oct 2026 9:26:40pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "WDepthView.h"
+#include "../WLookAndFeel.h"
+#include "../../../utils/TextCache.h"
+
+// the reference heat decays toward the current largest level, per column
+static constexpr double referenceDecay = 0.995;
+
+WDepthView::WDepthView(const Options& options) : _options(options) {
+	_options.historyColumns = jmax(2, _options.historyColumns);
+	_options.priceRows = jmax(8, _options.priceRows);
+	_heatmap = Image(Image::ARGB, _options.historyColumns, _options.priceRows, true);
+	_rows.resize((size_t)_options.priceRows);
+
+	// dark blue -> cyan -> yellow -> white
+	const Colour stops[] = { WLookAndFeel::bgWidgetColour, Colour(0xff1e3a8a), Colour(0xff06b6d4), Colour(0xfffacc15), Colours::white };
+	const int numStops = (int)std::size(stops);
+	for (int i = 0; i < 256; i++) {
+		const float t = (float)i / 255.0f * (float)(numStops - 1);
+		const int s = jmin(numStops - 2, (int)t);
+		_palette[i] = stops[s].interpolatedWith(stops[s + 1], t - (float)s);
+	}
+	_poller.onTimer = [this] { _poll(); };
+}
+
+WDepthView::~WDepthView() {
+	_poller.stopTimer();
+}
+
+void WDepthView::setBook(OrderBook::Ptr book) {
+	_book = std::move(book);
+	_version = 0;
+	_snapshot = {};
+	_heatmap.clear(_heatmap.getBounds());
+	_head = _numColumns = 0;
+	_rowStep = 0.0;
+	_reference = 0.0;
+	repaint();
+}
+
+void WDepthView::visibilityChanged() {
+	if (isVisible())
+		_poller.startTimerHz(60);
+	else
+		_poller.stopTimer();
+}
+
+void WDepthView::_poll() {
+	if (_book == nullptr)
+		return;
+	bool changed = false;
+	const uint32 version = _book->getVersion();
+	if (version != _version) {
+		_version = version;
+		_book->getSnapshot(_snapshot, _options.maxLevels);
+		changed = true;
+	}
+	const uint32 now = Time::getMillisecondCounter();
+	if (!_snapshot.isEmpty() && now >= _nextColumnTime) {
+		// a late timer skips columns instead of drifting
+		_nextColumnTime = jmax(_nextColumnTime + (uint32)_options.columnMs, now);
+		_pushColumn();
+		changed = true;
+	}
+	if (changed)
+		repaint();
+}
+
+void WDepthView::_placeRows(double mid) {
+	const int numRows = _options.priceRows;
+	if (_rowStep <= 0.0) {
+		const double tick = _book->getTickSize();
+		_rowStep = jmax(tick, std::round(mid * _options.spanFraction / (double)numRows / tick) * tick);
+		_topPrice = std::ceil((mid + _rowStep * (double)numRows * 0.5) / _rowStep) * _rowStep;
+		return;
+	}
+	const double center = _topPrice - _rowStep * (double)numRows * 0.5;
+	if (std::abs(mid - center) < _rowStep * (double)numRows * 0.25)
+		return;
+	// shift : rows to move down (the prices went up)
+	const int shift = (int)std::llround((mid - center) / _rowStep);
+	_topPrice += (double)shift * _rowStep;
+	const int w = _heatmap.getWidth();
+	if (std::abs(shift) >= numRows) {
+		_heatmap.clear(_heatmap.getBounds());
+		return;
+	}
+	if (shift > 0) {
+		_heatmap.moveImageSection(0, shift, 0, 0, w, numRows - shift);
+		_heatmap.clear({ 0, 0, w, shift });
+	}
+	else {
+		_heatmap.moveImageSection(0, 0, 0, -shift, w, numRows + shift);
+		_heatmap.clear({ 0, numRows + shift, w, -shift });
+	}
+}
+
+void WDepthView::_pushColumn() {
+	_placeRows(_snapshot.getMid());
+	std::fill(_rows.begin(), _rows.end(), 0.0);
+	const int numRows = _options.priceRows;
+	double largest = 0.0;
+	for (const auto* side : { &_snapshot.bids, &_snapshot.asks }) {
+		for (const auto& l : *side) {
+			const int row = (int)std::floor((_topPrice - l.price) / _rowStep);
+			if (!isPositiveAndBelow(row, numRows))
+				break; // sorted from the touch, all the next ones are out too
+			_rows[(size_t)row] += l.quantity;
+			largest = jmax(largest, _rows[(size_t)row]);
+		}
+	}
+	_reference = jmax(largest, _reference * referenceDecay);
+	const double scale = _reference > 0.0 ? 1.0 / std::log1p(_reference) : 0.0;
+
+	Image::BitmapData pixels(_heatmap, _head, 0, 1, numRows, Image::BitmapData::writeOnly);
+	for (int r = 0; r < numRows; r++) {
+		const int heat = jlimit(0, 255, (int)(std::log1p(_rows[(size_t)r]) * scale * 255.0));
+		pixels.setPixelColour(0, r, _palette[heat]);
+	}
+	_head = (_head + 1) % _heatmap.getWidth();
+	_numColumns = jmin(_numColumns + 1, _heatmap.getWidth());
+}
+
+float WDepthView::_toY(double price, const Rectangle<float>& area) const {
+	const double span = _rowStep * (double)_options.priceRows;
+	return area.getY() + (float)((_topPrice - price) / span) * area.getHeight();
+}
+
+void WDepthView::paint(Graphics& g) {
+	g.fillAll(WLookAndFeel::bgWidgetColour);
+	if (_rowStep <= 0.0 || _snapshot.isEmpty())
+		return;
+	auto area = getLocalBounds().toFloat();
+	const auto depthArea = area.removeFromRight(area.getWidth() * _options.depthFraction);
+	_paintHeatmap(g, area);
+	_paintDepth(g, depthArea);
+}
+
+void WDepthView::_paintHeatmap(Graphics& g, const Rectangle<float>& area) {
+	// oldest on the left, newest on the right edge
+	const int w = _heatmap.getWidth();
+	const int h = _heatmap.getHeight();
+	const float columnWidth = area.getWidth() / (float)w;
+	g.setImageResamplingQuality(Graphics::lowResamplingQuality);
+	auto drawColumns = [&](int first, int count, float x) {
+		if (count > 0)
+			g.drawImage(_heatmap, roundToInt(x), roundToInt(area.getY()), roundToInt(columnWidth * (float)count), roundToInt(area.getHeight()),
+						first, 0, count, h);
+	};
+	const float right = area.getRight();
+	if (_numColumns < w) {
+		drawColumns(0, _head, right - columnWidth * (float)_head);
+	}
+	else {
+		drawColumns(_head, w - _head, area.getX());
+		drawColumns(0, _head, area.getX() + columnWidth * (float)(w - _head));
+	}
+
+	// touch
+	if (!_snapshot.bids.empty()) {
+		g.setColour(WLookAndFeel::candleUpColour);
+		g.drawHorizontalLine(roundToInt(_toY(_snapshot.bids.front().price, area)), area.getX(), area.getRight());
+	}
+	if (!_snapshot.asks.empty()) {
+		g.setColour(WLookAndFeel::candleDownColour);
+		g.drawHorizontalLine(roundToInt(_toY(_snapshot.asks.front().price, area)), area.getX(), area.getRight());
+	}
+}
+
+void WDepthView::_addDepthPath(Path& path, const std::vector<OrderBook::Level>& levels, const Rectangle<float>& area, double maxCumulative) {
+	path.clear();
+	if (levels.empty() || maxCumulative <= 0.0)
+		return;
+	// steps growing away from the touch, x from the left edge of the area
+	double cumulative = 0.0;
+	float y = _toY(levels.front().price, area);
+	path.startNewSubPath(area.getX(), y);
+	for (const auto& l : levels) {
+		y = jlimit(area.getY(), area.getBottom(), _toY(l.price, area));
+		path.lineTo(area.getX() + (float)(cumulative / maxCumulative) * area.getWidth(), y);
+		cumulative += l.quantity;
+		path.lineTo(area.getX() + (float)(cumulative / maxCumulative) * area.getWidth(), y);
+		if (y <= area.getY() || y >= area.getBottom())
+			break;
+	}
+	path.lineTo(area.getX(), y);
+	path.closeSubPath();
+}
+
+void WDepthView::_paintDepth(Graphics& g, const Rectangle<float>& area) {
+	const double top = _topPrice;
+	const double bottom = _topPrice - _rowStep * (double)_options.priceRows;
+	// both sides on the same scale, their depth inside the visible prices
+	auto visibleDepth = [](const std::vector<OrderBook::Level>& levels, double low, double high) {
+		double sum = 0.0;
+		for (const auto& l : levels) {
+			if (l.price < low || l.price > high)
+				break;
+			sum += l.quantity;
+		}
+		return sum;
+	};
+	const double maxCumulative = jmax(visibleDepth(_snapshot.bids, bottom, top), visibleDepth(_snapshot.asks, bottom, top));
+	_addDepthPath(_bidPath, _snapshot.bids, area, maxCumulative);
+	_addDepthPath(_askPath, _snapshot.asks, area, maxCumulative);
+	g.setColour(WLookAndFeel::candleUpColour.withAlpha(0.3f));
+	g.fillPath(_bidPath);
+	g.setColour(WLookAndFeel::candleUpColour);
+	g.strokePath(_bidPath, PathStrokeType(1.0f));
+	g.setColour(WLookAndFeel::candleDownColour.withAlpha(0.3f));
+	g.fillPath(_askPath);
+	g.setColour(WLookAndFeel::candleDownColour);
+	g.strokePath(_askPath, PathStrokeType(1.0f));
+
+	g.setColour(WLookAndFeel::axisTextColour);
+	const double mid = _snapshot.getMid();
+	String label = String(mid, 2);
+	if (!_snapshot.bids.empty() && !_snapshot.asks.empty())
+		label << "  spread " << String(_snapshot.asks.front().price - _snapshot.bids.front().price, 2);
+	TextCache::getInstance().draw(g, Font(12.0f), label, area.reduced(4.0f).removeFromTop(16.0f), Justification::centredRight);
+}
@@ -0,0 +1,86 @@
+/*
+  ==============================================================================
+
+    WDepthView.h
+    Created: 15 Oct 2026 9:26:40pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "../BaseComponent.h"
+#include "../../../data/OrderBook.h"
+#include "../../../utils/TimerLambda.h"
+
+/*
+	Order book view : a heatmap of the resting quantities over time (x) and
+	price (y) on the left, the cumulative depth of both sides on the right,
+	sharing the price axis around the mid price.
+
+		feed.start("BTCUSDT", 0.01);
+		depthView.setBook(feed.getBook());
+
+	The view polls the book at 60 Hz and takes a snapshot only when its
+	version changed (OrderBook::getSnapshot never blocks the feed thread).
+	Every columnMs a column of the heatmap is written from the last snapshot.
+
+	The heatmap history is a ring texture : an image of historyColumns x
+	priceRows pixels where the newest column overwrites the oldest one, drawn
+	as its two halves so nothing is copied per frame. Colours are baked when a
+	column is written (log of the quantity over a reference that follows the
+	largest levels). When the mid leaves the central half of the rows, the
+	image is moved by whole rows and the exposed ones start empty.
+*/
+
+class WDepthView : public BaseComponent {
+public:
+	struct Options {
+		int historyColumns = 600;      // heatmap columns, one per columnMs
+		int columnMs = 100;
+		int priceRows = 256;           // heatmap rows over the whole height
+		double spanFraction = 0.004;   // of the mid price over the whole height
+		int maxLevels = 2000;          // per side and snapshot
+		float depthFraction = 0.25f;   // of the width for the cumulative depth
+	};
+
+	explicit WDepthView(const Options& options = {});
+	~WDepthView() override;
+
+	// the view keeps the book alive, nullptr clears the view
+	void setBook(OrderBook::Ptr book);
+	const OrderBook::Ptr& getBook() const { return _book; }
+
+	void paint(Graphics& g) override;
+
+private:
+	void visibilityChanged() override;
+	void _poll();
+	void _pushColumn();
+	// rows of rowStep around mid, the image moved to follow the previous ones
+	void _placeRows(double mid);
+	float _toY(double price, const Rectangle<float>& area) const;
+	void _paintHeatmap(Graphics& g, const Rectangle<float>& area);
+	void _paintDepth(Graphics& g, const Rectangle<float>& area);
+	void _addDepthPath(Path& path, const std::vector<OrderBook::Level>& levels, const Rectangle<float>& area, double maxCumulative);
+
+	Options _options;
+	OrderBook::Ptr _book;
+	OrderBook::Snapshot _snapshot;
+	uint32 _version = 0;
+	TimerLambda _poller;
+
+	// ring : column _head - 1 is the newest, row 0 ends at the highest price
+	Image _heatmap;
+	int _head = 0;
+	int _numColumns = 0;
+	uint32 _nextColumnTime = 0;
+	double _topPrice = 0.0;   // upper edge of row 0
+	double _rowStep = 0.0;    // 0 until the first snapshot
+	double _reference = 0.0;  // quantity drawn at full heat
+	std::vector<double> _rows;
+	Colour _palette[256];
+	Path _bidPath, _askPath;
+
+	JUCE_DECLARE_NON_COPYABLE(WDepthView)
+};
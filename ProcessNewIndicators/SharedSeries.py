@@ -0,0 +1,142 @@
+"""
+Writer side of the shared memory channel read by the C++ chart
+(CHARTING_VIEW/ChartingView/Source/core/io/SharedSeries.h).
+
+The channel is a file mapped by both processes (put it in /dev/shm or on a ram
+disk to never touch the disk): a 4096 byte control block followed by numpy
+columns. The chart maps the columns in place, nothing is serialized.
+
+	with SharedSeriesWriter("btc_1m.ttss", {"open_time": "<i8", "open": "<f8", ...}, capacity=5_000_000, name="BTCUSDT") as w:
+		w.write(open_time=times, open=opens, ...)   # whole arrays
+		w.append(open_time=t, open=o, ...)          # new rows only
+
+Every write makes the sequence odd, copies the values, updates the row count
+then makes the sequence even again: the chart only picks up complete updates.
+The capacity is fixed at creation, create a new file to grow.
+"""
+
+import mmap
+import os
+import struct
+
+import numpy as np
+
+
+MAGIC = b"TTSS"
+VERSION = 1
+HEADER_SIZE = 4096
+MAX_COLUMNS = 32
+COLUMN_ALIGN = 64
+
+# magic, version, headerSize, numColumns, sequence, numRows, capacity, name[64], reserved[24]
+_HEADER = struct.Struct("<4sIII QQQ 64s 24x")
+# name[48], dtype[4], itemSize, offset
+_COLUMN = struct.Struct("<48s4sIQ")
+_SEQUENCE_OFFSET = 16
+_ROWS_OFFSET = 24
+
+
+class SharedSeriesWriter:
+	def __init__(self, path, columns, capacity, name=""):
+		if len(columns) > MAX_COLUMNS:
+			raise ValueError(f"at most {MAX_COLUMNS} columns")
+		self.path = path
+		self.capacity = int(capacity)
+		self.dtypes = {k: np.dtype(v).newbyteorder("<") for k, v in columns.items()}
+		self.sequence = 0
+		self.num_rows = 0
+
+		offsets = {}
+		offset = HEADER_SIZE
+		for k, dt in self.dtypes.items():
+			offsets[k] = offset
+			offset += (self.capacity * dt.itemsize + COLUMN_ALIGN - 1) // COLUMN_ALIGN * COLUMN_ALIGN
+
+		with open(path, "wb") as f:
+			f.truncate(offset)
+		self._file = open(path, "r+b")
+		self._mm = mmap.mmap(self._file.fileno(), offset)
+
+		_HEADER.pack_into(self._mm, 0, MAGIC, VERSION, HEADER_SIZE, len(self.dtypes), 0, 0, self.capacity, name.encode("utf-8")[:63])
+		for i, (k, dt) in enumerate(self.dtypes.items()):
+			_COLUMN.pack_into(self._mm, _HEADER.size + i * _COLUMN.size, k.encode("utf-8")[:47], dt.str.encode("ascii"), dt.itemsize, offsets[k])
+
+		self.columns = {k: np.frombuffer(self._mm, dtype=dt, count=self.capacity, offset=offsets[k]) for k, dt in self.dtypes.items()}
+
+	def _begin(self):
+		self.sequence += 1
+		struct.pack_into("<Q", self._mm, _SEQUENCE_OFFSET, self.sequence)
+
+	def _end(self, num_rows):
+		self.num_rows = num_rows
+		struct.pack_into("<Q", self._mm, _ROWS_OFFSET, num_rows)
+		self.sequence += 1
+		struct.pack_into("<Q", self._mm, _SEQUENCE_OFFSET, self.sequence)
+
+	def write(self, **arrays):
+		"""Replaces the content, every column gets the same number of rows."""
+		n = self._check(arrays)
+		self._begin()
+		for k, v in arrays.items():
+			self.columns[k][:n] = v
+		self._end(n)
+
+	def append(self, **arrays):
+		"""Appends rows after the current ones."""
+		n = self._check(arrays)
+		if self.num_rows + n > self.capacity:
+			raise ValueError("capacity exceeded")
+		self._begin()
+		for k, v in arrays.items():
+			self.columns[k][self.num_rows:self.num_rows + n] = v
+		self._end(self.num_rows + n)
+
+	def _check(self, arrays):
+		lengths = {len(v) for v in arrays.values()}
+		if len(lengths) != 1:
+			raise ValueError("columns must have the same length")
+		unknown = set(arrays) - set(self.columns)
+		if unknown:
+			raise KeyError(f"unknown columns {unknown}")
+		n = lengths.pop()
+		if n > self.capacity:
+			raise ValueError("capacity exceeded")
+		return n
+
+	def close(self):
+		self.columns = {}
+		self._mm.close()
+		self._file.close()
+
+	def __enter__(self):
+		return self
+
+	def __exit__(self, exc_type, exc_val, exc_tb):
+		self.close()
+
+
+def kline_columns(extra=None):
+	"""Column layout of the DownloaderTool csv, the chart draws it as candles."""
+	columns = {
+		"open_time": "<i8", "open": "<f8", "high": "<f8", "low": "<f8", "close": "<f8", "volume": "<f8",
+		"close_time": "<i8", "quote_asset_volume": "<f8", "number_of_trades": "<i8",
+		"taker_buy_base_asset_volume": "<f8", "taker_buy_quote_asset_volume": "<f8",
+	}
+	columns.update(extra or {})
+	return columns
+
+
+if __name__ == "__main__":
+	import sys
+	import time
+
+	# demo : streams a random walk on the given path
+	path = sys.argv[1] if len(sys.argv) > 1 else os.path.join("/dev/shm" if os.path.isdir("/dev/shm") else ".", "demo.ttss")
+	with SharedSeriesWriter(path, kline_columns(), capacity=1_000_000, name="DEMO") as w:
+		t0 = int(time.time() // 60 * 60_000)
+		price = 100.0
+		for i in range(10_000):
+			o = price
+			price *= 1.0 + np.random.normal(0.0, 0.001)
+			w.append(open_time=[t0 + i * 60_000], open=[o], high=[max(o, price) * 1.0005], low=[min(o, price) * 0.9995], close=[price], volume=[1.0])
+			time.sleep(0.01)